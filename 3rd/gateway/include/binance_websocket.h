@@ -2,6 +2,11 @@
 
 #include "exchange_interface.h"
 #include "config_manager.h"
+#include "message_views.h"
+#include "request_signer.h"
+#include "order_template.h"
+#include "order_pacer.h"
+#include "exchange_clock.h"
 #include <ixwebsocket/IXWebSocket.h>
 #include <ixwebsocket/IXHttpClient.h>
 #include <thread>
@@ -9,6 +14,8 @@
 #include <mutex>
 #include <chrono>
 #include <queue>
+#include <array>
+#include <map>
 
 namespace trading {
 
@@ -51,10 +58,24 @@ public:
     void setOrderResponseCallback(std::function<void(const OrderResponse&)> callback) override;
     void setDepthUpdateCallback(std::function<void(const DepthUpdate&)> callback) override;
     void setTradeLiteCallback(std::function<void(const TradeLite&)> callback) override;
+    void setAggTradeCallback(std::function<void(const AggTrade&)> callback) override;
+    void setOrderUpdateViewCallback(std::function<void(const OrderUpdateView&)> callback) override;
+    void setAccountInfoViewCallback(std::function<void(const AccountInfoView&)> callback) override;
+    void setOrderTraceCallback(
+        std::function<void(const char* clientOrderId, OrderTraceStage stage, int64_t monotonicNs)> callback) override;
+    void setLatencySampleCallback(std::function<void(const LatencySample&)> callback) override;
+    ClockSyncStatus getClockSyncStatus() const override;
     
     // 订单操作方法
     void placeOrder(const OrderRequest& orderRequest, const std::string& requestId = "") override;
     void cancelOrder(const CancelOrderRequest& cancelRequest, const std::string& requestId = "") override;
+    int registerOrderTemplate(const OrderTemplateSpec& spec) override;
+    bool placeOrderFromTemplate(int templateHandle, bool isBuy, double quantity, double price,
+                                const char* clientOrderId, OrderUrgency urgency = OrderUrgency::NORMAL,
+                                int strategySlot = 0) override;
+    int registerStrategyRateLimit(const std::string& strategyId, uint32_t ordersPerSecond,
+                                  uint32_t ordersPerMinute) override;
+    OrderPacerStatistics getOrderPacerStatistics() const { return orderPacer_.getStatistics(); }
     
     // 市场数据订阅方法
     bool subscribeDepthUpdate(const std::string& symbol, int levels = 20, int updateSpeed = 100) override;
@@ -83,10 +104,13 @@ private:
     void parseOrderUpdate(yyjson_val* root);
     void parseAccountBalanceResponse(yyjson_val* root);  // 新增：解析账户余额响应
     void parseAccountInfoResponse(yyjson_val* root);     // 新增：解析账户信息响应
+    void dispatchAccountInfoResponse(yyjson_val* root);  // 按已注册回调选择视图或完整解析
     void parsePositionInfoResponse(yyjson_val* root);    // 新增：解析持仓信息响应
     void parseDepthUpdate(yyjson_val* root);             // 新增：解析深度更新
     void parseTradeLite(yyjson_val* root);               // 新增：解析交易数据
+    void parseAggTrade(yyjson_val* root);                // 解析公开归集成交
     void parseOrderResponse(yyjson_val* root);           // 新增：解析订单响应
+    void traceOrder(const char* clientOrderId, OrderTraceStage stage);  // 调用下单链路打点回调
     
     // HTTP API调用 (旧方法，已弃用)
     bool createListenKey();
@@ -97,6 +121,10 @@ private:
     std::string generateSignature(const std::string& queryString) const;
     std::string generateHmacSha256Signature(const std::string& queryString) const;  // HMAC-SHA256签名函数
     std::string generateEd25519Signature(const std::string& message) const;  // Ed25519签名函数
+    bool retryEd25519KeyLoad() const;  // 私钥加载失败后按退避间隔重新加载
+    void initRequestSigner();  // 启动时加载密钥并预计算签名状态
+    bool sendPacedOrder(PacedOrder& order);  // 限频调度器放行后渲染并发送
+    void parseRateLimits(yyjson_val* root);  // 解析WS API响应携带的rateLimits
     
     // 新的WebSocket API方法
     bool createListenKeyViaWebSocket();  // 通过WebSocket API创建listenKey
@@ -124,6 +152,9 @@ private:
     ExchangeConfig config_;
     std::string apiKey_;
     std::string apiSecret_;
+    std::unique_ptr<RequestSigner> signer_;  // 长生命周期签名器，密钥只加载一次
+    mutable std::atomic<int64_t> ed25519RetryAtNs_;       // 下次允许重新加载Ed25519私钥的时间（steady_clock）
+    mutable std::atomic<int64_t> ed25519RetryBackoffNs_;  // 当前退避间隔，每次失败翻倍
     int timeoutMs_;
     int reconnectIntervalMs_;
     
@@ -140,7 +171,7 @@ private:
     std::atomic<bool> wsApiConnected_;  // WebSocket API连接状态
     std::string sessionId_;
     int subscriptionId_;
-    int requestId_;  // WebSocket API请求ID计数器
+    std::atomic<int> requestId_;  // WebSocket API请求ID计数器（下单线程与调度线程共用）
     
     // 状态
     std::atomic<ConnectionStatus> status_;
@@ -162,15 +193,37 @@ private:
     std::function<void(const OrderResponse&)> orderResponseCallback_;           // 新增
     std::function<void(const DepthUpdate&)> depthUpdateCallback_;               // 新增
     std::function<void(const TradeLite&)> tradeLiteCallback_;                   // 新增
+    std::function<void(const AggTrade&)> aggTradeCallback_;                     // 公开成交
+    std::function<void(const OrderUpdateView&)> orderUpdateViewCallback_;       // 视图模式
+    std::function<void(const AccountInfoView&)> accountInfoViewCallback_;       // 视图模式
+    // 下单链路打点：在下单线程与WS回调线程中调用，替换时加锁，保证置空返回后不再有调用在执行
+    std::function<void(const char*, OrderTraceStage, int64_t)> orderTraceCallback_;
+    std::mutex orderTraceMutex_;
+    std::atomic<bool> orderTraceEnabled_{false};  // 未设置回调时跳过加锁
     
     // 心跳管理
     std::chrono::steady_clock::time_point lastHeartbeat_;
     static constexpr int HEARTBEAT_INTERVAL_MS = 30000; // 30秒
     static constexpr int LISTEN_KEY_REFRESH_INTERVAL_MS = 1800000; // 30分钟
+    static constexpr int64_t ED25519_RETRY_INITIAL_NS = 1000000000LL;   // 私钥重载初始退避1秒
+    static constexpr int64_t ED25519_RETRY_MAX_NS = 60000000000LL;      // 最长60秒
     
     // HTTP客户端
     std::unique_ptr<ix::HttpClient> httpClient_;
     std::string baseApiUrl_;
+    
+    // 下单模板：定长槽位，注册后只读，下单路径无需加锁
+    static constexpr int MAX_ORDER_TEMPLATES = 1024;
+    std::array<std::unique_ptr<OrderTemplate>, MAX_ORDER_TEMPLATES> orderTemplates_;
+    std::atomic<int> orderTemplateCount_;
+    std::map<std::string, int> orderTemplateIndex_;  // 规格键 -> 句柄，仅注册时使用
+    std::mutex orderTemplateMutex_;
+    
+    // 往返时间与交易所时钟偏移，出站timestamp据此校正
+    ExchangeClock exchangeClock_;
+    
+    // 下单限频调度，最后声明以便最先析构
+    OrderPacer orderPacer_;
 };
 
 /**
@@ -4,6 +4,7 @@
 #include <vector>
 #include <map>
 #include <chrono>
+#include <cstdint>
 
 namespace trading {
 
@@ -291,6 +292,24 @@ struct AccountInfoResponse {
 /**
  * @brief 订单请求参数
  */
+/**
+ * @brief 下单链路打点阶段，供上层按clientOrderId串联端到端延迟
+ */
+enum class OrderTraceStage : uint8_t {
+    SERIALIZED = 0,     // 请求报文已渲染（含签名前的全部字段）
+    SENT = 1,           // send()返回
+    ACKNOWLEDGED = 2    // 收到order.place应答
+};
+
+/**
+ * @brief 下单紧急程度 (限频排队时数值小的优先)
+ */
+enum class OrderUrgency : uint8_t {
+    URGENT = 0,     // 平仓、风控减仓
+    NORMAL = 1,     // 常规调仓
+    PASSIVE = 2     // TWAP切片等可延后的订单
+};
+
 struct OrderRequest {
     std::string symbol;                     // 交易对
     std::string side;                       // 买卖方向 BUY, SELL
@@ -311,8 +330,27 @@ struct OrderRequest {
     std::string priceMatch;                 // 价格匹配模式
     std::string selfTradePreventionMode;    // 自成交防止模式
     int64_t goodTillDate;                   // GTD订单自动取消时间
+    OrderUrgency urgency;                   // 限频排队优先级（不发送给交易所）
+    int strategySlot;                       // registerStrategyRateLimit返回的策略槽位，0为默认
     
-    OrderRequest() : goodTillDate(0) {}
+    OrderRequest() : goodTillDate(0), urgency(OrderUrgency::NORMAL), strategySlot(0) {}
+};
+
+/**
+ * @brief 下单模板规格 (按交易对和订单类型预渲染请求中的常量部分)
+ */
+struct OrderTemplateSpec {
+    std::string symbol;                     // 交易对
+    std::string type;                       // 订单类型
+    std::string positionSide;               // 持仓方向
+    std::string timeInForce;                // 有效方法
+    std::string reduceOnly;                 // 只减仓 true, false
+    std::string closePosition;              // 触发后全部平仓
+    std::string newOrderRespType;           // 响应类型 ACK, RESULT
+    double stepSize;                        // 数量步长
+    double tickSize;                        // 价格步长
+
+    OrderTemplateSpec() : stepSize(0.0), tickSize(0.0) {}
 };
 
 /**
@@ -400,6 +438,25 @@ struct DepthUpdate {
                    finalUpdateId(0), prevFinalUpdateId(0) {}
 };
 
+/**
+ * @brief 归集成交推送（公开行情<symbol>@aggTrade）
+ */
+struct AggTrade {
+    std::string eventType;                  // 事件类型 "aggTrade"
+    int64_t eventTime;                      // 事件时间
+    std::string symbol;                     // 交易对
+    int64_t aggTradeId;                     // 归集成交ID
+    std::string price;                      // 成交价格
+    std::string quantity;                   // 成交量
+    int64_t firstTradeId;                   // 被归集的首个成交ID
+    int64_t lastTradeId;                    // 被归集的末次成交ID
+    int64_t tradeTime;                      // 成交时间
+    bool isBuyerMaker;                      // 买方是否是做市方，是则主动方为卖方
+    
+    AggTrade() : eventTime(0), aggTradeId(0), firstTradeId(0), lastTradeId(0),
+                 tradeTime(0), isBuyerMaker(false) {}
+};
+
 /**
  * @brief 精简交易推送
  */
@@ -447,4 +504,38 @@ struct TradeLite {
                  stopPriceId(0), strategyId(0) {}
 };
 
+/**
+ * @brief 交易所延迟样本类型
+ */
+enum class LatencySampleKind : uint8_t {
+    REQUEST_RTT = 0,            // WS API请求往返时间
+    EXCHANGE_PROCESSING = 1,    // 用户数据流事件的E-T：撮合到推送
+    EVENT_DELIVERY = 2,         // 推送到本地收到，已扣除时钟偏移
+    CLOCK_OFFSET = 3            // 时钟偏移估计更新，值为交易所时间减本地时间，可为负
+};
+
+/**
+ * @brief 一个延迟样本，name在回调返回后失效
+ */
+struct LatencySample {
+    LatencySampleKind kind;
+    const char* name;           // REQUEST_RTT为请求方法，其余为事件类型
+    int64_t valueNs;
+};
+
+/**
+ * @brief 本地与交易所的时钟同步状态
+ */
+struct ClockSyncStatus {
+    bool synchronized;          // 至少有一个带服务器时间的应答
+    int64_t offsetNs;           // 交易所时间 - 本地CLOCK_REALTIME
+    int64_t uncertaintyNs;      // 所选样本往返时间的一半加服务器时间的毫秒截断
+    int64_t minRttNs;           // 滤波窗口内最小往返时间
+    uint64_t offsetSamples;
+    uint64_t rttSamples;
+    
+    ClockSyncStatus() : synchronized(false), offsetNs(0), uncertaintyNs(0), minRttNs(0),
+                        offsetSamples(0), rttSamples(0) {}
+};
+
 } // namespace trading
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "data_structures.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace trading {
+
+/**
+ * @brief 交易所往返时间与时钟偏移跟踪
+ *
+ * 发送WS API请求时按请求ID登记发送时刻，收到应答时得到往返时间；
+ * 应答带服务器时间(session.status、time等应答的serverTime)时按NTP方式估计偏移：
+ *   offset = 服务器时间 - (本地发送时刻 + 本地接收时刻) / 2
+ * 取最近FILTER_SIZE个样本中往返时间最小的一个作为当前偏移（往返越短，不对称误差越小）。
+ * 出站请求的timestamp用exchangeTimeMs()生成，避免本地时钟偏差引起recvWindow拒单。
+ * 登记和应答可以在不同线程，登记路径不加锁。
+ */
+class ExchangeClock {
+public:
+    static constexpr size_t PENDING_REQUESTS = 1024;    // 必须是2的幂，按请求ID取模
+    static constexpr size_t FILTER_SIZE = 8;
+    static constexpr size_t MAX_METHODS = 32;
+    static constexpr size_t MAX_METHOD_LENGTH = 48;
+    static constexpr int64_t MAX_OFFSET_RTT_NS = 2000000000LL;  // 往返超过2秒的样本不参与偏移估计
+
+    ExchangeClock();
+
+    void setSampleCallback(std::function<void(const LatencySample&)> callback);
+
+    void onRequestSent(int64_t requestId, const char* method);
+    // serverTimeMs为0表示应答不带服务器时间，只记往返时间
+    void onResponse(int64_t requestId, int64_t serverTimeMs, int64_t recvRealtimeNs, int64_t recvMonotonicNs);
+    // 用户数据流事件；transactionTimeMs为0时只记推送延迟
+    void onServerEvent(const char* eventType, int64_t eventTimeMs, int64_t transactionTimeMs, int64_t recvRealtimeNs);
+
+    // 校正到交易所时间的当前毫秒时间戳；尚未同步时等于本地时间
+    int64_t exchangeTimeMs() const;
+    int64_t offsetNs() const { return offsetNs_.load(std::memory_order_relaxed); }
+    ClockSyncStatus getStatus() const;
+
+    static int64_t realtimeNowNs();
+    static int64_t monotonicNowNs();
+
+private:
+    struct PendingRequest {
+        std::atomic<int64_t> requestId{0};   // 0表示空闲；先写其余字段再发布
+        std::atomic<int> methodIndex{-1};
+        std::atomic<int64_t> sendRealtimeNs{0};
+        std::atomic<int64_t> sendMonotonicNs{0};
+    };
+
+    struct OffsetSample {
+        int64_t offsetNs;
+        int64_t rttNs;
+    };
+
+    int methodIndex(const char* method);
+    void emit(LatencySampleKind kind, const char* name, int64_t valueNs) const;
+    void addOffsetSample(int64_t offsetNs, int64_t rttNs);
+
+    PendingRequest pending_[PENDING_REQUESTS];
+
+    // 方法名表：注册后不变，按下标引用
+    char methodNames_[MAX_METHODS][MAX_METHOD_LENGTH];
+    std::atomic<int> methodCount_;
+    std::mutex methodMutex_;
+
+    std::mutex filterMutex_;
+    OffsetSample filter_[FILTER_SIZE];
+    size_t filterCount_;
+    size_t filterNext_;
+
+    std::atomic<int64_t> offsetNs_;
+    std::atomic<int64_t> uncertaintyNs_;
+    std::atomic<int64_t> minRttNs_;
+    std::atomic<bool> synchronized_;
+    std::atomic<uint64_t> offsetSamples_;
+    std::atomic<uint64_t> rttSamples_;
+
+    std::function<void(const LatencySample&)> sampleCallback_;
+};
+
+} // namespace trading
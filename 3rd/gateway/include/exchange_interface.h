@@ -9,6 +9,9 @@
 
 namespace trading {
 
+class OrderUpdateView;
+class AccountInfoView;
+
 /**
  * @brief 交易所WebSocket连接状态
  */
@@ -54,6 +57,20 @@ public:
     virtual void setOrderResponseCallback(std::function<void(const OrderResponse&)> callback) = 0;
     virtual void setDepthUpdateCallback(std::function<void(const DepthUpdate&)> callback) = 0;
     virtual void setTradeLiteCallback(std::function<void(const TradeLite&)> callback) = 0;
+    virtual void setAggTradeCallback(std::function<void(const AggTrade&)> callback) = 0;
+
+    // 视图回调：直接访问解析后的JSON，只解码实际读取的字段，视图仅在回调内有效
+    virtual void setOrderUpdateViewCallback(std::function<void(const OrderUpdateView&)> callback) = 0;
+    virtual void setAccountInfoViewCallback(std::function<void(const AccountInfoView&)> callback) = 0;
+
+    // 下单链路打点：时间为CLOCK_MONOTONIC纳秒；只对带clientOrderId的订单回调，未设置时不产生开销
+    virtual void setOrderTraceCallback(
+        std::function<void(const char* clientOrderId, OrderTraceStage stage, int64_t monotonicNs)> callback) = 0;
+
+    // 往返时间/交易所处理延迟/时钟偏移样本，在网络线程上回调
+    virtual void setLatencySampleCallback(std::function<void(const LatencySample&)> callback) = 0;
+    // 出站请求的timestamp已按此偏移校正
+    virtual ClockSyncStatus getClockSyncStatus() const = 0;
 
     // 配置管理
     virtual void setApiCredentials(const std::string& apiKey, const std::string& apiSecret) = 0;
@@ -68,6 +85,16 @@ public:
     // 订单操作方法
     virtual void placeOrder(const OrderRequest& orderRequest, const std::string& requestId = "") = 0;
     virtual void cancelOrder(const CancelOrderRequest& cancelRequest, const std::string& requestId = "") = 0;
+
+    // 模板下单：注册后返回句柄(失败返回-1)，下单时只写入可变字段
+    virtual int registerOrderTemplate(const OrderTemplateSpec& spec) = 0;
+    virtual bool placeOrderFromTemplate(int templateHandle, bool isBuy, double quantity, double price,
+                                        const char* clientOrderId, OrderUrgency urgency = OrderUrgency::NORMAL,
+                                        int strategySlot = 0) = 0;
+
+    // 策略级下单限频：返回槽位，填入OrderRequest::strategySlot后生效（0为不限速的默认槽位）
+    virtual int registerStrategyRateLimit(const std::string& strategyId, uint32_t ordersPerSecond,
+                                          uint32_t ordersPerMinute) = 0;
     
     // 市场数据订阅方法
     virtual bool subscribeDepthUpdate(const std::string& symbol, int levels = 20, int updateSpeed = 100) = 0;
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "yyjson.h"
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+namespace trading {
+
+/**
+ * @brief 轻量级JSON视图基类
+ *
+ * 仅持有yyjson_val指针，字段在访问时才解码。视图只在回调执行期间有效，
+ * 回调返回后底层yyjson_doc即被释放，需要保留的数据必须自行拷贝。
+ */
+class JsonObjectView {
+public:
+    explicit JsonObjectView(yyjson_val* obj = nullptr) : obj_(obj) {}
+
+    bool valid() const { return obj_ && yyjson_is_obj(obj_); }
+    yyjson_val* raw() const { return obj_; }
+
+protected:
+    // 字符串字段，不存在或类型不符时返回空视图
+    std::string_view str(const char* key) const {
+        yyjson_val* val = obj_ ? yyjson_obj_get(obj_, key) : nullptr;
+        if (val && yyjson_is_str(val)) {
+            return std::string_view(yyjson_get_str(val), yyjson_get_len(val));
+        }
+        return std::string_view();
+    }
+
+    // 整数字段
+    int64_t i64(const char* key) const {
+        yyjson_val* val = obj_ ? yyjson_obj_get(obj_, key) : nullptr;
+        if (val && yyjson_is_int(val)) {
+            return yyjson_get_sint(val);
+        }
+        return 0;
+    }
+
+    // 布尔字段
+    bool boolean(const char* key) const {
+        yyjson_val* val = obj_ ? yyjson_obj_get(obj_, key) : nullptr;
+        return val && yyjson_is_bool(val) && yyjson_get_bool(val);
+    }
+
+    // 币安以字符串下发的数值字段，直接在原始缓冲上转换
+    double num(const char* key) const {
+        yyjson_val* val = obj_ ? yyjson_obj_get(obj_, key) : nullptr;
+        if (val && yyjson_is_str(val)) {
+            return std::strtod(yyjson_get_str(val), nullptr);
+        }
+        if (val && yyjson_is_num(val)) {
+            return yyjson_get_num(val);
+        }
+        return 0.0;
+    }
+
+    yyjson_val* obj_;
+};
+
+/**
+ * @brief ORDER_TRADE_UPDATE事件视图
+ */
+class OrderUpdateView : public JsonObjectView {
+public:
+    explicit OrderUpdateView(yyjson_val* root)
+        : JsonObjectView(root), order_(root ? yyjson_obj_get(root, "o") : nullptr) {}
+
+    bool valid() const { return JsonObjectView::valid() && order_.valid(); }
+
+    // 事件基本信息
+    int64_t eventTime() const { return i64("E"); }
+    int64_t transactionTime() const { return i64("T"); }
+
+    // 订单基本信息
+    std::string_view symbol() const { return order_.str("s"); }
+    std::string_view clientOrderId() const { return order_.str("c"); }
+    int64_t orderId() const { return order_.i64("i"); }
+    std::string_view side() const { return order_.str("S"); }
+    std::string_view orderType() const { return order_.str("o"); }
+    std::string_view timeInForce() const { return order_.str("f"); }
+    std::string_view positionSide() const { return order_.str("ps"); }
+
+    // 价格和数量
+    std::string_view originalQuantity() const { return order_.str("q"); }
+    std::string_view originalPrice() const { return order_.str("p"); }
+    std::string_view averagePrice() const { return order_.str("ap"); }
+    double originalQuantityValue() const { return order_.num("q"); }
+    double originalPriceValue() const { return order_.num("p"); }
+    double averagePriceValue() const { return order_.num("ap"); }
+
+    // 执行信息
+    std::string_view executionType() const { return order_.str("x"); }
+    std::string_view orderStatus() const { return order_.str("X"); }
+    std::string_view lastExecutedQuantity() const { return order_.str("l"); }
+    std::string_view cumulativeFilledQuantity() const { return order_.str("z"); }
+    std::string_view lastExecutedPrice() const { return order_.str("L"); }
+    double lastExecutedQuantityValue() const { return order_.num("l"); }
+    double cumulativeFilledQuantityValue() const { return order_.num("z"); }
+    double lastExecutedPriceValue() const { return order_.num("L"); }
+
+    // 手续费及其他
+    std::string_view commissionAsset() const { return order_.str("N"); }
+    double commissionAmountValue() const { return order_.num("n"); }
+    double realizedProfitValue() const { return order_.num("rp"); }
+    int64_t tradeTime() const { return order_.i64("T"); }
+    int64_t tradeId() const { return order_.i64("t"); }
+    bool isMakerSide() const { return order_.boolean("m"); }
+    bool isReduceOnly() const { return order_.boolean("R"); }
+
+private:
+    // 嵌套访问需要调用基类的受保护方法
+    struct OrderObject : JsonObjectView {
+        explicit OrderObject(yyjson_val* obj) : JsonObjectView(obj) {}
+        using JsonObjectView::str;
+        using JsonObjectView::i64;
+        using JsonObjectView::boolean;
+        using JsonObjectView::num;
+    };
+
+    OrderObject order_;
+};
+
+/**
+ * @brief 账户信息响应中的单个资产视图
+ */
+class AccountAssetView : public JsonObjectView {
+public:
+    explicit AccountAssetView(yyjson_val* obj) : JsonObjectView(obj) {}
+
+    std::string_view asset() const { return str("asset"); }
+    double walletBalance() const { return num("walletBalance"); }
+    double unrealizedProfit() const { return num("unrealizedProfit"); }
+    double marginBalance() const { return num("marginBalance"); }
+    double availableBalance() const { return num("availableBalance"); }
+    double maxWithdrawAmount() const { return num("maxWithdrawAmount"); }
+    int64_t updateTime() const { return i64("updateTime"); }
+};
+
+/**
+ * @brief 账户信息响应中的单个持仓视图
+ */
+class AccountPositionView : public JsonObjectView {
+public:
+    explicit AccountPositionView(yyjson_val* obj) : JsonObjectView(obj) {}
+
+    std::string_view symbol() const { return str("symbol"); }
+    std::string_view positionSide() const { return str("positionSide"); }
+    std::string_view positionAmt() const { return str("positionAmt"); }
+    double positionAmtValue() const { return num("positionAmt"); }
+    double entryPrice() const { return num("entryPrice"); }
+    double unrealizedProfit() const { return num("unrealizedProfit"); }
+    double notional() const { return num("notional"); }
+    double initialMargin() const { return num("initialMargin"); }
+    double maintMargin() const { return num("maintMargin"); }
+    int64_t updateTime() const { return i64("updateTime"); }
+};
+
+/**
+ * @brief 账户信息响应 (v2/account.status) 视图
+ *
+ * 资产和持仓通过forEach遍历，不会为未访问的条目分配任何内存。
+ */
+class AccountInfoView : public JsonObjectView {
+public:
+    explicit AccountInfoView(yyjson_val* root)
+        : JsonObjectView(root), result_(root ? yyjson_obj_get(root, "result") : nullptr) {}
+
+    std::string_view id() const { return str("id"); }
+    int status() const { return static_cast<int>(i64("status")); }
+
+    // 总计信息
+    double totalWalletBalance() const { return result_.num("totalWalletBalance"); }
+    double totalUnrealizedProfit() const { return result_.num("totalUnrealizedProfit"); }
+    double totalMarginBalance() const { return result_.num("totalMarginBalance"); }
+    double totalInitialMargin() const { return result_.num("totalInitialMargin"); }
+    double totalMaintMargin() const { return result_.num("totalMaintMargin"); }
+    double availableBalance() const { return result_.num("availableBalance"); }
+
+    size_t assetCount() const { return arraySize("assets"); }
+    size_t positionCount() const { return arraySize("positions"); }
+
+    template <typename Fn>
+    void forEachAsset(Fn&& fn) const {
+        forEach("assets", [&fn](yyjson_val* item) { fn(AccountAssetView(item)); });
+    }
+
+    template <typename Fn>
+    void forEachPosition(Fn&& fn) const {
+        forEach("positions", [&fn](yyjson_val* item) { fn(AccountPositionView(item)); });
+    }
+
+private:
+    struct ResultObject : JsonObjectView {
+        explicit ResultObject(yyjson_val* obj) : JsonObjectView(obj) {}
+        using JsonObjectView::num;
+    };
+
+    yyjson_val* array(const char* key) const {
+        yyjson_val* arr = result_.valid() ? yyjson_obj_get(result_.raw(), key) : nullptr;
+        return (arr && yyjson_is_arr(arr)) ? arr : nullptr;
+    }
+
+    size_t arraySize(const char* key) const {
+        yyjson_val* arr = array(key);
+        return arr ? yyjson_arr_size(arr) : 0;
+    }
+
+    template <typename Fn>
+    void forEach(const char* key, Fn&& fn) const {
+        yyjson_val* arr = array(key);
+        if (!arr) {
+            return;
+        }
+        size_t idx, max;
+        yyjson_val* item;
+        yyjson_arr_foreach(arr, idx, max, item) {
+            if (yyjson_is_obj(item)) {
+                fn(item);
+            }
+        }
+    }
+
+    ResultObject result_;
+};
+
+} // namespace trading
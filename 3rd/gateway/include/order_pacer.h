@@ -0,0 +1,236 @@
+#pragma once
+
+#include "data_structures.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace trading {
+
+/**
+ * @brief 无锁令牌桶（GCRA实现）
+ *
+ * 只维护一个原子的"理论到达时间"，取令牌为一次CAS，
+ * 多线程同时下单时无需加锁。rate为0表示不限速。
+ */
+class TokenBucket {
+public:
+    TokenBucket();
+
+    void configure(double ratePerSecond, uint32_t burst);
+    // 按"窗口内最多limit次"配置：1/4作突发，其余均匀补充，任意窗口内不超过limit
+    void configureWindow(uint32_t limit, double windowSeconds);
+    bool enabled() const { return intervalNs_.load(std::memory_order_relaxed) > 0; }
+
+    // 取到令牌返回0，否则返回需等待的纳秒数（不消耗令牌）
+    int64_t tryAcquire(int64_t nowNs, uint32_t tokens = 1);
+    // 归还已取得的令牌（组合限频中后续桶失败时回滚）
+    void release(uint32_t tokens = 1);
+
+private:
+    std::atomic<int64_t> tat_;          // 理论到达时间
+    std::atomic<int64_t> intervalNs_;   // 每个令牌的间隔
+    std::atomic<int64_t> burstNs_;      // 允许突发的时间容量
+};
+
+/**
+ * @brief 交易所限频计数
+ *
+ * 记录WS API响应中rateLimits回报的已用量/上限，
+ * 已用量接近上限时要求调度器等到当前窗口结束。
+ */
+class ExchangeRateLimitTracker {
+public:
+    static constexpr int MAX_LIMITS = 8;
+
+    enum class LimitType : uint8_t { REQUEST_WEIGHT = 0, ORDERS = 1 };
+
+    ExchangeRateLimitTracker();
+
+    void update(LimitType type, int64_t intervalMs, int64_t limit, int64_t count, int64_t nowMs);
+    // 本地发送后先行累加，避免在下一次回报前超发
+    void consume(LimitType type, int64_t amount, int64_t nowMs);
+    // 需要暂停时返回距窗口结束的毫秒数，否则返回0
+    int64_t holdTimeMs(LimitType type, int64_t nowMs, double headroom) const;
+    int64_t usagePermille(LimitType type) const;   // 各窗口中最高的使用率（千分比）
+
+private:
+    struct Slot {
+        std::atomic<int64_t> intervalMs;
+        std::atomic<int64_t> limit;
+        std::atomic<int64_t> count;
+        std::atomic<int64_t> windowEndMs;
+        std::atomic<uint8_t> type;
+    };
+
+    Slot slots_[MAX_LIMITS];
+    std::atomic<int> slotCount_;
+    std::mutex registerMutex_;    // 只在首次出现新的(类型,窗口)时使用
+};
+
+/**
+ * @brief 待发送订单
+ *
+ * 发送时才渲染请求并填入时间戳，排队再久也不会因recvWindow过期被拒。
+ * templateHandle>=0时为模板订单，否则params为不含timestamp的order.place参数。
+ */
+struct PacedOrder {
+    static constexpr size_t MAX_CLIENT_ORDER_ID = 40;
+
+    int64_t requestId;                      // 发送时分配的WS API请求ID
+    int templateHandle;
+    bool isBuy;
+    double quantity;
+    double price;
+    char clientOrderId[MAX_CLIENT_ORDER_ID];
+    std::string params;
+    OrderUrgency urgency;
+    int strategySlot;
+    int64_t enqueueNs;
+    uint32_t attempts;                      // 因限频被退回后的重发次数
+    uint32_t sendFailures;                  // 排队发送失败后重排的次数
+
+    PacedOrder() : requestId(0), templateHandle(-1), isBuy(true), quantity(0.0), price(0.0)
+                 , urgency(OrderUrgency::NORMAL), strategySlot(0), enqueueNs(0), attempts(0), sendFailures(0) {
+        clientOrderId[0] = '\0';
+    }
+};
+
+// 限频调度统计
+struct OrderPacerStatistics {
+    uint64_t sentImmediately;       // 预算充足、直接在调用线程发送
+    uint64_t sentFromQueue;         // 排队后由调度线程发送
+    uint64_t requeued;              // 因-1003/-1015被退回重排
+    uint64_t rejectedQueueFull;     // 队列已满被拒绝
+    uint64_t sendFailures;          // 发送回调失败（未发出，预算已归还）
+    uint64_t droppedAfterFailures;  // 排队订单多次发送失败后丢弃
+    uint64_t backoffCount;          // 进入退避的次数
+    size_t queued;                  // 当前排队数量
+    int64_t maxQueueDelayUs;        // 最长排队时间
+    int64_t weightUsagePermille;    // 交易所权重使用率
+    int64_t orderUsagePermille;     // 交易所下单数使用率
+};
+
+/**
+ * @brief 下单限频调度器
+ *
+ * 位于BinanceWebSocket下单接口之前：
+ * - 账户级令牌桶（10秒/1分钟下单数、1分钟权重）与策略级令牌桶（每秒/每分钟下单数）
+ * - 跟踪交易所回报的rateLimits计数，接近上限时暂停到窗口结束
+ * - 预算不足时按紧急程度排队，同一优先级内按策略轮转，保证公平
+ * - 收到-1003/-1015时指数退避，并将对应订单重新排到队首而不是丢弃
+ */
+class OrderPacer {
+public:
+    static constexpr int MAX_STRATEGIES = 64;
+    static constexpr int URGENCY_LEVELS = 3;
+    static constexpr size_t INFLIGHT_SLOTS = 4096;
+
+    struct Config {
+        uint32_t accountOrdersPer10s;       // 币安U本位合约：300/10s
+        uint32_t accountOrdersPerMinute;    // 1200/min
+        uint32_t accountWeightPerMinute;    // 2400/min
+        uint32_t orderWeight;               // 单次下单消耗的权重
+        double headroom;                    // 交易所计数达到上限的该比例即暂停
+        int64_t backoffInitialMs;
+        int64_t backoffMaxMs;
+        size_t maxQueued;
+
+        Config() : accountOrdersPer10s(300), accountOrdersPerMinute(1200), accountWeightPerMinute(2400)
+                 , orderWeight(1), headroom(0.9), backoffInitialMs(1000), backoffMaxMs(60000)
+                 , maxQueued(10000) {}
+    };
+
+    // 发送回调：渲染并发送，写入order.requestId，返回是否已发出
+    using Sender = std::function<bool(PacedOrder&)>;
+
+    OrderPacer();
+    ~OrderPacer();
+
+    OrderPacer(const OrderPacer&) = delete;
+    OrderPacer& operator=(const OrderPacer&) = delete;
+
+    void start(const Config& config, Sender sender);
+    void stop();
+
+    // 注册策略级限频，返回槽位（同名策略返回同一槽位，0为默认策略），失败返回0
+    int registerStrategy(const std::string& strategyId, uint32_t ordersPerSecond, uint32_t ordersPerMinute);
+
+    // 提交订单：预算充足且无排队时直接在调用线程发送，否则排队；队列已满或直接发送失败返回false
+    bool submit(PacedOrder& order);
+
+    // 响应处理（WS API线程调用）
+    void onRateLimit(ExchangeRateLimitTracker::LimitType type, int64_t intervalMs, int64_t limit, int64_t count);
+    // 返回true表示订单因限频已重新排队，调用方不应再按失败处理
+    bool onOrderResponse(int64_t requestId, int errorCode, const std::string& errorMessage);
+
+    OrderPacerStatistics getStatistics() const;
+
+private:
+    struct StrategyLimit {
+        TokenBucket perSecond;
+        TokenBucket perMinute;
+    };
+
+    static int64_t nowNs();
+
+    // 退避或交易所计数要求的全局暂停时间，无需暂停返回0
+    int64_t globalHoldNs(int64_t now) const;
+    // 尝试取得发送预算，成功返回0，否则返回需等待的纳秒数；accountLimited表示受账户级限制
+    int64_t acquireBudget(int strategySlot, int64_t now, bool& accountLimited);
+    // 归还acquireBudget取得的全部令牌（发送失败时）
+    void releaseBudget(int strategySlot);
+    bool sendNow(PacedOrder& order);
+    void recordInflight(const PacedOrder& order);
+    void enqueueLocked(PacedOrder&& order, bool front);
+    void dispatchLoop();
+
+    Config config_;
+    Sender sender_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> dispatchThread_;
+
+    // 限频状态
+    TokenBucket accountOrders10s_;
+    TokenBucket accountOrdersMinute_;
+    TokenBucket accountWeight_;
+    StrategyLimit strategyLimits_[MAX_STRATEGIES];
+    std::map<std::string, int> strategySlots_;
+    std::mutex strategyMutex_;           // 仅注册策略时使用
+    std::atomic<int> strategyCount_;
+    ExchangeRateLimitTracker exchangeLimits_;
+    std::atomic<int64_t> backoffUntilNs_;
+    std::atomic<uint32_t> consecutiveBackoffs_;
+
+    // 排队：每个优先级下每个策略一条FIFO，按策略轮转出队
+    std::mutex queueMutex_;
+    std::condition_variable queueCv_;
+    std::deque<PacedOrder> queues_[URGENCY_LEVELS][MAX_STRATEGIES];
+    int roundRobin_[URGENCY_LEVELS];
+    std::atomic<size_t> queued_;
+
+    // 已发送未回报的订单，按requestId取模定位，用于限频退回后重排
+    std::mutex inflightMutex_;
+    std::vector<PacedOrder> inflight_;
+
+    // 统计
+    std::atomic<uint64_t> sentImmediately_;
+    std::atomic<uint64_t> sentFromQueue_;
+    std::atomic<uint64_t> requeued_;
+    std::atomic<uint64_t> rejectedQueueFull_;
+    std::atomic<uint64_t> sendFailures_;
+    std::atomic<uint64_t> droppedAfterFailures_;
+    std::atomic<uint64_t> backoffCount_;
+    std::atomic<int64_t> maxQueueDelayNs_;
+};
+
+} // namespace trading
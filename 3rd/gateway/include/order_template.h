@@ -0,0 +1,66 @@
+#pragma once
+
+#include "data_structures.h"
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace trading {
+
+/**
+ * @brief 定点小数格式化器
+ *
+ * 构造时根据stepSize/tickSize确定小数位数和最小变动单位，
+ * 格式化时按整数单位取整后直接写入缓冲区，不经过printf/ostringstream。
+ */
+class DecimalFormat {
+public:
+    static constexpr int MAX_DECIMALS = 8;
+    static constexpr size_t MAX_LENGTH = 32;
+
+    // increment<=0 时按MAX_DECIMALS位输出并去掉末尾的0
+    explicit DecimalFormat(double increment = 0.0);
+
+    // 写入out（不含\0），返回长度；floorToStep为true时向下取整到步长，否则四舍五入
+    size_t format(double value, bool floorToStep, char* out) const;
+    std::string toString(double value, bool floorToStep = false) const;
+
+    int decimals() const { return decimals_; }
+
+private:
+    int decimals_;
+    int64_t stepUnits_;     // 以10^-decimals_为单位的步长
+    double scale_;          // 10^decimals_
+    bool trimZeros_;
+};
+
+/**
+ * @brief 下单请求模板
+ *
+ * 对固定的symbol/type/positionSide等部分预先渲染order.place请求，
+ * 下单时只在预分配缓冲区中原位写入方向、数量、价格、客户端订单号、时间戳和请求ID。
+ * 客户端订单号不做JSON转义，调用方需保证只含字母、数字、'_'或'-'。
+ */
+class OrderTemplate {
+public:
+    static constexpr size_t MAX_REQUEST_SIZE = 1024;
+
+    explicit OrderTemplate(const OrderTemplateSpec& spec);
+
+    // 渲染完整请求，返回长度，缓冲区不足返回0
+    size_t render(char* buf, size_t cap, int64_t requestId, bool isBuy,
+                  double quantity, double price, const char* clientOrderId,
+                  int64_t timestamp) const;
+
+    const OrderTemplateSpec& spec() const { return spec_; }
+    bool hasPrice() const { return hasPrice_; }
+
+private:
+    OrderTemplateSpec spec_;
+    std::string prefix_;        // {"method":"order.place","params":{...常量字段...,"side":"
+    DecimalFormat quantityFormat_;
+    DecimalFormat priceFormat_;
+    bool hasPrice_;
+};
+
+} // namespace trading
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <cstddef>
+
+// OpenSSL前向声明，避免头文件依赖
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+typedef struct evp_pkey_st EVP_PKEY;
+
+namespace trading {
+
+/**
+ * @brief 请求签名器
+ *
+ * 启动时一次性加载密钥并预计算签名状态：
+ * - HMAC-SHA256: 预先吸收ipad/opad，每次签名只需复制两个摘要上下文
+ * - Ed25519: PEM私钥只解析一次，签名上下文复用
+ * 签名直接写入调用方提供的缓冲区，热路径不做堆分配。
+ */
+class RequestSigner {
+public:
+    // base64(64字节Ed25519签名)=88字符，hex(32字节HMAC)=64字符，外加结尾\0
+    static constexpr size_t MAX_SIGNATURE_LENGTH = 96;
+
+    RequestSigner();
+    ~RequestSigner();
+
+    RequestSigner(const RequestSigner&) = delete;
+    RequestSigner& operator=(const RequestSigner&) = delete;
+
+    // 密钥加载
+    bool initHmac(const std::string& secret);
+    bool initEd25519FromFile(const std::string& keyPath);
+
+    bool isHmacReady() const { return hmacReady_; }
+    bool isEd25519Ready() const { return ed25519Ready_; }
+
+    // 签名写入out（以\0结尾），返回签名长度，失败返回0
+    size_t signHmacSha256(const char* data, size_t len, char* out, size_t outSize);
+    size_t signEd25519(const char* data, size_t len, char* out, size_t outSize);
+
+    // 便捷接口，失败返回空字符串
+    std::string signHmacSha256(const std::string& data);
+    std::string signEd25519(const std::string& data);
+
+private:
+    void releaseHmac();
+    void releaseEd25519();
+
+    // HMAC预计算状态
+    EVP_MD_CTX* hmacInner_;      // 已吸收 key^ipad
+    EVP_MD_CTX* hmacOuter_;      // 已吸收 key^opad
+    EVP_MD_CTX* hmacWork_;       // 每次签名的工作上下文
+    std::atomic<bool> hmacReady_;
+    std::mutex hmacMutex_;
+
+    // Ed25519状态
+    EVP_PKEY* ed25519Pkey_;
+    EVP_MD_CTX* ed25519Ctx_;
+    std::atomic<bool> ed25519Ready_;
+    std::mutex ed25519Mutex_;
+};
+
+} // namespace trading
@@ -3,6 +3,9 @@
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <pthread.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
 #include <openssl/evp.h>
@@ -12,10 +15,32 @@
 
 namespace trading {
 
+namespace {
+
+// 与上层(CLOCK_MONOTONIC)打点使用同一时钟
+int64_t monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 给回调线程命名，便于在/proc/self/task中按线程统计CPU和调度延迟；每个线程只设置一次
+void nameCallbackThread(const char* name) {
+    thread_local bool named = false;
+    if (!named) {
+        pthread_setname_np(pthread_self(), name);
+        named = true;
+    }
+}
+
+} // namespace
+
 BinanceWebSocket::BinanceWebSocket(const ExchangeConfig& config)
     : config_(config)
     , apiKey_(config.getCurrentApiKey())
     , apiSecret_(config.getCurrentApiSecret())
+    , signer_(std::make_unique<RequestSigner>())
+    , ed25519RetryAtNs_(0)
+    , ed25519RetryBackoffNs_(ED25519_RETRY_INITIAL_NS)
     , timeoutMs_(config.timeoutMs)
     , reconnectIntervalMs_(5000)
     , status_(ConnectionStatus::DISCONNECTED)
@@ -26,6 +51,7 @@ BinanceWebSocket::BinanceWebSocket(const ExchangeConfig& config)
     , subscriptionId_(-1)
     , requestId_(1)
     , httpClient_(std::make_unique<ix::HttpClient>())
+    , orderTemplateCount_(0)
 {
     // 配置HTTP客户端的TLS选项
     ix::SocketTLSOptions tlsOptions;
@@ -49,17 +75,26 @@ BinanceWebSocket::BinanceWebSocket(const ExchangeConfig& config)
     
     webSocket_ = std::make_unique<ix::WebSocket>();
     webSocket_->setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
+        nameCallbackThread("gw-ws-stream");
         onWebSocketMessage(msg);
     });
     
     // 初始化WebSocket API连接
     wsApiSocket_ = std::make_unique<ix::WebSocket>();
     wsApiSocket_->setOnMessageCallback([this](const ix::WebSocketMessagePtr& msg) {
+        nameCallbackThread("gw-ws-api");
         onWebSocketApiMessage(msg);
     });
+    
+    initRequestSigner();
+    
+    orderPacer_.start(OrderPacer::Config(), [this](PacedOrder& order) {
+        return sendPacedOrder(order);
+    });
 }
 
 BinanceWebSocket::~BinanceWebSocket() {
+    orderPacer_.stop();
     disconnect();
 }
 
@@ -217,13 +252,51 @@ void BinanceWebSocket::setDepthUpdateCallback(std::function<void(const DepthUpda
     depthUpdateCallback_ = callback;
 }
 
+void BinanceWebSocket::setOrderUpdateViewCallback(std::function<void(const OrderUpdateView&)> callback) {
+    orderUpdateViewCallback_ = callback;
+}
+
+void BinanceWebSocket::setAccountInfoViewCallback(std::function<void(const AccountInfoView&)> callback) {
+    accountInfoViewCallback_ = callback;
+}
+
+void BinanceWebSocket::setOrderTraceCallback(
+    std::function<void(const char* clientOrderId, OrderTraceStage stage, int64_t monotonicNs)> callback) {
+    std::lock_guard<std::mutex> lock(orderTraceMutex_);
+    orderTraceCallback_ = callback;
+    orderTraceEnabled_.store(static_cast<bool>(orderTraceCallback_), std::memory_order_release);
+}
+
+void BinanceWebSocket::traceOrder(const char* clientOrderId, OrderTraceStage stage) {
+    if (!orderTraceEnabled_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(orderTraceMutex_);
+    if (orderTraceCallback_) {
+        orderTraceCallback_(clientOrderId, stage, monotonicNowNs());
+    }
+}
+
+void BinanceWebSocket::setLatencySampleCallback(std::function<void(const LatencySample&)> callback) {
+    exchangeClock_.setSampleCallback(callback);
+}
+
+ClockSyncStatus BinanceWebSocket::getClockSyncStatus() const {
+    return exchangeClock_.getStatus();
+}
+
 void BinanceWebSocket::setTradeLiteCallback(std::function<void(const TradeLite&)> callback) {
     tradeLiteCallback_ = callback;
 }
 
+void BinanceWebSocket::setAggTradeCallback(std::function<void(const AggTrade&)> callback) {
+    aggTradeCallback_ = callback;
+}
+
 void BinanceWebSocket::setApiCredentials(const std::string& apiKey, const std::string& apiSecret) {
     apiKey_ = apiKey;
     apiSecret_ = apiSecret;
+    signer_->initHmac(apiSecret_);
 }
 
 void BinanceWebSocket::setTimeout(int timeoutMs) {
@@ -243,8 +316,7 @@ void BinanceWebSocket::requestAccountBalance(const std::string& requestId) {
     // 检查是否使用会话认证
     if (config_.signatureType == "ed25519" && sessionAuthenticated_) {
         // 会话认证模式下，也需要timestamp参数
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         std::ostringstream params;
         params << "\"recvWindow\":5000,\"timestamp\":" << timestamp;
@@ -254,8 +326,7 @@ void BinanceWebSocket::requestAccountBalance(const std::string& requestId) {
     } else {
         // 传统模式，需要API密钥和签名
         // 生成时间戳
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         // 构建查询字符串用于签名 - 按字母顺序排序参数
         std::string queryString = "apiKey=" + apiKey_ + "&timestamp=" + std::to_string(timestamp);
@@ -281,8 +352,7 @@ void BinanceWebSocket::requestAccountInfo(const std::string& requestId) {
     // 检查是否使用会话认证
     if (config_.signatureType == "ed25519" && sessionAuthenticated_) {
         // 会话认证模式下，也需要timestamp参数
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         std::ostringstream params;
         params << "\"recvWindow\":5000,\"timestamp\":" << timestamp;
@@ -292,8 +362,7 @@ void BinanceWebSocket::requestAccountInfo(const std::string& requestId) {
     } else {
         // 传统模式，需要API密钥和签名
         // 生成时间戳
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         // 构建查询字符串用于签名 - 按字母顺序排序参数
         std::string queryString = "apiKey=" + apiKey_ + "&timestamp=" + std::to_string(timestamp);
@@ -319,8 +388,7 @@ void BinanceWebSocket::requestPositionInfo(const std::string& requestId) {
     // 检查是否使用会话认证
     if (config_.signatureType == "ed25519" && sessionAuthenticated_) {
         // 会话认证模式下，仍需要timestamp参数
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         std::ostringstream params;
         params << "\"timestamp\":" << timestamp << ","
@@ -331,8 +399,7 @@ void BinanceWebSocket::requestPositionInfo(const std::string& requestId) {
     } else {
         // 传统模式，需要API密钥和签名
         // 生成时间戳
-        auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto timestamp = exchangeClock_.exchangeTimeMs();
         
         // 构建查询字符串用于签名 - 按字母顺序排序参数
         std::string queryString = "apiKey=" + apiKey_ + "&timestamp=" + std::to_string(timestamp);
@@ -393,6 +460,7 @@ void BinanceWebSocket::onWebSocketError(const std::string& error) {
 }
 
 void BinanceWebSocket::parseMessage(const std::string& message) {
+    int64_t recvRealtimeNs = ExchangeClock::realtimeNowNs();
     // 添加调试信息
     std::cout << "[DEBUG] Received WebSocket message: " << message << std::endl;
     
@@ -415,15 +483,36 @@ void BinanceWebSocket::parseMessage(const std::string& message) {
     if (e_val) {
         std::string eventType = yyjson_get_str(e_val);
         
+        // 用户数据流事件带E(推送时间)和T(撮合时间)，用于交易所处理与推送延迟
+        if (eventType != "depthUpdate" && eventType != "aggTrade") {
+            yyjson_val* eventTimeVal = yyjson_obj_get(root, "E");
+            yyjson_val* transactionTimeVal = yyjson_obj_get(root, "T");
+            exchangeClock_.onServerEvent(eventType.c_str(),
+                                         eventTimeVal && yyjson_is_int(eventTimeVal) ? yyjson_get_sint(eventTimeVal) : 0,
+                                         transactionTimeVal && yyjson_is_int(transactionTimeVal) ? yyjson_get_sint(transactionTimeVal) : 0,
+                                         recvRealtimeNs);
+        }
+        
         if (eventType == "ACCOUNT_UPDATE") {
             parseAccountUpdate(root);
         } else if (eventType == "ORDER_TRADE_UPDATE") {
-            parseOrderUpdate(root);
-        } else if (eventType == "ORDER_TRADE_LITE") {
+            // 视图模式下不构造OrderUpdate，仅在注册了结构体回调时才完整解析
+            if (orderUpdateViewCallback_) {
+                OrderUpdateView view(root);
+                if (view.valid()) {
+                    orderUpdateViewCallback_(view);
+                }
+            }
+            if (orderUpdateCallback_) {
+                parseOrderUpdate(root);
+            }
+        } else if (eventType == "TRADE_LITE" || eventType == "ORDER_TRADE_LITE") {
             parseTradeLite(root);
         } else if (eventType == "depthUpdate") {
             // 处理深度更新事件
             parseDepthUpdate(root);
+        } else if (eventType == "aggTrade") {
+            parseAggTrade(root);
         }
     } else {
         // 检查是否是深度更新消息（通过stream字段识别）
@@ -436,6 +525,11 @@ void BinanceWebSocket::parseMessage(const std::string& message) {
                 if (data_val) {
                     parseDepthUpdate(data_val);
                 }
+            } else if (streamName.find("@aggTrade") != std::string::npos) {
+                yyjson_val* data_val = yyjson_obj_get(root, "data");
+                if (data_val) {
+                    parseAggTrade(data_val);
+                }
             }
         } else {
             // 直接检查是否包含深度更新字段
@@ -902,114 +996,56 @@ std::string BinanceWebSocket::generateSignature(const std::string& queryString)
     }
 }
 
-std::string BinanceWebSocket::generateHmacSha256Signature(const std::string& queryString) const {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    unsigned int hashLen;
-    
-    HMAC(EVP_sha256(), apiSecret_.c_str(), apiSecret_.length(),
-         reinterpret_cast<const unsigned char*>(queryString.c_str()), queryString.length(),
-         hash, &hashLen);
-    
-    std::stringstream ss;
-    for (unsigned int i = 0; i < hashLen; ++i) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
+void BinanceWebSocket::initRequestSigner() {
+    // HMAC状态总是预计算，Ed25519私钥仅在启用时加载（密钥内容为私钥文件路径）
+    signer_->initHmac(apiSecret_);
+    if (config_.signatureType == "ed25519") {
+        if (!signer_->initEd25519FromFile(config_.getCurrentApiSecret())) {
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            ed25519RetryAtNs_.store(now + ED25519_RETRY_INITIAL_NS, std::memory_order_release);
+            ed25519RetryBackoffNs_.store(ED25519_RETRY_INITIAL_NS * 2, std::memory_order_relaxed);
+            std::cerr << "[ERROR] Ed25519 signer initialization failed, will retry in "
+                      << ED25519_RETRY_INITIAL_NS / 1000000 << "ms" << std::endl;
+        }
     }
-    
-    return ss.str();
+}
+
+std::string BinanceWebSocket::generateHmacSha256Signature(const std::string& queryString) const {
+    return signer_->signHmacSha256(queryString);
 }
 
 std::string BinanceWebSocket::generateEd25519Signature(const std::string& queryString) const {
-    // 获取Ed25519私钥文件路径（解密后的内容是文件路径）
-    std::string keyPath = config_.getCurrentApiSecret();
-    
-    // 从文件路径读取Ed25519私钥内容
-    std::ifstream keyFile(keyPath);
-    if (!keyFile.is_open()) {
-        std::cerr << "Failed to open Ed25519 private key file: " << keyPath << std::endl;
-        return "";
-    }
-    
-    std::string keyContent((std::istreambuf_iterator<char>(keyFile)),
-                           std::istreambuf_iterator<char>());
-    keyFile.close();
-    
-    // 创建BIO对象
-    BIO* bio = BIO_new_mem_buf(keyContent.c_str(), -1);
-    if (!bio) {
-        std::cerr << "Failed to create BIO for Ed25519 key" << std::endl;
-        return "";
-    }
-    
-    // 读取PEM格式的私钥
-    EVP_PKEY* pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-    
-    if (!pkey) {
-        std::cerr << "Failed to load Ed25519 private key from PEM format" << std::endl;
-        return "";
-    }
-    
-    // 创建签名上下文
-    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
-    if (!mdctx) {
-        EVP_PKEY_free(pkey);
-        std::cerr << "Failed to create MD context" << std::endl;
+    // 启动时加载失败（如密钥文件尚未就绪）时按退避间隔重试，退避期内直接失败，不再每次读文件
+    if (!signer_->isEd25519Ready() && !retryEd25519KeyLoad()) {
         return "";
     }
-    
-    // 初始化签名
-    if (EVP_DigestSignInit(mdctx, nullptr, nullptr, nullptr, pkey) <= 0) {
-        EVP_MD_CTX_free(mdctx);
-        EVP_PKEY_free(pkey);
-        std::cerr << "Failed to initialize Ed25519 signing" << std::endl;
-        return "";
+    return signer_->signEd25519(queryString);
+}
+
+bool BinanceWebSocket::retryEd25519KeyLoad() const {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t retryAt = ed25519RetryAtNs_.load(std::memory_order_acquire);
+    if (now < retryAt) {
+        return false;
     }
-    
-    // 计算签名长度
-    size_t siglen;
-    if (EVP_DigestSign(mdctx, nullptr, &siglen, 
-                       reinterpret_cast<const unsigned char*>(queryString.c_str()), 
-                       queryString.length()) <= 0) {
-        EVP_MD_CTX_free(mdctx);
-        EVP_PKEY_free(pkey);
-        std::cerr << "Failed to get Ed25519 signature length" << std::endl;
-        return "";
+
+    // 并发签名的线程中只有推进了重试时间的那个去读文件，其余按本轮失败处理
+    int64_t backoff = ed25519RetryBackoffNs_.load(std::memory_order_relaxed);
+    if (!ed25519RetryAtNs_.compare_exchange_strong(retryAt, now + backoff, std::memory_order_acq_rel)) {
+        return signer_->isEd25519Ready();
     }
-    
-    // 生成签名
-    std::vector<unsigned char> signature(siglen);
-    if (EVP_DigestSign(mdctx, signature.data(), &siglen,
-                       reinterpret_cast<const unsigned char*>(queryString.c_str()),
-                       queryString.length()) <= 0) {
-        EVP_MD_CTX_free(mdctx);
-        EVP_PKEY_free(pkey);
-        std::cerr << "Failed to generate Ed25519 signature" << std::endl;
-        return "";
+
+    if (signer_->initEd25519FromFile(config_.getCurrentApiSecret())) {
+        ed25519RetryBackoffNs_.store(ED25519_RETRY_INITIAL_NS, std::memory_order_relaxed);
+        std::cout << "[INFO] Ed25519 private key loaded after retry" << std::endl;
+        return true;
     }
-    
-    // 清理资源
-    EVP_MD_CTX_free(mdctx);
-    EVP_PKEY_free(pkey);
-    
-    // 转换为base64字符串
-    std::string base64_signature;
-    
-    // 使用OpenSSL的base64编码
-    BIO* b64_bio = BIO_new(BIO_s_mem());
-    BIO* b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);  // 不添加换行符
-    b64_bio = BIO_push(b64, b64_bio);
-    
-    BIO_write(b64_bio, signature.data(), siglen);
-    BIO_flush(b64_bio);
-    
-    BUF_MEM* bufferPtr;
-    BIO_get_mem_ptr(b64_bio, &bufferPtr);
-    base64_signature = std::string(bufferPtr->data, bufferPtr->length);
-    
-    BIO_free_all(b64_bio);
-    
-    return base64_signature;
+
+    ed25519RetryBackoffNs_.store(std::min(backoff * 2, ED25519_RETRY_MAX_NS), std::memory_order_relaxed);
+    std::cerr << "[ERROR] Ed25519 private key reload failed, next retry in " << backoff / 1000000 << "ms" << std::endl;
+    return false;
 }
 
 void BinanceWebSocket::startHeartbeat() {
@@ -1023,11 +1059,18 @@ void BinanceWebSocket::stopHeartbeat() {
 }
 
 void BinanceWebSocket::heartbeatLoop() {
+    pthread_setname_np(pthread_self(), "gw-heartbeat");
+    
     while (running_) {
         std::this_thread::sleep_for(std::chrono::milliseconds(HEARTBEAT_INTERVAL_MS));
         
         if (!running_) break;
         
+        // 空闲时也定期取一次服务器时间，保持时钟偏移估计新鲜
+        if (wsApiConnected_ && sessionAuthenticated_) {
+            sessionStatus();
+        }
+        
         auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastHeartbeat_).count();
         
@@ -1079,6 +1122,9 @@ void BinanceWebSocket::onWebSocketApiMessage(const ix::WebSocketMessagePtr& msg)
 }
 
 void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
+    // 接收时刻在日志和解析之前取，往返时间不含本地处理
+    int64_t recvRealtimeNs = ExchangeClock::realtimeNowNs();
+    int64_t recvMonotonicNs = ExchangeClock::monotonicNowNs();
     std::cout << "[DEBUG] Response: " << message << std::endl;
     
     yyjson_doc* doc = yyjson_read(message.c_str(), message.length(), 0);
@@ -1096,9 +1142,24 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
     // 获取请求ID
     yyjson_val* idVal = yyjson_obj_get(root, "id");
     std::string requestId = idVal && yyjson_is_str(idVal) ? yyjson_get_str(idVal) : "";
+    int64_t numericRequestId = requestId.empty() ? 0 : std::strtoll(requestId.c_str(), nullptr, 10);
+
+    // 每个响应都带有当前限频计数，交给下单调度器
+    parseRateLimits(root);
 
     // 首先检查是否是session.logon响应（通过检查result中的apiKey字段）
     yyjson_val* result = yyjson_obj_get(root, "result");
+
+    // 往返时间与时钟偏移：只用session.*/time应答的serverTime估计偏移；
+    // 订单应答的updateTime是撮合引擎处理订单的时刻，含排队和撮合耗时，不能当作服务器当前时间
+    int64_t serverTimeMs = 0;
+    if (result && yyjson_is_obj(result)) {
+        yyjson_val* serverTimeVal = yyjson_obj_get(result, "serverTime");
+        if (serverTimeVal && yyjson_is_int(serverTimeVal)) {
+            serverTimeMs = yyjson_get_sint(serverTimeVal);
+        }
+    }
+    exchangeClock_.onResponse(numericRequestId, serverTimeMs, recvRealtimeNs, recvMonotonicNs);
     if (result) {
         yyjson_val* apiKeyVal = yyjson_obj_get(result, "apiKey");
         if (apiKeyVal) {
@@ -1129,7 +1190,7 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
         yyjson_val* positions = yyjson_obj_get(result, "positions");
         if (assets && positions && yyjson_is_arr(assets) && yyjson_is_arr(positions)) {
             std::cout << "[DEBUG] Detected account info response based on structure" << std::endl;
-            parseAccountInfoResponse(root);
+            dispatchAccountInfoResponse(root);
             yyjson_doc_free(doc);
             return;
         }
@@ -1157,6 +1218,13 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
         yyjson_val* symbolVal = yyjson_obj_get(result, "symbol");
         if (orderIdVal && symbolVal) {
             // 这是订单响应
+            if (orderTraceEnabled_.load(std::memory_order_acquire)) {
+                yyjson_val* clientOrderIdVal = yyjson_obj_get(result, "clientOrderId");
+                if (clientOrderIdVal && yyjson_is_str(clientOrderIdVal)) {
+                    traceOrder(yyjson_get_str(clientOrderIdVal), OrderTraceStage::ACKNOWLEDGED);
+                }
+            }
+            orderPacer_.onOrderResponse(numericRequestId, 0, "");
             parseOrderResponse(root);
             yyjson_doc_free(doc);
             return;
@@ -1204,7 +1272,7 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
 
     // ID "3" 是账户信息请求
     if (requestId == "3") {
-        parseAccountInfoResponse(root);
+        dispatchAccountInfoResponse(root);
         yyjson_doc_free(doc);
         return;
     }
@@ -1220,15 +1288,23 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
     if (error) {
         yyjson_val* code = yyjson_obj_get(error, "code");
         yyjson_val* msg = yyjson_obj_get(error, "msg");
-        std::cout << "[ERROR] WebSocket API error - Code: " << (code ? yyjson_get_int(code) : 0) 
-                  << ", Message: " << (msg ? yyjson_get_str(msg) : "Unknown") << std::endl;
+        int errorCode = code ? yyjson_get_int(code) : 0;
+        std::string errorMessage = msg ? yyjson_get_str(msg) : "Unknown error";
+        std::cout << "[ERROR] WebSocket API error - Code: " << errorCode 
+                  << ", Message: " << errorMessage << std::endl;
+        
+        // 因限频被拒的订单已由调度器重新排队，不按失败上报
+        if (orderPacer_.onOrderResponse(numericRequestId, errorCode, errorMessage)) {
+            yyjson_doc_free(doc);
+            return;
+        }
         
         // 如果是订单相关错误，也通过订单回调返回
         if (orderResponseCallback_) {
             OrderResponse orderResp;
             orderResp.success = false;
-            orderResp.errorCode = code ? yyjson_get_int(code) : 0;
-            orderResp.errorMessage = msg ? yyjson_get_str(msg) : "Unknown error";
+            orderResp.errorCode = errorCode;
+            orderResp.errorMessage = errorMessage;
             orderResponseCallback_(orderResp);
         }
     }
@@ -1236,6 +1312,50 @@ void BinanceWebSocket::parseWebSocketApiMessage(const std::string& message) {
     yyjson_doc_free(doc);
 }
 
+void BinanceWebSocket::parseRateLimits(yyjson_val* root) {
+    yyjson_val* rateLimits = yyjson_obj_get(root, "rateLimits");
+    if (!rateLimits || !yyjson_is_arr(rateLimits)) {
+        return;
+    }
+    
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_arr_foreach(rateLimits, idx, max, item) {
+        const char* type = yyjson_get_str(yyjson_obj_get(item, "rateLimitType"));
+        const char* interval = yyjson_get_str(yyjson_obj_get(item, "interval"));
+        if (!type || !interval) {
+            continue;
+        }
+        
+        ExchangeRateLimitTracker::LimitType limitType;
+        if (std::strcmp(type, "REQUEST_WEIGHT") == 0) {
+            limitType = ExchangeRateLimitTracker::LimitType::REQUEST_WEIGHT;
+        } else if (std::strcmp(type, "ORDERS") == 0) {
+            limitType = ExchangeRateLimitTracker::LimitType::ORDERS;
+        } else {
+            continue;
+        }
+        
+        int64_t unitMs;
+        if (std::strcmp(interval, "SECOND") == 0) {
+            unitMs = 1000;
+        } else if (std::strcmp(interval, "MINUTE") == 0) {
+            unitMs = 60000;
+        } else if (std::strcmp(interval, "HOUR") == 0) {
+            unitMs = 3600000;
+        } else if (std::strcmp(interval, "DAY") == 0) {
+            unitMs = 86400000;
+        } else {
+            continue;
+        }
+        
+        int64_t intervalNum = yyjson_get_int(yyjson_obj_get(item, "intervalNum"));
+        int64_t limit = yyjson_get_int(yyjson_obj_get(item, "limit"));
+        int64_t count = yyjson_get_int(yyjson_obj_get(item, "count"));
+        orderPacer_.onRateLimit(limitType, unitMs * std::max<int64_t>(1, intervalNum), limit, count);
+    }
+}
+
 bool BinanceWebSocket::createListenKeyViaWebSocket() {
     if (!wsApiConnected_) {
         // 首先连接到WebSocket API
@@ -1277,6 +1397,7 @@ bool BinanceWebSocket::createListenKeyViaWebSocket() {
     std::cout << "[DEBUG] Sending WebSocket API request: " << request << std::endl;
     
     // 发送请求
+    exchangeClock_.onRequestSent(std::strtoll(requestId.c_str(), nullptr, 10), "userDataStream.start");
     wsApiSocket_->send(request);
     
     // 等待响应 (listenKey会在onWebSocketApiMessage中处理)
@@ -1313,6 +1434,7 @@ bool BinanceWebSocket::keepaliveListenKeyViaWebSocket() {
     })";
 
     std::cout << "[DEBUG] Sending keepalive request: " << request << std::endl;
+    exchangeClock_.onRequestSent(std::strtoll(requestId.c_str(), nullptr, 10), "userDataStream.ping");
     wsApiSocket_->send(request);
     
     return true;
@@ -1336,6 +1458,7 @@ bool BinanceWebSocket::closeListenKeyViaWebSocket() {
     })";
 
     std::cout << "[DEBUG] Sending close listenKey request: " << request << std::endl;
+    exchangeClock_.onRequestSent(std::strtoll(requestId.c_str(), nullptr, 10), "userDataStream.stop");
     wsApiSocket_->send(request);
     
     listenKey_.clear();
@@ -1392,7 +1515,7 @@ bool BinanceWebSocket::sessionLogon() {
             std::string streams = buildMarketDataStreams();
             if (streams.empty()) {
                 // 如果读取失败，使用默认值
-                streams = "btcusdt@depth5";
+                streams = "btcusdt@depth5/btcusdt@aggTrade";
                 std::cout << "[WARNING] Failed to read symbols from pos_update.json, using default streams" << std::endl;
             }
             
@@ -1429,8 +1552,7 @@ bool BinanceWebSocket::sessionLogon() {
 
 bool BinanceWebSocket::performSessionLogon() {
     // 生成时间戳
-    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto now = exchangeClock_.exchangeTimeMs();
     
     // 构建请求参数
     std::ostringstream paramsStream;
@@ -1450,9 +1572,10 @@ bool BinanceWebSocket::performSessionLogon() {
     fullParamsStream << params << "&signature=" << signature;
     
     // 构建session.logon请求
+    int requestId = requestId_++;
     std::ostringstream requestStream;
     requestStream << "{"
-                  << "\"id\":\"" << requestId_++ << "\","
+                  << "\"id\":\"" << requestId << "\","
                   << "\"method\":\"session.logon\","
                   << "\"params\":{"
                   << "\"apiKey\":\"" << apiKey_ << "\","
@@ -1466,6 +1589,7 @@ bool BinanceWebSocket::performSessionLogon() {
     std::cout << "[DEBUG] Request: " << request << std::endl;
     
     // 发送请求
+    exchangeClock_.onRequestSent(requestId, "session.logon");
     wsApiSocket_->send(request);
     
     // 等待响应
@@ -1486,7 +1610,8 @@ bool BinanceWebSocket::sessionLogout() {
     yyjson_mut_doc_set_root(doc, root);
     
     // 添加基本字段
-    yyjson_mut_obj_add_str(doc, root, "id", std::to_string(++requestId_).c_str());
+    int requestId = ++requestId_;
+    yyjson_mut_obj_add_str(doc, root, "id", std::to_string(requestId).c_str());
     yyjson_mut_obj_add_str(doc, root, "method", "session.logout");
     
     // 添加参数对象
@@ -1497,8 +1622,7 @@ bool BinanceWebSocket::sessionLogout() {
     yyjson_mut_obj_add_str(doc, params, "apiKey", config_.apiKey.c_str());
     
     // 添加时间戳
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto timestamp = exchangeClock_.exchangeTimeMs();
     yyjson_mut_obj_add_str(doc, params, "timestamp", std::to_string(timestamp).c_str());
     
     // 生成签名
@@ -1515,6 +1639,7 @@ bool BinanceWebSocket::sessionLogout() {
     std::cout << "Sending session.logout request: " << message << std::endl;
     
     // 发送请求
+    exchangeClock_.onRequestSent(requestId, "session.logout");
     wsApiSocket_->send(message);
     
     // 重置认证状态
@@ -1536,7 +1661,8 @@ bool BinanceWebSocket::sessionStatus() {
     yyjson_mut_doc_set_root(doc, root);
     
     // 添加基本字段
-    yyjson_mut_obj_add_str(doc, root, "id", std::to_string(++requestId_).c_str());
+    int requestId = ++requestId_;
+    yyjson_mut_obj_add_str(doc, root, "id", std::to_string(requestId).c_str());
     yyjson_mut_obj_add_str(doc, root, "method", "session.status");
     
     // 添加参数对象
@@ -1547,8 +1673,7 @@ bool BinanceWebSocket::sessionStatus() {
     yyjson_mut_obj_add_str(doc, params, "apiKey", config_.apiKey.c_str());
     
     // 添加时间戳
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto timestamp = exchangeClock_.exchangeTimeMs();
     yyjson_mut_obj_add_str(doc, params, "timestamp", std::to_string(timestamp).c_str());
     
     // 生成签名
@@ -1565,6 +1690,7 @@ bool BinanceWebSocket::sessionStatus() {
     std::cout << "Sending session.status request: " << message << std::endl;
     
     // 发送请求
+    exchangeClock_.onRequestSent(requestId, "session.status");
     wsApiSocket_->send(message);
     
     return true;
@@ -1633,6 +1759,7 @@ void BinanceWebSocket::sendWebSocketApiRequest(const std::string& method, const
     
     request += "}";
     
+    exchangeClock_.onRequestSent(std::strtoll(id.c_str(), nullptr, 10), method.c_str());
     wsApiSocket_->send(request);
     std::cout << "[DEBUG] Request: " << request << std::endl;
 }
@@ -1655,6 +1782,7 @@ void BinanceWebSocket::sendWebSocketRequest(const std::string& method, const std
     
     request += "}";
     
+    exchangeClock_.onRequestSent(std::strtoll(id.c_str(), nullptr, 10), method.c_str());
     wsApiSocket_->send(request);
     std::cout << "[INFO] Sent WebSocket API request: " << request << std::endl;
 }
@@ -1754,6 +1882,16 @@ void BinanceWebSocket::parseAccountBalanceResponse(yyjson_val* root) {
     }
 }
 
+void BinanceWebSocket::dispatchAccountInfoResponse(yyjson_val* root) {
+    // 视图模式下跳过全部资产和持仓的物化，只有结构体回调存在时才完整解析
+    if (accountInfoViewCallback_) {
+        accountInfoViewCallback_(AccountInfoView(root));
+    }
+    if (accountInfoCallback_) {
+        parseAccountInfoResponse(root);
+    }
+}
+
 void BinanceWebSocket::parseAccountInfoResponse(yyjson_val* root) {
     AccountInfoResponse response;
     
@@ -2049,7 +2187,7 @@ void BinanceWebSocket::placeOrder(const OrderRequest& orderRequest, const std::s
         return;
     }
     
-    std::string id = requestId.empty() ? std::to_string(requestId_++) : requestId;
+    (void)requestId;  // WS API请求ID在调度器实际发送时分配
     
     // 构建订单参数
     std::ostringstream params;
@@ -2121,15 +2259,133 @@ void BinanceWebSocket::placeOrder(const OrderRequest& orderRequest, const std::s
         params << ",\"reduceOnly\":" << orderRequest.reduceOnly;
     }
     
-    // 添加必需的timestamp参数
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
-    params << ",\"timestamp\":" << timestamp;
+    // timestamp在实际发送时补上，排队期间不会过期
+    PacedOrder order;
+    order.params = params.str();
+    // 参数已含clientOrderId，这里另存一份只用于链路打点
+    std::strncpy(order.clientOrderId, orderRequest.newClientOrderId.c_str(), PacedOrder::MAX_CLIENT_ORDER_ID - 1);
+    order.clientOrderId[PacedOrder::MAX_CLIENT_ORDER_ID - 1] = '\0';
+    order.urgency = orderRequest.urgency;
+    order.strategySlot = orderRequest.strategySlot;
+    std::cout << "[INFO] Placing order with params: " << order.params << std::endl;
     
-    std::string paramsStr = params.str();
-    std::cout << "[INFO] Placing order with params: " << paramsStr << std::endl;
+    if (!orderPacer_.submit(order)) {
+        std::cout << "[ERROR] Order rejected by pacer, symbol: " << orderRequest.symbol << std::endl;
+    }
+}
+
+int BinanceWebSocket::registerStrategyRateLimit(const std::string& strategyId, uint32_t ordersPerSecond,
+                                                uint32_t ordersPerMinute) {
+    int slot = orderPacer_.registerStrategy(strategyId, ordersPerSecond, ordersPerMinute);
+    std::cout << "[INFO] Registered rate limit for strategy " << strategyId << ": " << ordersPerSecond
+              << "/s, " << ordersPerMinute << "/min, slot " << slot << std::endl;
+    return slot;
+}
+
+bool BinanceWebSocket::sendPacedOrder(PacedOrder& order) {
+    if (!wsApiSocket_ || wsApiSocket_->getReadyState() != ix::ReadyState::Open) {
+        std::cout << "[ERROR] WebSocket API not connected" << std::endl;
+        return false;
+    }
+    
+    order.requestId = requestId_++;
+    auto timestamp = exchangeClock_.exchangeTimeMs();
+    
+    // 每个线程复用同一块发送缓冲，预热后不再分配内存
+    thread_local std::string requestBuffer;
+    if (order.templateHandle >= 0) {
+        requestBuffer.resize(OrderTemplate::MAX_REQUEST_SIZE);
+        size_t length = orderTemplates_[order.templateHandle]->render(
+            &requestBuffer[0], requestBuffer.size(), order.requestId, order.isBuy, order.quantity, order.price,
+            order.clientOrderId, timestamp);
+        if (length == 0) {
+            std::cout << "[ERROR] Order request exceeds template buffer, handle: " << order.templateHandle << std::endl;
+            return false;
+        }
+        requestBuffer.resize(length);
+    } else {
+        requestBuffer.clear();
+        requestBuffer += "{\"id\":\"";
+        requestBuffer += std::to_string(order.requestId);
+        requestBuffer += "\",\"method\":\"order.place\",\"params\":{";
+        requestBuffer += order.params;
+        requestBuffer += ",\"timestamp\":";
+        requestBuffer += std::to_string(timestamp);
+        requestBuffer += "}}";
+    }
+    
+    bool traced = orderTraceEnabled_.load(std::memory_order_acquire) && order.clientOrderId[0] != '\0';
+    if (traced) {
+        traceOrder(order.clientOrderId, OrderTraceStage::SERIALIZED);
+    }
+    
+    exchangeClock_.onRequestSent(order.requestId, "order.place");
+    wsApiSocket_->send(requestBuffer);
+    if (traced) {
+        traceOrder(order.clientOrderId, OrderTraceStage::SENT);
+    }
+#ifdef TES_ENABLE_ORDER_REQUEST_LOG
+    std::cout << "[DEBUG] Request: " << requestBuffer << std::endl;
+#endif
+    return true;
+}
+
+int BinanceWebSocket::registerOrderTemplate(const OrderTemplateSpec& spec) {
+    std::ostringstream key;
+    key << spec.symbol << '|' << spec.type << '|' << spec.positionSide << '|' << spec.timeInForce
+        << '|' << spec.reduceOnly << '|' << spec.closePosition << '|' << spec.newOrderRespType
+        << '|' << spec.stepSize << '|' << spec.tickSize;
+    
+    std::lock_guard<std::mutex> lock(orderTemplateMutex_);
+    auto it = orderTemplateIndex_.find(key.str());
+    if (it != orderTemplateIndex_.end()) {
+        return it->second;
+    }
+    
+    int handle = orderTemplateCount_.load(std::memory_order_relaxed);
+    if (handle >= MAX_ORDER_TEMPLATES) {
+        std::cout << "[ERROR] Order template capacity exhausted, symbol: " << spec.symbol << std::endl;
+        return -1;
+    }
     
-    sendWebSocketApiRequest("order.place", paramsStr);
+    orderTemplates_[handle] = std::make_unique<OrderTemplate>(spec);
+    orderTemplateIndex_[key.str()] = handle;
+    orderTemplateCount_.store(handle + 1, std::memory_order_release);
+    
+    std::cout << "[INFO] Registered order template " << handle << " for " << spec.symbol 
+              << " " << spec.type << std::endl;
+    return handle;
+}
+
+bool BinanceWebSocket::placeOrderFromTemplate(int templateHandle, bool isBuy, double quantity, double price,
+                                              const char* clientOrderId, OrderUrgency urgency, int strategySlot) {
+    if (!sessionAuthenticated_) {
+        std::cout << "[ERROR] Session not authenticated, cannot place order" << std::endl;
+        return false;
+    }
+    
+    if (templateHandle < 0 || templateHandle >= orderTemplateCount_.load(std::memory_order_acquire)) {
+        std::cout << "[ERROR] Invalid order template handle: " << templateHandle << std::endl;
+        return false;
+    }
+    
+    PacedOrder order;
+    if (clientOrderId) {
+        size_t length = std::strlen(clientOrderId);
+        if (length >= PacedOrder::MAX_CLIENT_ORDER_ID) {
+            std::cout << "[ERROR] Client order id too long: " << clientOrderId << std::endl;
+            return false;
+        }
+        std::memcpy(order.clientOrderId, clientOrderId, length + 1);
+    }
+    order.templateHandle = templateHandle;
+    order.isBuy = isBuy;
+    order.quantity = quantity;
+    order.price = price;
+    order.urgency = urgency;
+    order.strategySlot = strategySlot;
+    
+    return orderPacer_.submit(order);
 }
 
 void BinanceWebSocket::cancelOrder(const CancelOrderRequest& cancelRequest, const std::string& requestId) {
@@ -2153,8 +2409,7 @@ void BinanceWebSocket::cancelOrder(const CancelOrderRequest& cancelRequest, cons
     }
     
     // 添加必需的timestamp参数
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now().time_since_epoch()).count();
+    auto timestamp = exchangeClock_.exchangeTimeMs();
     params << ",\"timestamp\":" << timestamp;
     
     std::string paramsStr = params.str();
@@ -2334,6 +2589,48 @@ void BinanceWebSocket::parseOrderResponse(yyjson_val* root) {
     orderResponseCallback_(orderResp);
 }
 
+void BinanceWebSocket::parseAggTrade(yyjson_val* root) {
+    if (!aggTradeCallback_) {
+        return;
+    }
+    
+    AggTrade trade;
+    yyjson_val* val;
+    
+    if ((val = yyjson_obj_get(root, "e")) && yyjson_is_str(val)) {
+        trade.eventType = yyjson_get_str(val);
+    }
+    if ((val = yyjson_obj_get(root, "E")) && yyjson_is_num(val)) {
+        trade.eventTime = yyjson_get_int(val);
+    }
+    if ((val = yyjson_obj_get(root, "s")) && yyjson_is_str(val)) {
+        trade.symbol = yyjson_get_str(val);
+    }
+    if ((val = yyjson_obj_get(root, "a")) && yyjson_is_num(val)) {
+        trade.aggTradeId = yyjson_get_int(val);
+    }
+    if ((val = yyjson_obj_get(root, "p")) && yyjson_is_str(val)) {
+        trade.price = yyjson_get_str(val);
+    }
+    if ((val = yyjson_obj_get(root, "q")) && yyjson_is_str(val)) {
+        trade.quantity = yyjson_get_str(val);
+    }
+    if ((val = yyjson_obj_get(root, "f")) && yyjson_is_num(val)) {
+        trade.firstTradeId = yyjson_get_int(val);
+    }
+    if ((val = yyjson_obj_get(root, "l")) && yyjson_is_num(val)) {
+        trade.lastTradeId = yyjson_get_int(val);
+    }
+    if ((val = yyjson_obj_get(root, "T")) && yyjson_is_num(val)) {
+        trade.tradeTime = yyjson_get_int(val);
+    }
+    if ((val = yyjson_obj_get(root, "m")) && yyjson_is_bool(val)) {
+        trade.isBuyerMaker = yyjson_get_bool(val);
+    }
+    
+    aggTradeCallback_(trade);
+}
+
 void BinanceWebSocket::parseDepthUpdate(yyjson_val* root) {
     if (!depthUpdateCallback_) {
         return;
@@ -2427,10 +2724,26 @@ void BinanceWebSocket::parseTradeLite(yyjson_val* root) {
     TradeLite tradeLite;
     yyjson_val* val;
     
+    if ((val = yyjson_obj_get(root, "E")) && yyjson_is_num(val)) {
+        tradeLite.eventTime = yyjson_get_int(val);
+    }
+    
     if ((val = yyjson_obj_get(root, "s")) && yyjson_is_str(val)) {
         tradeLite.symbol = yyjson_get_str(val);
     }
     
+    if ((val = yyjson_obj_get(root, "S")) && yyjson_is_str(val)) {
+        tradeLite.side = yyjson_get_str(val);
+    }
+    
+    if ((val = yyjson_obj_get(root, "c")) && yyjson_is_str(val)) {
+        tradeLite.clientOrderId = yyjson_get_str(val);
+    }
+    
+    if ((val = yyjson_obj_get(root, "i")) && yyjson_is_num(val)) {
+        tradeLite.orderId = yyjson_get_int(val);
+    }
+    
     if ((val = yyjson_obj_get(root, "q")) && yyjson_is_str(val)) {
         tradeLite.quantity = yyjson_get_str(val);
     }
@@ -2465,6 +2778,7 @@ void BinanceWebSocket::parseTradeLite(yyjson_val* root) {
     
     if ((val = yyjson_obj_get(root, "T")) && yyjson_is_num(val)) {
         tradeLite.orderTradeTime = yyjson_get_int(val);
+        tradeLite.transactionTime = tradeLite.orderTradeTime;
     }
     
     if ((val = yyjson_obj_get(root, "t")) && yyjson_is_num(val)) {
@@ -2481,6 +2795,7 @@ void BinanceWebSocket::parseTradeLite(yyjson_val* root) {
     
     if ((val = yyjson_obj_get(root, "m")) && yyjson_is_bool(val)) {
         tradeLite.isMarkerSide = yyjson_get_bool(val);
+        tradeLite.isMakerSide = tradeLite.isMarkerSide;
     }
     
     if ((val = yyjson_obj_get(root, "R")) && yyjson_is_bool(val)) {
@@ -2559,6 +2874,7 @@ std::string BinanceWebSocket::buildMarketDataStreams() const {
                     // 转换为小写
                     std::transform(symbol.begin(), symbol.end(), symbol.begin(), ::tolower);
                     symbols.push_back(symbol + "@depth5");
+                    symbols.push_back(symbol + "@aggTrade");
                     std::cout << "[INFO] Added symbol to market data stream: " << symbol << std::endl;
                 }
             }
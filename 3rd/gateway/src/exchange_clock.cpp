@@ -0,0 +1,182 @@
+#include "exchange_clock.h"
+#include <chrono>
+#include <cstring>
+
+namespace trading {
+
+namespace {
+
+constexpr int64_t NS_PER_MS = 1000000LL;
+
+} // namespace
+
+ExchangeClock::ExchangeClock()
+    : methodNames_{}
+    , methodCount_(0)
+    , filter_{}
+    , filterCount_(0)
+    , filterNext_(0)
+    , offsetNs_(0)
+    , uncertaintyNs_(0)
+    , minRttNs_(0)
+    , synchronized_(false)
+    , offsetSamples_(0)
+    , rttSamples_(0) {
+}
+
+void ExchangeClock::setSampleCallback(std::function<void(const LatencySample&)> callback) {
+    sampleCallback_ = callback;
+}
+
+int64_t ExchangeClock::realtimeNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t ExchangeClock::monotonicNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int ExchangeClock::methodIndex(const char* method) {
+    if (!method) {
+        return -1;
+    }
+
+    int count = methodCount_.load(std::memory_order_acquire);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(methodNames_[i], method) == 0) {
+            return i;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(methodMutex_);
+    count = methodCount_.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; ++i) {
+        if (std::strcmp(methodNames_[i], method) == 0) {
+            return i;
+        }
+    }
+    if (count >= static_cast<int>(MAX_METHODS) || std::strlen(method) >= MAX_METHOD_LENGTH) {
+        return -1;
+    }
+    std::strcpy(methodNames_[count], method);
+    methodCount_.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+void ExchangeClock::emit(LatencySampleKind kind, const char* name, int64_t valueNs) const {
+    if (sampleCallback_) {
+        LatencySample sample;
+        sample.kind = kind;
+        sample.name = name;
+        sample.valueNs = valueNs;
+        sampleCallback_(sample);
+    }
+}
+
+void ExchangeClock::onRequestSent(int64_t requestId, const char* method) {
+    if (requestId <= 0) {
+        return;
+    }
+
+    PendingRequest& slot = pending_[static_cast<size_t>(requestId) & (PENDING_REQUESTS - 1)];
+    slot.requestId.store(0, std::memory_order_relaxed);
+    slot.methodIndex.store(methodIndex(method), std::memory_order_relaxed);
+    slot.sendRealtimeNs.store(realtimeNowNs(), std::memory_order_relaxed);
+    slot.sendMonotonicNs.store(monotonicNowNs(), std::memory_order_relaxed);
+    slot.requestId.store(requestId, std::memory_order_release);
+}
+
+void ExchangeClock::onResponse(int64_t requestId, int64_t serverTimeMs, int64_t recvRealtimeNs,
+                               int64_t recvMonotonicNs) {
+    if (requestId <= 0) {
+        return;
+    }
+
+    PendingRequest& slot = pending_[static_cast<size_t>(requestId) & (PENDING_REQUESTS - 1)];
+    if (slot.requestId.load(std::memory_order_acquire) != requestId) {
+        return;     // 未登记或槽位已被更新的请求占用
+    }
+    int index = slot.methodIndex.load(std::memory_order_relaxed);
+    int64_t sendRealtimeNs = slot.sendRealtimeNs.load(std::memory_order_relaxed);
+    int64_t sendMonotonicNs = slot.sendMonotonicNs.load(std::memory_order_relaxed);
+    // 认领槽位，同一请求的重复应答只统计一次
+    int64_t expected = requestId;
+    if (!slot.requestId.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    int64_t rttNs = recvMonotonicNs - sendMonotonicNs;
+    if (rttNs < 0) {
+        return;
+    }
+    rttSamples_.fetch_add(1, std::memory_order_relaxed);
+    emit(LatencySampleKind::REQUEST_RTT, index >= 0 ? methodNames_[index] : "unknown", rttNs);
+
+    if (serverTimeMs > 0 && rttNs <= MAX_OFFSET_RTT_NS) {
+        // 服务器时间只到毫秒，取该毫秒的中点
+        int64_t serverNs = serverTimeMs * NS_PER_MS + NS_PER_MS / 2;
+        int64_t localMidNs = sendRealtimeNs + (recvRealtimeNs - sendRealtimeNs) / 2;
+        addOffsetSample(serverNs - localMidNs, rttNs);
+    }
+}
+
+void ExchangeClock::addOffsetSample(int64_t offsetNs, int64_t rttNs) {
+    OffsetSample best;
+    {
+        std::lock_guard<std::mutex> lock(filterMutex_);
+        filter_[filterNext_] = {offsetNs, rttNs};
+        filterNext_ = (filterNext_ + 1) % FILTER_SIZE;
+        if (filterCount_ < FILTER_SIZE) {
+            ++filterCount_;
+        }
+
+        best = filter_[0];
+        for (size_t i = 1; i < filterCount_; ++i) {
+            if (filter_[i].rttNs < best.rttNs) {
+                best = filter_[i];
+            }
+        }
+    }
+
+    offsetNs_.store(best.offsetNs, std::memory_order_relaxed);
+    uncertaintyNs_.store(best.rttNs / 2 + NS_PER_MS / 2, std::memory_order_relaxed);
+    minRttNs_.store(best.rttNs, std::memory_order_relaxed);
+    synchronized_.store(true, std::memory_order_release);
+    offsetSamples_.fetch_add(1, std::memory_order_relaxed);
+    emit(LatencySampleKind::CLOCK_OFFSET, "offset", best.offsetNs);
+}
+
+void ExchangeClock::onServerEvent(const char* eventType, int64_t eventTimeMs, int64_t transactionTimeMs,
+                                  int64_t recvRealtimeNs) {
+    if (eventTimeMs <= 0) {
+        return;
+    }
+
+    if (transactionTimeMs > 0 && eventTimeMs >= transactionTimeMs) {
+        emit(LatencySampleKind::EXCHANGE_PROCESSING, eventType, (eventTimeMs - transactionTimeMs) * NS_PER_MS);
+    }
+    // 单向延迟依赖偏移估计，未同步前不记录
+    if (synchronized_.load(std::memory_order_acquire)) {
+        int64_t deliveryNs = recvRealtimeNs + offsetNs() - eventTimeMs * NS_PER_MS;
+        emit(LatencySampleKind::EVENT_DELIVERY, eventType, deliveryNs > 0 ? deliveryNs : 0);
+    }
+}
+
+int64_t ExchangeClock::exchangeTimeMs() const {
+    return (realtimeNowNs() + offsetNs()) / NS_PER_MS;
+}
+
+ClockSyncStatus ExchangeClock::getStatus() const {
+    ClockSyncStatus status;
+    status.synchronized = synchronized_.load(std::memory_order_acquire);
+    status.offsetNs = offsetNs_.load(std::memory_order_relaxed);
+    status.uncertaintyNs = uncertaintyNs_.load(std::memory_order_relaxed);
+    status.minRttNs = minRttNs_.load(std::memory_order_relaxed);
+    status.offsetSamples = offsetSamples_.load(std::memory_order_relaxed);
+    status.rttSamples = rttSamples_.load(std::memory_order_relaxed);
+    return status;
+}
+
+} // namespace trading
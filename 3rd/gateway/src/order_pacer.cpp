@@ -0,0 +1,567 @@
+#include "order_pacer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <pthread.h>
+
+namespace trading {
+
+namespace {
+
+constexpr int64_t NS_PER_MS = 1000000;
+constexpr int64_t NS_PER_SECOND = 1000000000;
+
+// 排队时最长等待粒度，便于及时响应新的rateLimits回报
+constexpr int64_t MAX_DISPATCH_WAIT_NS = 100 * NS_PER_MS;
+
+// 排队订单发送失败（连接断开等）后最多重排的次数，超过则丢弃
+constexpr uint32_t MAX_SEND_FAILURES = 3;
+
+// 币安限频错误码
+constexpr int ERROR_TOO_MANY_REQUESTS = -1003;
+constexpr int ERROR_TOO_MANY_ORDERS = -1015;
+
+inline int64_t systemMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// -1003封禁消息形如"... IP banned until 1700000000000. ..."，取出解封时间
+inline int64_t parseBannedUntilMs(const std::string& message) {
+    static const char KEY[] = "banned until ";
+    size_t pos = message.find(KEY);
+    if (pos == std::string::npos) {
+        return 0;
+    }
+    return std::strtoll(message.c_str() + pos + sizeof(KEY) - 1, nullptr, 10);
+}
+
+} // namespace
+
+// TokenBucket 实现
+TokenBucket::TokenBucket()
+    : tat_(0)
+    , intervalNs_(0)
+    , burstNs_(0)
+{
+}
+
+void TokenBucket::configure(double ratePerSecond, uint32_t burst) {
+    if (ratePerSecond <= 0.0) {
+        intervalNs_.store(0, std::memory_order_relaxed);
+        return;
+    }
+    int64_t interval = std::max<int64_t>(1, static_cast<int64_t>(NS_PER_SECOND / ratePerSecond));
+    burstNs_.store(interval * std::max<uint32_t>(1, burst), std::memory_order_relaxed);
+    intervalNs_.store(interval, std::memory_order_relaxed);
+}
+
+void TokenBucket::configureWindow(uint32_t limit, double windowSeconds) {
+    if (limit == 0 || windowSeconds <= 0.0) {
+        configure(0.0, 0);
+        return;
+    }
+    // 任意窗口内最多 burst + rate*window = limit 次
+    uint32_t burst = std::max<uint32_t>(1, limit / 4);
+    double rate = limit > burst ? (limit - burst) / windowSeconds : limit / windowSeconds;
+    configure(rate, burst);
+}
+
+int64_t TokenBucket::tryAcquire(int64_t nowNs, uint32_t tokens) {
+    int64_t interval = intervalNs_.load(std::memory_order_relaxed);
+    if (interval <= 0) {
+        return 0;
+    }
+    int64_t burst = burstNs_.load(std::memory_order_relaxed);
+    int64_t increment = interval * tokens;
+
+    int64_t tat = tat_.load(std::memory_order_relaxed);
+    while (true) {
+        int64_t newTat = std::max(tat, nowNs) + increment;
+        if (newTat - nowNs > burst) {
+            return newTat - nowNs - burst;
+        }
+        if (tat_.compare_exchange_weak(tat, newTat, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return 0;
+        }
+    }
+}
+
+void TokenBucket::release(uint32_t tokens) {
+    int64_t interval = intervalNs_.load(std::memory_order_relaxed);
+    if (interval > 0) {
+        tat_.fetch_sub(interval * tokens, std::memory_order_acq_rel);
+    }
+}
+
+// ExchangeRateLimitTracker 实现
+ExchangeRateLimitTracker::ExchangeRateLimitTracker()
+    : slotCount_(0)
+{
+    for (auto& slot : slots_) {
+        slot.intervalMs.store(0);
+        slot.limit.store(0);
+        slot.count.store(0);
+        slot.windowEndMs.store(0);
+        slot.type.store(0);
+    }
+}
+
+void ExchangeRateLimitTracker::update(LimitType type, int64_t intervalMs, int64_t limit, int64_t count, int64_t nowMs) {
+    if (intervalMs <= 0 || limit <= 0) {
+        return;
+    }
+
+    int n = slotCount_.load(std::memory_order_acquire);
+    Slot* target = nullptr;
+    for (int i = 0; i < n; ++i) {
+        if (slots_[i].type.load(std::memory_order_relaxed) == static_cast<uint8_t>(type) &&
+            slots_[i].intervalMs.load(std::memory_order_relaxed) == intervalMs) {
+            target = &slots_[i];
+            break;
+        }
+    }
+
+    if (!target) {
+        std::lock_guard<std::mutex> lock(registerMutex_);
+        n = slotCount_.load(std::memory_order_relaxed);
+        for (int i = 0; i < n && !target; ++i) {
+            if (slots_[i].type.load(std::memory_order_relaxed) == static_cast<uint8_t>(type) &&
+                slots_[i].intervalMs.load(std::memory_order_relaxed) == intervalMs) {
+                target = &slots_[i];
+            }
+        }
+        if (!target) {
+            if (n >= MAX_LIMITS) {
+                return;
+            }
+            target = &slots_[n];
+            target->type.store(static_cast<uint8_t>(type), std::memory_order_relaxed);
+            target->intervalMs.store(intervalMs, std::memory_order_relaxed);
+            slotCount_.store(n + 1, std::memory_order_release);
+        }
+    }
+
+    // 币安限频窗口按自然时间对齐
+    target->limit.store(limit, std::memory_order_relaxed);
+    target->count.store(count, std::memory_order_relaxed);
+    target->windowEndMs.store((nowMs / intervalMs + 1) * intervalMs, std::memory_order_relaxed);
+}
+
+void ExchangeRateLimitTracker::consume(LimitType type, int64_t amount, int64_t nowMs) {
+    int n = slotCount_.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.type.load(std::memory_order_relaxed) != static_cast<uint8_t>(type)) {
+            continue;
+        }
+        int64_t windowEnd = slot.windowEndMs.load(std::memory_order_relaxed);
+        if (nowMs >= windowEnd) {
+            // 已进入新窗口，计数从本地发送重新累计
+            int64_t interval = slot.intervalMs.load(std::memory_order_relaxed);
+            slot.windowEndMs.store((nowMs / interval + 1) * interval, std::memory_order_relaxed);
+            slot.count.store(amount, std::memory_order_relaxed);
+        } else {
+            slot.count.fetch_add(amount, std::memory_order_relaxed);
+        }
+    }
+}
+
+int64_t ExchangeRateLimitTracker::holdTimeMs(LimitType type, int64_t nowMs, double headroom) const {
+    int64_t hold = 0;
+    int n = slotCount_.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i) {
+        const Slot& slot = slots_[i];
+        if (slot.type.load(std::memory_order_relaxed) != static_cast<uint8_t>(type)) {
+            continue;
+        }
+        int64_t windowEnd = slot.windowEndMs.load(std::memory_order_relaxed);
+        if (nowMs >= windowEnd) {
+            continue;
+        }
+        double threshold = slot.limit.load(std::memory_order_relaxed) * headroom;
+        if (slot.count.load(std::memory_order_relaxed) >= threshold) {
+            hold = std::max(hold, windowEnd - nowMs);
+        }
+    }
+    return hold;
+}
+
+int64_t ExchangeRateLimitTracker::usagePermille(LimitType type) const {
+    int64_t usage = 0;
+    int n = slotCount_.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i) {
+        const Slot& slot = slots_[i];
+        int64_t limit = slot.limit.load(std::memory_order_relaxed);
+        if (slot.type.load(std::memory_order_relaxed) == static_cast<uint8_t>(type) && limit > 0) {
+            usage = std::max(usage, slot.count.load(std::memory_order_relaxed) * 1000 / limit);
+        }
+    }
+    return usage;
+}
+
+// OrderPacer 实现
+OrderPacer::OrderPacer()
+    : running_(false)
+    , strategyCount_(1)
+    , backoffUntilNs_(0)
+    , consecutiveBackoffs_(0)
+    , queued_(0)
+    , inflight_(INFLIGHT_SLOTS)
+    , sentImmediately_(0)
+    , sentFromQueue_(0)
+    , requeued_(0)
+    , rejectedQueueFull_(0)
+    , sendFailures_(0)
+    , droppedAfterFailures_(0)
+    , backoffCount_(0)
+    , maxQueueDelayNs_(0)
+{
+    // 槽位0为默认策略，不做策略级限频
+    strategySlots_["default"] = 0;
+    for (int& cursor : roundRobin_) {
+        cursor = 0;
+    }
+}
+
+OrderPacer::~OrderPacer() {
+    stop();
+}
+
+void OrderPacer::start(const Config& config, Sender sender) {
+    if (running_.load()) {
+        return;
+    }
+
+    config_ = config;
+    sender_ = std::move(sender);
+    accountOrders10s_.configureWindow(config_.accountOrdersPer10s, 10.0);
+    accountOrdersMinute_.configureWindow(config_.accountOrdersPerMinute, 60.0);
+    accountWeight_.configureWindow(config_.accountWeightPerMinute, 60.0);
+
+    running_.store(true);
+    dispatchThread_.reset(new std::thread(&OrderPacer::dispatchLoop, this));
+}
+
+void OrderPacer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    queueCv_.notify_all();
+
+    if (dispatchThread_ && dispatchThread_->joinable()) {
+        dispatchThread_->join();
+    }
+    dispatchThread_.reset();
+
+    size_t remaining = queued_.load();
+    if (remaining > 0) {
+        std::cout << "[WARNING] Order pacer stopped with " << remaining << " queued orders discarded" << std::endl;
+    }
+}
+
+int OrderPacer::registerStrategy(const std::string& strategyId, uint32_t ordersPerSecond, uint32_t ordersPerMinute) {
+    std::lock_guard<std::mutex> lock(strategyMutex_);
+
+    int slot;
+    auto it = strategySlots_.find(strategyId);
+    if (it != strategySlots_.end()) {
+        slot = it->second;
+    } else {
+        slot = strategyCount_.load(std::memory_order_relaxed);
+        if (slot >= MAX_STRATEGIES) {
+            std::cout << "[ERROR] Strategy rate limit capacity exhausted, strategy: " << strategyId << std::endl;
+            return 0;
+        }
+        strategySlots_[strategyId] = slot;
+    }
+
+    strategyLimits_[slot].perSecond.configureWindow(ordersPerSecond, 1.0);
+    strategyLimits_[slot].perMinute.configureWindow(ordersPerMinute, 60.0);
+    if (slot == strategyCount_.load(std::memory_order_relaxed)) {
+        strategyCount_.store(slot + 1, std::memory_order_release);
+    }
+    return slot;
+}
+
+bool OrderPacer::submit(PacedOrder& order) {
+    if (!running_.load()) {
+        return sender_ ? sendNow(order) : false;
+    }
+
+    int64_t now = nowNs();
+    order.enqueueNs = now;
+    if (order.strategySlot < 0 || order.strategySlot >= strategyCount_.load(std::memory_order_acquire)) {
+        order.strategySlot = 0;
+    }
+
+    // 快速路径：没有排队且预算充足时在调用线程直接发送，不经过调度线程
+    if (queued_.load(std::memory_order_acquire) == 0) {
+        bool accountLimited = false;
+        if (acquireBudget(order.strategySlot, now, accountLimited) == 0) {
+            if (!sendNow(order)) {
+                releaseBudget(order.strategySlot);
+                return false;
+            }
+            sentImmediately_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (queued_.load(std::memory_order_relaxed) >= config_.maxQueued) {
+            rejectedQueueFull_.fetch_add(1, std::memory_order_relaxed);
+            std::cout << "[ERROR] Order pacer queue full, order rejected" << std::endl;
+            return false;
+        }
+        enqueueLocked(std::move(order), false);
+    }
+    queueCv_.notify_one();
+    return true;
+}
+
+void OrderPacer::onRateLimit(ExchangeRateLimitTracker::LimitType type, int64_t intervalMs, int64_t limit, int64_t count) {
+    exchangeLimits_.update(type, intervalMs, limit, count, systemMs());
+}
+
+bool OrderPacer::onOrderResponse(int64_t requestId, int errorCode, const std::string& errorMessage) {
+    bool rateLimited = errorCode == ERROR_TOO_MANY_REQUESTS || errorCode == ERROR_TOO_MANY_ORDERS;
+
+    if (!rateLimited) {
+        if (errorCode == 0) {
+            consecutiveBackoffs_.store(0, std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        PacedOrder& slot = inflight_[static_cast<size_t>(requestId) % INFLIGHT_SLOTS];
+        if (slot.requestId == requestId) {
+            slot.requestId = 0;
+        }
+        return false;
+    }
+
+    // 指数退避；封禁消息带解封时间时以其为准
+    int64_t now = nowNs();
+    uint32_t level = std::min<uint32_t>(consecutiveBackoffs_.fetch_add(1, std::memory_order_relaxed), 16);
+    int64_t delayMs = std::min(config_.backoffMaxMs, config_.backoffInitialMs << level);
+    int64_t bannedUntilMs = parseBannedUntilMs(errorMessage);
+    if (bannedUntilMs > 0) {
+        delayMs = std::max(delayMs, bannedUntilMs - systemMs());
+    }
+    int64_t until = now + delayMs * NS_PER_MS;
+    int64_t current = backoffUntilNs_.load(std::memory_order_relaxed);
+    while (current < until && !backoffUntilNs_.compare_exchange_weak(current, until, std::memory_order_relaxed)) {
+    }
+    backoffCount_.fetch_add(1, std::memory_order_relaxed);
+    std::cout << "[WARNING] Exchange rate limit hit (code " << errorCode << "), backing off "
+              << delayMs << "ms" << std::endl;
+
+    PacedOrder order;
+    {
+        std::lock_guard<std::mutex> lock(inflightMutex_);
+        PacedOrder& slot = inflight_[static_cast<size_t>(requestId) % INFLIGHT_SLOTS];
+        if (slot.requestId != requestId || requestId == 0) {
+            return false;
+        }
+        order = std::move(slot);
+        slot.requestId = 0;
+    }
+
+    // 被退回的订单排到同优先级队首，退避结束后最先发送
+    order.attempts++;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        enqueueLocked(std::move(order), true);
+    }
+    requeued_.fetch_add(1, std::memory_order_relaxed);
+    queueCv_.notify_one();
+    return true;
+}
+
+OrderPacerStatistics OrderPacer::getStatistics() const {
+    OrderPacerStatistics stats;
+    stats.sentImmediately = sentImmediately_.load(std::memory_order_relaxed);
+    stats.sentFromQueue = sentFromQueue_.load(std::memory_order_relaxed);
+    stats.requeued = requeued_.load(std::memory_order_relaxed);
+    stats.rejectedQueueFull = rejectedQueueFull_.load(std::memory_order_relaxed);
+    stats.sendFailures = sendFailures_.load(std::memory_order_relaxed);
+    stats.droppedAfterFailures = droppedAfterFailures_.load(std::memory_order_relaxed);
+    stats.backoffCount = backoffCount_.load(std::memory_order_relaxed);
+    stats.queued = queued_.load(std::memory_order_relaxed);
+    stats.maxQueueDelayUs = maxQueueDelayNs_.load(std::memory_order_relaxed) / 1000;
+    stats.weightUsagePermille = exchangeLimits_.usagePermille(ExchangeRateLimitTracker::LimitType::REQUEST_WEIGHT);
+    stats.orderUsagePermille = exchangeLimits_.usagePermille(ExchangeRateLimitTracker::LimitType::ORDERS);
+    return stats;
+}
+
+int64_t OrderPacer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t OrderPacer::globalHoldNs(int64_t now) const {
+    int64_t hold = std::max<int64_t>(0, backoffUntilNs_.load(std::memory_order_relaxed) - now);
+
+    int64_t nowMs = systemMs();
+    int64_t exchangeHoldMs = std::max(
+        exchangeLimits_.holdTimeMs(ExchangeRateLimitTracker::LimitType::ORDERS, nowMs, config_.headroom),
+        exchangeLimits_.holdTimeMs(ExchangeRateLimitTracker::LimitType::REQUEST_WEIGHT, nowMs, config_.headroom));
+    return std::max(hold, exchangeHoldMs * NS_PER_MS);
+}
+
+int64_t OrderPacer::acquireBudget(int strategySlot, int64_t now, bool& accountLimited) {
+    accountLimited = true;
+    int64_t hold = globalHoldNs(now);
+    if (hold > 0) {
+        return hold;
+    }
+
+    // 先取策略级令牌，再取账户级令牌，任一失败都回滚已取得的部分
+    accountLimited = false;
+    StrategyLimit& strategy = strategyLimits_[strategySlot];
+    int64_t wait = strategy.perSecond.tryAcquire(now);
+    if (wait > 0) {
+        return wait;
+    }
+    wait = strategy.perMinute.tryAcquire(now);
+    if (wait > 0) {
+        strategy.perSecond.release();
+        return wait;
+    }
+
+    accountLimited = true;
+    wait = accountOrders10s_.tryAcquire(now);
+    if (wait == 0) {
+        wait = accountOrdersMinute_.tryAcquire(now);
+        if (wait == 0) {
+            wait = accountWeight_.tryAcquire(now, config_.orderWeight);
+            if (wait == 0) {
+                return 0;
+            }
+            accountOrdersMinute_.release();
+        }
+        accountOrders10s_.release();
+    }
+    strategy.perMinute.release();
+    strategy.perSecond.release();
+    return wait;
+}
+
+void OrderPacer::releaseBudget(int strategySlot) {
+    accountWeight_.release(config_.orderWeight);
+    accountOrdersMinute_.release();
+    accountOrders10s_.release();
+    strategyLimits_[strategySlot].perMinute.release();
+    strategyLimits_[strategySlot].perSecond.release();
+}
+
+bool OrderPacer::sendNow(PacedOrder& order) {
+    if (!sender_(order)) {
+        sendFailures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    int64_t nowMs = systemMs();
+    exchangeLimits_.consume(ExchangeRateLimitTracker::LimitType::ORDERS, 1, nowMs);
+    exchangeLimits_.consume(ExchangeRateLimitTracker::LimitType::REQUEST_WEIGHT, config_.orderWeight, nowMs);
+    recordInflight(order);
+    return true;
+}
+
+void OrderPacer::recordInflight(const PacedOrder& order) {
+    std::lock_guard<std::mutex> lock(inflightMutex_);
+    inflight_[static_cast<size_t>(order.requestId) % INFLIGHT_SLOTS] = order;
+}
+
+void OrderPacer::enqueueLocked(PacedOrder&& order, bool front) {
+    int urgency = std::min<int>(static_cast<int>(order.urgency), URGENCY_LEVELS - 1);
+    std::deque<PacedOrder>& queue = queues_[urgency][order.strategySlot];
+    if (front) {
+        queue.push_front(std::move(order));
+    } else {
+        queue.push_back(std::move(order));
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+}
+
+void OrderPacer::dispatchLoop() {
+    pthread_setname_np(pthread_self(), "gw-pacer");
+
+    std::unique_lock<std::mutex> lock(queueMutex_);
+
+    while (running_.load()) {
+        if (queued_.load(std::memory_order_relaxed) == 0) {
+            queueCv_.wait(lock, [this] { return !running_.load() || queued_.load() > 0; });
+            continue;
+        }
+
+        int64_t now = nowNs();
+        int64_t minWait = MAX_DISPATCH_WAIT_NS;
+        bool found = false;
+        PacedOrder order;
+
+        // 按紧急程度从高到低，同一级别内从上次位置开始按策略轮转
+        int strategyCount = strategyCount_.load(std::memory_order_acquire);
+        for (int urgency = 0; urgency < URGENCY_LEVELS && !found; ++urgency) {
+            for (int step = 0; step < strategyCount; ++step) {
+                int slot = (roundRobin_[urgency] + step) % strategyCount;
+                std::deque<PacedOrder>& queue = queues_[urgency][slot];
+                if (queue.empty()) {
+                    continue;
+                }
+
+                bool accountLimited = false;
+                int64_t wait = acquireBudget(slot, now, accountLimited);
+                if (wait == 0) {
+                    order = std::move(queue.front());
+                    queue.pop_front();
+                    queued_.fetch_sub(1, std::memory_order_release);
+                    roundRobin_[urgency] = (slot + 1) % strategyCount;
+                    found = true;
+                    break;
+                }
+
+                minWait = std::min(minWait, wait);
+                if (accountLimited) {
+                    // 账户级/全局限制对所有策略相同，无需继续尝试
+                    urgency = URGENCY_LEVELS;
+                    break;
+                }
+            }
+        }
+
+        if (!found) {
+            queueCv_.wait_for(lock, std::chrono::nanoseconds(std::max<int64_t>(minWait, NS_PER_MS)));
+            continue;
+        }
+
+        lock.unlock();
+        int64_t delay = now - order.enqueueNs;
+        int64_t maxDelay = maxQueueDelayNs_.load(std::memory_order_relaxed);
+        if (delay > maxDelay) {
+            maxQueueDelayNs_.store(delay, std::memory_order_relaxed);
+        }
+        if (sendNow(order)) {
+            sentFromQueue_.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+            continue;
+        }
+
+        // 未发出的订单不占用预算；重排到同优先级队首，多次失败后丢弃
+        releaseBudget(order.strategySlot);
+        lock.lock();
+        if (++order.sendFailures <= MAX_SEND_FAILURES) {
+            enqueueLocked(std::move(order), true);
+        } else {
+            droppedAfterFailures_.fetch_add(1, std::memory_order_relaxed);
+            std::cout << "[ERROR] Failed to send paced order " << order.sendFailures
+                      << " times, dropped, client order id: " << order.clientOrderId << std::endl;
+        }
+    }
+}
+
+} // namespace trading
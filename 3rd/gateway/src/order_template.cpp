@@ -0,0 +1,176 @@
+#include "order_template.h"
+#include <cmath>
+#include <cstring>
+
+namespace trading {
+
+namespace {
+
+constexpr double POW10[] = {1.0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+// 写入无符号整数，返回长度
+inline size_t writeUnsigned(uint64_t value, char* out) {
+    char tmp[20];
+    size_t n = 0;
+    do {
+        tmp[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = tmp[n - 1 - i];
+    }
+    return n;
+}
+
+inline size_t writeSigned(int64_t value, char* out) {
+    if (value < 0) {
+        *out = '-';
+        return 1 + writeUnsigned(static_cast<uint64_t>(-(value + 1)) + 1, out + 1);
+    }
+    return writeUnsigned(static_cast<uint64_t>(value), out);
+}
+
+inline size_t writeLiteral(const char* literal, size_t len, char* out) {
+    std::memcpy(out, literal, len);
+    return len;
+}
+
+#define WRITE_LITERAL(lit, out) writeLiteral(lit, sizeof(lit) - 1, out)
+
+} // namespace
+
+DecimalFormat::DecimalFormat(double increment)
+    : decimals_(MAX_DECIMALS)
+    , stepUnits_(1)
+    , scale_(POW10[MAX_DECIMALS])
+    , trimZeros_(increment <= 0.0)
+{
+    if (increment <= 0.0) {
+        return;
+    }
+
+    // 找到能精确表示步长的最小小数位数，如0.001 -> 3，10 -> 0
+    for (int d = 0; d <= MAX_DECIMALS; ++d) {
+        double scaled = increment * POW10[d];
+        if (std::fabs(scaled - std::round(scaled)) < 1e-9 * POW10[d]) {
+            decimals_ = d;
+            break;
+        }
+    }
+    scale_ = POW10[decimals_];
+    stepUnits_ = static_cast<int64_t>(std::llround(increment * scale_));
+    if (stepUnits_ <= 0) {
+        stepUnits_ = 1;
+    }
+}
+
+size_t DecimalFormat::format(double value, bool floorToStep, char* out) const {
+    // 换算为最小单位整数，加少量epsilon抵消二进制浮点误差（如0.3/0.1）
+    double units = value * scale_ / static_cast<double>(stepUnits_);
+    int64_t steps = floorToStep ? static_cast<int64_t>(std::floor(units + 1e-9))
+                                : static_cast<int64_t>(std::llround(units));
+    int64_t scaled = steps * stepUnits_;
+
+    size_t n = 0;
+    if (scaled < 0) {
+        out[n++] = '-';
+        scaled = -scaled;
+    }
+
+    uint64_t divisor = static_cast<uint64_t>(scale_);
+    uint64_t integerPart = static_cast<uint64_t>(scaled) / divisor;
+    uint64_t fractionPart = static_cast<uint64_t>(scaled) % divisor;
+    n += writeUnsigned(integerPart, out + n);
+
+    int digits = decimals_;
+    if (trimZeros_) {
+        while (digits > 0 && fractionPart % 10 == 0) {
+            fractionPart /= 10;
+            --digits;
+        }
+    }
+
+    if (digits > 0) {
+        out[n++] = '.';
+        for (int i = digits - 1; i >= 0; --i) {
+            out[n + i] = static_cast<char>('0' + fractionPart % 10);
+            fractionPart /= 10;
+        }
+        n += digits;
+    }
+    return n;
+}
+
+std::string DecimalFormat::toString(double value, bool floorToStep) const {
+    char buf[MAX_LENGTH];
+    return std::string(buf, format(value, floorToStep, buf));
+}
+
+OrderTemplate::OrderTemplate(const OrderTemplateSpec& spec)
+    : spec_(spec)
+    , quantityFormat_(spec.stepSize)
+    , priceFormat_(spec.tickSize)
+    , hasPrice_(spec.type != "MARKET" && spec.type != "STOP_MARKET" && spec.type != "TAKE_PROFIT_MARKET")
+{
+    // 字段顺序与BinanceWebSocket::placeOrder保持一致，常量部分一次性渲染
+    prefix_ = "{\"method\":\"order.place\",\"params\":{\"symbol\":\"" + spec.symbol + "\""
+              ",\"type\":\"" + spec.type + "\"";
+    if (!spec.positionSide.empty()) {
+        prefix_ += ",\"positionSide\":\"" + spec.positionSide + "\"";
+    }
+    if (!spec.timeInForce.empty()) {
+        prefix_ += ",\"timeInForce\":\"" + spec.timeInForce + "\"";
+    }
+    if (!spec.closePosition.empty()) {
+        prefix_ += ",\"closePosition\":" + spec.closePosition;
+    }
+    if (!spec.reduceOnly.empty()) {
+        prefix_ += ",\"reduceOnly\":" + spec.reduceOnly;
+    }
+    if (!spec.newOrderRespType.empty()) {
+        prefix_ += ",\"newOrderRespType\":\"" + spec.newOrderRespType + "\"";
+    }
+    prefix_ += ",\"side\":\"";
+}
+
+size_t OrderTemplate::render(char* buf, size_t cap, int64_t requestId, bool isBuy,
+                             double quantity, double price, const char* clientOrderId,
+                             int64_t timestamp) const {
+    size_t clientIdLen = clientOrderId ? std::strlen(clientOrderId) : 0;
+
+    // 可变部分上限：方向+数量+价格+订单号+时间戳+请求ID+固定分隔符
+    size_t worstCase = prefix_.size() + 2 * DecimalFormat::MAX_LENGTH + clientIdLen + 160;
+    if (worstCase > cap) {
+        return 0;
+    }
+
+    char* p = buf;
+    p += writeLiteral(prefix_.data(), prefix_.size(), p);
+    p += isBuy ? WRITE_LITERAL("BUY", p) : WRITE_LITERAL("SELL", p);
+
+    p += WRITE_LITERAL("\",\"quantity\":\"", p);
+    p += quantityFormat_.format(quantity, true, p);
+
+    if (hasPrice_) {
+        p += WRITE_LITERAL("\",\"price\":\"", p);
+        p += priceFormat_.format(price, false, p);
+    }
+
+    if (clientIdLen > 0) {
+        p += WRITE_LITERAL("\",\"newClientOrderId\":\"", p);
+        p += writeLiteral(clientOrderId, clientIdLen, p);
+    }
+
+    p += WRITE_LITERAL("\",\"timestamp\":", p);
+    p += writeSigned(timestamp, p);
+
+    p += WRITE_LITERAL("},\"id\":\"", p);
+    p += writeSigned(requestId, p);
+    p += WRITE_LITERAL("\"}", p);
+
+    return static_cast<size_t>(p - buf);
+}
+
+#undef WRITE_LITERAL
+
+} // namespace trading
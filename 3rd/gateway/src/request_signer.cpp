@@ -0,0 +1,203 @@
+#include "request_signer.h"
+#include <iostream>
+#include <cstring>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/sha.h>
+#include <openssl/crypto.h>
+
+namespace trading {
+
+namespace {
+constexpr size_t SHA256_BLOCK_SIZE = 64;
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+}
+
+RequestSigner::RequestSigner()
+    : hmacInner_(nullptr)
+    , hmacOuter_(nullptr)
+    , hmacWork_(nullptr)
+    , hmacReady_(false)
+    , ed25519Pkey_(nullptr)
+    , ed25519Ctx_(nullptr)
+    , ed25519Ready_(false)
+{
+}
+
+RequestSigner::~RequestSigner() {
+    releaseHmac();
+    releaseEd25519();
+}
+
+void RequestSigner::releaseHmac() {
+    hmacReady_ = false;
+    EVP_MD_CTX_free(hmacInner_);
+    EVP_MD_CTX_free(hmacOuter_);
+    EVP_MD_CTX_free(hmacWork_);
+    hmacInner_ = nullptr;
+    hmacOuter_ = nullptr;
+    hmacWork_ = nullptr;
+}
+
+void RequestSigner::releaseEd25519() {
+    ed25519Ready_ = false;
+    EVP_MD_CTX_free(ed25519Ctx_);
+    EVP_PKEY_free(ed25519Pkey_);
+    ed25519Ctx_ = nullptr;
+    ed25519Pkey_ = nullptr;
+}
+
+bool RequestSigner::initHmac(const std::string& secret) {
+    std::lock_guard<std::mutex> lock(hmacMutex_);
+    releaseHmac();
+
+    // 按RFC 2104规范化密钥：超过块长度时先做一次SHA256
+    unsigned char key[SHA256_BLOCK_SIZE] = {0};
+    if (secret.size() > SHA256_BLOCK_SIZE) {
+        unsigned int keyLen = 0;
+        EVP_Digest(secret.data(), secret.size(), key, &keyLen, EVP_sha256(), nullptr);
+    } else {
+        std::memcpy(key, secret.data(), secret.size());
+    }
+
+    unsigned char ipad[SHA256_BLOCK_SIZE];
+    unsigned char opad[SHA256_BLOCK_SIZE];
+    for (size_t i = 0; i < SHA256_BLOCK_SIZE; ++i) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+    OPENSSL_cleanse(key, sizeof(key));
+
+    hmacInner_ = EVP_MD_CTX_new();
+    hmacOuter_ = EVP_MD_CTX_new();
+    hmacWork_ = EVP_MD_CTX_new();
+    bool ok = hmacInner_ && hmacOuter_ && hmacWork_
+        && EVP_DigestInit_ex(hmacInner_, EVP_sha256(), nullptr) > 0
+        && EVP_DigestUpdate(hmacInner_, ipad, sizeof(ipad)) > 0
+        && EVP_DigestInit_ex(hmacOuter_, EVP_sha256(), nullptr) > 0
+        && EVP_DigestUpdate(hmacOuter_, opad, sizeof(opad)) > 0;
+    OPENSSL_cleanse(ipad, sizeof(ipad));
+    OPENSSL_cleanse(opad, sizeof(opad));
+
+    if (!ok) {
+        std::cerr << "Failed to prepare HMAC-SHA256 signing context" << std::endl;
+        releaseHmac();
+        return false;
+    }
+
+    hmacReady_ = true;
+    return true;
+}
+
+bool RequestSigner::initEd25519FromFile(const std::string& keyPath) {
+    std::lock_guard<std::mutex> lock(ed25519Mutex_);
+    releaseEd25519();
+
+    BIO* bio = BIO_new_file(keyPath.c_str(), "r");
+    if (!bio) {
+        std::cerr << "Failed to open Ed25519 private key file: " << keyPath << std::endl;
+        return false;
+    }
+
+    ed25519Pkey_ = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+
+    if (!ed25519Pkey_) {
+        std::cerr << "Failed to load Ed25519 private key from PEM format" << std::endl;
+        return false;
+    }
+
+    ed25519Ctx_ = EVP_MD_CTX_new();
+    if (!ed25519Ctx_) {
+        std::cerr << "Failed to create MD context" << std::endl;
+        releaseEd25519();
+        return false;
+    }
+
+    ed25519Ready_ = true;
+    return true;
+}
+
+size_t RequestSigner::signHmacSha256(const char* data, size_t len, char* out, size_t outSize) {
+    unsigned char innerHash[SHA256_DIGEST_LENGTH];
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    unsigned int hashLen = 0;
+
+    if (outSize < SHA256_DIGEST_LENGTH * 2 + 1) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(hmacMutex_);
+        if (!hmacReady_) {
+            return 0;
+        }
+
+        // inner = H((K^ipad) || data)
+        if (EVP_MD_CTX_copy_ex(hmacWork_, hmacInner_) <= 0
+            || EVP_DigestUpdate(hmacWork_, data, len) <= 0
+            || EVP_DigestFinal_ex(hmacWork_, innerHash, &hashLen) <= 0) {
+            return 0;
+        }
+
+        // outer = H((K^opad) || inner)
+        if (EVP_MD_CTX_copy_ex(hmacWork_, hmacOuter_) <= 0
+            || EVP_DigestUpdate(hmacWork_, innerHash, hashLen) <= 0
+            || EVP_DigestFinal_ex(hmacWork_, hash, &hashLen) <= 0) {
+            return 0;
+        }
+    }
+
+    for (unsigned int i = 0; i < hashLen; ++i) {
+        out[i * 2] = HEX_DIGITS[hash[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[hash[i] & 0x0f];
+    }
+    out[hashLen * 2] = '\0';
+    return hashLen * 2;
+}
+
+size_t RequestSigner::signEd25519(const char* data, size_t len, char* out, size_t outSize) {
+    unsigned char signature[64];
+    size_t siglen = sizeof(signature);
+
+    // base64输出长度为4*ceil(64/3)=88，EVP_EncodeBlock会额外写入\0
+    if (outSize < ((sizeof(signature) + 2) / 3) * 4 + 1) {
+        return 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(ed25519Mutex_);
+        if (!ed25519Ready_) {
+            return 0;
+        }
+
+        // 复用上下文，仅重新绑定已解析的私钥
+        if (EVP_DigestSignInit(ed25519Ctx_, nullptr, nullptr, nullptr, ed25519Pkey_) <= 0) {
+            std::cerr << "Failed to initialize Ed25519 signing" << std::endl;
+            return 0;
+        }
+
+        if (EVP_DigestSign(ed25519Ctx_, signature, &siglen,
+                           reinterpret_cast<const unsigned char*>(data), len) <= 0) {
+            std::cerr << "Failed to generate Ed25519 signature" << std::endl;
+            return 0;
+        }
+    }
+
+    int encoded = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out), signature, static_cast<int>(siglen));
+    return encoded > 0 ? static_cast<size_t>(encoded) : 0;
+}
+
+std::string RequestSigner::signHmacSha256(const std::string& data) {
+    char buffer[MAX_SIGNATURE_LENGTH];
+    size_t n = signHmacSha256(data.data(), data.size(), buffer, sizeof(buffer));
+    return std::string(buffer, n);
+}
+
+std::string RequestSigner::signEd25519(const std::string& data) {
+    char buffer[MAX_SIGNATURE_LENGTH];
+    size_t n = signEd25519(data.data(), data.size(), buffer, sizeof(buffer));
+    return std::string(buffer, n);
+}
+
+} // namespace trading
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 禁止分配区域内发生分配时的处理方式
+enum class AllocationPolicy : uint8_t {
+    COUNT = 0,      // 只计数
+    REPORT = 1,     // 计数，并向stderr输出前若干次违规
+    ABORT = 2       // 输出后abort()，用于回归测试
+};
+
+// 线程累计分配计数
+struct AllocationCounters {
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t bytes_allocated;
+};
+
+// 按区域名汇总，同名的区域（同一调用点）共用一份
+struct AllocationRegionStats {
+    static constexpr size_t MAX_NAME_LENGTH = 48;
+
+    char name[MAX_NAME_LENGTH];
+    std::atomic<uint64_t> entries;
+    std::atomic<uint64_t> violating_entries;    // 至少分配过一次的进入次数
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+};
+
+struct AllocationRegionReport {
+    std::string name;
+    uint64_t entries;
+    uint64_t violating_entries;
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+/**
+ * 全局分配跟踪
+ * 定义TES_ENABLE_ALLOCATION_TRACKING时替换全局operator new/delete，按线程计数（thread_local，不加锁）；
+ * 未定义时不替换，计数恒为0，TES_NO_ALLOC_REGION编译为空语句。
+ * 违规处理策略默认取环境变量TES_ALLOC_POLICY（count/report/abort），未设置时为report。
+ */
+class AllocationTracker {
+public:
+    static constexpr size_t MAX_REGIONS = 32;
+    static constexpr uint64_t MAX_REPORTED_VIOLATIONS = 16;    // report策略下进程内最多输出的违规条数
+
+    // 是否编译了分配钩子
+    static bool enabled();
+
+    static AllocationCounters thread_counters();
+
+    static AllocationPolicy policy();
+    static void set_policy(AllocationPolicy policy);
+
+    // 超过MAX_REGIONS时返回nullptr，该区域不统计
+    static AllocationRegionStats* register_region(const char* name);
+    static std::vector<AllocationRegionReport> get_region_reports();
+    static std::string generate_report();
+
+    // 由operator new/delete调用
+    static void on_allocate(size_t size);
+    static void on_deallocate();
+};
+
+// 禁止分配区域：作用域内当前线程的每次分配都记为违规；可以嵌套，违规计入最内层区域
+class ScopedNoAllocRegion {
+public:
+    explicit ScopedNoAllocRegion(AllocationRegionStats* stats);
+    explicit ScopedNoAllocRegion(const char* name);
+    ~ScopedNoAllocRegion();
+
+    ScopedNoAllocRegion(const ScopedNoAllocRegion&) = delete;
+    ScopedNoAllocRegion& operator=(const ScopedNoAllocRegion&) = delete;
+
+    const char* name() const { return stats_ ? stats_->name : "unregistered"; }
+    uint64_t allocations() const { return allocations_; }
+
+private:
+    friend class AllocationTracker;
+
+    void enter();
+
+    AllocationRegionStats* stats_;
+    ScopedNoAllocRegion* parent_;
+    uint64_t allocations_;
+};
+
+#define TES_ALLOC_CONCAT_IMPL(a, b) a##b
+#define TES_ALLOC_CONCAT(a, b) TES_ALLOC_CONCAT_IMPL(a, b)
+
+// 每个调用点只在首次执行时登记区域名
+#ifdef TES_ENABLE_ALLOCATION_TRACKING
+#define TES_NO_ALLOC_REGION(name) \
+    static ::tes::execution::AllocationRegionStats* const TES_ALLOC_CONCAT(_tes_alloc_region_stats_, __LINE__) = \
+        ::tes::execution::AllocationTracker::register_region(name); \
+    ::tes::execution::ScopedNoAllocRegion TES_ALLOC_CONCAT(_tes_no_alloc_region_, __LINE__)( \
+        TES_ALLOC_CONCAT(_tes_alloc_region_stats_, __LINE__))
+#else
+#define TES_NO_ALLOC_REGION(name) do { } while (0)
+#endif
+
+} // namespace execution
+} // namespace tes
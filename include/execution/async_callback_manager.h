@@ -34,20 +34,19 @@ struct AsyncCallbackEvent {
     std::chrono::high_resolution_clock::time_point timestamp;
     std::string data; // JSON格式的事件数据
     
-    AsyncCallbackEvent() : type(CallbackEventType::ORDER_CREATED), 
-                          timestamp(std::chrono::high_resolution_clock::now()) {}
+    AsyncCallbackEvent() : type(CallbackEventType::ORDER_CREATED) {}
     
-    AsyncCallbackEvent(CallbackEventType t, const std::string& eid, const std::string& d)
-        : type(t), execution_id(eid), data(d), 
-          timestamp(std::chrono::high_resolution_clock::now()) {
+    // 事件时间由调用方传入，事件ID也据此生成，构造时不读时钟
+    AsyncCallbackEvent(CallbackEventType t, const std::string& eid, const std::string& d,
+                       std::chrono::high_resolution_clock::time_point ts)
+        : type(t), execution_id(eid), timestamp(ts), data(d) {
         event_id = generate_event_id();
     }
     
 private:
     std::string generate_event_id() const {
         static std::atomic<uint64_t> counter{0};
-        auto now = std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        auto now = std::chrono::duration_cast<std::chrono::microseconds>(timestamp.time_since_epoch()).count();
         return "evt_" + std::to_string(now) + "_" + std::to_string(counter.fetch_add(1));
     }
 };
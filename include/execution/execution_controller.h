@@ -4,6 +4,7 @@
 #include <nlohmann/json_fwd.hpp>
 #include <memory>
 #include <shared_mutex>
+#include <unordered_map>
 #include <filesystem>
 
 // 前向声明
@@ -26,6 +27,10 @@ namespace md {
 #include "lockfree_queue.h"
 #include "async_callback_manager.h"
 #include "performance_monitor.h"
+#include "latency_tracer.h"
+#include "lock_profiler.h"
+#include "allocation_tracker.h"
+#include "shared_memory/core/flight_recorder.h"
 #include <memory>
 #include <atomic>
 #include <mutex>
@@ -66,6 +71,7 @@ public:
         uint32_t signal_processing_interval_ms;  // 信号处理间隔（毫秒）
         uint32_t heartbeat_interval_ms;          // 心跳间隔（毫秒）
         uint32_t statistics_update_interval_ms;  // 统计更新间隔（毫秒）
+        uint32_t clock_drift_correction_interval_ms;  // TSC时钟漂移修正间隔（毫秒）
         bool enable_risk_checking;               // 启用风险检查
         bool enable_position_tracking;           // 启用持仓跟踪
         bool enable_algorithm_execution;         // 启用算法执行
@@ -92,10 +98,20 @@ public:
         double default_participation_rate;       // 默认参与率
         uint32_t max_price_deviation_bps;        // 最大价格偏离（基点）
         
+        // 端到端延迟跟踪配置
+        bool enable_latency_tracing;             // 启用信号到成交的延迟跟踪
+        LatencyTracer::Config latency_tracer_config;  // 采样率与轨迹文件
+        
+        // 飞行记录器：崩溃后仍保留最近的事件时间线，用flight_recorder_dump查看
+        bool enable_flight_recorder;             // 启用飞行记录器
+        std::string flight_recorder_path;        // 记录文件路径，放在/dev/shm避免落盘开销
+        size_t flight_recorder_capacity;         // 事件槽数（40字节/条）
+        
         Config() : worker_thread_count(std::thread::hardware_concurrency()),
                    signal_processing_interval_ms(1),
                    heartbeat_interval_ms(1000),
                    statistics_update_interval_ms(5000),
+                   clock_drift_correction_interval_ms(1000),
                    enable_risk_checking(true),
                    enable_position_tracking(true),
                    enable_algorithm_execution(true),
@@ -110,7 +126,11 @@ public:
                    twap_min_slice_size(100.0),
                    max_twap_slices(200),
                    default_participation_rate(0.2),
-                   max_price_deviation_bps(50) {}
+                   max_price_deviation_bps(50),
+                   enable_latency_tracing(true),
+                   enable_flight_recorder(true),
+                   flight_recorder_path("/dev/shm/tes_flight_recorder"),
+                   flight_recorder_capacity(shared_memory::FlightRecorder::DEFAULT_CAPACITY) {}
     };
     
     // 事件回调函数类型
@@ -195,6 +215,7 @@ private:
     void statistics_worker();
     void setup_event_callbacks();
     void handle_order_event(const Order& order);
+    void handle_exchange_latency(ExchangeLatencyKind kind, const char* name, int64_t value_ns);
     void handle_trade_event(const Trade& trade);
     void handle_trading_rule_event(const TradingRuleEvent& event);
     void handle_position_event(const PositionEvent& event);
@@ -208,10 +229,10 @@ private:
 
     
     // 成员变量
-    mutable std::mutex config_mutex_;
-    mutable std::mutex statistics_mutex_;
-    mutable std::mutex error_mutex_;
-    mutable std::mutex callbacks_mutex_;
+    mutable NamedMutex config_mutex_ TES_LOCK_NAME("execution_controller.config");
+    mutable NamedMutex statistics_mutex_ TES_LOCK_NAME("execution_controller.statistics");
+    mutable NamedMutex error_mutex_ TES_LOCK_NAME("execution_controller.error");
+    mutable NamedMutex callbacks_mutex_ TES_LOCK_NAME("execution_controller.callbacks");
     
     Config config_;
     ExecutionStatistics statistics_;
@@ -244,6 +265,36 @@ private:
     // 性能监控器
     std::unique_ptr<PerformanceMonitor> performance_monitor_;
     
+    // 信号处理路径上预注册的指标句柄
+    struct SignalMetrics {
+        HistogramHandle queue_size;
+        HistogramHandle serial_latency;
+        HistogramHandle concurrent_latency;
+        HistogramHandle serial_throughput;
+        HistogramHandle concurrent_throughput;
+        CounterHandle serial_success;
+        CounterHandle serial_error;
+        CounterHandle concurrent_success;
+        CounterHandle concurrent_error;
+    };
+    SignalMetrics signal_metrics_;
+    
+    // 端到端延迟跟踪器
+    std::unique_ptr<LatencyTracer> latency_tracer_;
+    // 未启用追踪时飞行记录器的事件ID，与轨迹ID一样编码进clientOrderId，下单应答和成交据此关联到信号
+    std::atomic<uint64_t> next_flight_id_{0};
+    
+    // 交易所往返/处理/推送延迟与时钟偏移，按请求方法首次出现时注册往返直方图
+    struct ExchangeLatencyMetrics {
+        NamedMutex mutex TES_LOCK_NAME("execution_controller.exchange_latency");
+        std::unordered_map<std::string, HistogramHandle> request_rtt;
+        HistogramHandle exchange_processing;
+        HistogramHandle event_delivery;
+        GaugeHandle clock_offset;
+        GaugeHandle clock_uncertainty;
+    };
+    ExchangeLatencyMetrics exchange_latency_metrics_;
+    
     // 工作线程
     std::vector<std::unique_ptr<std::thread>> worker_threads_;
     
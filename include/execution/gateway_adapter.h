@@ -1,6 +1,7 @@
 #pragma once
 
 #include "types.h"
+#include "latency_tracer.h"
 #include <memory>
 #include <string>
 #include <functional>
@@ -17,6 +18,7 @@ namespace trading {
     struct AccountUpdate;
     struct PositionUpdate;
     struct OrderUpdate;
+    class OrderUpdateView;
     struct AccountBalanceResponse;
     struct AccountInfoResponse;
     struct OrderResponse;
@@ -29,6 +31,28 @@ namespace trading {
 namespace tes {
 namespace execution {
 
+/**
+ * @brief 交易所延迟样本类型
+ */
+enum class ExchangeLatencyKind {
+    REQUEST_RTT,            // WS API请求往返，name为请求方法
+    EXCHANGE_PROCESSING,    // 事件时间E减撮合时间T，name为事件类型
+    EVENT_DELIVERY,         // 事件时间E到本地接收的单向延迟（按时钟偏移校正）
+    CLOCK_OFFSET            // 交易所时间减本地时间
+};
+
+/**
+ * @brief 本地与交易所的时钟同步状态
+ */
+struct ExchangeClockStatus {
+    bool synchronized = false;
+    int64_t offset_ns = 0;          // 交易所时间 - 本地时间
+    int64_t uncertainty_ns = 0;     // 最小往返的一半加服务器时间的毫秒截断
+    int64_t min_rtt_ns = 0;
+    uint64_t offset_samples = 0;
+    uint64_t rtt_samples = 0;
+};
+
 /**
  * @brief Gateway适配器类
  * 
@@ -56,6 +80,10 @@ public:
     using PositionUpdateCallback = std::function<void(const Position&)>;
     using TradeExecutionCallback = std::function<void(const Trade&)>;
     using ErrorCallback = std::function<void(const std::string&)>;
+    // 下单链路打点：序列化完成、send()返回、收到下单应答，时间为CLOCK_MONOTONIC纳秒
+    using OrderTraceCallback = std::function<void(const char* client_order_id, TraceHop hop, int64_t ns)>;
+    // 交易所延迟样本，name只在回调期间有效，值为纳秒
+    using ExchangeLatencyCallback = std::function<void(ExchangeLatencyKind kind, const char* name, int64_t value_ns)>;
 
     // 单例模式
     static GatewayAdapter& getInstance();
@@ -93,6 +121,13 @@ public:
     void set_position_update_callback(PositionUpdateCallback callback);
     void set_trade_execution_callback(TradeExecutionCallback callback);
     void set_error_callback(ErrorCallback callback);
+    // 须在initialize之后调用；未设置时网关不产生打点开销
+    void set_order_trace_callback(OrderTraceCallback callback);
+    // 须在initialize之后调用；回调在网关接收线程中执行
+    void set_exchange_latency_callback(ExchangeLatencyCallback callback);
+
+    // 时钟同步状态，网关未创建时返回未同步
+    ExchangeClockStatus get_exchange_clock_status() const;
 
     // 错误处理
     std::string get_last_error() const;
@@ -106,12 +141,15 @@ private:
     void setup_callbacks();
     void on_account_update(const trading::AccountUpdate& update);
     void on_position_update(const trading::PositionUpdate& update);
-    void on_order_update(const trading::OrderUpdate& update);
+    void on_order_update(const trading::OrderUpdateView& update);
     void on_connection_status(trading::ConnectionStatus status);
     void on_error(const std::string& error);
 
+    // 按策略取下单限频槽位，首次出现时按RiskLimits默认值注册
+    int get_strategy_rate_limit_slot(const std::string& strategy_id);
+
     // 数据转换
-    Order convert_gateway_order_to_tes(const trading::OrderUpdate& gateway_order) const;
+    Order convert_gateway_order_to_tes(const trading::OrderUpdateView& gateway_order) const;
     tes::execution::Position convert_gateway_position_to_tes(const trading::Position& gateway_position) const;
     // trading::OrderRequest convert_tes_order_to_gateway(const Order& tes_order) const; // 移除此方法
 
@@ -131,11 +169,17 @@ private:
     PositionUpdateCallback position_update_callback_;
     TradeExecutionCallback trade_execution_callback_;
     ErrorCallback error_callback_;
+    OrderTraceCallback order_trace_callback_;
+    ExchangeLatencyCallback exchange_latency_callback_;
 
     // 缓存数据
     mutable std::mutex cache_mutex_;
     std::vector<Position> cached_positions_;
     std::map<std::string, double> cached_balances_;
+
+    // 策略 -> 下单限频槽位
+    std::mutex strategy_slot_mutex_;
+    std::map<std::string, int> strategy_rate_limit_slots_;
 };
 
 } // namespace execution
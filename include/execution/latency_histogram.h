@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 直方图快照：合并各线程分片后的计数副本，各桶不保证取自同一时刻
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;   // 按桶下标
+    uint64_t total_count;
+    uint64_t sum;
+    uint64_t min_value;
+    uint64_t max_value;
+
+    HistogramSnapshot() : total_count(0), sum(0), min_value(0), max_value(0) {}
+
+    // percentile取0~100；返回所在桶的中点，并收敛到[min_value, max_value]
+    uint64_t value_at_percentile(double percentile) const;
+    double mean() const { return total_count ? static_cast<double>(sum) / total_count : 0.0; }
+};
+
+/**
+ * HDR风格的对数-线性直方图
+ * 每个2的幂区间再线性切成32个子桶，相对误差不超过1/32；值域[0, 2^44)，更大的值记入最后一个桶。
+ * 每个记录线程按线程槽位写自己的分片，只用relaxed原子操作，不加锁、不分配内存；
+ * 读取时把所有分片逐桶相加。线程数超过MAX_SHARDS时槽位回绕共享分片，计数依然正确。
+ * 内存固定：每个分片约10KB，首次在该线程记录时分配。
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_VALUE_BITS = 44;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    static constexpr size_t MAX_SHARDS = 16;
+
+    LatencyHistogram();
+    ~LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t value);
+    void snapshot(HistogramSnapshot& snapshot) const;
+    // 清零全部分片；与并发记录同时发生时可能丢掉少量样本
+    void reset();
+
+    // 当前线程的槽位号，进程内按线程首次使用的顺序分配；其他按线程分片的计数也用它
+    static size_t thread_slot();
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(size_t index);
+    static uint64_t bucket_upper_bound(size_t index);
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> counts[BUCKET_COUNT];
+        alignas(64) std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> min_value;
+        std::atomic<uint64_t> max_value;
+
+        Shard();
+        void reset();
+    };
+
+    Shard& local_shard();
+
+    std::atomic<Shard*> shards_[MAX_SHARDS];
+};
+
+} // namespace execution
+} // namespace tes
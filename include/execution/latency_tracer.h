@@ -0,0 +1,133 @@
+#pragma once
+
+#include "performance_monitor.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 信号到成交链路上的打点位置，按发生顺序排列
+enum class TraceHop : uint8_t {
+    SHM_WRITE = 0,      // 策略写入共享内存信号缓冲区
+    SHM_READ = 1,       // 执行端从共享内存读出
+    RISK_PASS = 2,      // 交易规则检查通过
+    SERIALIZE = 3,      // 网关渲染完下单报文
+    SEND = 4,           // send()返回
+    ACK = 5,            // 收到order.place应答
+    FILL = 6            // 首次成交回报
+};
+
+constexpr size_t TRACE_HOP_COUNT = 7;
+
+const char* trace_hop_name(TraceHop hop);
+
+// 采样轨迹文件：文件头之后是定长记录的顺序追加，字段按本机字节序
+struct TraceFileHeader {
+    char magic[8];                      // "TESTRACE"
+    uint32_t version;
+    uint32_t record_size;
+};
+
+struct TraceFileRecord {
+    uint64_t trace_id;
+    uint64_t signal_id;
+    int64_t hop_ns[TRACE_HOP_COUNT];    // CLOCK_MONOTONIC纳秒，0表示该跳未发生
+    char client_order_id[40];
+    char instrument_id[32];
+};
+
+static_assert(std::is_trivially_copyable<TraceFileRecord>::value, "TraceFileRecord is written as raw bytes");
+
+/**
+ * 端到端延迟跟踪
+ * 信号读出时开启一条轨迹，轨迹ID编码进clientOrderId，网关和交易所回报据此找回轨迹，无需查表。
+ * 每跳打点时把与上一个已发生跳的间隔记入PerformanceMonitor直方图(latency_trace_<hop>)，
+ * 另记信号写入到send()、到ACK的总延迟；按1/sample_every采样的完整轨迹缓存后由flush()写入文件。
+ * 活动轨迹存放在定长环中，轨迹ID取模定位，被新轨迹覆盖后迟到的打点会被丢弃。
+ * 所有时间戳都用CLOCK_MONOTONIC，策略进程与执行进程之间可以直接相减。
+ */
+class LatencyTracer {
+public:
+    struct Config {
+        uint32_t sample_every;          // 每多少条轨迹采样一条写文件，0表示不写文件
+        std::string trace_file_path;
+
+        Config() : sample_every(100), trace_file_path("tick_to_trade_traces.bin") {}
+    };
+
+    struct Statistics {
+        uint64_t traces_started;
+        uint64_t hops_recorded;
+        uint64_t stale_marks;           // 轨迹已被覆盖或ID无法识别
+        uint64_t samples_written;
+    };
+
+    static constexpr size_t ACTIVE_TRACES = 4096;      // 必须是2的幂
+    static constexpr const char* CLIENT_ORDER_ID_PREFIX = "tr";
+
+    LatencyTracer();
+    ~LatencyTracer();
+
+    LatencyTracer(const LatencyTracer&) = delete;
+    LatencyTracer& operator=(const LatencyTracer&) = delete;
+
+    // monitor可以为空，此时只写采样文件
+    bool initialize(const Config& config, PerformanceMonitor* monitor);
+
+    // 开启轨迹；trace_id为0时由跟踪器分配。shm_write_ns/shm_read_ns为0表示该跳未知
+    uint64_t begin_trace(uint64_t trace_id, uint64_t signal_id, const char* instrument_id,
+                         int64_t shm_write_ns, int64_t shm_read_ns);
+    void mark(uint64_t trace_id, TraceHop hop, int64_t ns);
+    void mark(const char* client_order_id, TraceHop hop, int64_t ns);
+
+    // 写出缓存的采样轨迹，由后台线程定期调用
+    void flush();
+
+    Statistics get_statistics() const;
+
+    static std::string make_client_order_id(uint64_t trace_id);
+    // 不是本跟踪器生成的clientOrderId返回0
+    static uint64_t parse_client_order_id(const char* client_order_id);
+    static int64_t now_ns();
+
+private:
+    struct alignas(64) ActiveTrace {
+        std::atomic<uint64_t> trace_id{0};
+        std::atomic<int64_t> hop_ns[TRACE_HOP_COUNT];
+        std::atomic<bool> sampled{false};
+        std::atomic<bool> emitted{false};
+        uint64_t signal_id = 0;                         // 以下字段只在begin_trace中、发布trace_id之前写入
+        char instrument_id[32] = {};
+    };
+
+    void record_hop(ActiveTrace& trace, TraceHop hop, int64_t ns);
+    void emit_sample(ActiveTrace& trace);
+
+    Config config_;
+    PerformanceMonitor* monitor_;
+    HistogramHandle hop_histograms_[TRACE_HOP_COUNT];
+    HistogramHandle tick_to_send_;
+    HistogramHandle tick_to_ack_;
+
+    std::unique_ptr<ActiveTrace[]> traces_;
+    std::atomic<uint64_t> next_trace_id_;
+
+    std::mutex sample_mutex_;
+    std::vector<TraceFileRecord> pending_samples_;
+    std::ofstream trace_file_;
+
+    std::atomic<uint64_t> traces_started_{0};
+    std::atomic<uint64_t> hops_recorded_{0};
+    std::atomic<uint64_t> stale_marks_{0};
+    std::atomic<uint64_t> samples_written_{0};
+};
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "latency_histogram.h"
+#include "shared_memory/core/tsc_clock.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 单把具名锁的统计，同名的锁（如同一类的多个实例）共用一份
+struct LockStats {
+    static constexpr size_t MAX_NAME_LENGTH = 64;
+
+    char name[MAX_NAME_LENGTH];
+    LatencyHistogram wait_ns;           // 只记发生争用的获取，样本数即争用次数
+    LatencyHistogram hold_ns;           // 独占持有时间，样本数即独占获取次数
+    LatencyHistogram shared_hold_ns;    // 共享持有时间，样本数即共享获取次数
+};
+
+// 报告中的一行，时间单位为纳秒
+struct LockReport {
+    std::string name;
+    uint64_t acquisitions;
+    uint64_t shared_acquisitions;
+    uint64_t contended;
+    double contention_ratio;
+    uint64_t total_wait_ns;
+    uint64_t wait_p50_ns;
+    uint64_t wait_p99_ns;
+    uint64_t wait_max_ns;
+    uint64_t total_hold_ns;
+    uint64_t hold_p50_ns;
+    uint64_t hold_p99_ns;
+    uint64_t hold_max_ns;
+};
+
+/**
+ * 具名锁争用统计
+ * 锁在构造时按名字登记，统计对象在进程内常驻，锁销毁后数据仍保留在报告中。
+ * 直方图按线程分片，记录不加锁；只有登记和生成报告需要加锁。
+ */
+class LockProfiler {
+public:
+    static constexpr size_t MAX_LOCKS = 128;
+
+    static LockProfiler& instance();
+
+    // 超过MAX_LOCKS时返回nullptr，该锁不再统计
+    LockStats* register_lock(const char* name);
+
+    // 按累计等待时间降序
+    std::vector<LockReport> get_reports() const;
+    std::string generate_report() const;
+    void reset();
+
+private:
+    LockProfiler() : lock_count_(0) {}
+
+    mutable std::mutex registry_mutex_;
+    std::unique_ptr<LockStats> locks_[MAX_LOCKS];
+    size_t lock_count_;
+};
+
+// 先try_lock，失败才计时等待，未争用时只多一次读TSC
+class ProfiledMutex {
+public:
+    explicit ProfiledMutex(const char* name)
+        : stats_(LockProfiler::instance().register_lock(name)), hold_start_ticks_(0) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock() {
+        const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+        if (mutex_.try_lock()) {
+            hold_start_ticks_ = clock.ticks();
+            return;
+        }
+        uint64_t wait_start = clock.ticks();
+        mutex_.lock();
+        hold_start_ticks_ = clock.ticks();
+        if (stats_) {
+            stats_->wait_ns.record(clock.ticks_to_ns(hold_start_ticks_ - wait_start));
+        }
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        hold_start_ticks_ = shared_memory::TscClock::instance().ticks();
+        return true;
+    }
+
+    void unlock() {
+        const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+        uint64_t held_ticks = clock.ticks() - hold_start_ticks_;
+        mutex_.unlock();
+        if (stats_) {
+            stats_->hold_ns.record(clock.ticks_to_ns(held_ticks));
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    LockStats* stats_;
+    uint64_t hold_start_ticks_;     // 只由持有者读写
+};
+
+class ProfiledSharedMutex {
+public:
+    explicit ProfiledSharedMutex(const char* name)
+        : stats_(LockProfiler::instance().register_lock(name)), hold_start_ticks_(0) {}
+
+    ProfiledSharedMutex(const ProfiledSharedMutex&) = delete;
+    ProfiledSharedMutex& operator=(const ProfiledSharedMutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    // 共享持有者可能有多个，起始时刻记在线程本地的小栈中
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+private:
+    std::shared_mutex mutex_;
+    LockStats* stats_;
+    uint64_t hold_start_ticks_;
+};
+
+// 成员锁统一声明为NamedMutex/NamedSharedMutex，名字用TES_LOCK_NAME给出：
+//   NamedMutex orders_mutex_ TES_LOCK_NAME("order_manager.orders");
+// 定义TES_ENABLE_LOCK_PROFILING时才插桩；关闭时就是标准锁，名字不参与构造，
+// 与之配合的条件变量声明为NamedConditionVariable，关闭统计时为std::condition_variable
+#ifdef TES_ENABLE_LOCK_PROFILING
+#define TES_LOCK_NAME(name) {name}
+using NamedMutex = ProfiledMutex;
+using NamedSharedMutex = ProfiledSharedMutex;
+using NamedConditionVariable = std::condition_variable_any;
+#else
+#define TES_LOCK_NAME(name)
+using NamedMutex = std::mutex;
+using NamedSharedMutex = std::shared_mutex;
+using NamedConditionVariable = std::condition_variable;
+#endif
+
+} // namespace execution
+} // namespace tes
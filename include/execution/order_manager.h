@@ -1,12 +1,14 @@
 #pragma once
 
 #include "types.h"
+#include "lock_profiler.h"
 #include <unordered_map>
 #include <vector>
 #include <mutex>
 #include <memory>
 #include <functional>
 #include <atomic>
+#include <condition_variable>
 #include <queue>
 #include <thread>
 
@@ -123,10 +125,10 @@ private:
     void update_statistics();
     
     // 成员变量
-    mutable std::mutex orders_mutex_;
-    mutable std::mutex trades_mutex_;
-    mutable std::mutex config_mutex_;
-    mutable std::mutex statistics_mutex_;
+    mutable NamedMutex orders_mutex_ TES_LOCK_NAME("order_manager.orders");
+    mutable NamedMutex trades_mutex_ TES_LOCK_NAME("order_manager.trades");
+    mutable NamedMutex config_mutex_ TES_LOCK_NAME("order_manager.config");
+    mutable NamedMutex statistics_mutex_ TES_LOCK_NAME("order_manager.statistics");
     
     std::unordered_map<std::string, std::shared_ptr<Order>> orders_;
     std::unordered_map<std::string, std::vector<Trade>> trades_by_order_;
@@ -139,7 +141,7 @@ private:
     
     // 交易所适配器
     std::shared_ptr<ExchangeAdapter> exchange_adapter_;
-    mutable std::mutex adapter_mutex_;
+    mutable NamedMutex adapter_mutex_ TES_LOCK_NAME("order_manager.adapter");
     
     std::atomic<bool> running_;
     std::atomic<bool> initialized_;
@@ -148,6 +150,8 @@ private:
     // 清理线程相关
     std::thread cleanup_thread_;
     std::atomic<bool> cleanup_running_;
+    std::mutex cleanup_wake_mutex_;         // stop()通过条件变量唤醒，不必等满清理间隔
+    std::condition_variable cleanup_wake_cv_;
     void cleanup_worker();
 };
 
@@ -78,8 +78,9 @@ struct OrderStateInfo {
                       filled_quantity(0.0), average_price(0.0),
                       retry_count(0), state_change_count(0),
                       submit_timeout(std::chrono::milliseconds(5000)),
-                      cancel_timeout(std::chrono::milliseconds(3000)) {
-        auto now = std::chrono::high_resolution_clock::now();
+                      cancel_timeout(std::chrono::milliseconds(3000)) {}
+    
+    explicit OrderStateInfo(std::chrono::high_resolution_clock::time_point now) : OrderStateInfo() {
         state_change_time = now;
         create_time = now;
         last_update_time = now;
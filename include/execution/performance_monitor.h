@@ -1,5 +1,8 @@
 #pragma once
 
+#include "latency_histogram.h"
+#include "thread_accounting.h"
+#include "shared_memory/core/tsc_clock.h"
 #include <atomic>
 #include <chrono>
 #include <memory>
@@ -31,14 +34,10 @@ struct MetricDataPoint {
     double value;
     std::string label;
     
-    MetricDataPoint() : value(0.0) {
-        timestamp = std::chrono::high_resolution_clock::now();
-    }
+    MetricDataPoint() : value(0.0) {}
     
-    MetricDataPoint(double v, const std::string& l = "")
-        : value(v), label(l) {
-        timestamp = std::chrono::high_resolution_clock::now();
-    }
+    MetricDataPoint(std::chrono::high_resolution_clock::time_point t, double v, const std::string& l = "")
+        : timestamp(t), value(v), label(l) {}
 };
 
 // 性能统计信息
@@ -59,24 +58,52 @@ struct PerformanceStats {
     }
 };
 
+// 预注册的指标句柄：启动时按名字注册一次，热路径上只做数组下标访问
+// 下标超出注册范围的句柄（默认构造）记录时直接忽略
+constexpr uint32_t INVALID_METRIC_INDEX = 0xffffffffu;
+
+struct CounterHandle {
+    uint32_t index = INVALID_METRIC_INDEX;
+    bool valid() const { return index != INVALID_METRIC_INDEX; }
+};
+
+struct GaugeHandle {
+    uint32_t index = INVALID_METRIC_INDEX;
+    bool valid() const { return index != INVALID_METRIC_INDEX; }
+};
+
+struct HistogramHandle {
+    uint32_t index = INVALID_METRIC_INDEX;
+    bool valid() const { return index != INVALID_METRIC_INDEX; }
+};
+
 // 性能监控器
 class PerformanceMonitor {
 public:
     struct Config {
         uint32_t collection_interval_ms;   // 数据收集间隔（毫秒）
         uint32_t report_interval_ms;       // 报告间隔（毫秒）
-        size_t max_data_points;            // 最大数据点数量
+        size_t max_data_points;            // 已不再使用：指标改为固定内存的直方图，保留以兼容旧配置
         bool enable_cpu_monitoring;        // 启用CPU监控
         bool enable_memory_monitoring;     // 启用内存监控
+        bool enable_thread_monitoring;     // 启用按线程的CPU/上下文切换/排队延迟统计
+        uint32_t thread_sampling_interval_ms;  // 线程统计采样间隔（毫秒），需扫描/proc，不宜过密
+        uint32_t stall_threshold_ms;       // 监控线程睡眠超出预期多于该值时记为调度停顿，写入飞行记录器
         bool enable_file_output;           // 启用文件输出
         std::string output_file_path;      // 输出文件路径
         
         Config() : collection_interval_ms(100), report_interval_ms(5000),
                   max_data_points(1000), enable_cpu_monitoring(true),
-                  enable_memory_monitoring(true), enable_file_output(false),
+                  enable_memory_monitoring(true), enable_thread_monitoring(true),
+                  thread_sampling_interval_ms(1000), stall_threshold_ms(10),
+                  enable_file_output(false),
                   output_file_path("performance_metrics.log") {}
     };
     
+    static constexpr size_t MAX_COUNTERS = 128;
+    static constexpr size_t MAX_GAUGES = 64;
+    static constexpr size_t MAX_HISTOGRAMS = 64;
+    
     PerformanceMonitor();
     ~PerformanceMonitor();
     
@@ -95,6 +122,38 @@ public:
     void record_success(const std::string& operation);
     void record_custom_metric(const std::string& name, double value, const std::string& label = "");
     
+    // 句柄注册：同名重复注册返回同一句柄，超出容量返回无效句柄
+    // 直方图与按名字记录的指标共用命名空间，如"latency_signal_processing"
+    CounterHandle register_counter(const std::string& name);
+    GaugeHandle register_gauge(const std::string& name);
+    HistogramHandle register_histogram(const std::string& name);
+    
+    // 句柄记录：不加锁、不查表、不分配内存
+    void increment(CounterHandle handle, uint64_t count = 1) {
+        if (handle.index < MAX_COUNTERS) {
+            counter_slab().values[handle.index].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    
+    void set_gauge(GaugeHandle handle, double value) {
+        if (handle.index < MAX_GAUGES) {
+            gauges_[handle.index].store(value, std::memory_order_relaxed);
+        }
+    }
+    
+    void record(HistogramHandle handle, double value) {
+        if (handle.index < MAX_HISTOGRAMS) {
+            MetricCollection* collection = histogram_slots_[handle.index].load(std::memory_order_acquire);
+            if (collection) {
+                collection->histogram.record(to_fixed(value));
+            }
+        }
+    }
+    
+    uint64_t get_counter(CounterHandle handle) const;
+    double get_gauge(GaugeHandle handle) const;
+    PerformanceStats get_histogram_stats(HistogramHandle handle) const;
+    
     // 统计信息获取
     PerformanceStats get_latency_stats(const std::string& operation) const;
     PerformanceStats get_throughput_stats(const std::string& operation) const;
@@ -103,6 +162,8 @@ public:
     // 系统资源监控
     double get_cpu_usage() const;
     double get_memory_usage() const;
+    // 最近一个采样区间内各线程的使用情况，按CPU占用降序
+    std::vector<ThreadUsage> get_thread_usage() const;
     
     // 报告生成
     std::string generate_report() const;
@@ -117,21 +178,42 @@ public:
     void clear_metric(const std::string& name);
     
 private:
+    // 每个指标一个对数-线性直方图，值按VALUE_SCALE转为定点整数保存（延迟即为纳秒）
+    static constexpr double VALUE_SCALE = 1000.0;
+    
     struct MetricCollection {
-        std::vector<MetricDataPoint> data_points;
-        mutable std::mutex mutex;
-        PerformanceStats cached_stats;
-        bool stats_dirty;
+        LatencyHistogram histogram;
+    };
+    
+    // 计数器按线程槽位分片，读取时求和
+    struct alignas(64) CounterSlab {
+        std::atomic<uint64_t> values[MAX_COUNTERS];
         
-        MetricCollection() : stats_dirty(true) {}
+        CounterSlab() {
+            for (auto& value : values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
     };
     
+    static uint64_t to_fixed(double value) {
+        return value > 0.0 ? static_cast<uint64_t>(value * VALUE_SCALE + 0.5) : 0;
+    }
+    
+    CounterSlab& counter_slab() {
+        std::atomic<CounterSlab*>& slot = counter_slabs_[LatencyHistogram::thread_slot() % LatencyHistogram::MAX_SHARDS];
+        CounterSlab* slab = slot.load(std::memory_order_acquire);
+        return slab ? *slab : allocate_counter_slab(slot);
+    }
+    
+    CounterSlab& allocate_counter_slab(std::atomic<CounterSlab*>& slot);
+    MetricCollection& get_or_create_collection_locked(const std::string& name);
+    
     // 内部方法
     void monitoring_worker();
     void collect_system_metrics();
-    void update_stats(MetricCollection& collection);
-    PerformanceStats calculate_stats(const std::vector<MetricDataPoint>& data_points) const;
-    void cleanup_old_data(MetricCollection& collection);
+    void record_value(const std::string& name, double value);
+    PerformanceStats calculate_stats(const HistogramSnapshot& snapshot) const;
     std::string format_timestamp(const std::chrono::high_resolution_clock::time_point& tp) const;
     
     // CPU和内存监控
@@ -148,6 +230,16 @@ private:
     // 系统资源监控
     std::atomic<double> current_cpu_usage_;
     std::atomic<double> current_memory_usage_;
+    ThreadAccounting thread_accounting_;
+    std::chrono::steady_clock::time_point last_thread_sample_;  // 只在监控线程中访问
+    
+    // 句柄注册表（注册和读取时在metrics_mutex_下访问名字）
+    std::vector<std::string> counter_names_;
+    std::vector<std::string> gauge_names_;
+    std::vector<std::string> histogram_names_;
+    std::atomic<CounterSlab*> counter_slabs_[LatencyHistogram::MAX_SHARDS];
+    std::atomic<double> gauges_[MAX_GAUGES];
+    std::atomic<MetricCollection*> histogram_slots_[MAX_HISTOGRAMS];
     
     // 错误和成功计数
     std::unordered_map<std::string, std::atomic<uint64_t>> error_counts_;
@@ -190,9 +282,59 @@ private:
     std::chrono::high_resolution_clock::time_point start_time_;
 };
 
+// 宏里统一取裸指针
+inline PerformanceMonitor* metric_monitor(PerformanceMonitor* monitor) { return monitor; }
+inline PerformanceMonitor* metric_monitor(const std::unique_ptr<PerformanceMonitor>& monitor) { return monitor.get(); }
+
+// 句柄版RAII延迟测量，不复制操作名；只读TSC计数，析构时才换算成纳秒
+class ScopedLatency {
+public:
+    ScopedLatency(PerformanceMonitor* monitor, HistogramHandle handle)
+        : monitor_(monitor), handle_(handle), clock_(shared_memory::TscClock::instance()) {
+        start_ticks_ = clock_.ticks();
+    }
+    
+    ~ScopedLatency() {
+        if (monitor_) {
+            int64_t duration = clock_.ticks_to_ns(clock_.ticks() - start_ticks_);
+            monitor_->record(handle_, static_cast<double>(duration) / 1000.0);
+        }
+    }
+    
+private:
+    PerformanceMonitor* monitor_;
+    HistogramHandle handle_;
+    const shared_memory::TscClock& clock_;
+    uint64_t start_ticks_;
+};
+
 // 便利宏定义
 #define MEASURE_LATENCY(monitor, operation) \
     LatencyMeasurer _latency_measurer(monitor, operation)
 
+// 句柄记录宏：未定义TES_ENABLE_METRICS时整体编译为空语句，参数不求值
+// monitor可以是裸指针或unique_ptr
+#define TES_METRIC_CONCAT_IMPL(a, b) a##b
+#define TES_METRIC_CONCAT(a, b) TES_METRIC_CONCAT_IMPL(a, b)
+
+#ifdef TES_ENABLE_METRICS
+#define TES_METRIC_INCREMENT(monitor, handle) \
+    do { if (monitor) { (monitor)->increment(handle); } } while (0)
+#define TES_METRIC_ADD(monitor, handle, count) \
+    do { if (monitor) { (monitor)->increment(handle, count); } } while (0)
+#define TES_METRIC_SET(monitor, handle, value) \
+    do { if (monitor) { (monitor)->set_gauge(handle, value); } } while (0)
+#define TES_METRIC_RECORD(monitor, handle, value) \
+    do { if (monitor) { (monitor)->record(handle, value); } } while (0)
+#define TES_METRIC_SCOPED_LATENCY(monitor, handle) \
+    ::tes::execution::ScopedLatency TES_METRIC_CONCAT(_tes_scoped_latency_, __LINE__)(::tes::execution::metric_monitor(monitor), handle)
+#else
+#define TES_METRIC_INCREMENT(monitor, handle) do { } while (0)
+#define TES_METRIC_ADD(monitor, handle, count) do { } while (0)
+#define TES_METRIC_SET(monitor, handle, value) do { } while (0)
+#define TES_METRIC_RECORD(monitor, handle, value) do { } while (0)
+#define TES_METRIC_SCOPED_LATENCY(monitor, handle) do { } while (0)
+#endif
+
 } // namespace execution
 } // namespace tes
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 单个交易对在一轮调仓中的状态
+enum class AlignmentState : uint8_t {
+    WORKING,        // 已下单（或已有TWAP在执行），等待订单终态
+    SETTLING,       // 订单已终态，等待ACCOUNT_UPDATE把仓位推到目标
+    ALIGNED,        // 仓位已在容差内
+    FAILED          // 不可交易、无法下单或超过重试次数
+};
+
+// 下单回调的结果
+enum class AlignmentDispatch : uint8_t {
+    SUBMITTED,      // 已提交新的调整订单
+    IN_PROGRESS,    // 已有订单/TWAP在执行，本次未下单
+    REJECTED        // 无法下单（交易规则、行情缺失等）
+};
+
+// 调仓目标
+struct AlignmentTarget {
+    std::string symbol;
+    double target_quantity;
+    double current_quantity;        // 开始时的仓位，之后由仓位推送更新
+    bool tradable;                  // 交易规则预校验是否通过
+
+    AlignmentTarget() : target_quantity(0.0), current_quantity(0.0), tradable(true) {}
+};
+
+// 单个交易对的对齐进度
+struct SymbolAlignment {
+    std::string symbol;
+    double target_quantity;
+    double current_quantity;
+    double tolerance;
+    AlignmentState state;
+    uint32_t attempts;                                  // 已提交调整订单的次数
+    std::chrono::steady_clock::time_point deadline;     // 当前状态的超时点
+    double align_time_ms;                               // 从开始到进入容差的耗时，未对齐为-1
+
+    SymbolAlignment() : target_quantity(0.0), current_quantity(0.0), tolerance(0.0),
+                        state(AlignmentState::WORKING), attempts(0), align_time_ms(-1.0) {}
+};
+
+// 一轮调仓的结果
+struct AlignmentReport {
+    uint64_t rebalance_id;
+    bool success;                   // 全部交易对进入容差
+    bool timed_out;                 // 因整轮超时结束
+    double wall_time_ms;            // 从开始到最后一个交易对结束的墙钟时间
+    size_t aligned_count;
+    size_t failed_count;
+    std::vector<SymbolAlignment> symbols;
+
+    AlignmentReport() : rebalance_id(0), success(false), timed_out(false), wall_time_ms(0.0),
+                        aligned_count(0), failed_count(0) {}
+};
+
+// 调仓统计
+struct AlignmentStatistics {
+    uint64_t rebalance_count;
+    uint64_t success_count;
+    uint64_t orders_dispatched;
+    double last_wall_time_ms;
+    double max_wall_time_ms;
+    double avg_wall_time_ms;
+};
+
+/**
+ * 事件驱动的仓位对齐引擎
+ * 一轮调仓中所有交易对同时推进，各自的状态只由事件驱动：
+ * ACCOUNT_UPDATE推送的仓位变化、ORDER_TRADE_UPDATE/下单回报的订单终态，
+ * 以及内部定时器检查的超时。不再轮询账户信息，也不在订单之间阻塞等待；
+ * 最后一个交易对进入容差（或失败）时立即结束本轮并回调完成函数。
+ *
+ * 下单回调与完成回调都不在内部锁内调用；完成回调在引擎自己的线程中执行，
+ * 不占用WebSocket回调线程。
+ */
+class PositionAlignmentEngine {
+public:
+    struct Config {
+        std::chrono::milliseconds order_timeout;        // 下单后等待订单终态的上限
+        std::chrono::milliseconds settle_timeout;       // 订单终态后等待仓位推送的时间，超时按当前仓位重新下单
+        std::chrono::milliseconds rebalance_timeout;    // 整轮上限
+        uint32_t max_attempts;                          // 单个交易对最多提交的调整订单次数
+        double absolute_tolerance;
+        double relative_tolerance;                      // 相对目标仓位的容差
+
+        Config() : order_timeout(std::chrono::seconds(15)), settle_timeout(std::chrono::seconds(2)),
+                   rebalance_timeout(std::chrono::seconds(120)), max_attempts(5),
+                   absolute_tolerance(0.000001), relative_tolerance(0.05) {}
+    };
+
+    // 为symbol提交(target - current)的调整订单
+    using OrderDispatcher = std::function<AlignmentDispatch(const std::string& symbol,
+                                                            double current_quantity, double target_quantity)>;
+    using CompletionCallback = std::function<void(const AlignmentReport&)>;
+
+    PositionAlignmentEngine();
+    ~PositionAlignmentEngine();
+
+    bool initialize(const Config& config, OrderDispatcher dispatcher, CompletionCallback on_complete);
+    bool start();
+    void stop();
+
+    // 开始一轮调仓，已有进行中的轮次时返回false
+    bool begin(const std::vector<AlignmentTarget>& targets);
+    bool is_active() const { return active_.load(); }
+
+    // 事件入口（任意线程）
+    void on_position_update(const std::string& symbol, double quantity);
+    void on_order_finished(const std::string& symbol);
+
+    AlignmentStatistics get_statistics() const;
+
+private:
+    struct PendingDispatch {
+        std::string symbol;
+        double current_quantity;
+        double target_quantity;
+        uint64_t rebalance_id;
+    };
+
+    void timer_worker();
+    // 以下函数要求持有mutex_
+    void evaluate_locked(SymbolAlignment& entry, std::chrono::steady_clock::time_point now);
+    void schedule_dispatch_locked(SymbolAlignment& entry, std::chrono::steady_clock::time_point now,
+                                  std::vector<PendingDispatch>& dispatches);
+    void check_complete_locked(std::chrono::steady_clock::time_point now, bool timed_out);
+    bool within_tolerance(const SymbolAlignment& entry) const;
+
+    void run_dispatches(const std::vector<PendingDispatch>& dispatches);
+
+    Config config_;
+    OrderDispatcher dispatcher_;
+    CompletionCallback on_complete_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> running_;
+    std::atomic<bool> active_;
+    std::unique_ptr<std::thread> timer_thread_;
+
+    // 当前轮次
+    uint64_t rebalance_id_;
+    std::chrono::steady_clock::time_point begin_time_;
+    std::unordered_map<std::string, SymbolAlignment> symbols_;
+    std::unique_ptr<AlignmentReport> finished_report_;  // 待定时线程回调的结果
+
+    // 统计
+    uint64_t success_count_;
+    uint64_t orders_dispatched_;
+    double last_wall_time_ms_;
+    double max_wall_time_ms_;
+    double total_wall_time_ms_;
+};
+
+} // namespace execution
+} // namespace tes
@@ -1,16 +1,22 @@
 #pragma once
 
 #include "types.h"
+#include "lock_profiler.h"
 #include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <thread>
 #include <vector>
 
 namespace tes {
+namespace shared_memory {
+class PositionTable;
+}
+
 namespace execution {
 
 // 前向声明
@@ -159,6 +165,9 @@ public:
     void refresh_positions_from_exchange();
     void clear_stale_positions(std::chrono::seconds max_age);
     
+    // 共享内存持仓表：设置后每次成交和行情更新都写入对应行，供策略进程读取
+    void set_shared_position_table(std::shared_ptr<shared_memory::PositionTable> table);
+    
     // 策略映射功能
     void set_strategy_mapping_callback(StrategyMappingCallback callback);
     std::string map_exchange_strategy_id(const std::string& exchange_strategy_id) const;
@@ -185,13 +194,14 @@ private:
     void cleanup_zero_positions();
     void update_statistics();
     void worker_thread();
+    void publish_shared_position(const Position& position, double mark_price);   // 需持有positions_mutex_
     
     // 成员变量
-    mutable std::mutex positions_mutex_;
-    mutable std::mutex market_data_mutex_;
-    mutable std::mutex events_mutex_;
-    mutable std::mutex config_mutex_;
-    mutable std::mutex statistics_mutex_;
+    mutable NamedMutex positions_mutex_ TES_LOCK_NAME("position_manager.positions");
+    mutable NamedMutex market_data_mutex_ TES_LOCK_NAME("position_manager.market_data");
+    mutable NamedMutex events_mutex_ TES_LOCK_NAME("position_manager.events");
+    mutable NamedMutex config_mutex_ TES_LOCK_NAME("position_manager.config");
+    mutable NamedMutex statistics_mutex_ TES_LOCK_NAME("position_manager.statistics");
     
     std::unordered_map<std::string, PositionData> positions_; // position_key -> PositionData
     std::unordered_map<std::string, double> current_prices_;  // instrument_id -> price
@@ -206,15 +216,20 @@ private:
     std::atomic<uint64_t> event_sequence_;
     
     std::unique_ptr<std::thread> worker_thread_;
+    std::mutex wake_mutex_;                 // 清理间隔可达数分钟，stop()通过条件变量立即唤醒
+    std::condition_variable wake_cv_;
     
     // 交易所适配器相关
     std::shared_ptr<PositionExchangeAdapter> exchange_adapter_;
-    mutable std::mutex adapter_mutex_;
+    mutable NamedMutex adapter_mutex_ TES_LOCK_NAME("position_manager.adapter");
     
     // 策略映射相关
     StrategyMappingCallback strategy_mapping_callback_;
     std::unordered_map<std::string, std::string> strategy_mappings_; // exchange_strategy_id -> internal_strategy_id
-    mutable std::mutex strategy_mapping_mutex_;
+    mutable NamedMutex strategy_mapping_mutex_ TES_LOCK_NAME("position_manager.strategy_mapping");
+    
+    // 共享内存持仓表（受positions_mutex_保护）
+    std::shared_ptr<shared_memory::PositionTable> shared_position_table_;
 };
 
 } // namespace execution
@@ -3,11 +3,14 @@
 #include "types.h"
 #include "position_manager.h"
 #include "shared_memory_interface.h"
+#include "target_file_watcher.h"
+#include "../shared_memory/core/target_position_table.h"
 #include <memory>
 #include <atomic>
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <fstream>
 #include <nlohmann/json.hpp>
@@ -25,7 +28,8 @@ namespace execution {
 // 信号传递模式
 enum class SignalTransmissionMode {
     SHARED_MEMORY = 0,  // 共享内存模式
-    JSON_FILE = 1       // JSON文件模式
+    JSON_FILE = 1,      // JSON文件模式
+    SHARED_MEMORY_TABLE = 2 // 共享内存目标仓位表模式
 };
 
 // JSON文件仓位数据结构
@@ -64,6 +68,7 @@ public:
     struct Config {
         SignalTransmissionMode mode;
         std::string json_file_path;
+        std::string target_table_name;
         uint32_t json_update_interval_ms;
         double precision_tolerance;
         double max_position_diff;
@@ -72,6 +77,7 @@ public:
         
         Config() : mode(SignalTransmissionMode::SHARED_MEMORY),
                    json_file_path("config/pos_update.json"),
+                   target_table_name("positions"),
                    json_update_interval_ms(1000),
                    precision_tolerance(0.00001),
                    max_position_diff(0.00001),
@@ -121,6 +127,7 @@ public:
 private:
     // 内部方法
     void json_monitoring_worker();
+    void target_table_worker();
     void position_sync_worker();
     bool compare_positions_with_json(const JsonPositionUpdate& json_data, PositionSyncResult& result);
     bool align_position(const std::string& symbol, double target_quantity, PositionSyncResult& result);
@@ -157,6 +164,17 @@ private:
     // JSON文件相关
     std::chrono::high_resolution_clock::time_point last_json_update_time_;
     JsonPositionUpdate last_json_data_;
+    
+    // 文件变化由共享的TargetFileWatcher推送，不再轮询读文件
+    std::shared_ptr<TargetFileWatcher> json_watcher_;
+    uint64_t json_subscription_id_;
+    std::mutex json_event_mutex_;
+    std::condition_variable json_event_cv_;
+    bool json_changed_;
+    
+    // 共享内存目标仓位表模式：网关创建表，策略发布，确认字代替isFinished回写
+    std::unique_ptr<shared_memory::TargetPositionTable> target_table_;
+    std::atomic<uint64_t> loaded_table_generation_;
 };
 
 } // namespace execution
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 目标仓位文件中的一条仓位
+struct TargetFileEntry {
+    int id;
+    std::string symbol;
+    std::string quantity;           // 文件中的原始数量文本
+    double quantity_value;
+
+    TargetFileEntry() : id(0), quantity_value(0.0) {}
+};
+
+// 目标仓位文件的一次完整解析结果，发布后只读
+struct TargetFileSnapshot {
+    uint64_t version;                       // 每发布一次递增
+    std::vector<TargetFileEntry> targets;   // 扁平格式中带id/symbol/quantity的对象，或has_position
+    std::vector<TargetFileEntry> closed;    // no_position
+    int is_finished;                        // 未找到为-1
+    std::string errorstring;
+    double update_timestamp;
+    double booksize;
+    double targetvalue;
+    double longtarget;
+    double shorttarget;
+
+    TargetFileSnapshot() : version(0), is_finished(-1), update_timestamp(0.0), booksize(0.0),
+                           targetvalue(0.0), longtarget(0.0), shorttarget(0.0) {}
+
+    const TargetFileEntry* find_target(const std::string& symbol) const;
+};
+
+enum class TargetChangeType : uint8_t {
+    ADDED,
+    MODIFIED,
+    REMOVED
+};
+
+// 单个交易对目标的变化
+struct TargetChange {
+    std::string symbol;
+    TargetChangeType type;
+    double old_quantity;
+    double new_quantity;
+};
+
+// 推送给订阅者的增量
+struct TargetFileDelta {
+    std::shared_ptr<const TargetFileSnapshot> snapshot;
+    std::vector<TargetChange> changes;      // 只含目标有变化的交易对
+    bool status_changed;                    // isFinished/时间戳/booksize等非仓位字段或no_position有变化
+    bool initial;                           // 订阅时补发的当前快照
+
+    TargetFileDelta() : status_changed(false), initial(false) {}
+    bool symbols_changed() const;           // 有交易对新增或移除
+};
+
+/**
+ * 目标仓位文件(pos_update.json)监听器
+ * 同一路径在进程内共享一个实例：一个线程用inotify监听所在目录的
+ * IN_CLOSE_WRITE/IN_MOVED_TO（覆盖原地写入和"写临时文件再rename"两种方式），
+ * 只在文件内容变化时用yyjson解析一次，与上一次的目标集合比较后
+ * 把变化的交易对推给所有订阅者；读者随时可以无IO地取最新快照。
+ * inotify不可用时退化为按间隔检查文件修改时间。
+ *
+ * 订阅回调在监听线程中调用，应尽快返回；耗时处理请转交自己的线程。
+ */
+class TargetFileWatcher {
+public:
+    using Listener = std::function<void(const TargetFileDelta&)>;
+
+    // 获取path对应的共享实例，首次获取时加载文件并启动监听
+    static std::shared_ptr<TargetFileWatcher> acquire(const std::string& path);
+
+    ~TargetFileWatcher();
+
+    TargetFileWatcher(const TargetFileWatcher&) = delete;
+    TargetFileWatcher& operator=(const TargetFileWatcher&) = delete;
+
+    const std::string& path() const { return path_; }
+
+    // 最新快照，文件从未成功解析时返回nullptr
+    std::shared_ptr<const TargetFileSnapshot> current() const;
+
+    // 订阅变化；已有快照时立即以initial=true补发一次
+    uint64_t subscribe(Listener listener);
+    // 返回后不会再有该订阅的回调在执行（在回调内调用时除外）
+    void unsubscribe(uint64_t subscription_id);
+
+    // 立即重新读取文件（写者自己改完文件后可调用，不必等事件）；不要在回调内调用
+    bool reload();
+
+    uint64_t parse_count() const { return parse_count_.load(); }
+    bool using_inotify() const { return inotify_fd_ >= 0; }
+
+private:
+    explicit TargetFileWatcher(const std::string& path);
+
+    void start();
+    void stop();
+    void worker();
+    bool parse(const std::string& content, TargetFileSnapshot& snapshot) const;
+    void publish(std::shared_ptr<TargetFileSnapshot> snapshot);
+
+    std::string path_;
+    std::string directory_;
+    std::string file_name_;
+
+    int inotify_fd_;
+    int wake_fd_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> thread_;
+    std::chrono::milliseconds fallback_poll_interval_;
+
+    std::mutex reload_mutex_;               // 串行化读文件/比较/发布
+    std::string last_content_;
+    int64_t last_mtime_ns_;                 // 仅退化为轮询时使用
+
+    mutable std::mutex snapshot_mutex_;
+    std::shared_ptr<const TargetFileSnapshot> snapshot_;
+
+    std::mutex listeners_mutex_;
+    std::vector<std::pair<uint64_t, Listener>> listeners_;
+    uint64_t next_subscription_id_;
+    std::mutex dispatch_mutex_;             // 回调执行期间持有，unsubscribe据此等待进行中的回调
+    std::atomic<std::thread::id> dispatching_thread_;
+
+    std::atomic<uint64_t> parse_count_;
+};
+
+} // namespace execution
+} // namespace tes
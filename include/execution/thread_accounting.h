@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 线程累计计数，均自线程创建起算
+struct ThreadCounters {
+    uint64_t user_ns;
+    uint64_t system_ns;
+    uint64_t voluntary_switches;        // 主动让出（阻塞、睡眠）
+    uint64_t involuntary_switches;      // 被抢占，持续偏高说明线程在抢CPU
+    uint64_t run_ns;                    // schedstat：在CPU上运行的时间
+    uint64_t run_delay_ns;              // schedstat：可运行但在运行队列中等待的时间
+    uint64_t timeslices;
+
+    ThreadCounters() : user_ns(0), system_ns(0), voluntary_switches(0), involuntary_switches(0),
+                       run_ns(0), run_delay_ns(0), timeslices(0) {}
+};
+
+// 单个线程在最近一个采样区间内的资源使用
+struct ThreadUsage {
+    pid_t tid;
+    std::string name;
+    double user_cpu_percent;
+    double system_cpu_percent;
+    double voluntary_switches_per_sec;
+    double involuntary_switches_per_sec;
+    double run_delay_percent;           // 区间内排队等待时间占比
+    double avg_run_delay_us;            // 平均每次上CPU前的排队时间
+    ThreadCounters totals;
+
+    ThreadUsage() : tid(0), user_cpu_percent(0.0), system_cpu_percent(0.0),
+                    voluntary_switches_per_sec(0.0), involuntary_switches_per_sec(0.0),
+                    run_delay_percent(0.0), avg_run_delay_us(0.0) {}
+};
+
+/**
+ * 按线程的CPU与调度统计
+ * 定期扫描/proc/self/task/<tid>/{comm,stat,status,schedstat}，与上次采样相减得到区间内的使用率。
+ * 线程名取自comm，工作线程启动时应调用set_current_thread_name命名，否则只能看到进程名。
+ * schedstat需要内核开启CONFIG_SCHED_INFO，缺失时排队延迟为0。
+ */
+class ThreadAccounting {
+public:
+    ThreadAccounting();
+
+    // 设置当前线程名，超过15个字符的部分被截断
+    static void set_current_thread_name(const char* name);
+
+    // 当前线程的累计计数，CPU时间和切换次数来自getrusage(RUSAGE_THREAD)，不扫描目录
+    static bool read_current_thread(ThreadCounters& counters);
+    static bool read_thread(pid_t tid, ThreadCounters& counters, std::string& name);
+
+    // 扫描全部线程并返回区间使用率；首次调用只建立基线，新出现的线程下一次才有数据
+    std::vector<ThreadUsage> sample();
+    std::vector<ThreadUsage> get_last_sample() const;
+
+private:
+    std::unordered_map<pid_t, ThreadCounters> baseline_;
+    int64_t last_sample_ns_;
+    std::vector<ThreadUsage> last_sample_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace execution
+} // namespace tes
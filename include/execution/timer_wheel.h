@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+// 定时器句柄：高32位为代数，低32位为节点下标；0表示无效
+using TimerId = uint64_t;
+constexpr TimerId INVALID_TIMER_ID = 0;
+
+// 定时器统计
+struct TimerWheelStatistics {
+    uint64_t scheduled;             // 累计创建
+    uint64_t fired;                 // 累计触发
+    uint64_t cancelled;             // 累计取消
+    size_t pending;                 // 当前等待中的定时器
+    uint64_t max_lateness_us;       // 触发时刻相对到期时刻的最大延迟
+};
+
+/**
+ * 分层时间轮
+ * 一个线程承载全部延时任务，替代"每个任务一个sleep线程"的做法。
+ * 第0层256个槽、每槽一个tick；第1~3层各64个槽，逐层放大64倍，
+ * 默认1ms tick下可覆盖约18.6小时，更远的定时器挂在最外层并在级联时重新分配。
+ * 插入、取消均为O(1)；没有即将到期的定时器时线程直接睡到下一次级联点。
+ *
+ * 回调在时间轮线程中、锁外执行，应尽快返回；耗时工作请投递到其他线程。
+ * 回调内可以再次schedule或cancel。
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    explicit TimerWheel(std::chrono::microseconds tick = std::chrono::milliseconds(1));
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    bool start();
+    void stop();                    // 未触发的定时器直接丢弃
+    bool is_running() const { return running_.load(); }
+
+    // 延时执行，返回可用于取消的句柄；未启动时返回INVALID_TIMER_ID
+    TimerId schedule_after(std::chrono::microseconds delay, Callback callback);
+    // 取消尚未触发的定时器，已触发/已取消/句柄过期返回false
+    bool cancel(TimerId id);
+
+    TimerWheelStatistics get_statistics() const;
+
+private:
+    static constexpr int LEVEL0_BITS = 8;
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVELS = 4;
+    static constexpr uint32_t LEVEL0_SIZE = 1u << LEVEL0_BITS;
+    static constexpr uint32_t LEVEL_SIZE = 1u << LEVEL_BITS;
+    static constexpr uint64_t MAX_DELTA = (1ull << (LEVEL0_BITS + (LEVELS - 1) * LEVEL_BITS)) - 1;
+    static constexpr int32_t NIL = -1;
+
+    struct Node {
+        Callback callback;
+        uint64_t expires;           // 到期tick
+        uint32_t generation;        // 节点复用时递增，使旧句柄失效
+        int32_t prev;
+        int32_t next;
+        int32_t* slot;              // 所在槽的链表头，空闲节点为nullptr
+    };
+
+    void worker();
+    uint64_t current_tick() const;
+    uint64_t next_wakeup_tick_locked() const;
+
+    // 以下函数要求持有mutex_
+    void add_locked(int32_t index);
+    void unlink_locked(int32_t index);
+    void free_node_locked(int32_t index);
+    uint32_t cascade_locked(int level);
+    void advance_locked(uint64_t now, std::vector<Callback>& expired, uint64_t& max_lateness_ticks);
+
+    const std::chrono::microseconds tick_;
+    std::chrono::steady_clock::time_point epoch_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> thread_;
+
+    uint64_t wheel_tick_;                               // 下一个待处理的tick
+    int32_t level0_[LEVEL0_SIZE];
+    int32_t levels_[LEVELS - 1][LEVEL_SIZE];
+    std::vector<Node> nodes_;
+    int32_t free_list_;
+    size_t pending_;
+
+    uint64_t scheduled_count_;
+    uint64_t fired_count_;
+    uint64_t cancelled_count_;
+    uint64_t max_lateness_ticks_;
+};
+
+} // namespace execution
+} // namespace tes
@@ -1,18 +1,21 @@
 #pragma once
 
 #include "types.h"
+#include "trading_rule_table.h"
 #include "../../../3rd/gateway/include/binance_websocket.h"
 #include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <string_view>
+#include <vector>
 
 namespace tes {
 namespace execution {
 
 // 交易规则检查结果
-enum class TradingRuleCheckResult {
+enum class TradingRuleCheckResult : uint8_t {
     PASS,                        // 通过
     REJECT_SYMBOL_NOT_TRADING,   // 拒绝：交易对未开放交易
     REJECT_QUANTITY_TOO_SMALL,   // 拒绝：数量过小
@@ -57,6 +60,35 @@ struct TradingRuleLimits {
                          enable_after_hours_trading(false) {}
 };
 
+// 规则检查项掩码，与Config中的开关一一对应
+enum TradingRuleCheckMask : uint32_t {
+    CHECK_SYMBOL_STATUS = 1u << 0,
+    CHECK_QUANTITY      = 1u << 1,
+    CHECK_PRICE         = 1u << 2,
+    CHECK_PRECISION     = 1u << 3,
+    CHECK_MIN_NOTIONAL  = 1u << 4,
+    CHECK_ALL           = 0x1Fu
+};
+
+/**
+ * 批量校验输入（SoA）
+ * 一次调仓的全部订单先按交易对解析为规则表下标，再一次性向量化校验。
+ * 下标只对解析时绑定的规则表有效，因此批次记下该表，校验时使用同一张表（批次在一次调仓内用完，不跨刷新保存）。
+ * price为0表示市价单，跳过价格精度和最小名义价值检查。
+ */
+struct TradingRuleBatch {
+    TradingRuleTablePtr table;
+    std::vector<int32_t> rule_indices;
+    std::vector<double> quantities;
+    std::vector<double> prices;
+    std::vector<TradingRuleCheckResult> results;
+
+    // 绑定规则表并清空，table为nullptr时只做基本的正数检查
+    void reset(TradingRuleTablePtr rule_table);
+    void add(std::string_view symbol, double quantity, double price);
+    size_t size() const { return quantities.size(); }
+};
+
 // 交易规则检查统计
 struct TradingRuleStatistics {
     uint64_t total_checks;
@@ -105,6 +137,9 @@ public:
     
     // TWAP拆单专用检查和修正
     TradingRuleCheckResult check_twap_slice(const std::string& symbol, double slice_quantity, double price, bool is_futures = false);
+    
+    // 批量校验：结果写入batch.results，返回通过数量
+    size_t check_batch(TradingRuleBatch& batch);
     double fix_quantity_precision(const std::string& symbol, double quantity, bool is_futures = false);
     double fix_price_precision(const std::string& symbol, double price, bool is_futures = false);
     
@@ -123,28 +158,61 @@ public:
     std::vector<TradingRuleEvent> get_recent_events(uint32_t count = 100) const;
     
     // 实用方法
-    std::string get_trading_rule_result_description(TradingRuleCheckResult result) const;
+    static std::string get_trading_rule_result_description(TradingRuleCheckResult result);
+    
+    // 规则引擎：无状态、无锁，单笔与批量共用同一套规则，TradingRuleManager也直接调用。
+    // table为nullptr时跳过交易对检查，只做数量/价格的正数检查；index为NOT_FOUND时不论mask都返回REJECT_SYMBOL_NOT_FOUND
+    static TradingRuleCheckResult evaluate(const TradingRuleTable* table, int32_t index,
+                                           double quantity, double price, uint32_t mask = CHECK_ALL);
+    static size_t evaluate_batch(const TradingRuleTable* table, const int32_t* indices,
+                                 const double* quantities, const double* prices, size_t count,
+                                 uint32_t mask, TradingRuleCheckResult* results);
     
 private:
+    // 违规统计分类
+    enum ViolationCategory {
+        VIOLATION_SYMBOL = 0,
+        VIOLATION_QUANTITY,
+        VIOLATION_PRICE,
+        VIOLATION_PRECISION,
+        VIOLATION_MIN_NOTIONAL,
+        VIOLATION_CATEGORY_COUNT
+    };
+    
     // 内部方法
     std::string generate_event_id();
     void log_trading_rule_event(const TradingRuleEvent& event);
-    const void* get_symbol_info(const std::string& symbol, bool is_futures = false) const;
+    // 从TradingRuleRegistry无锁读取当前规则表，未找到时table为nullptr或返回NOT_FOUND
+    int32_t find_symbol_rule(const std::string& symbol, TradingRuleTablePtr& table) const;
+    uint32_t config_mask() const;
+    TradingRuleCheckResult run_check(const std::string& symbol, double quantity, double price, uint32_t mask);
+    void record_rejection(const std::string& symbol, TradingRuleCheckResult result,
+                          double quantity, double price, int64_t now_ns);
+    static ViolationCategory violation_category(TradingRuleCheckResult result);
+    static int64_t now_ns();
     
     // 成员变量
     mutable std::mutex events_mutex_;
     mutable std::mutex config_mutex_;
-    mutable std::mutex statistics_mutex_;
     mutable std::mutex binance_client_mutex_;
     
     std::vector<TradingRuleEvent> recent_events_;
-    Config config_;
+    Config config_;                             // 完整配置，读写都持config_mutex_
+    std::atomic<uint32_t> check_mask_;          // config_中启用的检查项，set_config更新，检查路径无锁读取
+    std::atomic<bool> log_violations_;          // config_.log_violations的副本，同上
     TradingRuleLimits limits_;
-    TradingRuleStatistics statistics_;
     std::shared_ptr<trading::BinanceWebSocket> binance_client_;
     
     std::atomic<bool> initialized_;
     std::atomic<uint64_t> event_sequence_;
+    
+    // 统计计数全部为原子变量，检查路径不加锁
+    std::atomic<uint64_t> total_checks_;
+    std::atomic<uint64_t> passed_checks_;
+    std::atomic<uint64_t> rejected_checks_;
+    std::atomic<uint64_t> violations_[VIOLATION_CATEGORY_COUNT];
+    std::atomic<int64_t> last_check_ns_;
+    std::atomic<int64_t> last_violation_ns_;
 };
 
 } // namespace execution
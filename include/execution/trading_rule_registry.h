@@ -0,0 +1,114 @@
+#pragma once
+
+#include "trading_rule_table.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace tes {
+namespace execution {
+
+/**
+ * 交易规则注册表（进程内唯一）
+ * 当前规则表以原子指针发布(RCU)：写者在后台完整构建新表后一次性替换指针，
+ * 读者只做一次acquire加载，不加锁、不改引用计数，不会看到构建到一半的表。
+ * 被替换的旧表不立即释放：注册表保留最近RETAINED_TABLES个版本，
+ * 一张表在其后又发布了RETAINED_TABLES-1个版本时才释放。
+ * 读者拿到的指针只在一次校验/一个批次内使用，不能跨越多次发布长期持有；
+ * 需要最新规则时应重新调用current()。
+ */
+class TradingRuleRegistry {
+public:
+    static constexpr size_t RETAINED_TABLES = 8;    // 刷新周期为分钟级，足以覆盖任何单次校验
+
+    static TradingRuleRegistry& getInstance();
+
+    // 读者接口：一次acquire加载，未发布任何表时返回nullptr
+    TradingRuleTablePtr current() const { return current_.load(std::memory_order_acquire); }
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+    // 写者接口：发布新表，同时释放RETAINED_TABLES个版本之前的旧表
+    void publish(std::unique_ptr<TradingRuleTable> table);
+
+private:
+    TradingRuleRegistry();
+    ~TradingRuleRegistry();
+    TradingRuleRegistry(const TradingRuleRegistry&) = delete;
+    TradingRuleRegistry& operator=(const TradingRuleRegistry&) = delete;
+
+    std::atomic<TradingRuleTablePtr> current_;
+    std::atomic<uint64_t> version_;
+
+    std::mutex publish_mutex_;          // 串行化写者，保证version_与发布顺序一致
+    std::unique_ptr<const TradingRuleTable> retained_[RETAINED_TABLES];    // 按版本号取模，含当前表
+};
+
+// 交易规则刷新统计
+struct ExchangeRulesRefreshStatistics {
+    uint64_t refresh_count;         // 发布新表次数
+    uint64_t unchanged_count;       // 内容未变化、跳过重建的次数
+    uint64_t failure_count;         // 拉取或解析失败次数
+    uint64_t last_success_ms;       // 最近一次成功拉取的时间（unix毫秒）
+    uint64_t last_build_us;         // 最近一次解析+构建耗时
+    size_t symbol_count;            // 当前表中交易对数量
+};
+
+/**
+ * 交易规则后台刷新器
+ * 周期性从本地文件或HTTP接口拉取exchangeInfo，在后台线程完成解析和建表，
+ * 通过TradingRuleRegistry原子发布；内容未变化时跳过重建。
+ * 热路径上的读者只访问注册表，与刷新线程没有任何锁竞争。
+ */
+class ExchangeRulesRefresher {
+public:
+    struct Config {
+        std::string source;             // http(s)://开头为HTTP接口，否则视为本地exchangeInfo JSON文件
+        std::string api_key;            // HTTP请求的X-MBX-APIKEY，可为空
+        std::string snapshot_path;      // 发布后写入二进制快照，空则不写
+        std::string json_path;          // 发布后原样保存JSON，空则不写
+        std::chrono::milliseconds refresh_interval;
+        int http_timeout_s;
+
+        Config() : refresh_interval(std::chrono::minutes(15)), http_timeout_s(10) {}
+    };
+
+    ExchangeRulesRefresher();
+    ~ExchangeRulesRefresher();
+
+    bool start(const Config& config);
+    void stop();
+    bool is_running() const { return running_.load(); }
+
+    // 立即拉取一次（在调用线程执行），成功发布或内容未变化时返回true
+    bool refresh_now();
+
+    ExchangeRulesRefreshStatistics get_statistics() const;
+
+private:
+    void refresh_worker();
+    bool fetch(std::string& body) const;
+
+    Config config_;
+    std::atomic<bool> running_;
+    std::unique_ptr<std::thread> refresh_thread_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+
+    std::mutex refresh_mutex_;          // 串行化refresh_now与后台刷新
+    uint64_t last_content_hash_;
+
+    std::atomic<uint64_t> refresh_count_;
+    std::atomic<uint64_t> unchanged_count_;
+    std::atomic<uint64_t> failure_count_;
+    std::atomic<uint64_t> last_success_ms_;
+    std::atomic<uint64_t> last_build_us_;
+};
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace tes {
+namespace execution {
+
+// 交易对状态
+enum class SymbolTradingStatus : uint8_t {
+    UNKNOWN = 0,
+    TRADING = 1,     // 正常交易
+    SUSPENDED = 2    // 非TRADING状态（待上线、暂停、下架等）
+};
+
+// 单个交易对的交易规则（构建规则表的输入）
+struct SymbolRule {
+    std::string symbol;
+    SymbolTradingStatus status;
+    int32_t quantity_precision;
+    int32_t price_precision;
+    double min_qty;
+    double max_qty;
+    double step_size;
+    double tick_size;
+    double min_notional;
+
+    SymbolRule() : status(SymbolTradingStatus::UNKNOWN), quantity_precision(0), price_precision(0)
+                 , min_qty(0.0), max_qty(0.0), step_size(0.0), tick_size(0.0), min_notional(0.0) {}
+};
+
+/**
+ * 不可变交易规则表
+ * 规则按列(SoA)连续存放，交易对通过构建时生成的完美哈希(hash-and-displace)
+ * 映射到稠密下标。表构建后只读，查询无需加锁；内存布局即快照文件格式，
+ * 可直接写盘并在冷启动时通过mmap加载，跳过exchangeInfo的下载和JSON解析。
+ */
+class TradingRuleTable {
+public:
+    static constexpr int32_t NOT_FOUND = -1;
+    static constexpr size_t MAX_SYMBOL_LENGTH = 32;   // 含结尾\0
+
+    ~TradingRuleTable();
+
+    TradingRuleTable(const TradingRuleTable&) = delete;
+    TradingRuleTable& operator=(const TradingRuleTable&) = delete;
+
+    // 构建与解析
+    static std::unique_ptr<TradingRuleTable> build(const std::vector<SymbolRule>& rules, uint64_t created_ms = 0);
+    static bool parse_exchange_info(const std::string& json_data, std::vector<SymbolRule>& rules);
+
+    // 快照读写（写入采用临时文件+rename，保证读者不会看到半个文件）
+    static std::unique_ptr<TradingRuleTable> load_snapshot(const std::string& path);
+    bool save_snapshot(const std::string& path) const;
+
+    // 查询
+    int32_t find(std::string_view symbol) const;
+    size_t size() const { return count_; }
+    uint64_t created_ms() const;
+    bool is_mapped() const { return mapped_ != nullptr; }
+
+    // 按下标访问，调用方保证 0 <= index < size()
+    std::string_view symbol(int32_t index) const;
+    SymbolTradingStatus status(int32_t index) const { return static_cast<SymbolTradingStatus>(status_[index]); }
+    int32_t quantity_precision(int32_t index) const { return quantity_precision_[index]; }
+    int32_t price_precision(int32_t index) const { return price_precision_[index]; }
+    double min_qty(int32_t index) const { return min_qty_[index]; }
+    double max_qty(int32_t index) const { return max_qty_[index]; }
+    double step_size(int32_t index) const { return step_size_[index]; }
+    double tick_size(int32_t index) const { return tick_size_[index]; }
+    double min_notional(int32_t index) const { return min_notional_[index]; }
+    SymbolRule rule(int32_t index) const;
+
+    // 列访问（批量校验用）
+    const double* min_qty_column() const { return min_qty_; }
+    const double* max_qty_column() const { return max_qty_; }
+    const double* step_size_column() const { return step_size_; }
+    const double* tick_size_column() const { return tick_size_; }
+    const double* min_notional_column() const { return min_notional_; }
+    const uint8_t* status_column() const { return status_; }
+
+private:
+    struct SnapshotHeader;
+
+    TradingRuleTable();
+    bool bind(const uint8_t* data, size_t size);
+
+    static uint64_t hash_symbol(std::string_view symbol);
+    static uint32_t slot_for(uint64_t hash, uint32_t displacement, uint32_t slot_count);
+
+    // 存储：堆上构建或mmap映射，二者只有一个有效
+    std::vector<uint8_t> storage_;
+    void* mapped_;
+    size_t mapped_size_;
+
+    // 指向存储内部的各段
+    const SnapshotHeader* header_;
+    const uint32_t* displacements_;
+    const uint32_t* slots_;
+    const char* symbols_;
+    const double* min_qty_;
+    const double* max_qty_;
+    const double* step_size_;
+    const double* tick_size_;
+    const double* min_notional_;
+    const int32_t* quantity_precision_;
+    const int32_t* price_precision_;
+    const uint8_t* status_;
+    uint32_t count_;
+    uint32_t bucket_count_;
+    uint32_t slot_count_;
+};
+
+// 已发布规则表的只读指针：由TradingRuleRegistry保留最近若干版本，
+// 读者只在一次校验/一个批次内使用，不跨越多次发布持有
+using TradingRuleTablePtr = const TradingRuleTable*;
+
+} // namespace execution
+} // namespace tes
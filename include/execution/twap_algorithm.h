@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../common/common_types.h"
+#include "lock_profiler.h"
 #include "types.h"
 #include "order_manager.h"
 #include "thread_pool.h"
@@ -144,15 +145,15 @@ private:
     std::shared_ptr<GatewayAdapter> gateway_adapter_;
     std::unique_ptr<ThreadPool> execution_thread_pool_;
     
-    mutable std::shared_mutex executions_mutex_;
-    mutable std::mutex slices_mutex_;
-    mutable std::shared_mutex market_data_mutex_;
-    mutable std::mutex config_mutex_;
-    mutable std::mutex statistics_mutex_;
+    mutable NamedSharedMutex executions_mutex_ TES_LOCK_NAME("twap_algorithm.executions");
+    mutable NamedMutex slices_mutex_ TES_LOCK_NAME("twap_algorithm.slices");
+    mutable NamedSharedMutex market_data_mutex_ TES_LOCK_NAME("twap_algorithm.market_data");
+    mutable NamedMutex config_mutex_ TES_LOCK_NAME("twap_algorithm.config");
+    mutable NamedMutex statistics_mutex_ TES_LOCK_NAME("twap_algorithm.statistics");
     
     // 按标的分组的执行队列
     std::unordered_map<std::string, std::queue<std::string>> instrument_execution_queues_;
-    mutable std::mutex instrument_queues_mutex_;
+    mutable NamedMutex instrument_queues_mutex_ TES_LOCK_NAME("twap_algorithm.instrument_queues");
     
     std::unordered_map<std::string, std::shared_ptr<execution::AlgorithmExecution>> executions_;
     std::unordered_map<std::string, std::vector<ExecutionSlice>> execution_slices_;
@@ -8,6 +8,9 @@
 namespace tes {
 namespace execution {
 
+// 下列热路径结构体的构造函数不读时钟：默认构造的时间字段为纪元零点，
+// 需要时间戳的调用方用带时间点的构造函数传入（通常取自TscClock）
+
 // 订单状态
 enum class OrderStatus {
     PENDING,        // 待处理
@@ -62,10 +65,12 @@ struct Order {
     
     Order() : type(OrderType::MARKET), side(OrderSide::BUY), time_in_force(TimeInForce::GTC),
               quantity(0.0), price(0.0), filled_quantity(0.0), average_price(0.0),
-              status(OrderStatus::PENDING) {
-        create_time = std::chrono::high_resolution_clock::now();
-        update_time = create_time;
-        timestamp = create_time;
+              status(OrderStatus::PENDING) {}
+    
+    explicit Order(std::chrono::high_resolution_clock::time_point now) : Order() {
+        create_time = now;
+        update_time = now;
+        timestamp = now;
     }
 };
 
@@ -80,8 +85,10 @@ struct Trade {
     std::chrono::high_resolution_clock::time_point trade_time;
     double commission;
     
-    Trade() : side(OrderSide::BUY), quantity(0.0), price(0.0), commission(0.0) {
-        trade_time = std::chrono::high_resolution_clock::now();
+    Trade() : side(OrderSide::BUY), quantity(0.0), price(0.0), commission(0.0) {}
+    
+    explicit Trade(std::chrono::high_resolution_clock::time_point now) : Trade() {
+        trade_time = now;
     }
 };
 
@@ -98,8 +105,10 @@ struct Position {
     std::chrono::high_resolution_clock::time_point update_time;
     
     Position() : long_quantity(0.0), short_quantity(0.0), net_quantity(0.0),
-                 average_cost(0.0), unrealized_pnl(0.0), realized_pnl(0.0) {
-        update_time = std::chrono::high_resolution_clock::now();
+                 average_cost(0.0), unrealized_pnl(0.0), realized_pnl(0.0) {}
+    
+    explicit Position(std::chrono::high_resolution_clock::time_point now) : Position() {
+        update_time = now;
     }
 };
 
@@ -177,8 +186,10 @@ struct MarketData {
     std::chrono::high_resolution_clock::time_point timestamp;
     
     MarketData() : bid_price(0.0), ask_price(0.0), bid_size(0.0),
-                   ask_size(0.0), last_price(0.0), volume(0.0) {
-        timestamp = std::chrono::high_resolution_clock::now();
+                   ask_size(0.0), last_price(0.0), volume(0.0) {}
+    
+    explicit MarketData(std::chrono::high_resolution_clock::time_point now) : MarketData() {
+        timestamp = now;
     }
 };
 
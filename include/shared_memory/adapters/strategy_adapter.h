@@ -85,6 +85,55 @@ public:
         return impl_->receive_order_feedbacks_batch(feedbacks, max_count);
     }
 
+    /// 阻塞等待订单反馈，超时返回false
+    bool wait_for_feedback(std::chrono::microseconds timeout) {
+        return impl_->wait_for_feedback(timeout);
+    }
+
+    /**
+     * @brief 订阅共享内存行情
+     * @param symbols 交易对列表
+     * @return true 订阅成功，false 行情段不存在
+     */
+    bool subscribe_market_data(const std::vector<std::string>& symbols) {
+        return impl_->subscribe_market_data(symbols);
+    }
+
+    /// 取消订阅共享内存行情
+    void unsubscribe_market_data(const std::vector<std::string>& symbols) {
+        impl_->unsubscribe_market_data(symbols);
+    }
+
+    /// 读取最优买卖价
+    bool get_top_of_book(const std::string& symbol, TopOfBook& quote) {
+        return impl_->get_top_of_book(symbol, quote);
+    }
+
+    /// 以MarketData结构读取最新行情
+    bool get_market_data(const std::string& symbol, MarketData& data) {
+        return impl_->get_market_data(symbol, data);
+    }
+
+    /// 按序接收已订阅交易对的行情
+    size_t receive_market_ticks(std::vector<MarketTick>& ticks, size_t max_count) {
+        return impl_->receive_market_ticks(ticks, max_count);
+    }
+
+    /// 读取网关维护的实时持仓和盈亏
+    bool get_position(const std::string& strategy_id, const std::string& instrument_id, PositionRecord& record) {
+        return impl_->get_position(strategy_id, instrument_id, record);
+    }
+
+    /// 读取某个策略的全部持仓（strategy_id为空时读取全部）
+    size_t get_positions(const std::string& strategy_id, std::vector<PositionRecord>& records) {
+        return impl_->get_positions(strategy_id, records);
+    }
+
+    /// 持仓表的全表更新序号
+    uint64_t get_position_update_sequence() {
+        return impl_->get_position_update_sequence();
+    }
+
     /**
      * @brief 获取系统控制信息
      * @return 系统控制信息
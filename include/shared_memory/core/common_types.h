@@ -135,12 +135,18 @@ struct alignas(8) TradingSignal {
     double take_profit;
     uint64_t timestamp;
     uint64_t expiry_time;
+    // 端到端延迟跟踪上下文：trace_id可由策略指定（0表示由执行端分配），
+    // 两个时间戳由SignalBuffer在写入/读出时填写（CLOCK_MONOTONIC纳秒）
+    uint64_t trace_id;
+    int64_t shm_write_ns;
+    int64_t shm_read_ns;
     char metadata[512];  // 固定长度字符数组替代std::string
     
     TradingSignal() : signal_id(0), sequence_id(0), type(SignalType::HOLD), urgency(SignalUrgency::NORMAL)
                     , side(OrderSide::BUY), order_type(OrderType::LIMIT), time_in_force(TimeInForce::GTC)
                     , target_price(0.0), price(0.0), target_quantity(0.0), quantity(0.0)
-                    , stop_loss(0.0), take_profit(0.0), timestamp(0), expiry_time(0) {
+                    , stop_loss(0.0), take_profit(0.0), timestamp(0), expiry_time(0)
+                    , trace_id(0), shm_write_ns(0), shm_read_ns(0) {
         symbol[0] = '\0';
         instrument_id[0] = '\0';
         strategy_id[0] = '\0';
@@ -271,6 +277,13 @@ inline uint64_t get_current_timestamp_ns() {
     ).count();
 }
 
+// CLOCK_MONOTONIC纳秒，跨进程可比，用于延迟打点
+inline int64_t get_monotonic_timestamp_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
 inline uint64_t get_current_timestamp_us() {
     return std::chrono::duration_cast<std::chrono::microseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()
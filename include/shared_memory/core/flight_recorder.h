@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tes {
+namespace shared_memory {
+
+// 飞行记录器事件类型，数值写入文件，只能追加不能改动
+enum class FlightEventType : uint16_t {
+    SIGNAL_IN = 1,          // 执行端读出信号，id为轨迹ID，value为共享内存写入到读出的纳秒（未知为0）
+    ORDER_SERIALIZED = 2,   // 网关渲染完下单报文
+    ORDER_SENT = 3,         // send()返回
+    ORDER_ACK = 4,          // 收到下单应答
+    FILL = 5,               // 成交回报，value为累计成交量*1e8
+    ORDER_REJECT = 6,       // 风控拒单
+    CONNECTED = 7,
+    DISCONNECTED = 8,       // value为网关连接状态（断开或错误）
+    RECONNECTING = 9,
+    STALL = 10,             // 周期线程的调度停顿，value为超出预期的纳秒
+    QUEUE_DEPTH = 11,       // id为队列编号，value为深度
+    MARK = 12               // 自定义标记
+};
+
+const char* flight_event_type_name(FlightEventType type);
+
+// 单条事件，定长40字节
+struct FlightEvent {
+    std::atomic<uint64_t> sequence;     // 2*(位置+1)为写完，奇数为写入中，0为从未写过
+    int64_t timestamp_ns;               // CLOCK_REALTIME纳秒
+    uint64_t id;
+    int64_t value;
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t thread_id;
+};
+
+static_assert(sizeof(FlightEvent) == 40, "FlightEvent layout is part of the file format");
+
+struct FlightRecorderHeader {
+    char magic[8];                      // "TESFLREC"
+    uint32_t version;
+    uint32_t event_size;
+    uint64_t capacity;                  // 事件槽数，2的幂
+    int64_t created_realtime_ns;
+    int32_t pid;
+    std::atomic<uint32_t> clean_shutdown;   // 正常关闭时置1，为0说明进程崩溃或仍在运行
+    alignas(64) std::atomic<uint64_t> write_index;
+};
+
+// 解码结果中的一条事件（已去掉序号）
+struct FlightEventRecord {
+    uint64_t position;
+    int64_t timestamp_ns;
+    uint64_t id;
+    int64_t value;
+    FlightEventType type;
+    uint32_t thread_id;
+};
+
+// 飞行记录器
+// 文件映射（MAP_SHARED）的环形事件缓冲区，默认放在/dev/shm，进程崩溃后内容仍由内核保留，
+// 用flight_recorder_dump按时间线解码。写入无锁：fetch_add取位置，槽位用seqlock序号发布，
+// 多线程可并发写。未打开时record()直接返回，调用点不需要判断。
+// 打开时若发现上次未正常关闭的记录文件，先改名为<path>.prev保留现场。
+class FlightRecorder {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 18;    // 约10MB
+
+    static FlightRecorder& instance();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // capacity向上取整到2的幂
+    bool open(const std::string& path, size_t capacity = DEFAULT_CAPACITY);
+    // 标记正常关闭并停止记录；映射保留到下次open或进程退出，避免与并发写者竞争
+    void close();
+    bool is_open() const { return events_.load(std::memory_order_acquire) != nullptr; }
+
+    void record(FlightEventType type, uint64_t id, int64_t value = 0) {
+        FlightEvent* events = events_.load(std::memory_order_acquire);
+        if (events) {
+            append(events, type, id, value);
+        }
+    }
+
+    // 读取记录文件，按位置升序返回仍完整的事件；文件无效时返回false
+    static bool load(const std::string& path, FlightRecorderHeader& header,
+                     std::vector<FlightEventRecord>& events, std::string& error);
+
+private:
+    FlightRecorder();
+    ~FlightRecorder();
+
+    void append(FlightEvent* events, FlightEventType type, uint64_t id, int64_t value);
+    void unmap();
+
+    FlightRecorderHeader* header_;
+    std::atomic<FlightEvent*> events_;
+    size_t mask_;
+    size_t mapped_size_;
+    int fd_;
+};
+
+} // namespace shared_memory
+} // namespace tes
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "common_types.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tes {
+namespace shared_memory {
+
+// 最优买卖价（读者拿到的一致副本）
+struct TopOfBook {
+    double bid_price;
+    double bid_volume;
+    double ask_price;
+    double ask_volume;
+    uint64_t exchange_timestamp;    // 交易所事件时间(ms)
+    uint64_t local_timestamp;       // 网关收到时间(ns)
+    uint64_t update_id;             // 交易所finalUpdateId
+    uint64_t version;               // 本槽位的发布次数，读者据此判断是否有更新
+
+    TopOfBook() : bid_price(0.0), bid_volume(0.0), ask_price(0.0), ask_volume(0.0),
+                  exchange_timestamp(0), local_timestamp(0), update_id(0), version(0) {}
+};
+
+enum class MarketTickType : uint8_t {
+    QUOTE = 0,          // 最优价变化
+    TRADE = 1           // 逐笔成交
+};
+
+// 行情环中的一条记录
+struct MarketTick {
+    uint32_t symbol_index;
+    MarketTickType type;
+    OrderSide side;                 // TRADE时为主动方
+    double price;                   // QUOTE时为买一价
+    double quantity;                // QUOTE时为买一量
+    double ask_price;               // 仅QUOTE
+    double ask_quantity;            // 仅QUOTE
+    uint64_t trade_id;              // TRADE为成交ID，QUOTE为finalUpdateId
+    uint64_t exchange_timestamp;
+    uint64_t local_timestamp;
+
+    MarketTick() : symbol_index(0), type(MarketTickType::QUOTE), side(OrderSide::BUY), price(0.0),
+                   quantity(0.0), ask_price(0.0), ask_quantity(0.0), trade_id(0),
+                   exchange_timestamp(0), local_timestamp(0) {}
+};
+
+// 共享内存行情段
+// 网关（唯一写者进程）把深度/成交流写入两部分：
+//  - 按交易对的最优价表，每个槽位一个seqlock，读者随时读到最新且不撕裂的一档；
+//  - 单生产者多消费者的行情环，每个读者自带游标，互不影响，也不阻塞写者。
+//    读者落后超过一圈时跳到最旧的有效记录并计入丢失数。
+// 交易对目录只追加，下标一经分配永久有效。
+class MarketDataSegment {
+public:
+    static constexpr size_t MAX_SYMBOLS = 256;
+    static constexpr size_t SYMBOL_LENGTH = 32;
+    static constexpr size_t TICK_RING_SIZE = 16384;        // 必须是2的幂
+    static constexpr uint32_t INVALID_SYMBOL_INDEX = 0xffffffffu;
+    static constexpr const char* GATEWAY_SEGMENT = "gateway";      // 段名后缀，共享内存名为/tes_market_data_gateway
+
+    struct alignas(64) QuoteSlot {
+        std::atomic<uint64_t> sequence{0};                  // seqlock，奇数表示写入中
+        std::atomic<double> bid_price{0.0};
+        std::atomic<double> bid_volume{0.0};
+        std::atomic<double> ask_price{0.0};
+        std::atomic<double> ask_volume{0.0};
+        std::atomic<uint64_t> exchange_timestamp{0};
+        std::atomic<uint64_t> local_timestamp{0};
+        std::atomic<uint64_t> update_id{0};
+    };
+
+    struct alignas(64) TickSlot {
+        std::atomic<uint64_t> sequence{0};                  // 2*(位置+1)为写完，奇数为写入中
+        std::atomic<uint32_t> symbol_index{0};
+        std::atomic<uint8_t> type{0};
+        std::atomic<uint8_t> side{0};
+        std::atomic<double> price{0.0};
+        std::atomic<double> quantity{0.0};
+        std::atomic<double> ask_price{0.0};
+        std::atomic<double> ask_quantity{0.0};
+        std::atomic<uint64_t> trade_id{0};
+        std::atomic<uint64_t> exchange_timestamp{0};
+        std::atomic<uint64_t> local_timestamp{0};
+    };
+
+    struct alignas(64) SharedData {
+        std::atomic<uint32_t> symbol_count{0};
+        char symbols[MAX_SYMBOLS][SYMBOL_LENGTH];
+        alignas(64) QuoteSlot quotes[MAX_SYMBOLS];
+        alignas(64) std::atomic<uint64_t> write_index{0};  // 下一条行情的位置
+        TickSlot ticks[TICK_RING_SIZE];
+        std::atomic<bool> is_initialized{false};
+    };
+
+    MarketDataSegment(const std::string& name, bool create = false);
+    ~MarketDataSegment();
+
+    MarketDataSegment(const MarketDataSegment&) = delete;
+    MarketDataSegment& operator=(const MarketDataSegment&) = delete;
+
+    // 写者（网关）
+    uint32_t register_symbol(const std::string& symbol);
+    bool publish_quote(const std::string& symbol, const TopOfBook& quote);
+    bool publish_trade(const std::string& symbol, const MarketTick& trade);
+
+    // 读者（策略），均不加锁
+    uint32_t find_symbol(const std::string& symbol) const;
+    std::string symbol_at(uint32_t index) const;
+    bool read_quote(uint32_t symbol_index, TopOfBook& quote) const;
+    // 行情环当前写位置；新读者从这里开始只看之后的行情
+    uint64_t tick_cursor() const;
+    // 从cursor开始最多读max_count条并前移cursor；落后超过一圈时lost返回跳过的条数
+    size_t read_ticks(uint64_t& cursor, MarketTick* ticks, size_t max_count, uint64_t* lost = nullptr) const;
+
+    struct Statistics {
+        uint64_t quotes_published;
+        uint64_t ticks_published;
+        uint64_t publish_failures;
+        uint64_t quote_read_retries;
+        uint64_t ticks_lost;
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    std::string shm_name_;
+    int shm_fd_;
+    SharedData* shared_data_;
+    bool is_creator_;
+
+    std::mutex writer_mutex_;                               // 网关内多条行情连接的回调串行写入
+    std::unordered_map<std::string, uint32_t> symbol_cache_;
+
+    mutable std::atomic<uint64_t> quotes_published_{0};
+    mutable std::atomic<uint64_t> ticks_published_{0};
+    mutable std::atomic<uint64_t> publish_failures_{0};
+    mutable std::atomic<uint64_t> quote_read_retries_{0};
+    mutable std::atomic<uint64_t> ticks_lost_{0};
+
+    uint32_t intern_symbol_locked(const std::string& symbol);
+    void push_tick_locked(const MarketTick& tick);
+    bool create_shared_memory();
+    bool open_shared_memory();
+    void cleanup();
+};
+
+} // namespace shared_memory
+} // namespace tes
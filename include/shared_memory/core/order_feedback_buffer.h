@@ -3,6 +3,7 @@
 #include "common_types.h"
 #include "../../common/common_types.h"
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <sys/mman.h>
 #include <fcntl.h>
@@ -13,16 +14,38 @@ namespace tes {
 namespace shared_memory {
 
 // 订单回报缓冲区
+// 段内附带一张开放寻址的订单ID索引：订单ID的64位哈希 -> 该订单最新一条回报的位置，
+// 由写者在写完槽位后以release发布，任意读者进程都能O(1)查到订单的最新状态。
+// 槽位带seqlock序号，读者据此识别被环覆盖或正在改写的槽位。
+// 可选的唤醒通道：段内一个进程间futex字，读者无回报时挂起在上面，
+// 写者只在有读者挂起时才发起系统调用。
 class OrderFeedbackBuffer {
 public:
     static constexpr size_t BUFFER_SIZE = constants::MAX_ORDER_BUFFER_SIZE;
+    static constexpr size_t INDEX_SIZE = 32768;             // 必须是2的幂且不小于2*BUFFER_SIZE
+    static constexpr size_t MAX_INDEX_PROBES = 64;          // 线性探测的最大步数
+    
+    static_assert((INDEX_SIZE & (INDEX_SIZE - 1)) == 0, "INDEX_SIZE must be a power of two");
+    static_assert(INDEX_SIZE >= 2 * BUFFER_SIZE, "INDEX_SIZE too small for BUFFER_SIZE");
     
     // 使用common_types.h中的OrderFeedback定义
     
+    // 索引项：hash为0表示空；position为回报位置+1，0表示尚未发布
+    struct IndexEntry {
+        std::atomic<uint64_t> hash{0};
+        std::atomic<uint64_t> position{0};
+    };
+    
     struct alignas(64) SharedData {
         std::atomic<uint64_t> write_index{0};
         std::atomic<uint64_t> read_index{0};
         OrderFeedback feedbacks[BUFFER_SIZE];
+        std::atomic<uint64_t> slot_sequences[BUFFER_SIZE];  // seqlock，2*(位置+1)为写完，奇数为写入中
+        IndexEntry order_index[INDEX_SIZE];
+        std::atomic<uint64_t> index_overflows{0};           // 索引探测窗口满的累计次数（统计用）
+        std::atomic<uint64_t> last_unindexed{0};            // 最近一条漏登记回报的位置+1，仍在环内时查找回退到扫描
+        alignas(64) std::atomic<uint32_t> notify_word{0};   // futex字，每次唤醒加1
+        std::atomic<uint32_t> parked_readers{0};            // 正挂起在futex上的读者数
         std::atomic<bool> is_initialized{false};
     };
     
@@ -38,8 +61,14 @@ public:
     // 批量读取订单回报
     size_t read_feedbacks(OrderFeedback* feedbacks, size_t max_count);
     
-    // 根据订单ID查找回报
-    bool find_feedback_by_order_id(OrderId order_id, OrderFeedback& feedback);
+    // 根据订单ID查找该订单最新的一条回报（含已被消费但尚未被环覆盖的）
+    bool find_feedback_by_order_id(const OrderId& order_id, OrderFeedback& feedback) const;
+    
+    // 写者：写入一批回报后调用，有读者挂起时唤醒它们，返回是否发起了唤醒
+    bool notify_readers();
+    
+    // 读者：等到有未读回报或超时，返回是否有回报
+    bool wait_for_feedback(std::chrono::microseconds timeout);
     
     // 获取可用回报数量
     size_t available_feedbacks() const;
@@ -56,6 +85,12 @@ public:
         uint64_t write_failures;
         uint64_t read_failures;
         uint64_t duplicate_orders;
+        uint64_t index_hits;
+        uint64_t index_misses;
+        uint64_t index_overflows;
+        uint64_t fallback_scans;
+        uint64_t reader_wakeups;
+        uint64_t reader_waits;
     };
     
     Statistics get_statistics() const;
@@ -71,7 +106,15 @@ private:
     mutable std::atomic<uint64_t> write_failures_{0};
     mutable std::atomic<uint64_t> read_failures_{0};
     mutable std::atomic<uint64_t> duplicate_orders_{0};
+    mutable std::atomic<uint64_t> index_hits_{0};
+    mutable std::atomic<uint64_t> index_misses_{0};
+    mutable std::atomic<uint64_t> fallback_scans_{0};
+    mutable std::atomic<uint64_t> reader_wakeups_{0};
+    mutable std::atomic<uint64_t> reader_waits_{0};
     
+    void index_feedback(const char* order_id, uint64_t position);
+    bool read_slot(uint64_t position, OrderFeedback& feedback) const;
+    bool scan_feedback(const char* order_id, uint64_t newest_end, OrderFeedback& feedback) const;
     bool create_shared_memory();
     bool open_shared_memory();
     void cleanup();
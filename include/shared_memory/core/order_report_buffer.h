@@ -2,7 +2,9 @@
 
 #include "common/common_types.h"
 #include <atomic>
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <chrono>
 #include <thread>
 #include <sys/mman.h>
@@ -14,9 +16,14 @@ namespace tes {
 namespace shared_memory {
 
 // 订单回报结构
-struct OrderReport {
+// 直接存放在跨进程共享的环形缓冲区里，必须是定长、可按字节拷贝的结构，
+// 不能含std::string等指向写者进程堆内存的成员。按缓存行对齐，相邻槽位不共享缓存行。
+struct alignas(64) OrderReport {
+    static constexpr size_t SYMBOL_LENGTH = 32;
+    static constexpr size_t ERROR_MESSAGE_LENGTH = 64;
+
     uint64_t order_id;
-    std::string symbol;
+    char symbol[SYMBOL_LENGTH];                     // 固定长度字符数组替代std::string
     Side side;
     OrderType type;
     OrderStatus status;
@@ -26,23 +33,52 @@ struct OrderReport {
     double avg_fill_price;
     double commission;
     uint64_t timestamp;
-    std::string error_message;
+    char error_message[ERROR_MESSAGE_LENGTH];       // 超长时截断
     
     OrderReport() 
         : order_id(0), side(Side::BUY), type(OrderType::MARKET)
         , status(OrderStatus::PENDING), quantity(0.0), filled_quantity(0.0)
-        , price(0.0), avg_fill_price(0.0), commission(0.0), timestamp(0) {}
+        , price(0.0), avg_fill_price(0.0), commission(0.0), timestamp(0) {
+        symbol[0] = '\0';
+        error_message[0] = '\0';
+    }
+    
+    // 辅助方法设置字符串字段
+    void set_symbol(const std::string& sym) {
+        strncpy(symbol, sym.c_str(), sizeof(symbol) - 1);
+        symbol[sizeof(symbol) - 1] = '\0';
+    }
+    
+    void set_error_message(const std::string& message) {
+        strncpy(error_message, message.c_str(), sizeof(error_message) - 1);
+        error_message[sizeof(error_message) - 1] = '\0';
+    }
+    
+    // 辅助方法获取字符串字段
+    std::string get_symbol() const {
+        return std::string(symbol);
+    }
+    
+    std::string get_error_message() const {
+        return std::string(error_message);
+    }
 };
 
+static_assert(std::is_trivially_copyable<OrderReport>::value, "OrderReport must be trivially copyable for shared memory");
+static_assert(sizeof(OrderReport) % 64 == 0, "OrderReport must occupy whole cache lines");
+
 // 共享内存中的订单回报缓冲区结构
+// 单生产者单消费者：head只由消费者写，tail只由生产者写，两者各占一条缓存行。
+// 下标单调递增，槽位为下标 & mask，容量取2的幂。
 struct SharedOrderReportBuffer {
-    std::atomic<size_t> head;
-    std::atomic<size_t> tail;
-    size_t capacity;
+    alignas(64) std::atomic<uint64_t> head;     // 下一个读取位置（消费者）
+    alignas(64) std::atomic<uint64_t> tail;     // 下一个写入位置（生产者）
+    alignas(64) uint64_t capacity;
+    uint64_t mask;
     std::atomic<bool> is_initialized;
-    OrderReport reports[]; // 柔性数组成员
+    alignas(64) OrderReport reports[];          // 柔性数组成员
     
-    SharedOrderReportBuffer() : head(0), tail(0), capacity(0), is_initialized(false) {}
+    SharedOrderReportBuffer() : head(0), tail(0), capacity(0), mask(0), is_initialized(false) {}
 };
 
 // 订单回报缓冲区类
@@ -72,6 +108,7 @@ public:
     bool push(const OrderReport& report);
     bool pop(OrderReport& report);
     bool try_pop(OrderReport& report, std::chrono::milliseconds timeout = std::chrono::milliseconds(100));
+    size_t pop_batch(OrderReport* reports, size_t max_count);
     
     // 状态查询
     size_t size() const;
@@ -90,12 +127,17 @@ private:
     // 共享内存管理
     bool create_shared_memory(size_t capacity);
     bool open_shared_memory();
+    size_t mapped_size() const;
     
     // 成员变量
     std::string shm_name_;
     int shm_fd_;
     SharedOrderReportBuffer* buffer_;
     bool is_creator_;
+    
+    // 本端缓存的对端下标，只在判满/判空失败时才重新读取对端的缓存行
+    uint64_t cached_head_;                      // 生产者使用
+    uint64_t cached_tail_;                      // 消费者使用
 };
 
 } // namespace shared_memory
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "common_types.h"
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tes {
+namespace shared_memory {
+
+// 一行持仓的一致副本
+struct PositionRecord {
+    std::string strategy_id;
+    std::string instrument_id;
+    double net_quantity;
+    double average_cost;
+    double realized_pnl;
+    double unrealized_pnl;
+    double mark_price;
+    uint64_t update_sequence;       // 写入时的全表更新序号
+    uint64_t update_time;           // 写入时间(ns, CLOCK_MONOTONIC)
+
+    PositionRecord() : net_quantity(0.0), average_cost(0.0), realized_pnl(0.0), unrealized_pnl(0.0),
+                       mark_price(0.0), update_sequence(0), update_time(0) {}
+};
+
+// 共享内存持仓/盈亏表
+// 每张表只有一个写者进程（由它创建），在每次成交和标记价格变化时按(策略, 合约)行写入，
+// 每行一个seqlock；策略进程无系统调用地读取，不会读到撕裂的一行。
+// 分配行不跨进程加锁，所以网关和执行引擎各写各的表：网关写GATEWAY_TABLE（账户级ACCOUNT行），
+// 执行引擎写EXECUTION_TABLE（按策略的行）。
+// 行只追加不回收，平仓后数量为0但保留已实现盈亏；全表更新序号供读者判断是否有变化。
+class PositionTable {
+public:
+    static constexpr size_t MAX_ROWS = 1024;
+    static constexpr size_t STRATEGY_ID_LENGTH = 64;
+    static constexpr size_t INSTRUMENT_ID_LENGTH = 32;
+    static constexpr uint32_t INVALID_ROW = 0xffffffffu;
+    static constexpr const char* ACCOUNT_STRATEGY_ID = "ACCOUNT";   // 网关账户级持仓（不区分策略）
+    static constexpr const char* GATEWAY_TABLE = "gateway";         // 网关创建并写入，只含ACCOUNT行
+    static constexpr const char* EXECUTION_TABLE = "execution";     // 执行引擎创建并写入，按策略的行
+
+    struct alignas(64) PositionRow {
+        std::atomic<uint64_t> sequence{0};                  // seqlock，奇数表示写入中
+        std::atomic<double> net_quantity{0.0};
+        std::atomic<double> average_cost{0.0};
+        std::atomic<double> realized_pnl{0.0};
+        std::atomic<double> unrealized_pnl{0.0};
+        std::atomic<double> mark_price{0.0};
+        std::atomic<uint64_t> update_sequence{0};
+        std::atomic<uint64_t> update_time{0};
+        char strategy_id[STRATEGY_ID_LENGTH];               // 分配行时写入一次，之后不变
+        char instrument_id[INSTRUMENT_ID_LENGTH];
+    };
+
+    struct alignas(64) SharedData {
+        std::atomic<uint32_t> row_count{0};
+        alignas(64) std::atomic<uint64_t> update_sequence{0};
+        PositionRow rows[MAX_ROWS];
+        std::atomic<bool> is_initialized{false};
+    };
+
+    PositionTable(const std::string& name, bool create = false);
+    ~PositionTable();
+
+    PositionTable(const PositionTable&) = delete;
+    PositionTable& operator=(const PositionTable&) = delete;
+
+    // 写者（网关）：写入一行持仓，update_sequence/update_time由表填写；行数已满返回false
+    bool update_position(const PositionRecord& record);
+    // 写者：按标记价格重算该合约所有行的未实现盈亏，返回更新的行数
+    size_t update_mark_price(const std::string& instrument_id, double mark_price);
+
+    // 读者（策略），均不加锁
+    uint64_t update_sequence() const;
+    uint32_t row_count() const;
+    uint32_t find_row(const std::string& strategy_id, const std::string& instrument_id) const;
+    bool read_row(uint32_t row, PositionRecord& record) const;
+    bool read_position(const std::string& strategy_id, const std::string& instrument_id, PositionRecord& record) const;
+    // strategy_id为空时读取全部行
+    size_t read_positions(const std::string& strategy_id, std::vector<PositionRecord>& records) const;
+
+    struct Statistics {
+        uint64_t position_updates;
+        uint64_t mark_updates;
+        uint64_t update_failures;
+        uint64_t read_retries;
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    std::string shm_name_;
+    int shm_fd_;
+    SharedData* shared_data_;
+    bool is_creator_;
+
+    std::mutex writer_mutex_;
+    std::unordered_map<std::string, uint32_t> row_cache_;                       // 策略\0合约 -> 行
+    std::unordered_map<std::string, std::vector<uint32_t>> instrument_rows_;    // 合约 -> 行
+
+    mutable std::atomic<uint64_t> position_updates_{0};
+    mutable std::atomic<uint64_t> mark_updates_{0};
+    mutable std::atomic<uint64_t> update_failures_{0};
+    mutable std::atomic<uint64_t> read_retries_{0};
+
+    uint32_t acquire_row_locked(const std::string& strategy_id, const std::string& instrument_id);
+    void write_row_locked(PositionRow& row, double net_quantity, double average_cost, double realized_pnl,
+                          double unrealized_pnl, double mark_price);
+    bool create_shared_memory();
+    bool open_shared_memory();
+    void cleanup();
+};
+
+} // namespace shared_memory
+} // namespace tes
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common_types.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace tes {
+namespace shared_memory {
+
+// 网关对一次调仓的确认状态，与pos_update.json中isFinished的取值一致
+enum class TargetAckStatus : uint8_t {
+    PENDING = 0,        // 尚未处理完
+    COMPLETED = 1,      // 全部对齐
+    FAILED = 2          // 处理失败
+};
+
+// 一条目标仓位
+struct TargetPositionEntry {
+    std::string symbol;
+    double quantity;
+
+    TargetPositionEntry() : quantity(0.0) {}
+    TargetPositionEntry(const std::string& s, double q) : symbol(s), quantity(q) {}
+};
+
+// 一次完整调仓的一致性快照
+struct TargetPositionSnapshot {
+    uint64_t generation;
+    std::vector<TargetPositionEntry> targets;
+
+    TargetPositionSnapshot() : generation(0) {}
+};
+
+// 共享内存目标仓位表
+// 策略（单写者）整表发布一次调仓，网关（读者）无文件IO地读取并回写确认字。
+// 每行定长、各自带seqlock；整表另有一个seqlock和代数，读者据此拿到同一次发布的完整快照。
+class TargetPositionTable {
+public:
+    static constexpr size_t MAX_ROWS = 512;
+    static constexpr size_t MAX_SYMBOLS = 1024;
+    static constexpr size_t SYMBOL_LENGTH = 32;
+    static constexpr int64_t QUANTITY_SCALE = 100000000;   // 数量按1e-8定点存储
+    static constexpr uint32_t INVALID_SYMBOL_INDEX = 0xffffffffu;
+
+    struct alignas(64) TargetRow {
+        std::atomic<uint32_t> sequence{0};                  // 行seqlock，奇数表示写入中
+        std::atomic<uint32_t> symbol_index{INVALID_SYMBOL_INDEX};
+        std::atomic<int64_t> quantity{0};                   // 定点数量
+        std::atomic<uint64_t> generation{0};                // 最后写入本行的表代数
+    };
+
+    struct alignas(64) SharedData {
+        std::atomic<uint32_t> table_sequence{0};            // 整表seqlock
+        std::atomic<uint32_t> row_count{0};
+        std::atomic<uint64_t> generation{0};                // 最新已发布的代数
+        alignas(64) std::atomic<uint64_t> ack_word{0};      // 网关确认：代数 << 8 | TargetAckStatus
+        alignas(64) std::atomic<uint32_t> symbol_count{0};  // 交易对目录只追加，下标永久有效
+        char symbols[MAX_SYMBOLS][SYMBOL_LENGTH];
+        TargetRow rows[MAX_ROWS];
+        std::atomic<bool> is_initialized{false};
+    };
+
+    TargetPositionTable(const std::string& name, bool create = false);
+    ~TargetPositionTable();
+
+    TargetPositionTable(const TargetPositionTable&) = delete;
+    TargetPositionTable& operator=(const TargetPositionTable&) = delete;
+
+    // 写者（策略）：原子地发布一次完整调仓，返回新代数，失败返回0
+    uint64_t publish(const std::vector<TargetPositionEntry>& targets);
+
+    // 读者（网关）
+    uint64_t generation() const;
+    bool read_snapshot(TargetPositionSnapshot& snapshot) const;
+    // 只读单个交易对（按行seqlock，不等待整表）
+    bool read_target(const std::string& symbol, double& quantity, uint64_t& generation) const;
+    // 等待代数超过after，超时返回false
+    bool wait_for_generation(uint64_t after, std::chrono::microseconds timeout) const;
+
+    // 确认字：网关写，策略读
+    void acknowledge(uint64_t generation, TargetAckStatus status);
+    bool get_acknowledgement(uint64_t& generation, TargetAckStatus& status) const;
+    // 策略等待网关确认某一代数，超时返回false
+    bool wait_for_acknowledgement(uint64_t generation, TargetAckStatus& status,
+                                  std::chrono::microseconds timeout) const;
+
+    std::string symbol_at(uint32_t index) const;
+
+    struct Statistics {
+        uint64_t publishes;
+        uint64_t publish_failures;
+        uint64_t snapshot_reads;
+        uint64_t read_retries;
+    };
+
+    Statistics get_statistics() const;
+
+private:
+    std::string shm_name_;
+    int shm_fd_;
+    SharedData* shared_data_;
+    bool is_creator_;
+
+    std::mutex writer_mutex_;                               // 同一进程内的多个写线程串行化
+    std::unordered_map<std::string, uint32_t> symbol_cache_;
+
+    mutable std::atomic<uint64_t> publishes_{0};
+    mutable std::atomic<uint64_t> publish_failures_{0};
+    mutable std::atomic<uint64_t> snapshot_reads_{0};
+    mutable std::atomic<uint64_t> read_retries_{0};
+
+    uint32_t intern_symbol_locked(const std::string& symbol);
+    bool create_shared_memory();
+    bool open_shared_memory();
+    void cleanup();
+};
+
+} // namespace shared_memory
+} // namespace tes
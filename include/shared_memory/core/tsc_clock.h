@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TES_HAS_TSC 1
+#else
+#define TES_HAS_TSC 0
+#endif
+
+namespace tes {
+namespace shared_memory {
+
+// 基于TSC的低开销时钟
+// 热路径只读取原始计数(rdtsc，约几纳秒，无系统调用)，需要时再换算成纳秒。
+// 启动时以CLOCK_MONOTONIC/CLOCK_REALTIME标定，后台线程定期重新采样并平滑修正漂移：
+// 修正只调整斜率、不回拨，换算出的单调时间不会倒退；偏差超过STEP_THRESHOLD_NS（如挂起恢复）才直接跳变。
+// CPU不支持恒定TSC时退化为clock_gettime(CLOCK_MONOTONIC)，此时计数即纳秒。
+class TscClock {
+public:
+    using TimePoint = std::chrono::high_resolution_clock::time_point;
+
+    static constexpr unsigned MULT_SHIFT = 32;                      // 换算系数的定点小数位
+    static constexpr int64_t STEP_THRESHOLD_NS = 1000000;           // 超过1ms的偏差直接跳变
+    static constexpr int64_t MAX_SLEW_PPM = 500;                    // 平滑修正时斜率最多偏离500ppm
+
+    struct Statistics {
+        bool tsc_enabled;               // false表示已退化为clock_gettime
+        double ticks_per_ns;
+        uint64_t recalibrations;
+        uint64_t steps;                 // 偏差过大而直接跳变的次数
+        int64_t last_drift_ns;          // 最近一次重采样时换算值与CLOCK_MONOTONIC之差（实际减换算）
+        int64_t max_abs_drift_ns;
+    };
+
+    static TscClock& instance();
+
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+
+    // 原始计数；不保证跨CPU严格有序，需要与之前的内存访问排序时用ticks_serialized()
+    uint64_t ticks() const {
+#if TES_HAS_TSC
+        if (tsc_enabled_) {
+            return __rdtsc();
+        }
+#endif
+        return fallback_ticks();
+    }
+
+    uint64_t ticks_serialized() const {
+#if TES_HAS_TSC
+        if (tsc_enabled_) {
+            unsigned int aux;
+            return __rdtscp(&aux);
+        }
+#endif
+        return fallback_ticks();
+    }
+
+    // 计数换算到CLOCK_MONOTONIC/CLOCK_REALTIME纳秒
+    int64_t to_monotonic_ns(uint64_t ticks) const;
+    int64_t to_realtime_ns(uint64_t ticks) const;
+    // 换算成high_resolution_clock的时间点，与其纪元一致（libstdc++中为系统时间）
+    TimePoint to_time_point(uint64_t ticks) const;
+    // 两个计数之差换算成纳秒，适合测量区间
+    int64_t ticks_to_ns(uint64_t delta_ticks) const;
+
+    int64_t monotonic_ns() const { return to_monotonic_ns(ticks()); }
+    int64_t realtime_ns() const { return to_realtime_ns(ticks()); }
+    TimePoint now() const { return to_time_point(ticks()); }
+
+    // 立即重新采样并修正，返回本次测得的漂移（纳秒）
+    int64_t recalibrate();
+
+    // 后台漂移修正线程，重复调用无副作用
+    void start_drift_correction(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    void stop_drift_correction();
+
+    Statistics get_statistics() const;
+
+private:
+    // 一组换算参数：mono_ns = base_mono_ns + ((ticks - base_ticks) * mult) >> MULT_SHIFT
+    struct Params {
+        uint64_t base_ticks;
+        int64_t base_mono_ns;
+        uint64_t mult;
+        int64_t realtime_offset_ns;     // realtime - monotonic
+    };
+
+    struct Sample {
+        uint64_t ticks;
+        int64_t mono_ns;
+        int64_t real_ns;
+    };
+
+    TscClock();
+    ~TscClock();
+
+    static uint64_t fallback_ticks();
+    Sample take_sample() const;
+    void calibrate();
+    Params load_params() const;
+    void store_params(const Params& params);
+    static int64_t apply(const Params& params, uint64_t ticks);
+    void drift_worker(std::chrono::milliseconds interval);
+
+    bool tsc_enabled_;
+
+    // 换算参数由seqlock保护，奇数表示写入中；只有标定/修正线程写
+    std::atomic<uint64_t> sequence_{0};
+    std::atomic<uint64_t> base_ticks_{0};
+    std::atomic<int64_t> base_mono_ns_{0};
+    std::atomic<uint64_t> mult_{uint64_t(1) << MULT_SHIFT};
+    std::atomic<int64_t> realtime_offset_ns_{0};
+
+    std::mutex calibration_mutex_;
+    Sample anchor_;                     // 启动标定样本，长期斜率以此为起点
+    int64_t drift_interval_ns_;
+
+    std::atomic<uint64_t> recalibrations_{0};
+    std::atomic<uint64_t> steps_{0};
+    std::atomic<int64_t> last_drift_ns_{0};
+    std::atomic<int64_t> max_abs_drift_ns_{0};
+
+    std::mutex worker_mutex_;
+    std::condition_variable worker_cv_;
+    std::thread worker_;
+    bool worker_running_;
+};
+
+} // namespace shared_memory
+} // namespace tes
@@ -149,6 +149,8 @@ public:
 
         bool result = order_feedback_buffer_->write_feedback(feedback);
         if (result) {
+            // 只有策略挂起在wait_for_feedback上时才会发起系统调用
+            order_feedback_buffer_->notify_readers();
             feedbacks_sent_++;
             update_heartbeat();
         }
@@ -180,6 +182,7 @@ public:
         }
 
         if (sent_count > 0) {
+            order_feedback_buffer_->notify_readers();
             feedbacks_sent_ += sent_count;
             update_heartbeat();
         }
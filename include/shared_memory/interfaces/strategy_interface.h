@@ -1,6 +1,9 @@
 #pragma once
 
 #include "base_interface.h"
+#include "../core/market_data_segment.h"
+#include "../core/position_table.h"
+#include <stdexcept>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -170,6 +173,198 @@ public:
         return count;
     }
 
+    /**
+     * @brief 阻塞等待订单反馈，代替忙轮询receive_order_feedback
+     * @param timeout 最长等待时间
+     * @return true 有未读反馈，false 超时或缓冲区不可用
+     */
+    bool wait_for_feedback(std::chrono::microseconds timeout)
+    {
+        if (!validate_buffer(order_feedback_buffer_.get())) {
+            return false;
+        }
+        return order_feedback_buffer_->wait_for_feedback(timeout);
+    }
+
+    /**
+     * @brief 订阅共享内存行情
+     * @param symbols 交易对列表；网关尚未登记的交易对会在其首次有行情时自动生效
+     * @return true 订阅成功，false 行情段不存在（网关未启动）
+     * 
+     * 所有本机策略进程共用网关的一路行情，不需要自己建立连接和解析。
+     * 首次订阅时行情环游标定位到当前写位置，只接收之后的行情。
+     */
+    bool subscribe_market_data(const std::vector<std::string>& symbols)
+    {
+        if (!market_data_) {
+            try {
+                market_data_ = std::make_unique<MarketDataSegment>(MarketDataSegment::GATEWAY_SEGMENT, false);
+            } catch (const std::runtime_error&) {
+                return false;
+            }
+            tick_cursor_ = market_data_->tick_cursor();
+        }
+
+        for (const auto& symbol : symbols) {
+            market_data_symbols_.emplace(symbol, MarketDataSegment::INVALID_SYMBOL_INDEX);
+        }
+        resolve_market_data_symbols();
+        return true;
+    }
+
+    /**
+     * @brief 取消订阅共享内存行情
+     * @param symbols 交易对列表
+     */
+    void unsubscribe_market_data(const std::vector<std::string>& symbols)
+    {
+        for (const auto& symbol : symbols) {
+            auto it = market_data_symbols_.find(symbol);
+            if (it == market_data_symbols_.end()) {
+                continue;
+            }
+            if (it->second != MarketDataSegment::INVALID_SYMBOL_INDEX) {
+                subscribed_symbol_indices_[it->second] = false;
+            }
+            market_data_symbols_.erase(it);
+        }
+    }
+
+    /**
+     * @brief 读取最优买卖价
+     * @param symbol 交易对
+     * @param quote 输出参数，最新一档（无锁seqlock读取，不会撕裂）
+     * @return true 成功，false 未订阅或尚无行情
+     */
+    bool get_top_of_book(const std::string& symbol, TopOfBook& quote)
+    {
+        uint32_t index = market_data_index(symbol);
+        if (index == MarketDataSegment::INVALID_SYMBOL_INDEX) {
+            return false;
+        }
+        return market_data_->read_quote(index, quote);
+    }
+
+    /**
+     * @brief 以MarketData结构读取最新行情
+     * @param symbol 交易对
+     * @param data 输出参数，只填充最优价相关字段
+     * @return true 成功，false 未订阅或尚无行情
+     */
+    bool get_market_data(const std::string& symbol, MarketData& data)
+    {
+        TopOfBook quote;
+        if (!get_top_of_book(symbol, quote)) {
+            return false;
+        }
+        data.symbol = symbol;
+        data.bid_price = quote.bid_price;
+        data.bid_volume = quote.bid_volume;
+        data.ask_price = quote.ask_price;
+        data.ask_volume = quote.ask_volume;
+        data.price = (quote.bid_price + quote.ask_price) / 2.0;
+        data.timestamp = quote.exchange_timestamp;
+        return true;
+    }
+
+    /**
+     * @brief 按序接收已订阅交易对的行情（最优价变化和逐笔成交）
+     * @param ticks 输出参数，接收到的行情
+     * @param max_count 最大接收数量
+     * @return 实际接收到的数量
+     */
+    size_t receive_market_ticks(std::vector<MarketTick>& ticks, size_t max_count)
+    {
+        ticks.clear();
+        if (!market_data_ || market_data_symbols_.empty()) {
+            return 0;
+        }
+        resolve_market_data_symbols();
+
+        tick_buffer_.resize(max_count);
+        uint64_t lost = 0;
+        size_t count = market_data_->read_ticks(tick_cursor_, tick_buffer_.data(), max_count, &lost);
+        market_ticks_lost_ += lost;
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t index = tick_buffer_[i].symbol_index;
+            if (index < subscribed_symbol_indices_.size() && subscribed_symbol_indices_[index]) {
+                ticks.push_back(tick_buffer_[i]);
+            }
+        }
+        market_ticks_received_ += ticks.size();
+        return ticks.size();
+    }
+
+    /**
+     * @brief 读取网关维护的实时持仓和盈亏
+     * @param strategy_id 策略ID，网关账户级持仓为PositionTable::ACCOUNT_STRATEGY_ID
+     * @param instrument_id 合约
+     * @param record 输出参数，该行的一致副本
+     * @return true 成功，false 持仓表不存在或无该行
+     */
+    bool get_position(const std::string& strategy_id, const std::string& instrument_id, PositionRecord& record)
+    {
+        PositionTable* table = position_table_for(strategy_id);
+        if (!table) {
+            return false;
+        }
+
+        // 行一经分配位置不变，缓存下标后每次只是一次seqlock读；ACCOUNT行和策略行分属两张表，键不会冲突
+        std::string key = strategy_id + '\0' + instrument_id;
+        auto it = position_rows_.find(key);
+        if (it == position_rows_.end()) {
+            uint32_t row = table->find_row(strategy_id, instrument_id);
+            if (row == PositionTable::INVALID_ROW) {
+                return false;
+            }
+            it = position_rows_.emplace(key, row).first;
+        }
+        return table->read_row(it->second, record);
+    }
+
+    /**
+     * @brief 读取某个策略的全部持仓
+     * @param strategy_id 策略ID，为空时读取全部行
+     * @param records 输出参数
+     * @return 行数
+     */
+    size_t get_positions(const std::string& strategy_id, std::vector<PositionRecord>& records)
+    {
+        records.clear();
+        if (!strategy_id.empty()) {
+            PositionTable* table = position_table_for(strategy_id);
+            return table ? table->read_positions(strategy_id, records) : 0;
+        }
+
+        // 全部行：网关账户级在前，策略行在后
+        std::vector<PositionRecord> strategy_records;
+        if (open_position_table(account_position_table_, PositionTable::GATEWAY_TABLE)) {
+            account_position_table_->read_positions(strategy_id, records);
+        }
+        if (open_position_table(strategy_position_table_, PositionTable::EXECUTION_TABLE)) {
+            strategy_position_table_->read_positions(strategy_id, strategy_records);
+            records.insert(records.end(), strategy_records.begin(), strategy_records.end());
+        }
+        return records.size();
+    }
+
+    /**
+     * @brief 持仓表的全表更新序号，与上次比较即可知道是否有任何持仓变化
+     * @return 两张表更新序号之和（各自单调递增），持仓表都不存在时为0
+     */
+    uint64_t get_position_update_sequence()
+    {
+        uint64_t sequence = 0;
+        if (open_position_table(account_position_table_, PositionTable::GATEWAY_TABLE)) {
+            sequence += account_position_table_->update_sequence();
+        }
+        if (open_position_table(strategy_position_table_, PositionTable::EXECUTION_TABLE)) {
+            sequence += strategy_position_table_->update_sequence();
+        }
+        return sequence;
+    }
+
     /**
      * @brief 获取系统控制信息
      * @return 系统控制信息
@@ -292,6 +487,8 @@ public:
         uint64_t signals_sent = 0;
         uint64_t feedbacks_received = 0;
         std::unordered_map<SignalType, uint64_t> signal_type_counts;
+        uint64_t market_ticks_received = 0;
+        uint64_t market_ticks_lost = 0;                 ///< 处理过慢被行情环覆盖的条数
         SignalBuffer::Statistics signal_buffer_stats;
         OrderFeedbackBuffer::Statistics feedback_buffer_stats;
         PerformanceStats base_stats;
@@ -303,6 +500,8 @@ public:
         stats.signals_sent = signals_sent_;
         stats.feedbacks_received = feedbacks_received_;
         stats.signal_type_counts = signal_type_counts_;
+        stats.market_ticks_received = market_ticks_received_;
+        stats.market_ticks_lost = market_ticks_lost_;
         
         if (signal_buffer_) {
             stats.signal_buffer_stats = signal_buffer_->get_statistics();
@@ -359,6 +558,8 @@ public:
         signals_sent_ = 0;
         feedbacks_received_ = 0;
         signal_type_counts_.clear();
+        market_ticks_received_ = 0;
+        market_ticks_lost_ = 0;
         
         // 注意：缓冲区类暂时没有reset_statistics方法
         // 统计信息重置已在上面完成
@@ -392,6 +593,76 @@ private:
         signal_type_counts_[signal_type]++;
     }
 
+    /**
+     * @brief 首次使用时打开共享内存持仓表（只打开，从不创建或删除）
+     * @param table 持仓表句柄
+     * @param name 表名，PositionTable::GATEWAY_TABLE或EXECUTION_TABLE
+     * @return true 已打开，false 写者进程尚未创建
+     */
+    bool open_position_table(std::unique_ptr<PositionTable>& table, const char* name)
+    {
+        if (table) {
+            return true;
+        }
+        try {
+            table = std::make_unique<PositionTable>(name, false);
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 按策略ID选择持仓表：ACCOUNT行由网关写入，其余由执行引擎写入
+     * @param strategy_id 策略ID
+     * @return 已打开的持仓表，不存在时为nullptr
+     */
+    PositionTable* position_table_for(const std::string& strategy_id)
+    {
+        if (strategy_id == PositionTable::ACCOUNT_STRATEGY_ID) {
+            return open_position_table(account_position_table_, PositionTable::GATEWAY_TABLE)
+                ? account_position_table_.get() : nullptr;
+        }
+        return open_position_table(strategy_position_table_, PositionTable::EXECUTION_TABLE)
+            ? strategy_position_table_.get() : nullptr;
+    }
+
+    /**
+     * @brief 解析网关后来才登记的已订阅交易对
+     */
+    void resolve_market_data_symbols()
+    {
+        for (auto& entry : market_data_symbols_) {
+            if (entry.second != MarketDataSegment::INVALID_SYMBOL_INDEX) {
+                continue;
+            }
+            entry.second = market_data_->find_symbol(entry.first);
+            if (entry.second != MarketDataSegment::INVALID_SYMBOL_INDEX) {
+                subscribed_symbol_indices_[entry.second] = true;
+            }
+        }
+    }
+
+    /**
+     * @brief 已订阅交易对在行情段中的下标
+     * @param symbol 交易对
+     * @return 下标，未订阅或网关尚未登记时返回INVALID_SYMBOL_INDEX
+     */
+    uint32_t market_data_index(const std::string& symbol)
+    {
+        auto it = market_data_symbols_.find(symbol);
+        if (!market_data_ || it == market_data_symbols_.end()) {
+            return MarketDataSegment::INVALID_SYMBOL_INDEX;
+        }
+        if (it->second == MarketDataSegment::INVALID_SYMBOL_INDEX) {
+            it->second = market_data_->find_symbol(symbol);
+            if (it->second != MarketDataSegment::INVALID_SYMBOL_INDEX) {
+                subscribed_symbol_indices_[it->second] = true;
+            }
+        }
+        return it->second;
+    }
+
 private:
     std::unique_ptr<SignalBuffer> signal_buffer_;                    ///< 信号缓冲区
     std::unique_ptr<OrderFeedbackBuffer> order_feedback_buffer_;     ///< 订单反馈缓冲区
@@ -400,6 +671,18 @@ private:
     std::atomic<uint64_t> signals_sent_{0};                         ///< 发送信号计数
     std::atomic<uint64_t> feedbacks_received_{0};                    ///< 接收反馈计数
     std::unordered_map<SignalType, uint64_t> signal_type_counts_;    ///< 信号类型计数
+
+    std::unique_ptr<MarketDataSegment> market_data_;                 ///< 共享内存行情段（首次订阅时打开）
+    std::unordered_map<std::string, uint32_t> market_data_symbols_;  ///< 已订阅交易对 -> 行情段下标
+    std::vector<bool> subscribed_symbol_indices_ = std::vector<bool>(MarketDataSegment::MAX_SYMBOLS, false);
+    std::vector<MarketTick> tick_buffer_;                            ///< 行情环读取缓冲
+    uint64_t tick_cursor_ = 0;                                       ///< 本进程的行情环游标
+    uint64_t market_ticks_received_ = 0;                             ///< 接收行情计数
+    uint64_t market_ticks_lost_ = 0;                                 ///< 丢失行情计数
+
+    std::unique_ptr<PositionTable> account_position_table_;          ///< 网关账户级持仓表（首次读取时打开）
+    std::unique_ptr<PositionTable> strategy_position_table_;         ///< 执行引擎按策略持仓表（首次读取时打开）
+    std::unordered_map<std::string, uint32_t> position_rows_;        ///< 策略\0合约 -> 行下标
 };
 
 } // namespace interfaces
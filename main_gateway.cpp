@@ -14,6 +14,9 @@
 #include <set>
 #include <filesystem>
 #include <cmath>
+#include <array>
+#include <limits>
+#include <cstdio>
 #include <nlohmann/json.hpp>
 #include <ixwebsocket/IXHttpClient.h>
 
@@ -21,17 +24,28 @@
 #include "execution/types.h"
 #include "execution/order_manager.h"
 #include "execution/order_state_machine.h"
+#include "execution/lock_profiler.h"
+#include "execution/trading_rule_table.h"
+#include "execution/trading_rule_registry.h"
+#include "execution/trading_rule_checker.h"
+#include "execution/position_alignment_engine.h"
+#include "execution/timer_wheel.h"
+#include "execution/target_file_watcher.h"
+#include "shared_memory/core/target_position_table.h"
+#include "shared_memory/core/market_data_segment.h"
+#include "shared_memory/core/position_table.h"
 #include "3rd/gateway/include/binance_websocket.h"
 #include "3rd/gateway/include/data_structures.h"
 #include "3rd/gateway/include/config_manager.h"
 #include "3rd/gateway/include/exchange_interface.h"
+#include "3rd/gateway/include/order_template.h"
 
 using namespace tes::execution;
 using namespace trading;
 
 std::atomic<bool> g_running(true);
 std::atomic<bool> g_processing_positions(false);
-std::mutex g_file_mutex;
+NamedMutex g_file_mutex TES_LOCK_NAME("gateway.file_output");
 
 // 交易规则结构
 struct TradingRule {
@@ -62,13 +76,25 @@ public:
     double formatPrice(const std::string& symbol, double price) const;
     bool isValidOrder(const std::string& symbol, double quantity, double price) const;
     
+    // 后台定期刷新交易规则，source为空时使用币安exchangeInfo接口
+    bool startAutoRefresh(const std::string& apiKey, bool testnet, const std::string& source,
+                          std::chrono::milliseconds interval);
+    void stopAutoRefresh();
+    
 private:
-    std::unordered_map<std::string, TradingRule> trading_rules_;
-    std::mutex rules_mutex_;
+    // 规则表由TradingRuleRegistry原子发布，读者无锁访问，刷新线程在后台建表后整体替换
+    ExchangeRulesRefresher refresher_;
+    
+    static constexpr const char* SNAPSHOT_PATH = "config/exchange_info.bin";
+    static constexpr const char* EXCHANGE_INFO_JSON_PATH = "config/exchange_info.json";
+    static constexpr auto SNAPSHOT_MAX_AGE = std::chrono::hours(6);
+    
+    static std::string exchangeInfoUrl(bool testnet);
     
     std::string makeHttpRequest(const std::string& url, const std::string& apiKey) const;
     bool parseExchangeInfo(const std::string& jsonData);
     bool saveExchangeInfoToFile(const std::string& jsonData) const;
+    bool loadSnapshot();
 };
 
 // 系统配置结构
@@ -76,8 +102,9 @@ struct SystemConfig {
     std::string name;
     std::string version;
     int max_threads;
-    int signaltrans_mode;
+    int signaltrans_mode;                   // 1=JSON文件，2=共享内存目标仓位表
     std::string position_file;
+    std::string target_table_name;
     int update_interval_ms;
     double tolerance_threshold;
     bool enable_auto_sync;
@@ -103,8 +130,10 @@ struct SystemConfig {
     int max_slices;
     double default_participation_rate;
     int max_price_deviation_bps;
+    std::string exchange_info_source;       // 交易规则刷新来源（URL或本地文件），空则使用币安接口
+    int exchange_info_refresh_interval_ms;  // 交易规则刷新间隔，<=0关闭后台刷新
     
-    SystemConfig() : max_threads(8), signaltrans_mode(1), update_interval_ms(100),
+    SystemConfig() : max_threads(8), signaltrans_mode(1), target_table_name("positions"), update_interval_ms(100),
                      tolerance_threshold(0.001), enable_auto_sync(true),
                      output_directory("./output"), filename_prefix("order_feedback"),
                      append_timestamp(true), pretty_print(true), testnet(false),
@@ -112,7 +141,7 @@ struct SystemConfig {
                      value_threshold(1000000.0), market_impact_threshold(0.05),
                      default_duration_minutes(30), min_slice_size(100.0),
                      max_slices(200), default_participation_rate(0.2),
-                     max_price_deviation_bps(50) {}
+                     max_price_deviation_bps(50), exchange_info_refresh_interval_ms(900000) {}
 };
 
 // 目标仓位信息结构
@@ -167,10 +196,13 @@ struct TWAPOrder {
     bool is_final_slice;             // 新增：是否为最后切片
     std::vector<std::string> pending_order_ids; // 新增：待处理订单ID列表
     std::chrono::time_point<std::chrono::steady_clock> slice_start_time; // 新增：切片开始时间
+    TimerId next_slice_timer;        // 待触发的下一切片计算
+    TimerId slice_order_timer;       // 待触发的延迟切片下单
     
     TWAPOrder() : total_quantity(0.0), remaining_quantity(0.0), unfilled_quantity(0.0),
                   target_price(0.0), slices_count(0), current_slice(0),
-                  slice_interval(30000), is_active(false), is_final_slice(false) {}
+                  slice_interval(30000), is_active(false), is_final_slice(false),
+                  next_slice_timer(INVALID_TIMER_ID), slice_order_timer(INVALID_TIMER_ID) {}
 };
 
 // 信号处理
@@ -201,6 +233,8 @@ public:
         order_manager_->set_order_event_callback([this](const Order& order) {
             this->on_order_event(order);
         });
+        
+        alignment_engine_.reset(new PositionAlignmentEngine());
     }
 
     ~TradingSystemManager()
@@ -231,6 +265,13 @@ public:
             }
             std::cout << "Exchange trading rules loaded successfully" << std::endl;
             
+            if (system_config_.exchange_info_refresh_interval_ms > 0) {
+                ruleManager.startAutoRefresh(system_config_.ed25519_api_key,
+                                             system_config_.testnet,
+                                             system_config_.exchange_info_source,
+                                             std::chrono::milliseconds(system_config_.exchange_info_refresh_interval_ms));
+            }
+            
             // 3. 创建输出目录
             if (!create_directory(system_config_.output_directory)) {
                 std::cerr << "Failed to create output directory: " << system_config_.output_directory << std::endl;
@@ -257,6 +298,57 @@ public:
             
             std::cout << "Order state machine initialized and started successfully" << std::endl;
 
+            // 4.0 目标仓位来源：共享内存目标仓位表，或监听目标仓位文件
+            if (system_config_.signaltrans_mode == 2) {
+                target_table_ = std::make_unique<tes::shared_memory::TargetPositionTable>(
+                    system_config_.target_table_name, true);
+                std::cout << "Target position table created: " << system_config_.target_table_name << std::endl;
+            } else {
+                target_watcher_ = TargetFileWatcher::acquire(position_file_path_);
+                if (!target_watcher_->current()) {
+                    std::cerr << "Failed to load position file: " << position_file_path_ << std::endl;
+                    return false;
+                }
+            }
+
+            // 4.1 启动定时器（TWAP切片间隔、订单仓位核对等延时任务）
+            if (!timer_wheel_.start()) {
+                std::cerr << "Failed to start timer wheel" << std::endl;
+                return false;
+            }
+
+            // 4.2 初始化事件驱动调仓引擎
+            PositionAlignmentEngine::Config alignment_config;
+            alignment_config.order_timeout = ORDER_COMPLETION_TIMEOUT;
+            alignment_config.absolute_tolerance = system_config_.tolerance_threshold;
+            if (!alignment_engine_->initialize(alignment_config,
+                    [this](const std::string& symbol, double current_qty, double target_qty) {
+                        return dispatch_alignment_order(symbol, current_qty, target_qty);
+                    },
+                    [this](const AlignmentReport& report) {
+                        on_alignment_complete(report);
+                    }) || !alignment_engine_->start()) {
+                std::cerr << "Failed to start position alignment engine" << std::endl;
+                return false;
+            }
+
+            // 4.3 创建共享内存行情段，本机策略进程共用网关的深度行情
+            try {
+                market_data_segment_ = std::make_unique<tes::shared_memory::MarketDataSegment>(
+                    tes::shared_memory::MarketDataSegment::GATEWAY_SEGMENT, true);
+            } catch (const std::exception& e) {
+                std::cerr << "[WARNING] Market data segment unavailable, strategies will not receive shared market data: "
+                          << e.what() << std::endl;
+            }
+
+            // 4.4 创建共享内存持仓表，账户仓位和盈亏随成交和行情实时写入
+            try {
+                position_table_ = std::make_unique<tes::shared_memory::PositionTable>(
+                    tes::shared_memory::PositionTable::GATEWAY_TABLE, true);
+            } catch (const std::exception& e) {
+                std::cerr << "[WARNING] Shared position table unavailable: " << e.what() << std::endl;
+            }
+
             // 5. 初始化Gateway接口
             if (!initialize_gateway()) {
                 std::cerr << "Failed to initialize gateway interface" << std::endl;
@@ -286,8 +378,13 @@ public:
             position_monitor_thread_.reset(new std::thread(&TradingSystemManager::position_monitor_worker, this));
             std::cout << "Position monitor thread created" << std::endl;
 
-            // 初始化市场数据订阅
+            // 订阅目标仓位文件变化；订阅时会补发当前快照，完成初始行情订阅
             std::cout << "Initializing market subscriptions..." << std::endl;
+            if (target_watcher_) {
+                target_subscription_id_ = target_watcher_->subscribe([this](const TargetFileDelta& delta) {
+                    on_target_file_changed(delta);
+                });
+            }
             update_market_subscriptions();
             std::cout << "Market subscriptions initialized" << std::endl;
 
@@ -318,6 +415,15 @@ public:
     {
         std::cout << "Stopping trading system..." << std::endl;
         g_running.store(false);
+        
+        if (target_watcher_) {
+            target_watcher_->unsubscribe(target_subscription_id_);
+        }
+        {
+            std::lock_guard<NamedMutex> lock(target_event_mutex_);
+            target_changed_ = true;
+        }
+        target_event_cv_.notify_all();
 
         if (account_update_thread_ && account_update_thread_->joinable()) {
             account_update_thread_->join();
@@ -326,6 +432,15 @@ public:
         if (position_monitor_thread_ && position_monitor_thread_->joinable()) {
             position_monitor_thread_->join();
         }
+        
+        // 先停定时器，之后不再有延时回调访问下面要关闭的组件
+        timer_wheel_.stop();
+
+        if (alignment_engine_) {
+            alignment_engine_->stop();
+        }
+
+        TradingRuleManager::getInstance().stopAutoRefresh();
 
         // 断开Gateway连接
         if (binance_ws_) {
@@ -353,60 +468,102 @@ private:
     std::unique_ptr<std::thread> position_monitor_thread_;
     
     std::vector<TargetPosition> target_positions_;
-    std::mutex target_positions_mutex_;
+    NamedMutex target_positions_mutex_ TES_LOCK_NAME("gateway.target_positions");
     
     // 当前仓位信息存储
     std::unordered_map<std::string, CurrentPosition> current_positions_;
-    std::mutex current_positions_mutex_;
+    NamedMutex current_positions_mutex_ TES_LOCK_NAME("gateway.current_positions");
     
     // 行情数据存储
     std::unordered_map<std::string, MarketDepth> market_depths_;
-    std::mutex market_depths_mutex_;
+    NamedMutex market_depths_mutex_ TES_LOCK_NAME("gateway.market_depths");
     
     // TWAP订单管理
     std::vector<TWAPOrder> active_twap_orders_;
-    std::mutex twap_orders_mutex_;
+    NamedMutex twap_orders_mutex_ TES_LOCK_NAME("gateway.twap_orders");
     
     // Gateway接口集成
     std::shared_ptr<IExchangeWebSocket> binance_ws_;
-    std::mutex gateway_mutex_;
+    NamedMutex gateway_mutex_ TES_LOCK_NAME("gateway.connection");
     bool gateway_connected_;
     
     // 当前订阅的交易对集合
     std::set<std::string> subscribed_symbols_;
-    std::mutex subscribed_symbols_mutex_;
+    NamedMutex subscribed_symbols_mutex_ TES_LOCK_NAME("gateway.subscribed_symbols");
     
     // 实时数据接收标志
     std::atomic<bool> positions_updated_;
     std::atomic<bool> market_data_updated_;
 
     // 事件驱动架构 - 条件变量和同步机制
-    std::condition_variable account_update_cv_;
-    std::mutex account_update_mutex_;
+    NamedConditionVariable account_update_cv_;
+    NamedMutex account_update_mutex_ TES_LOCK_NAME("gateway.account_update");
     std::atomic<bool> account_data_ready_{false};
     
-    std::condition_variable order_completion_cv_;
-    std::mutex order_completion_mutex_;
-    std::atomic<bool> order_completed_{false};
-    
-    std::condition_variable position_alignment_cv_;
-    std::mutex position_alignment_mutex_;
+    NamedConditionVariable position_alignment_cv_;
+    NamedMutex position_alignment_mutex_ TES_LOCK_NAME("gateway.position_alignment");
     std::atomic<bool> position_alignment_completed_{false};
     
+    // 事件驱动调仓
+    std::unique_ptr<PositionAlignmentEngine> alignment_engine_;
+    std::atomic<int64_t> alignment_retry_after_ns_{0};   // 上一轮未完成时，下一轮的最早开始时间
+    
+    // 目标仓位文件监听（与SignalTransmissionManager共享同一实例）
+    std::shared_ptr<TargetFileWatcher> target_watcher_;
+    uint64_t target_subscription_id_{0};
+    NamedMutex target_event_mutex_ TES_LOCK_NAME("gateway.target_event");
+    NamedConditionVariable target_event_cv_;
+    bool target_changed_{false};
+    
+    // 共享内存目标仓位表（signaltrans_mode=2）：策略发布，网关通过确认字回写完成状态
+    std::unique_ptr<tes::shared_memory::TargetPositionTable> target_table_;
+    std::atomic<uint64_t> aligning_target_generation_{0};   // 本轮调仓对应的表代数
+    
+    // 共享内存行情段：深度回调写入，策略进程通过StrategyInterface订阅读取
+    std::unique_ptr<tes::shared_memory::MarketDataSegment> market_data_segment_;
+    
+    // 共享内存持仓表：账户级仓位按ACCOUNT行写入，策略进程无系统调用读取
+    std::unique_ptr<tes::shared_memory::PositionTable> position_table_;
+    
+    // 延时任务：所有延时回调共用一个定时线程，不再为每个任务起一个sleep线程
+    TimerWheel timer_wheel_;
+    
+    // NEW订单的仓位核对定时器，订单终态后取消
+    struct PositionCheck {
+        std::string symbol;
+        std::string client_order_id;
+        std::string side;
+        std::string orig_qty;
+        double expected_qty;
+        double initial_position;
+        int attempt;
+    };
+    std::unordered_map<std::string, TimerId> position_check_timers_;
+    NamedMutex position_check_timers_mutex_ TES_LOCK_NAME("gateway.position_check_timers");
+    
     // 超时配置
     static constexpr auto ACCOUNT_UPDATE_TIMEOUT = std::chrono::seconds(10);
     static constexpr auto ORDER_COMPLETION_TIMEOUT = std::chrono::seconds(15);
+    static constexpr auto ALIGNMENT_RETRY_DELAY = std::chrono::seconds(2);
     static constexpr auto POSITION_ALIGNMENT_TIMEOUT = std::chrono::seconds(5);
 
     // 订单管理器
     std::unique_ptr<OrderManager> order_manager_;
     std::unique_ptr<OrderStateMachine> order_state_machine_;
-    std::mutex pending_orders_mutex_;
+    NamedMutex pending_orders_mutex_ TES_LOCK_NAME("gateway.pending_orders");
     std::set<std::string> pending_orders_;
     
     // 订单错误记录
     std::unordered_map<std::string, std::string> order_errors_;
-    std::mutex order_errors_mutex_;
+    NamedMutex order_errors_mutex_ TES_LOCK_NAME("gateway.order_errors");
+    
+    // 下单模板句柄缓存：symbol -> {开仓模板, 平仓模板}，按注册时的交易规则版本失效
+    struct CachedOrderTemplates {
+        std::array<int, 2> handles{{-1, -1}};
+        uint64_t rule_version = 0;
+    };
+    std::unordered_map<std::string, CachedOrderTemplates> order_templates_;
+    NamedMutex order_templates_mutex_ TES_LOCK_NAME("gateway.order_templates");
 
     // 初始化Gateway接口
     bool initialize_gateway()
@@ -476,9 +633,9 @@ private:
     // 设置Gateway回调函数
     void setup_gateway_callbacks(std::shared_ptr<IExchangeWebSocket> client)
     {
-        // 设置账户信息回调
-        client->setAccountInfoCallback([this](const AccountInfoResponse& response) {
-            this->on_account_info_received(response);
+        // 设置账户信息回调（视图模式，只解码symbol/positionSide/positionAmt）
+        client->setAccountInfoViewCallback([this](const AccountInfoView& view) {
+            this->on_account_info_received(view);
         });
         
         // 设置账户更新回调
@@ -496,11 +653,22 @@ private:
             this->on_depth_update_received(update);
         });
         
+        // 设置公开成交回调（<symbol>@aggTrade）：写入共享内存行情环；
+        // 本账户自己的成交（TRADE_LITE）不进行情环，避免被策略当作市场成交
+        client->setAggTradeCallback([this](const AggTrade& trade) {
+            this->publish_shared_trade(trade);
+        });
+        
         // 设置订单响应回调
         client->setOrderResponseCallback([this](const OrderResponse& response) {
             this->on_order_response_received(response);
         });
         
+        // 设置订单推送回调（ORDER_TRADE_UPDATE，视图模式只读取交易对和状态）
+        client->setOrderUpdateViewCallback([this](const OrderUpdateView& update) {
+            this->on_order_update_received(update);
+        });
+        
         // 设置错误回调
         client->setErrorCallback([this](const std::string& error) {
             std::cerr << "Gateway error: " << error << std::endl;
@@ -508,149 +676,90 @@ private:
     }
 
     // Gateway回调处理函数
-    // 从pos_update.json获取所有交易对
-    std::set<std::string> get_all_symbols_from_config()
+    void on_account_info_received(const AccountInfoView& response)
     {
-        std::set<std::string> symbols;
-        
-        try {
-            nlohmann::json pos_data;
-            if (read_position_file(pos_data)) {
-                if (pos_data.is_array()) {
-                    for (const auto& item : pos_data) {
-                        // 只处理包含symbol字段的对象
-                        if (item.contains("symbol") && item["symbol"].is_string()) {
-                            std::string symbol = item["symbol"];
-                            symbols.insert(symbol);
-                            std::cout << "Found symbol in config: " << symbol << std::endl;
-                        }
-                    }
-                }
-            }
-            
-            // 如果没有找到任何交易对，使用默认值
-            if (symbols.empty()) {
-                std::cout << "No symbols found in config, using defaults" << std::endl;
-                return symbols;
+        std::lock_guard<NamedMutex> lock(current_positions_mutex_);
+        
+        // 本轮快照的刷新时间戳：原地更新的记录打上该时间戳，未被刷新的旧记录最后统一删除，
+        // 避免先清空再整体重建；行级处理不输出日志，只在结尾打印汇总
+        const auto refresh_time = std::chrono::high_resolution_clock::now();
+        size_t api_positions = 0;
+        size_t skipped_positions = 0;
+        std::string key;
+        
+        auto refresh_position = [&](double quantity, double entry_price, double unrealized_pnl) {
+            auto it = current_positions_.find(key);
+            if (it == current_positions_.end()) {
+                it = current_positions_.emplace(key, CurrentPosition()).first;
+                it->second.symbol = key;
+            }
+            it->second.quantity = quantity;
+            it->second.entry_price = entry_price;
+            it->second.unrealized_pnl = unrealized_pnl;
+            it->second.last_update = refresh_time;
+        };
+        
+        // 单向持仓模式下positionSide为"BOTH"，positionAmt直接表示净仓位（正多负空），零仓位也记录
+        response.forEachPosition([&](const AccountPositionView& pos) {
+            std::string_view symbol = pos.symbol();
+            if (symbol.empty() || pos.positionAmt().empty()) {
+                ++skipped_positions;
+                return;
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Error reading symbols from config: " << e.what() << std::endl;
-            return symbols;
-        }
-        
-        return symbols;
-    }
-
-    void on_account_info_received(const AccountInfoResponse& response)
-    {
-        std::lock_guard<std::mutex> lock(current_positions_mutex_);
-        
-        std::cout << "[DEBUG] Received account info with " << response.positions.size() << " positions" << std::endl;
-        
-        // 先记录当前缓存的仓位数据用于对比
-        std::cout << "[DEBUG] Current cached positions before update:" << std::endl;
-        for (const auto& pair : current_positions_) {
-            std::cout << "[DEBUG]   " << pair.first << ": " << pair.second.quantity << std::endl;
-        }
-        
-        // 清空当前仓位信息，确保使用最新的API数据
-        current_positions_.clear();
-        std::cout << "[DEBUG] Cleared all cached positions" << std::endl;
-        
-        // 计算每个交易对的净仓位（单向持仓模式）
-        std::unordered_map<std::string, double> net_positions;
+            key.assign(symbol.data(), symbol.size());
+            double position_amt = pos.positionAmtValue();
+            double entry_price = pos.entryPrice();
+            double unrealized_pnl = pos.unrealizedProfit();
+            publish_account_position(key, position_amt, entry_price, unrealized_pnl,
+                                     std::numeric_limits<double>::quiet_NaN());
+            refresh_position(position_amt, entry_price, unrealized_pnl);
+            ++api_positions;
+        });
         
-        for (const auto& pos : response.positions) {
-            try {
-                double position_amt = std::stod(pos.positionAmt);
-                std::cout << "[DEBUG] Processing position from API: " << pos.symbol 
-                         << " positionSide: " << pos.positionSide 
-                         << " positionAmt: " << pos.positionAmt 
-                         << " (parsed: " << position_amt << ")" << std::endl;
-                
-                // 在单向持仓模式下，positionSide应该是"BOTH"，positionAmt直接表示净仓位
-                // 正数表示多头，负数表示空头
-                // 记录所有仓位，包括零仓位，以确保数据完整性
-                net_positions[pos.symbol] = position_amt;
-                
-                if (std::abs(position_amt) > system_config_.tolerance_threshold) {
-                    std::cout << "[DEBUG] Found non-zero position: " << pos.symbol 
-                             << " net position: " << position_amt << std::endl;
-                } else {
-                    std::cout << "[DEBUG] Found zero position: " << pos.symbol 
-                             << " net position: " << position_amt << std::endl;
+        // 配置文件中有而API未返回的交易对按零仓位记录
+        auto snapshot = current_target_snapshot();
+        if (snapshot) {
+            for (const auto& entry : snapshot->targets) {
+                auto it = current_positions_.find(entry.symbol);
+                if (it == current_positions_.end() || it->second.last_update != refresh_time) {
+                    key = entry.symbol;
+                    refresh_position(0.0, 0.0, 0.0);
                 }
-            } catch (const std::exception& e) {
-                std::cout << "[ERROR] Error parsing position amount for " << pos.symbol << ": " << pos.positionAmt 
-                         << " - " << e.what() << std::endl;
-                continue;
             }
         }
         
-        // 获取配置文件中的所有交易对
-        std::set<std::string> config_symbols = get_all_symbols_from_config();
-        
-        // 合并API返回的仓位和配置文件中的交易对
-        std::set<std::string> all_symbols = config_symbols;
-        for (const auto& pair : net_positions) {
-            all_symbols.insert(pair.first);
-        }
-        
-        std::cout << "[DEBUG] Processing " << all_symbols.size() << " symbols total" << std::endl;
-        
-        // 更新所有交易对的仓位记录，强制使用最新API数据
-        for (const auto& symbol : all_symbols) {
-            double net_qty = 0.0;
-            if (net_positions.find(symbol) != net_positions.end()) {
-                net_qty = net_positions[symbol];
+        // 删除本轮既不在API返回中也不在配置中的旧记录
+        for (auto it = current_positions_.begin(); it != current_positions_.end();) {
+            if (it->second.last_update != refresh_time) {
+                it = current_positions_.erase(it);
+            } else {
+                ++it;
             }
-            
-            // 创建新的仓位记录，确保使用最新数据
-            CurrentPosition current_pos;
-            current_pos.symbol = symbol;
-            current_pos.quantity = net_qty;
-            current_pos.entry_price = 0.0;
-            current_pos.unrealized_pnl = 0.0;
-            current_pos.last_update = std::chrono::high_resolution_clock::now();
-            
-            // 直接插入新记录，避免查找和更新的竞态条件
-            current_positions_[symbol] = current_pos;
-            
-            std::cout << "[DEBUG] Created/Updated position record: " << symbol 
-                     << " quantity: " << net_qty 
-                     << " (from " << (net_positions.find(symbol) != net_positions.end() ? "API" : "default") << ")" << std::endl;
         }
         
-        std::cout << "[DEBUG] Position update complete. Total positions: " << current_positions_.size() << std::endl;
-        
-        // 验证关键仓位数据
-        std::cout << "[DEBUG] Final position verification:" << std::endl;
         for (const auto& pair : current_positions_) {
-            std::cout << "[DEBUG]   " << pair.first << ": " << pair.second.quantity << std::endl;
-        }
-        
-        // 特别验证APRUSDT
-        auto aprusdt_it = current_positions_.find("APRUSDT");
-        if (aprusdt_it != current_positions_.end()) {
-            std::cout << "[CRITICAL] APRUSDT position after update: " << aprusdt_it->second.quantity << std::endl;
-        } else {
-            std::cout << "[CRITICAL] APRUSDT position not found after update!" << std::endl;
+            alignment_engine_->on_position_update(pair.first, pair.second.quantity);
         }
         
         positions_updated_.store(true);
         
         // 事件驱动架构 - 通知等待账户数据的线程
         {
-            std::lock_guard<std::mutex> notify_lock(account_update_mutex_);
+            std::lock_guard<NamedMutex> notify_lock(account_update_mutex_);
             account_data_ready_.store(true);
         }
         account_update_cv_.notify_all();
-        std::cout << "[DEBUG] Account data ready, notified waiting threads" << std::endl;
+        std::cout << "Account info applied: " << api_positions << " positions from API, "
+                  << current_positions_.size() << " tracked";
+        if (skipped_positions != 0) {
+            std::cout << ", " << skipped_positions << " malformed skipped";
+        }
+        std::cout << std::endl;
     }
 
     void on_position_update_received(const PositionUpdate& update)
     {
-        std::lock_guard<std::mutex> lock(current_positions_mutex_);
+        std::lock_guard<NamedMutex> lock(current_positions_mutex_);
         
         try {
             CurrentPosition current_pos;
@@ -661,6 +770,9 @@ private:
             current_pos.last_update = std::chrono::high_resolution_clock::now();
             
             current_positions_[update.symbol] = current_pos;
+            alignment_engine_->on_position_update(update.symbol, current_pos.quantity);
+            publish_account_position(update.symbol, current_pos.quantity, current_pos.entry_price,
+                                     current_pos.unrealized_pnl, std::numeric_limits<double>::quiet_NaN());
             
             std::cout << "Position update received: " << update.symbol 
                      << " quantity: " << current_pos.quantity 
@@ -675,7 +787,7 @@ private:
 
     void on_account_update_received(const AccountUpdate& update)
     {
-        std::lock_guard<std::mutex> lock(current_positions_mutex_);
+        std::lock_guard<NamedMutex> lock(current_positions_mutex_);
         
         std::cout << "[DEBUG] Account update received: eventType=" << update.eventType 
                  << " eventTime=" << update.eventTime 
@@ -723,6 +835,12 @@ private:
                     current_positions_[pos.symbol] = current_pos;
                 }
                 
+                // 仓位增量直接推动调仓状态机，无需再请求账户信息
+                alignment_engine_->on_position_update(pos.symbol, position_amt);
+                publish_account_position(pos.symbol, position_amt, entry_price, unrealized_pnl,
+                                         pos.cumulativeRealized.empty() ? std::numeric_limits<double>::quiet_NaN()
+                                                                        : std::stod(pos.cumulativeRealized));
+                
                 std::cout << "[DEBUG] Position update completed: " << pos.symbol 
                          << " final quantity: " << current_positions_[pos.symbol].quantity 
                          << " entry_price: " << current_positions_[pos.symbol].entry_price 
@@ -737,9 +855,20 @@ private:
         positions_updated_.store(true);
     }
 
+    void on_order_update_received(const OrderUpdateView& update)
+    {
+        std::string_view status = update.orderStatus();
+        if (status == "FILLED" || status == "CANCELED" || status == "EXPIRED" ||
+            status == "REJECTED" || status == "EXPIRED_IN_MATCH") {
+            alignment_engine_->on_order_finished(std::string(update.symbol()));
+        }
+    }
+
     void on_depth_update_received(const DepthUpdate& update)
     {
-        std::lock_guard<std::mutex> lock(market_depths_mutex_);
+        publish_shared_quote(update);
+        
+        std::lock_guard<NamedMutex> lock(market_depths_mutex_);
         
         if (!update.bids.empty() && !update.asks.empty()) {
             MarketDepth depth;
@@ -764,6 +893,84 @@ private:
         }
     }
 
+    // 把账户仓位写入共享内存持仓表；realized_pnl为NaN表示本次事件不含已实现盈亏，沿用表中的值
+    void publish_account_position(const std::string& symbol, double quantity, double entry_price,
+                                  double unrealized_pnl, double realized_pnl)
+    {
+        if (!position_table_) {
+            return;
+        }
+        
+        tes::shared_memory::PositionRecord record;
+        if (std::isnan(realized_pnl)) {
+            tes::shared_memory::PositionRecord previous;
+            if (position_table_->read_position(tes::shared_memory::PositionTable::ACCOUNT_STRATEGY_ID, symbol, previous)) {
+                realized_pnl = previous.realized_pnl;
+            } else {
+                realized_pnl = 0.0;
+            }
+        }
+        record.strategy_id = tes::shared_memory::PositionTable::ACCOUNT_STRATEGY_ID;
+        record.instrument_id = symbol;
+        record.net_quantity = quantity;
+        record.average_cost = entry_price;
+        record.realized_pnl = realized_pnl;
+        record.unrealized_pnl = unrealized_pnl;
+        position_table_->update_position(record);
+    }
+
+    // 把最优价写入共享内存行情段，并按中间价刷新持仓表的标记价格（不持有market_depths_mutex_）
+    void publish_shared_quote(const DepthUpdate& update)
+    {
+        if ((!market_data_segment_ && !position_table_) || update.bids.empty() || update.asks.empty()) {
+            return;
+        }
+        
+        try {
+            tes::shared_memory::TopOfBook quote;
+            quote.bid_price = std::stod(update.bids[0].price);
+            quote.bid_volume = std::stod(update.bids[0].quantity);
+            quote.ask_price = std::stod(update.asks[0].price);
+            quote.ask_volume = std::stod(update.asks[0].quantity);
+            quote.exchange_timestamp = static_cast<uint64_t>(update.eventTime);
+            quote.local_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            quote.update_id = static_cast<uint64_t>(update.finalUpdateId);
+            if (market_data_segment_) {
+                market_data_segment_->publish_quote(update.symbol, quote);
+            }
+            if (position_table_) {
+                position_table_->update_mark_price(update.symbol, (quote.bid_price + quote.ask_price) / 2.0);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error publishing shared market data for " << update.symbol << ": " << e.what() << std::endl;
+        }
+    }
+
+    // 把公开成交写入共享内存行情环；买方是做市方时主动方为卖方
+    void publish_shared_trade(const AggTrade& trade)
+    {
+        if (!market_data_segment_ || trade.symbol.empty()) {
+            return;
+        }
+        
+        double last_price = std::strtod(trade.price.c_str(), nullptr);
+        double last_quantity = std::strtod(trade.quantity.c_str(), nullptr);
+        if (!(last_price > 0.0) || !(last_quantity > 0.0)) {
+            return;
+        }
+        
+        tes::shared_memory::MarketTick tick;
+        tick.side = trade.isBuyerMaker ? tes::shared_memory::OrderSide::SELL : tes::shared_memory::OrderSide::BUY;
+        tick.price = last_price;
+        tick.quantity = last_quantity;
+        tick.trade_id = static_cast<uint64_t>(trade.aggTradeId);
+        tick.exchange_timestamp = static_cast<uint64_t>(trade.tradeTime ? trade.tradeTime : trade.eventTime);
+        tick.local_timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        market_data_segment_->publish_trade(trade.symbol, tick);
+    }
+
     void on_order_response_received(const OrderResponse& response)
     {
         std::cout << "Order response: " << response.symbol 
@@ -776,7 +983,7 @@ private:
             std::cout << "Empty order response detected - likely order failure, clearing pending orders" << std::endl;
             // 清理所有待处理订单，避免阻塞后续操作
             {
-                std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+                std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
                 pending_orders_.clear();
             }
             
@@ -813,7 +1020,7 @@ private:
         
         // 订单成交后，立即请求更新账户信息以获取最新仓位
         if (response.status_str == "FILLED" || response.status_str == "PARTIALLY_FILLED") {
-            std::cout << "Order " << response.status_str << ", requesting account update..." << std::endl;
+            std::cout << "Order " << response.status_str << ", waiting for ACCOUNT_UPDATE..." << std::endl;
             
             // 处理部分成交情况
             double executed_qty = 0.0;
@@ -840,15 +1047,6 @@ private:
                 // cancel_remaining_order(response.orderId, response.symbol);
             }
             
-            if (binance_ws_) {
-                try {
-                    // 请求账户信息更新
-                    binance_ws_->requestAccountInfo();
-                } catch (const std::exception& e) {
-                    std::cerr << "Error requesting account info after order fill: " << e.what() << std::endl;
-                }
-            }
-            
             // 更新TWAP执行进度（只更新已成交部分）
             if (executed_qty > 0) {
                 update_twap_progress(response.symbol, executed_qty);
@@ -856,21 +1054,19 @@ private:
             
             // 从待处理订单列表中移除
             {
-                std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+                std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
                 pending_orders_.erase(response.clientOrderId);
                 
                 // 同时移除基于订单特征的键
                 std::string order_key = response.symbol + "_" + response.side + "_" + response.origQty;
                 pending_orders_.erase(order_key);
             }
+            finish_position_check(response.clientOrderId);
             
-            // 事件驱动架构 - 通知订单执行完成
-            {
-                std::lock_guard<std::mutex> notify_lock(order_completion_mutex_);
-                order_completed_.store(true);
+            // 事件驱动架构 - 通知调仓引擎订单已终态
+            if (response.status_str == "FILLED") {
+                alignment_engine_->on_order_finished(response.symbol);
             }
-            order_completion_cv_.notify_all();
-            std::cout << "[DEBUG] Order execution completed, notified waiting threads" << std::endl;
         } else if (response.status_str == "CANCELLED" || response.status_str == "REJECTED") {
             // 订单被取消或拒绝，从待处理列表中移除
             std::cout << "Order " << response.status_str << ", removing from pending list" << std::endl;
@@ -899,118 +1095,161 @@ private:
                 record_order_error(response.symbol, error_msg);
             }
             
-            std::lock_guard<std::mutex> lock(pending_orders_mutex_);
-            pending_orders_.erase(response.clientOrderId);
-            
-            std::string order_key = response.symbol + "_" + response.side + "_" + response.origQty;
-            pending_orders_.erase(order_key);
+            {
+                std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
+                pending_orders_.erase(response.clientOrderId);
+                
+                std::string order_key = response.symbol + "_" + response.side + "_" + response.origQty;
+                pending_orders_.erase(order_key);
+            }
+            finish_position_check(response.clientOrderId);
+            alignment_engine_->on_order_finished(response.symbol);
         } else if (response.status_str == "NEW") {
             // 订单已创建，保持在待处理列表中直到成交或取消
             std::cout << "Order " << response.status_str << ", keeping in pending list until filled or cancelled" << std::endl;
             
             // 添加仓位变化检测机制，不仅依赖订单状态
-            std::thread([this, symbol = response.symbol, client_order_id = response.clientOrderId, expected_qty = std::stod(response.origQty), side = response.side, orig_qty = response.origQty]() {
-                std::this_thread::sleep_for(std::chrono::seconds(5)); // 5秒后开始检测
-                
+            std::shared_ptr<PositionCheck> check(new PositionCheck());
+            check->symbol = response.symbol;
+            check->client_order_id = response.clientOrderId;
+            check->side = response.side;
+            check->orig_qty = response.origQty;
+            check->expected_qty = std::stod(response.origQty);
+            check->initial_position = 0.0;
+            check->attempt = 0;
+            schedule_position_check(check, std::chrono::seconds(5), [this, check]() { // 5秒后开始检测
                 // 获取订单提交前的仓位
-                double initial_position = 0.0;
                 {
-                    std::lock_guard<std::mutex> lock(current_positions_mutex_);
-                    auto it = current_positions_.find(symbol);
+                    std::lock_guard<NamedMutex> lock(current_positions_mutex_);
+                    auto it = current_positions_.find(check->symbol);
                     if (it != current_positions_.end()) {
-                        initial_position = it->second.quantity;
+                        check->initial_position = it->second.quantity;
                     }
                 }
-                
-                // 定期检测仓位变化，最多检测6次（30秒）
-                for (int i = 0; i < 6; ++i) {
-                    std::this_thread::sleep_for(std::chrono::seconds(5));
-                    
-                    // 检查订单是否仍在待处理列表中
-                    bool order_still_pending = false;
-                    {
-                        std::lock_guard<std::mutex> lock(pending_orders_mutex_);
-                        order_still_pending = pending_orders_.count(client_order_id) > 0;
-                    }
-                    
-                    if (!order_still_pending) {
-                        std::cout << "[POSITION_CHECK] Order " << client_order_id << " no longer pending, stopping position check" << std::endl;
-                        break;
-                    }
-                    
-                    // 强制刷新仓位数据
-                    if (binance_ws_) {
-                        try {
-                            binance_ws_->requestAccountInfo();
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1000)); // 等待数据更新
-                        } catch (const std::exception& e) {
-                            std::cerr << "Error requesting account info for position check: " << e.what() << std::endl;
-                        }
-                    }
-                    
-                    // 检查仓位是否发生变化
-                    double current_position = 0.0;
-                    {
-                        std::lock_guard<std::mutex> lock(current_positions_mutex_);
-                        auto it = current_positions_.find(symbol);
-                        if (it != current_positions_.end()) {
-                            current_position = it->second.quantity;
-                        }
-                    }
-                    
-                    double position_change = current_position - initial_position;
-                    double expected_change = (side == "BUY") ? expected_qty : -expected_qty;
-                    
-                    std::cout << "[POSITION_CHECK] " << symbol << " position change: " << position_change 
-                              << ", expected: " << expected_change << std::endl;
-                    
-                    // 如果仓位变化符合预期，说明订单已成交
-                    if (std::abs(position_change - expected_change) < 1.0) { // 允许1个单位的误差
-                        std::cout << "[POSITION_CHECK] Order " << client_order_id << " detected as filled by position change" << std::endl;
-                        
-                        // 从待处理订单列表中移除
-                        {
-                             std::lock_guard<std::mutex> lock(pending_orders_mutex_);
-                             pending_orders_.erase(client_order_id);
-                             std::string order_key = symbol + "_" + side + "_" + orig_qty;
-                             pending_orders_.erase(order_key);
-                         }
-                        
-                        // 触发TWAP进度更新
-                        update_twap_progress(symbol, expected_qty);
-                        
-                        // 通知订单执行完成
-                        {
-                            std::lock_guard<std::mutex> notify_lock(order_completion_mutex_);
-                            order_completed_.store(true);
-                        }
-                        order_completion_cv_.notify_all();
-                        std::cout << "[POSITION_CHECK] Order execution completed by position detection, notified waiting threads" << std::endl;
-                        
-                        break;
-                    }
-                }
-                
-                // 最终超时处理
-                bool order_still_pending = false;
-                {
-                    std::lock_guard<std::mutex> lock(pending_orders_mutex_);
-                    order_still_pending = pending_orders_.count(client_order_id) > 0;
-                }
-                
-                if (order_still_pending) {
-                    std::cout << "[TIMEOUT] Order " << client_order_id << " timeout after position checks, forcing TWAP continuation" << std::endl;
-                    // 强制触发下一个TWAP切片
-                    update_twap_progress(symbol, 0.0); // 使用0表示超时触发
-                }
-            }).detach();
+                schedule_position_check(check, std::chrono::seconds(5), [this, check]() { run_position_check(check); });
+            });
+        }
+    }
+    
+    // 仓位核对的一次检测：刷新账户信息，1秒后比较仓位变化
+    void run_position_check(const std::shared_ptr<PositionCheck>& check)
+    {
+        // 检查订单是否仍在待处理列表中
+        bool order_still_pending = false;
+        {
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
+            order_still_pending = pending_orders_.count(check->client_order_id) > 0;
         }
+        
+        if (!order_still_pending) {
+            std::cout << "[POSITION_CHECK] Order " << check->client_order_id << " no longer pending, stopping position check" << std::endl;
+            finish_position_check(check->client_order_id);
+            return;
+        }
+        
+        // 强制刷新仓位数据
+        if (binance_ws_) {
+            try {
+                binance_ws_->requestAccountInfo();
+            } catch (const std::exception& e) {
+                std::cerr << "Error requesting account info for position check: " << e.what() << std::endl;
+            }
+        }
+        
+        schedule_position_check(check, std::chrono::milliseconds(1000), [this, check]() { // 等待数据更新
+            compare_position_check(check);
+        });
+    }
+    
+    void compare_position_check(const std::shared_ptr<PositionCheck>& check)
+    {
+        // 检查仓位是否发生变化
+        double current_position = 0.0;
+        {
+            std::lock_guard<NamedMutex> lock(current_positions_mutex_);
+            auto it = current_positions_.find(check->symbol);
+            if (it != current_positions_.end()) {
+                current_position = it->second.quantity;
+            }
+        }
+        
+        double position_change = current_position - check->initial_position;
+        double expected_change = (check->side == "BUY") ? check->expected_qty : -check->expected_qty;
+        
+        std::cout << "[POSITION_CHECK] " << check->symbol << " position change: " << position_change 
+                  << ", expected: " << expected_change << std::endl;
+        
+        // 如果仓位变化符合预期，说明订单已成交
+        if (std::abs(position_change - expected_change) < 1.0) { // 允许1个单位的误差
+            std::cout << "[POSITION_CHECK] Order " << check->client_order_id << " detected as filled by position change" << std::endl;
+            finish_position_check(check->client_order_id);
+            
+            // 从待处理订单列表中移除
+            {
+                std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
+                pending_orders_.erase(check->client_order_id);
+                std::string order_key = check->symbol + "_" + check->side + "_" + check->orig_qty;
+                pending_orders_.erase(order_key);
+            }
+            
+            // 触发TWAP进度更新
+            update_twap_progress(check->symbol, check->expected_qty);
+            
+            // 通知调仓引擎订单已终态
+            alignment_engine_->on_order_finished(check->symbol);
+            std::cout << "[POSITION_CHECK] Order execution completed by position detection" << std::endl;
+            return;
+        }
+        
+        // 定期检测仓位变化，最多检测6次（30秒）
+        if (++check->attempt < 6) {
+            schedule_position_check(check, std::chrono::seconds(5), [this, check]() { run_position_check(check); });
+            return;
+        }
+        
+        // 最终超时处理
+        finish_position_check(check->client_order_id);
+        bool order_still_pending = false;
+        {
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
+            order_still_pending = pending_orders_.count(check->client_order_id) > 0;
+        }
+        
+        if (order_still_pending) {
+            std::cout << "[TIMEOUT] Order " << check->client_order_id << " timeout after position checks, forcing TWAP continuation" << std::endl;
+            // 强制触发下一个TWAP切片
+            update_twap_progress(check->symbol, 0.0); // 使用0表示超时触发
+        }
+    }
+    
+    void schedule_position_check(const std::shared_ptr<PositionCheck>& check, std::chrono::milliseconds delay,
+                                 TimerWheel::Callback step)
+    {
+        TimerId timer_id = timer_wheel_.schedule_after(delay, std::move(step));
+        std::lock_guard<NamedMutex> lock(position_check_timers_mutex_);
+        position_check_timers_[check->client_order_id] = timer_id;
+    }
+    
+    // 订单已终态或核对结束：取消尚未触发的核对步骤
+    void finish_position_check(const std::string& client_order_id)
+    {
+        TimerId timer_id = INVALID_TIMER_ID;
+        {
+            std::lock_guard<NamedMutex> lock(position_check_timers_mutex_);
+            auto it = position_check_timers_.find(client_order_id);
+            if (it == position_check_timers_.end()) {
+                return;
+            }
+            timer_id = it->second;
+            position_check_timers_.erase(it);
+        }
+        timer_wheel_.cancel(timer_id);
     }
     
     // 更新TWAP执行进度
     void update_twap_progress(const std::string& symbol, double executed_qty)
     {
-        std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+        std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
         
         for (auto& twap_order : active_twap_orders_) {
             if (twap_order.symbol == symbol && twap_order.is_active) {
@@ -1023,7 +1262,7 @@ private:
                 // 检查当前仓位，确定是否需要继续TWAP执行
                 double current_position = 0.0;
                 {
-                    std::lock_guard<std::mutex> pos_lock(current_positions_mutex_);
+                    std::lock_guard<NamedMutex> pos_lock(current_positions_mutex_);
                     auto it = current_positions_.find(symbol);
                     if (it != current_positions_.end()) {
                         current_position = it->second.quantity;
@@ -1033,7 +1272,7 @@ private:
                 // 获取目标仓位
                 double target_position = 0.0;
                 {
-                    std::lock_guard<std::mutex> target_lock(target_positions_mutex_);
+                    std::lock_guard<NamedMutex> target_lock(target_positions_mutex_);
                     for (const auto& target : target_positions_) {
                         if (target.symbol == symbol) {
                             target_position = target.quantity;
@@ -1049,11 +1288,11 @@ private:
                 // 精确数量控制：不使用容差，确保100%执行目标数量
                 std::cout << "[TWAP_EXACT_CONTROL] Exact quantity control enabled - no tolerance threshold applied" << std::endl;
                 
-                // 触发下一个切片的处理，使用正确的间隔时间
-                std::thread([this, symbol, interval = twap_order.slice_interval]() {
-                    std::this_thread::sleep_for(interval); // 使用TWAP设定的间隔时间
+                // 触发下一个切片的处理，使用TWAP设定的间隔时间；先取消尚未触发的上一次调度，避免同一切片被重复处理
+                timer_wheel_.cancel(twap_order.next_slice_timer);
+                twap_order.next_slice_timer = timer_wheel_.schedule_after(twap_order.slice_interval, [this, symbol]() {
                     process_next_twap_slice(symbol);
-                }).detach();
+                });
                 
                 break;
             }
@@ -1064,7 +1303,7 @@ private:
     // 记录订单错误信息
     void record_order_error(const std::string& symbol, const std::string& error_message)
     {
-        std::lock_guard<std::mutex> lock(order_errors_mutex_);
+        std::lock_guard<NamedMutex> lock(order_errors_mutex_);
         
         // 创建错误记录
         order_errors_[symbol] = error_message;
@@ -1072,15 +1311,25 @@ private:
         std::cout << "[ERROR] Recording order error for " << symbol << ": " << error_message << std::endl;
     }
 
+    // 取消TWAP尚未触发的切片定时器，调用方需持有twap_orders_mutex_
+    void cancel_twap_timers(TWAPOrder& twap_order)
+    {
+        timer_wheel_.cancel(twap_order.next_slice_timer);
+        timer_wheel_.cancel(twap_order.slice_order_timer);
+        twap_order.next_slice_timer = INVALID_TIMER_ID;
+        twap_order.slice_order_timer = INVALID_TIMER_ID;
+    }
+
     void cleanup_failed_order(const std::string& symbol, const std::string& client_order_id)
     {
         std::cout << "Cleaning up failed order: " << symbol << " " << client_order_id << std::endl;
         
         // 停止相关的TWAP执行
-        std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+        std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
         for (auto& twap_order : active_twap_orders_) {
             if (twap_order.symbol == symbol && twap_order.is_active) {
                 twap_order.is_active = false;
+                cancel_twap_timers(twap_order);
                 std::cout << "TWAP execution stopped due to order failure: " << symbol << std::endl;
                 break;
             }
@@ -1097,7 +1346,7 @@ private:
         if (order.status == tes::execution::OrderStatus::FILLED || 
             order.status == tes::execution::OrderStatus::CANCELLED ||
             order.status == tes::execution::OrderStatus::REJECTED) {
-            std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
             // 注意：这里需要根据实际的订单ID映射来移除
             // pending_orders_.erase(order_id);
         }
@@ -1123,6 +1372,7 @@ private:
                 if (system.contains("version")) system_config_.version = system["version"];
                 if (system.contains("max_threads")) system_config_.max_threads = system["max_threads"];
                 if (system.contains("signaltrans_mode")) system_config_.signaltrans_mode = system["signaltrans_mode"];
+                if (system.contains("target_table_name")) system_config_.target_table_name = system["target_table_name"];
                 
                 // JSON文件配置
                 if (system.contains("json_file_config")) {
@@ -1226,6 +1476,13 @@ private:
                     if (binance.contains("max_slices")) system_config_.max_slices = binance["max_slices"];
                     if (binance.contains("default_participation_rate")) system_config_.default_participation_rate = binance["default_participation_rate"];
                     if (binance.contains("max_price_deviation_bps")) system_config_.max_price_deviation_bps = binance["max_price_deviation_bps"];
+                    
+                    // 交易规则后台刷新配置
+                    if (binance.contains("exchange_info_refresh")) {
+                        auto& refresh = binance["exchange_info_refresh"];
+                        if (refresh.contains("source")) system_config_.exchange_info_source = refresh["source"];
+                        if (refresh.contains("interval_ms")) system_config_.exchange_info_refresh_interval_ms = refresh["interval_ms"];
+                    }
                 }
             }
             
@@ -1247,20 +1504,18 @@ private:
     void update_market_subscriptions()
     {
         try {
-            // 读取pos_update.json文件获取需要的交易对
-            nlohmann::json pos_data;
-            if (!read_position_file(pos_data)) {
+            // 取监听器中最新的目标仓位快照，不读文件
+            auto snapshot = current_target_snapshot();
+            if (!snapshot || !binance_ws_) {
                 return;
             }
             
-            // 解析目标仓位，获取所有交易对
             std::set<std::string> required_symbols;
-            auto targets = parse_target_positions(pos_data);
-            for (const auto& target : targets) {
-                required_symbols.insert(target.symbol);
+            for (const auto& entry : snapshot->targets) {
+                required_symbols.insert(entry.symbol);
             }
             
-            std::lock_guard<std::mutex> lock(subscribed_symbols_mutex_);
+            std::lock_guard<NamedMutex> lock(subscribed_symbols_mutex_);
             
             // 取消不再需要的订阅
             for (const auto& symbol : subscribed_symbols_) {
@@ -1274,6 +1529,9 @@ private:
             for (const auto& symbol : required_symbols) {
                 if (subscribed_symbols_.find(symbol) == subscribed_symbols_.end()) {
                     binance_ws_->subscribeDepthUpdate(symbol, 5, 100);
+                    if (market_data_segment_) {
+                        market_data_segment_->register_symbol(symbol);
+                    }
                     std::cout << "Subscribed to market data for " << symbol << std::endl;
                 }
             }
@@ -1297,7 +1555,7 @@ private:
                     // 请求账户信息
                     binance_ws_->requestAccountInfo();
                     
-                    // 动态订阅交易对的深度数据
+                    // 兜底对账深度订阅（目标变化时已由文件监听即时处理）
                     update_market_subscriptions();
                 }
                 
@@ -1315,73 +1573,167 @@ private:
     void position_monitor_worker()
     {
         std::cout << "Position monitor thread started" << std::endl;
+        bool snapshot_missing = false;
         
         while (g_running.load()) {
             try {
-                // 读取pos_update.json文件
-                nlohmann::json pos_data;
-                if (read_position_file(pos_data)) {
-                    // 检查isFinished字段
-                    int finished_status = get_finished_status(pos_data);
+                // 取目标仓位的最新快照，文件只在变化时解析
+                auto snapshot = current_target_snapshot();
+                if (!snapshot) {
+                    // 文件正在被替换或目标表尚未就绪：稍后重试，不退出监控线程
+                    if (!snapshot_missing) {
+                        std::cout << "Failed to read target positions, will retry every "
+                                  << system_config_.update_interval_ms << "ms" << std::endl;
+                        snapshot_missing = true;
+                    }
+                    wait_for_target_event();
+                    continue;
+                }
+                snapshot_missing = false;
+                
+                {
+                    // 检查isFinished字段；上一轮失败(2)的目标同样在重试时间到后重新调仓
+                    int finished_status = snapshot->is_finished;
+                    bool needs_alignment = finished_status == 0 ||
+                        finished_status == static_cast<int>(tes::shared_memory::TargetAckStatus::FAILED);
                     
-                    if (finished_status == 0) {
+                    if (needs_alignment && !alignment_engine_->is_active() &&
+                        std::chrono::steady_clock::now().time_since_epoch().count() >= alignment_retry_after_ns_.load()) {
                         // isFinished = 0，需要进行仓位对齐
                         std::cout << "Detected isFinished=0, starting position alignment..." << std::endl;
                         
-                        // 先请求最新的账户信息
-                        if (gateway_connected_ && binance_ws_) {
-                            // 重置账户数据状态
-                            account_data_ready_.store(false);
-                            
+                        // 只有从未收到过账户快照时才请求一次，之后仓位由ACCOUNT_UPDATE实时维护
+                        if (gateway_connected_ && binance_ws_ && !account_data_ready_.load()) {
                             binance_ws_->requestAccountInfo();
-                            std::cout << "[DEBUG] Requested account info, waiting for response..." << std::endl;
+                            std::cout << "[DEBUG] Requested initial account snapshot, waiting for response..." << std::endl;
                             
-                            // 使用条件变量等待账户信息更新，替代固定sleep
-                            std::unique_lock<std::mutex> lock(account_update_mutex_);
-                            if (account_update_cv_.wait_for(lock, ACCOUNT_UPDATE_TIMEOUT, 
+                            std::unique_lock<NamedMutex> lock(account_update_mutex_);
+                            if (!account_update_cv_.wait_for(lock, ACCOUNT_UPDATE_TIMEOUT, 
                                 [this] { return account_data_ready_.load(); })) {
-                                std::cout << "[DEBUG] Account data received, proceeding with position processing" << std::endl;
-                            } else {
-                                std::cout << "[WARNING] Account update timeout, proceeding anyway..." << std::endl;
+                                std::cout << "[WARNING] Account snapshot timeout, proceeding anyway..." << std::endl;
                             }
                         }
                         
                         // 解析目标仓位
-                        std::cout << "[DEBUG] About to parse target positions from JSON data..." << std::endl;
-                        auto targets = parse_target_positions(pos_data);
+                        aligning_target_generation_.store(snapshot->version);
+                        auto targets = parse_target_positions(*snapshot);
                         std::cout << "[DEBUG] parse_target_positions returned " << targets.size() << " targets" << std::endl;
                         
                         if (!targets.empty()) {
-                            std::cout << "[DEBUG] Found " << targets.size() << " target positions, calling process_target_positions..." << std::endl;
+                            // 只发起本轮调仓，不等待结果；完成后由引擎回调写回isFinished
                             process_target_positions(targets);
                         } else {
                             std::cout << "[WARNING] No target positions found in pos_update.json - this may indicate a parsing issue" << std::endl;
-                            std::cout << "[DEBUG] Raw JSON data: " << pos_data.dump(2) << std::endl;
                         }
-                        
-                        // 处理完成后等待更长时间，避免频繁操作
-                        std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+                    } else if (needs_alignment) {
+                        // 调仓进行中或等待重试
                     } else if (finished_status == 1) {
                         // isFinished = 1，略过处理
                         // 静默跳过，不输出日志避免刷屏
-                        std::this_thread::sleep_for(std::chrono::milliseconds(system_config_.update_interval_ms));
                     } else {
                         std::cout << "Invalid or missing isFinished field in pos_update.json" << std::endl;
-                        std::this_thread::sleep_for(std::chrono::milliseconds(system_config_.update_interval_ms));
+                    }
+                }
+                
+                // 目标变化时立即被唤醒；超时只用于重新检查调仓引擎状态和重试时间
+                if (target_table_) {
+                    if (target_table_->wait_for_generation(snapshot->version,
+                            std::chrono::milliseconds(system_config_.update_interval_ms)) && gateway_connected_) {
+                        update_market_subscriptions();
                     }
                 } else {
-                    std::cout << "Failed to read pos_update.json file" << std::endl;
-                    return; // 失败后直接退出
+                    wait_for_target_event();
                 }
                 
             } catch (const std::exception& e) {
+                // 单轮异常不结束监控线程，下一周期重试
                 std::cerr << "Exception in position monitor worker: " << e.what() << std::endl;
-                return; // 失败后直接退出
+                wait_for_target_event();
             }
         }
         
         std::cout << "Position monitor thread stopped" << std::endl;
     }
+    
+    // 等待目标仓位变化通知，最多一个检查周期
+    void wait_for_target_event()
+    {
+        std::unique_lock<NamedMutex> lock(target_event_mutex_);
+        target_event_cv_.wait_for(lock, std::chrono::milliseconds(system_config_.update_interval_ms),
+            [this] { return target_changed_ || !g_running.load(); });
+        target_changed_ = false;
+    }
+    
+    // 本轮调仓失败：向策略确认FAILED，并推迟下一轮的开始时间
+    void fail_alignment_round()
+    {
+        if (!update_finished_status(static_cast<int>(tes::shared_memory::TargetAckStatus::FAILED))) {
+            std::cerr << "[ERROR] Failed to acknowledge failed alignment" << std::endl;
+        }
+        alignment_retry_after_ns_.store((std::chrono::steady_clock::now() + ALIGNMENT_RETRY_DELAY)
+                                        .time_since_epoch().count());
+    }
+    
+    // 目标仓位文件变化（在文件监听线程中调用）：只处理变化的交易对
+    void on_target_file_changed(const TargetFileDelta& delta)
+    {
+        if (!delta.initial) {
+            for (const auto& change : delta.changes) {
+                std::cout << "[TARGET_UPDATE] " << change.symbol << " "
+                          << (change.type == TargetChangeType::ADDED ? "added" :
+                              change.type == TargetChangeType::REMOVED ? "removed" : "modified")
+                          << ": " << change.old_quantity << " -> " << change.new_quantity << std::endl;
+            }
+        }
+        
+        // 只有交易对集合变化时才需要调整行情订阅
+        if (delta.symbols_changed() && gateway_connected_) {
+            update_market_subscriptions();
+        }
+        
+        {
+            std::lock_guard<NamedMutex> lock(target_event_mutex_);
+            target_changed_ = true;
+        }
+        target_event_cv_.notify_all();
+    }
+
+    // 当前目标仓位快照：表模式下从共享内存表读取，否则取文件监听器的最新解析结果
+    std::shared_ptr<const TargetFileSnapshot> current_target_snapshot()
+    {
+        if (!target_table_) {
+            return target_watcher_ ? target_watcher_->current() : nullptr;
+        }
+        
+        tes::shared_memory::TargetPositionSnapshot table_snapshot;
+        if (!target_table_->read_snapshot(table_snapshot)) {
+            return nullptr;
+        }
+        
+        auto snapshot = std::make_shared<TargetFileSnapshot>();
+        snapshot->version = table_snapshot.generation;
+        snapshot->targets.reserve(table_snapshot.targets.size());
+        int id = 0;
+        for (const auto& target : table_snapshot.targets) {
+            TargetFileEntry entry;
+            entry.id = ++id;
+            entry.symbol = target.symbol;
+            entry.quantity = std::to_string(target.quantity);
+            entry.quantity_value = target.quantity;
+            snapshot->targets.push_back(std::move(entry));
+        }
+        
+        // 策略尚未发布过目标时无事可做；已确认到当前代数时沿用确认状态，否则待处理
+        uint64_t ack_generation = 0;
+        tes::shared_memory::TargetAckStatus ack_status = tes::shared_memory::TargetAckStatus::PENDING;
+        target_table_->get_acknowledgement(ack_generation, ack_status);
+        if (table_snapshot.generation == 0) {
+            snapshot->is_finished = 1;
+        } else {
+            snapshot->is_finished = ack_generation >= table_snapshot.generation ? static_cast<int>(ack_status) : 0;
+        }
+        return snapshot;
+    }
 
     bool read_position_file(nlohmann::json& data)
     {
@@ -1399,193 +1751,106 @@ private:
         }
     }
 
-    int get_finished_status(const nlohmann::json& data)
-    {
-        try {
-            if (data.is_array()) {
-                for (const auto& item : data) {
-                    if (item.contains("isFinished")) {
-                        return item["isFinished"];
-                    }
-                }
-            }
-            return -1;  // 表示未找到isFinished字段
-        } catch (const std::exception& e) {
-            std::cerr << "Error getting finished status: " << e.what() << std::endl;
-            return -1;
-        }
-    }
-
-    std::vector<TargetPosition> parse_target_positions(const nlohmann::json& data)
+    std::vector<TargetPosition> parse_target_positions(const TargetFileSnapshot& snapshot)
     {
-        std::cout << "[DEBUG] Starting parse_target_positions..." << std::endl;
         std::vector<TargetPosition> targets;
-        
-        try {
-            std::cout << "[DEBUG] JSON data type: " << (data.is_array() ? "array" : "not array") << std::endl;
-            std::cout << "[DEBUG] JSON data size: " << data.size() << std::endl;
-            
-            if (data.is_array()) {
-                std::cout << "[DEBUG] Processing JSON array with " << data.size() << " items" << std::endl;
-                
-                for (size_t i = 0; i < data.size(); ++i) {
-                    const auto& item = data[i];
-                    std::cout << "[DEBUG] Processing item " << i << ": " << item.dump() << std::endl;
-                    
-                    // 检查是否包含必要字段
-                    bool has_id = item.contains("id");
-                    bool has_symbol = item.contains("symbol");
-                    bool has_quantity = item.contains("quantity");
-                    
-                    std::cout << "[DEBUG] Item " << i << " fields - id: " << has_id 
-                             << ", symbol: " << has_symbol << ", quantity: " << has_quantity << std::endl;
-                    
-                    // 只处理包含id、symbol和quantity字段的对象
-                    if (has_id && has_symbol && has_quantity) {
-                        try {
-                            TargetPosition target;
-                            target.id = item["id"];
-                            target.symbol = item["symbol"];
-                            
-                            // 详细记录quantity字段的处理
-                            std::cout << "[DEBUG] Processing quantity field for " << target.symbol << std::endl;
-                            std::cout << "[DEBUG] Quantity raw value: " << item["quantity"].dump() << std::endl;
-                            std::cout << "[DEBUG] Quantity type: " << item["quantity"].type_name() << std::endl;
-                            
-                            std::string quantity_str = item["quantity"].get<std::string>();
-                            std::cout << "[DEBUG] Quantity as string: '" << quantity_str << "'" << std::endl;
-                            
-                            target.quantity = std::stod(quantity_str);
-                            std::cout << "[DEBUG] Parsed quantity: " << target.quantity << std::endl;
-                            
-                            targets.push_back(target);
-                            std::cout << "[DEBUG] Successfully added target: " << target.symbol 
-                                     << " (id=" << target.id << ", quantity=" << target.quantity << ")" << std::endl;
-                        } catch (const std::exception& e) {
-                            std::cerr << "[ERROR] Failed to parse item " << i << ": " << e.what() << std::endl;
-                        }
-                    } else {
-                        std::cout << "[DEBUG] Skipping item " << i << " - missing required fields" << std::endl;
-                    }
-                }
-            } else {
-                std::cout << "[DEBUG] JSON data is not an array, cannot parse target positions" << std::endl;
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "[ERROR] Exception in parse_target_positions: " << e.what() << std::endl;
+        targets.reserve(snapshot.targets.size());
+        for (const auto& entry : snapshot.targets) {
+            targets.emplace_back(entry.id, entry.symbol, entry.quantity_value);
+            std::cout << "[DEBUG] Target: " << entry.symbol << " (id=" << entry.id
+                      << ", quantity=" << entry.quantity << ")" << std::endl;
         }
-        
-        std::cout << "[DEBUG] parse_target_positions completed. Found " << targets.size() << " target positions" << std::endl;
         return targets;
     }
 
-    void process_target_positions(const std::vector<TargetPosition>& targets)
+    // 开始一轮事件驱动的调仓：所有交易对同时下单，之后由仓位/订单推送驱动直至全部进入容差
+    bool process_target_positions(const std::vector<TargetPosition>& targets)
     {
         std::cout << "Processing " << targets.size() << " target positions" << std::endl;
         
-        // 在处理仓位对齐前强制刷新仓位数据
-        std::cout << "[DEBUG] Force refreshing position data before alignment..." << std::endl;
-        if (gateway_connected_ && binance_ws_) {
-            // 重置账户数据状态
-            account_data_ready_.store(false);
-            
-            binance_ws_->requestAccountInfo();
-            std::cout << "[DEBUG] Requested account info for position alignment..." << std::endl;
-            
-            // 使用条件变量等待账户信息更新，替代固定sleep 3秒
-            std::unique_lock<std::mutex> lock(account_update_mutex_);
-            if (account_update_cv_.wait_for(lock, ACCOUNT_UPDATE_TIMEOUT, 
-                [this] { return account_data_ready_.load(); })) {
-                std::cout << "[DEBUG] Position data refresh completed" << std::endl;
-            } else {
-                std::cout << "[WARNING] Position data refresh timeout, proceeding anyway..." << std::endl;
-            }
-        } else {
-            std::cerr << "[ERROR] Gateway not connected, cannot refresh position data" << std::endl;
-            return; // 失败后直接退出
+        if (!gateway_connected_ || !binance_ws_) {
+            std::cerr << "[ERROR] Gateway not connected, cannot align positions" << std::endl;
+            fail_alignment_round();
+            return false;
         }
         
-        for (const auto& target : targets) {
-            std::cout << "Target: " << target.symbol << " quantity: " << target.quantity << std::endl;
-            
-            // 1. 获取当前仓位（从Gateway获取的真实数据）
-            CurrentPosition current_pos = get_current_position(target.symbol);
-            std::cout << "Current position for " << target.symbol << ": " << current_pos.quantity << std::endl;
-            
-            // 2. 计算需要调整的数量
-            double position_diff = target.quantity - current_pos.quantity;
-            std::cout << "Position difference: " << position_diff << std::endl;
-            
-            if (std::abs(position_diff) < system_config_.tolerance_threshold) {
-                std::cout << "Position difference within tolerance, skipping " << target.symbol << std::endl;
-                continue;
-            }
-            
-            // 3. 获取行情数据（从Gateway获取的真实数据）
-            MarketDepth depth = get_market_depth(target.symbol);
-            if (depth.bid_price == 0.0 || depth.ask_price == 0.0) {
-                std::cout << "No market data available for " << target.symbol << ", skipping" << std::endl;
-                continue;
+        {
+            std::lock_guard<NamedMutex> lock(target_positions_mutex_);
+            target_positions_ = targets;
+        }
+        
+        // 1. 当前仓位直接取自由ACCOUNT_UPDATE实时维护的缓存，并计算需要调整的数量
+        std::vector<double> current_quantities(targets.size());
+        TradingRuleBatch rule_batch;
+        rule_batch.reset(TradingRuleRegistry::getInstance().current());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            current_quantities[i] = get_current_position(targets[i].symbol).quantity;
+            rule_batch.add(targets[i].symbol, std::abs(targets[i].quantity - current_quantities[i]), 0.0);
+        }
+        
+        // 2. 整批预校验本轮调仓：交易对不可交易或调整量低于最小下单量的标记为不可交易，
+        //    超过单笔最大数量的仍交给TWAP拆单，逐笔订单下单前再完整校验
+        rule_batch.results.resize(rule_batch.size());
+        TradingRuleChecker::evaluate_batch(rule_batch.table, rule_batch.rule_indices.data(),
+                                           rule_batch.quantities.data(), rule_batch.prices.data(),
+                                           rule_batch.size(), CHECK_SYMBOL_STATUS | CHECK_QUANTITY,
+                                           rule_batch.results.data());
+        
+        std::vector<AlignmentTarget> alignment_targets(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            const auto& target = targets[i];
+            std::cout << "Target: " << target.symbol << " quantity: " << target.quantity
+                      << " current: " << current_quantities[i] << std::endl;
+            
+            alignment_targets[i].symbol = target.symbol;
+            alignment_targets[i].target_quantity = target.quantity;
+            alignment_targets[i].current_quantity = current_quantities[i];
+            
+            TradingRuleCheckResult rule_result = rule_batch.results[i];
+            if (rule_result != TradingRuleCheckResult::PASS &&
+                rule_result != TradingRuleCheckResult::REJECT_QUANTITY_TOO_LARGE) {
+                alignment_targets[i].tradable = false;
+                if (std::abs(target.quantity - current_quantities[i]) >= system_config_.tolerance_threshold) {
+                    std::cout << "[WARNING] Skipping " << target.symbol << ": "
+                              << TradingRuleChecker::get_trading_rule_result_description(rule_result) << std::endl;
+                }
             }
-            
-            // 4. 智能平仓算法：根据当前仓位和目标仓位计算最优平仓策略
-            execute_position_alignment(target.symbol, current_pos.quantity, target.quantity, depth);
         }
         
-        // 等待一段时间让订单执行完成 - 使用条件变量替代固定sleep
-        std::cout << "[DEBUG] Waiting for order execution completion..." << std::endl;
-        order_completed_.store(false);
-        
-        std::unique_lock<std::mutex> order_lock(order_completion_mutex_);
-        if (order_completion_cv_.wait_for(order_lock, ORDER_COMPLETION_TIMEOUT,
-            [this] { return order_completed_.load(); })) {
-            std::cout << "[DEBUG] Order execution completed" << std::endl;
-        } else {
-            std::cout << "[WARNING] Order execution timeout, proceeding with alignment check..." << std::endl;
-            
-            // 超时时强制检查仓位变化并继续TWAP执行
-            std::cout << "[TIMEOUT_TWAP] Checking for position changes to continue TWAP execution..." << std::endl;
-            
-            // 检查是否有活跃的TWAP订单需要继续执行
-            std::lock_guard<std::mutex> twap_lock(twap_orders_mutex_);
-            for (auto& twap_order : active_twap_orders_) {
-                if (twap_order.is_active) {
-                    std::cout << "[TIMEOUT_TWAP] Found active TWAP for " << twap_order.symbol << ", forcing continuation" << std::endl;
-                    
-                    // 异步触发TWAP进度更新，使用0表示超时触发
-                    std::thread([this, symbol = twap_order.symbol]() {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 短暂延迟
-                        update_twap_progress(symbol, 0.0);
-                    }).detach();
-                }
-            }
+        return alignment_engine_->begin(alignment_targets);
+    }
+    
+    // 调仓引擎的下单回调：为单个交易对提交调整订单
+    AlignmentDispatch dispatch_alignment_order(const std::string& symbol, double current_qty, double target_qty)
+    {
+        MarketDepth depth = get_market_depth(symbol);
+        if (depth.bid_price == 0.0 || depth.ask_price == 0.0) {
+            std::cout << "No market data available for " << symbol << ", skipping" << std::endl;
+            return AlignmentDispatch::REJECTED;
         }
         
-        // 检查仓位是否已对齐
-        std::cout << "[DEBUG] Checking if all positions are aligned..." << std::endl;
+        // 智能平仓算法：根据当前仓位和目标仓位计算最优平仓策略
+        return execute_position_alignment(symbol, current_qty, target_qty, depth);
+    }
+    
+    // 一轮调仓结束（在调仓引擎线程中调用）
+    void on_alignment_complete(const AlignmentReport& report)
+    {
+        std::vector<TargetPosition> targets;
+        {
+            std::lock_guard<NamedMutex> lock(target_positions_mutex_);
+            targets = target_positions_;
+        }
         
-        // 重新获取最新的账户信息
-        std::cout << "[DEBUG] Force refreshing position data for alignment check..." << std::endl;
-        if (gateway_connected_ && binance_ws_) {
-            // 重置账户数据状态
-            account_data_ready_.store(false);
-            
-            binance_ws_->requestAccountInfo();
-            std::cout << "[DEBUG] Requested account info for alignment check..." << std::endl;
-            
-            // 使用条件变量等待账户信息更新，替代固定sleep 3秒
-            std::unique_lock<std::mutex> check_lock(account_update_mutex_);
-            if (account_update_cv_.wait_for(check_lock, ACCOUNT_UPDATE_TIMEOUT, 
-                [this] { return account_data_ready_.load(); })) {
-                std::cout << "[DEBUG] Position data refresh for alignment check completed" << std::endl;
-            } else {
-                std::cout << "[WARNING] Position data refresh timeout for alignment check" << std::endl;
-            }
+        for (const auto& entry : report.symbols) {
+            std::cout << "[ALIGNMENT] " << entry.symbol << " current=" << entry.current_quantity
+                      << " target=" << entry.target_quantity << " attempts=" << entry.attempts
+                      << " aligned_in=" << entry.align_time_ms << "ms" << std::endl;
         }
         
-        // 检查仓位对齐状态
-        if (check_positions_aligned(targets)) {
-            std::cout << "[DEBUG] All positions aligned successfully. Completing position alignment process..." << std::endl;
+        if (report.success) {
+            std::cout << "[DEBUG] All positions aligned in " << report.wall_time_ms
+                      << "ms. Completing position alignment process..." << std::endl;
             
             // 1. 生成仓位对齐反馈报告
             if (generate_position_feedback_report(targets)) {
@@ -1601,22 +1866,24 @@ private:
                 std::cerr << "[ERROR] Failed to update isFinished status" << std::endl;
             }
         } else {
-            std::cout << "[WARNING] Some positions are not yet aligned. Will retry in next cycle." << std::endl;
+            std::cout << "[WARNING] " << report.failed_count << " positions not aligned after "
+                      << report.wall_time_ms << "ms. Will retry in next cycle." << std::endl;
+            fail_alignment_round();
         }
         
         // 生成执行结果报告
-        generate_execution_report(targets);
+        generate_execution_report(targets, report);
     }
 
     // 智能仓位对齐算法 - 集成TWAP和订单状态跟踪
-    void execute_position_alignment(const std::string& symbol, double current_qty, double target_qty, const MarketDepth& depth)
+    AlignmentDispatch execute_position_alignment(const std::string& symbol, double current_qty, double target_qty, const MarketDepth& depth)
     {
         std::cout << "Executing position alignment for " << symbol 
                  << " current NET: " << current_qty << " target NET: " << target_qty << std::endl;
         
         // 检查是否有该交易对的待处理订单或活跃TWAP执行
         {
-            std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
             bool has_pending = false;
             for (const auto& order_key : pending_orders_) {
                 if (order_key.find(symbol) != std::string::npos) {
@@ -1626,23 +1893,23 @@ private:
             }
             
             // 检查是否有活跃的TWAP执行
-            std::lock_guard<std::mutex> twap_lock(twap_orders_mutex_);
+            std::lock_guard<NamedMutex> twap_lock(twap_orders_mutex_);
             for (const auto& twap_order : active_twap_orders_) {
                 if (twap_order.symbol == symbol && twap_order.is_active) {
                     std::cout << "Position alignment skipped - active TWAP execution exists for " << symbol << std::endl;
-                    return;
+                    return AlignmentDispatch::IN_PROGRESS;
                 }
             }
             
             if (has_pending) {
                 std::cout << "Position alignment skipped - pending orders exist for " << symbol << std::endl;
-                return;
+                return AlignmentDispatch::IN_PROGRESS;
             }
         }
         
         if (std::abs(current_qty - target_qty) < system_config_.tolerance_threshold) {
             std::cout << "Position already aligned within tolerance" << std::endl;
-            return;
+            return AlignmentDispatch::IN_PROGRESS;
         }
         
         // 计算需要调整的净仓位数量
@@ -1653,7 +1920,7 @@ private:
         if (std::abs(net_adjustment) > system_config_.min_slice_size) {
             std::cout << "Large order detected, using TWAP algorithm for " << symbol << std::endl;
             execute_twap_order(symbol, net_adjustment, depth);
-            return;
+            return AlignmentDispatch::SUBMITTED;
         }
         
         // 优化后的仓位对齐逻辑：区分开仓和平仓场景
@@ -1747,6 +2014,7 @@ private:
                 }
             }
         }
+        return AlignmentDispatch::SUBMITTED;
     }
 
     // TWAP订单执行方法
@@ -1784,7 +2052,7 @@ private:
         
         // 添加到活跃TWAP订单列表
         {
-            std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+            std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
             active_twap_orders_.push_back(twap_order);
         }
         
@@ -1803,7 +2071,7 @@ private:
         // 添加到待处理订单列表
         std::string order_key = symbol + "_" + side + "_" + std::to_string(quantity);
         {
-            std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
             pending_orders_.insert(order_key);
         }
         
@@ -1825,7 +2093,7 @@ private:
             return;
         }
         
-        std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+        std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
         
         for (auto& twap_order : active_twap_orders_) {
             if (twap_order.symbol == symbol && twap_order.is_active) {
@@ -1862,6 +2130,7 @@ private:
                 if (twap_order.remaining_quantity <= 0.0) {
                     // TWAP执行完成
                     twap_order.is_active = false;
+                    cancel_twap_timers(twap_order);
                     std::cout << "TWAP execution completed for " << symbol << std::endl;
                 } else {
                     // 获取最新市场数据
@@ -1869,11 +2138,12 @@ private:
                     if (depth.bid_price > 0 && depth.ask_price > 0) {
                         double price = (twap_order.side == "BUY") ? depth.ask_price : depth.bid_price;
                         
-                        // 延迟执行下一个切片
-                        std::thread([this, symbol, actual_slice_size, twap_order, price]() {
-                            std::this_thread::sleep_for(twap_order.slice_interval);
-                            execute_twap_slice(symbol, actual_slice_size, twap_order.side, price);
-                        }).detach();
+                        // 延迟执行下一个切片，替换尚未触发的切片下单
+                        timer_wheel_.cancel(twap_order.slice_order_timer);
+                        twap_order.slice_order_timer = timer_wheel_.schedule_after(twap_order.slice_interval,
+                            [this, symbol, actual_slice_size, side = twap_order.side, price]() {
+                                execute_twap_slice(symbol, actual_slice_size, side, price);
+                            });
                     }
                 }
                 break;
@@ -1895,7 +2165,7 @@ private:
             order_req.symbol = symbol;
             order_req.side = side;
             order_req.type = "MARKET";
-            order_req.quantity = std::to_string(quantity);
+            order_req.quantity = DecimalFormat(TradingRuleManager::getInstance().getTradingRule(symbol).stepSize).toString(quantity, true);
             // 市价单不需要设置价格
             // order_req.price = std::to_string(price);  // 注释掉价格设置
             order_req.timeInForce = "IOC";
@@ -1934,7 +2204,7 @@ private:
         // 检查是否有相同的待处理订单
         std::string order_key = symbol + "_" + side + "_" + std::to_string(quantity);
         {
-            std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+            std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
             if (pending_orders_.find(order_key) != pending_orders_.end()) {
                 std::cout << "Similar order already pending, skipping: " << order_key << std::endl;
                 return;
@@ -1944,33 +2214,23 @@ private:
         }
 
         try {
-            // 构建平仓订单请求 - 修改为市价单
-            OrderRequest order_req;
-            order_req.symbol = symbol;
-            order_req.side = side;
-            order_req.type = "MARKET";  // 使用市价单
-            order_req.quantity = std::to_string(quantity);
-            // 市价单不需要设置价格
-            // order_req.price = std::to_string(price);  // 注释掉价格设置
-            // 市价单不需要timeInForce参数，移除该设置
-            // order_req.timeInForce = "GTC";  // 市价单不需要timeInForce参数
-            
-            // 根据Binance官方文档，单向持仓模式下：
-            // positionSide持仓方向，单向持仓模式下非必填，默认且仅可填BOTH
-            order_req.positionSide = "BOTH";
-            
-            // 在单向持仓模式下，平仓需要设置reduceOnly=true
-            // 这样可以确保订单只用于平仓，不会开新仓位
-            order_req.reduceOnly = "true";
-            
-            // closePosition填false，不与quantity合用
-            order_req.closePosition = "false";
-            
-            std::string client_order_id = "TES_CLOSE_" + symbol + "_" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-            order_req.newClientOrderId = client_order_id;
-
-            // 通过Gateway下单
-            binance_ws_->placeOrder(order_req);
+            // 平仓使用市价单模板：positionSide=BOTH，reduceOnly=true确保只减仓不开新仓，
+            // closePosition=false不与quantity合用；数量按stepSize定点格式化；限频排队时优先于开仓单发送
+            // clientOrderId直接格式化到栈上缓冲，长度上限与限频队列中的订单一致
+            char client_order_id[PacedOrder::MAX_CLIENT_ORDER_ID];
+            long long now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            int id_length = std::snprintf(client_order_id, sizeof(client_order_id), "TES_CLOSE_%s_%lld",
+                                          symbol.c_str(), now_ms);
+            if (id_length < 0 || static_cast<size_t>(id_length) >= sizeof(client_order_id)) {
+                throw std::runtime_error("client order id too long");
+            }
+            int template_handle = get_order_template(symbol, true);
+            if (template_handle < 0 ||
+                !binance_ws_->placeOrderFromTemplate(template_handle, side == "BUY", quantity, 0.0, client_order_id,
+                                                     OrderUrgency::URGENT)) {
+                throw std::runtime_error("order template submission failed");
+            }
             
             std::cout << "Placed close market order (Single Position Mode): " << symbol << " " << side << " " << quantity 
                      << " reference price: " << price << " positionSide: BOTH reduceOnly: true" 
@@ -1980,50 +2240,19 @@ private:
             std::cerr << "Error placing close market order: " << e.what() << std::endl;
             // 下单失败时，从待处理列表中移除
             {
-                std::lock_guard<std::mutex> lock(pending_orders_mutex_);
+                std::lock_guard<NamedMutex> lock(pending_orders_mutex_);
                 pending_orders_.erase(order_key);
             }
         }
     }
 
-    // 获取当前仓位信息（从Gateway获取的真实数据）
+    // 获取当前仓位信息：缓存由账户快照初始化、ACCOUNT_UPDATE推送实时更新，不再逐个交易对刷新
     CurrentPosition get_current_position(const std::string& symbol)
     {
         std::cout << "[DEBUG] get_current_position called for: " << symbol << std::endl;
         
-        // 在获取仓位前，先强制刷新账户信息
-        if (gateway_connected_ && binance_ws_) {
-            std::cout << "[DEBUG] Refreshing account info before getting position for " << symbol << std::endl;
-            
-            // 重置positions_updated_标志
-            positions_updated_.store(false);
-            
-            // 请求账户信息
-            binance_ws_->requestAccountInfo();
-            
-            // 等待仓位数据更新完成，最多等待5秒
-            auto start_time = std::chrono::steady_clock::now();
-            const auto timeout = std::chrono::seconds(5);
-            
-            while (!positions_updated_.load() && 
-                   (std::chrono::steady_clock::now() - start_time) < timeout) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            }
-            
-            if (!positions_updated_.load()) {
-                std::cerr << "[WARNING] Position update timeout after 5 seconds for " << symbol << std::endl;
-            } else {
-                std::cout << "[DEBUG] Position data updated successfully for " << symbol << std::endl;
-            }
-        } else {
-            std::cerr << "[ERROR] Gateway not connected, cannot refresh account info" << std::endl;
-            CurrentPosition empty_pos;
-            empty_pos.symbol = symbol;
-            return empty_pos; // 失败后直接返回空仓位
-        }
-        
         // 使用独立的锁来访问仓位数据，确保数据一致性
-        std::lock_guard<std::mutex> lock(current_positions_mutex_);
+        std::lock_guard<NamedMutex> lock(current_positions_mutex_);
         
         // 先验证当前缓存的所有仓位数据
         std::cout << "[DEBUG] Current positions in cache:" << std::endl;
@@ -2052,7 +2281,7 @@ private:
     // 获取行情数据（从Gateway获取的真实数据）
     MarketDepth get_market_depth(const std::string& symbol)
     {
-        std::lock_guard<std::mutex> lock(market_depths_mutex_);
+        std::lock_guard<NamedMutex> lock(market_depths_mutex_);
         auto it = market_depths_.find(symbol);
         if (it != market_depths_.end()) {
             return it->second;
@@ -2060,6 +2289,34 @@ private:
         return MarketDepth();  // 返回空行情数据
     }
 
+    // 获取单向持仓市价单模板，首次使用时按交易规则的stepSize/tickSize注册；
+    // 规则表重新发布后按新的精度重新注册（精度未变时网关返回原句柄）
+    int get_order_template(const std::string& symbol, bool reduce_only)
+    {
+        uint64_t rule_version = TradingRuleRegistry::getInstance().version();
+        std::lock_guard<NamedMutex> lock(order_templates_mutex_);
+        CachedOrderTemplates& cached = order_templates_[symbol];
+        if (cached.rule_version != rule_version) {
+            cached.handles = {{-1, -1}};
+            cached.rule_version = rule_version;
+        }
+        
+        int& handle = cached.handles[reduce_only ? 1 : 0];
+        if (handle < 0) {
+            TradingRule rule = TradingRuleManager::getInstance().getTradingRule(symbol);
+            OrderTemplateSpec spec;
+            spec.symbol = symbol;
+            spec.type = "MARKET";
+            spec.positionSide = "BOTH";
+            spec.reduceOnly = reduce_only ? "true" : "false";
+            spec.closePosition = "false";
+            spec.stepSize = rule.stepSize;
+            spec.tickSize = rule.tickSize;
+            handle = binance_ws_->registerOrderTemplate(spec);
+        }
+        return handle;
+    }
+
     // 使用真实的Gateway接口下单 - 单向持仓模式
     void place_real_order(const std::string& symbol, double quantity, const std::string& side, double price)
     {
@@ -2125,36 +2382,26 @@ private:
                 return;
             }
 
-            // 构建订单请求 - 修改为市价单
-            OrderRequest order_req;
-            order_req.symbol = symbol;
-            order_req.side = side;
-            order_req.type = "MARKET";  // 使用市价单
-            order_req.quantity = std::to_string(formatted_quantity);  // 使用格式化后的数量
-            // 市价单不需要设置价格
-            // order_req.price = std::to_string(formatted_price);  // 注释掉价格设置
-            // 市价单不需要timeInForce参数，移除该设置
-            // order_req.timeInForce = "IOC";  // 市价单不需要timeInForce参数
-            
-            // 根据Binance官方文档，单向持仓模式下：
-            // positionSide持仓方向，单向持仓模式下非必填，默认且仅可填BOTH
-            order_req.positionSide = "BOTH";
-            
-            // 根据官方文档：非双开模式下默认false
-            // reduceOnly参数在单向持仓模式下默认为false，用于开仓
-            order_req.reduceOnly = "false";
-            
-            // closePosition填false，不与quantity合用
-            order_req.closePosition = "false";
-            
-            // 使用状态机生成的订单ID作为客户端订单ID
-            order_req.newClientOrderId = order_id;
+            // 开仓市价单模板：positionSide=BOTH，reduceOnly=false，closePosition=false
+            int template_handle = get_order_template(symbol, false);
+            if (template_handle < 0) {
+                std::cerr << "Failed to get order template for " << symbol << std::endl;
+                order_state_machine_->process_event(order_id, OrderEvent::REJECT);
+                return;
+            }
 
             // 更新状态机：提交订单
             order_state_machine_->process_event(order_id, OrderEvent::SUBMIT);
 
-            // 通过Gateway下单
-            binance_ws_->placeOrder(order_req);
+            // 通过Gateway下单，使用状态机生成的订单ID作为客户端订单ID；
+            // 未能发出（限频队列满、连接断开等）时订单不会有交易所回报，直接在状态机中置为拒绝
+            if (!binance_ws_->placeOrderFromTemplate(template_handle, side == "BUY", formatted_quantity,
+                                                     formatted_price, order_id.c_str())) {
+                order_state_machine_->process_event(order_id, OrderEvent::REJECT);
+                std::cerr << "[ERROR] Failed to submit market order: " << symbol << " " << side << " "
+                          << formatted_quantity << " OrderID: " << order_id << std::endl;
+                return;
+            }
             
             std::cout << "Placed market order (Single Position Mode): " << symbol << " " << side << " " << formatted_quantity 
                      << " reference price: " << formatted_price << " positionSide: BOTH reduceOnly: false OrderID: " << order_id << std::endl;
@@ -2164,17 +2411,35 @@ private:
         }
     }
 
-    void generate_execution_report(const std::vector<TargetPosition>& targets)
+    void generate_execution_report(const std::vector<TargetPosition>& targets, const AlignmentReport& alignment)
     {
         try {
             nlohmann::json report;
             report["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
                 std::chrono::system_clock::now().time_since_epoch()).count();
             report["completion_time"] = std::time(nullptr);
-            report["status"] = "completed";
-            report["message"] = "Position alignment completed successfully";
+            report["status"] = alignment.success ? "completed" : (alignment.timed_out ? "timeout" : "incomplete");
+            report["message"] = alignment.success ? "Position alignment completed successfully"
+                                                  : "Some positions are not yet aligned";
             report["processed_targets"] = targets.size();
             report["gateway_connected"] = gateway_connected_;
+            report["rebalance_id"] = alignment.rebalance_id;
+            report["wall_time_ms"] = alignment.wall_time_ms;
+            report["aligned_count"] = alignment.aligned_count;
+            report["failed_count"] = alignment.failed_count;
+            
+            nlohmann::json symbols = nlohmann::json::array();
+            for (const auto& entry : alignment.symbols) {
+                nlohmann::json item;
+                item["symbol"] = entry.symbol;
+                item["target"] = entry.target_quantity;
+                item["current"] = entry.current_quantity;
+                item["aligned"] = entry.state == AlignmentState::ALIGNED;
+                item["attempts"] = entry.attempts;
+                item["align_time_ms"] = entry.align_time_ms;
+                symbols.push_back(item);
+            }
+            report["symbols"] = symbols;
             
             // 保存报告到output目录
             std::string report_path = system_config_.output_directory + "/execution_report.json";
@@ -2197,8 +2462,16 @@ private:
     // 更新pos_update.json中的isFinished状态
     bool update_finished_status(int status)
     {
+        if (target_table_) {
+            // 表模式只确认本轮调仓的代数，期间策略新发布的目标会在下一轮处理
+            uint64_t generation = aligning_target_generation_.load();
+            target_table_->acknowledge(generation, static_cast<tes::shared_memory::TargetAckStatus>(status));
+            std::cout << "[DEBUG] Acknowledged target generation " << generation << " with status " << status << std::endl;
+            return true;
+        }
+        
         try {
-            std::lock_guard<std::mutex> lock(g_file_mutex);
+            std::lock_guard<NamedMutex> lock(g_file_mutex);
             
             nlohmann::json pos_data;
             if (!read_position_file(pos_data)) {
@@ -2225,15 +2498,20 @@ private:
                 return false;
             }
             
-            // 写回文件
-            std::ofstream file(position_file_path_);
+            // 写临时文件后rename，读者和文件监听不会看到写了一半的内容
+            std::string temp_path = position_file_path_ + ".tmp";
+            std::ofstream file(temp_path);
             if (file.is_open()) {
                 file << pos_data.dump(2);
                 file.close();
+                std::filesystem::rename(temp_path, position_file_path_);
+                if (target_watcher_) {
+                    target_watcher_->reload();
+                }
                 std::cout << "[DEBUG] Updated isFinished status to " << status << " in " << position_file_path_ << std::endl;
                 return true;
             } else {
-                std::cerr << "Failed to open position file for writing: " << position_file_path_ << std::endl;
+                std::cerr << "Failed to open position file for writing: " << temp_path << std::endl;
                 return false;
             }
             
@@ -2285,7 +2563,7 @@ private:
                 // 检查是否有订单错误
                 std::string error_message = "";
                 {
-                    std::lock_guard<std::mutex> lock(order_errors_mutex_);
+                    std::lock_guard<NamedMutex> lock(order_errors_mutex_);
                     auto error_it = order_errors_.find(target.symbol);
                     if (error_it != order_errors_.end()) {
                         error_message = error_it->second;
@@ -2296,28 +2574,16 @@ private:
                 feedback_report.push_back(position_info);
             }
             
-            // 读取pos_update.json获取额外信息
-            nlohmann::json pos_data;
+            // 从pos_update.json快照获取额外信息
             double targetvalue = 0.0, longtarget = 0.0, shorttarget = 0.0;
             double update_timestamp = 0.0;
             
-            if (read_position_file(pos_data) && pos_data.is_array()) {
-                for (const auto& item : pos_data) {
-                    if (item.is_object()) {
-                        if (item.contains("targetvalue")) {
-                            targetvalue = item["targetvalue"];
-                        }
-                        if (item.contains("longtarget")) {
-                            longtarget = item["longtarget"];
-                        }
-                        if (item.contains("shorttarget")) {
-                            shorttarget = item["shorttarget"];
-                        }
-                        if (item.contains("update_timestamp")) {
-                            update_timestamp = item["update_timestamp"];
-                        }
-                    }
-                }
+            auto snapshot = current_target_snapshot();
+            if (snapshot) {
+                targetvalue = snapshot->targetvalue;
+                longtarget = snapshot->longtarget;
+                shorttarget = snapshot->shorttarget;
+                update_timestamp = snapshot->update_timestamp;
             }
             
             // 添加汇总信息
@@ -2349,48 +2615,9 @@ private:
         }
     }
 
-    // 检查所有仓位是否已对齐
-    bool check_positions_aligned(const std::vector<TargetPosition>& targets)
-    {
-        std::cout << "[DEBUG] Starting position alignment check with dynamic tolerance" << std::endl;
-        
-        for (const auto& target : targets) {
-            CurrentPosition current_pos = get_current_position(target.symbol);
-            double diff = std::abs(current_pos.quantity - target.quantity);
-            
-            // 计算动态容差：基于目标仓位的相对容差 + 最小绝对容差
-            double dynamic_tolerance = std::max(
-                system_config_.tolerance_threshold,  // 最小绝对容差 (0.000001)
-                std::abs(target.quantity) * 0.05     // 目标仓位的5%作为相对容差
-            );
-            
-            std::cout << "[DEBUG] Checking " << target.symbol 
-                     << ": current=" << current_pos.quantity 
-                     << ", target=" << target.quantity 
-                     << ", diff=" << diff 
-                     << ", dynamic_tolerance=" << dynamic_tolerance 
-                     << " (absolute: " << system_config_.tolerance_threshold 
-                     << ", relative 5%: " << std::abs(target.quantity) * 0.05 << ")" << std::endl;
-            
-            if (diff > dynamic_tolerance) {
-                std::cout << "[DEBUG] Position not aligned for " << target.symbol 
-                         << ": current=" << current_pos.quantity 
-                         << ", target=" << target.quantity 
-                         << ", diff=" << diff << " > dynamic_tolerance=" << dynamic_tolerance << std::endl;
-                return false;
-            } else {
-                std::cout << "[DEBUG] Position aligned for " << target.symbol 
-                         << ": diff=" << diff << " <= dynamic_tolerance=" << dynamic_tolerance << std::endl;
-            }
-        }
-        
-        std::cout << "[DEBUG] All positions are aligned within dynamic tolerance" << std::endl;
-        return true;
-    }
-    
     // 新增：将未成交数量加入未完成数量池
     void add_to_unfilled_pool(const std::string& symbol, double unfilled_qty) {
-        std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+        std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
         
         for (auto& twap_order : active_twap_orders_) {
             if (twap_order.symbol == symbol && twap_order.is_active) {
@@ -2406,7 +2633,7 @@ private:
     
     // 新增：计算包含补偿的下一切片数量
     double calculate_next_slice_with_compensation(const std::string& symbol) {
-        std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+        std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
         
         for (auto& twap_order : active_twap_orders_) {
             if (twap_order.symbol == symbol && twap_order.is_active) {
@@ -2437,7 +2664,7 @@ private:
      
      // 新增：最后切片强制完成机制
      void execute_final_slice_with_guarantee(const std::string& symbol) {
-         std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+         std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
          
          for (auto& twap_order : active_twap_orders_) {
              if (twap_order.symbol == symbol && twap_order.is_active) {
@@ -2472,11 +2699,9 @@ private:
      
      // 新增：监控最后切片完成情况
      void monitor_final_slice_completion(const std::string& symbol, double expected_quantity) {
-         std::thread([this, symbol, expected_quantity]() {
-             std::this_thread::sleep_for(std::chrono::seconds(10)); // 10秒监控
-             
+         timer_wheel_.schedule_after(std::chrono::seconds(10), [this, symbol, expected_quantity]() { // 10秒监控
              // 检查TWAP是否真正完成
-             std::lock_guard<std::mutex> lock(twap_orders_mutex_);
+             std::lock_guard<NamedMutex> lock(twap_orders_mutex_);
              for (auto& twap_order : active_twap_orders_) {
                  if (twap_order.symbol == symbol && twap_order.is_active) {
                      std::cout << "[TWAP_FINAL_CHECK] Final slice monitoring timeout for " << symbol 
@@ -2484,6 +2709,7 @@ private:
                      
                      // 强制完成TWAP
                      twap_order.is_active = false;
+                     cancel_twap_timers(twap_order);
                      twap_order.remaining_quantity = 0.0;
                      twap_order.unfilled_quantity = 0.0;
                      
@@ -2491,15 +2717,19 @@ private:
                      break;
                  }
              }
-         }).detach();
+         });
      }
 };
 
 // TradingRuleManager 实现
 bool TradingRuleManager::loadExchangeInfo(const std::string& apiKey, const std::string& apiSecret, bool testnet) {
     try {
-        std::string baseUrl = testnet ? "https://testnet.binancefuture.com" : "https://fapi.binance.com";
-        std::string url = baseUrl + "/fapi/v1/exchangeInfo";
+        // 快照足够新时直接mmap加载，跳过下载和JSON解析
+        if (loadSnapshot()) {
+            return true;
+        }
+        
+        std::string url = exchangeInfoUrl(testnet);
         
         std::cout << "[INFO] Fetching exchange info from: " << url << std::endl;
         
@@ -2518,7 +2748,12 @@ bool TradingRuleManager::loadExchangeInfo(const std::string& apiKey, const std::
             std::cerr << "[WARNING] Failed to save exchange info to file" << std::endl;
         }
         
-        std::cout << "[INFO] Successfully loaded " << trading_rules_.size() << " trading rules" << std::endl;
+        TradingRuleTablePtr table = TradingRuleRegistry::getInstance().current();
+        if (table && !table->save_snapshot(SNAPSHOT_PATH)) {
+            std::cerr << "[WARNING] Failed to save trading rule snapshot" << std::endl;
+        }
+        
+        std::cout << "[INFO] Successfully loaded " << (table ? table->size() : 0) << " trading rules" << std::endl;
         return true;
         
     } catch (const std::exception& e) {
@@ -2527,6 +2762,45 @@ bool TradingRuleManager::loadExchangeInfo(const std::string& apiKey, const std::
     }
 }
 
+bool TradingRuleManager::loadSnapshot() {
+    std::unique_ptr<TradingRuleTable> table = TradingRuleTable::load_snapshot(SNAPSHOT_PATH);
+    if (!table) {
+        return false;
+    }
+    
+    uint64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    uint64_t max_age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(SNAPSHOT_MAX_AGE).count();
+    if (table->size() == 0 || now_ms - table->created_ms() > max_age_ms) {
+        std::cout << "[INFO] Trading rule snapshot is stale, refreshing from API" << std::endl;
+        return false;
+    }
+    
+    std::cout << "[INFO] Loaded " << table->size() << " trading rules from snapshot: " << SNAPSHOT_PATH << std::endl;
+    TradingRuleRegistry::getInstance().publish(std::move(table));
+    return true;
+}
+
+std::string TradingRuleManager::exchangeInfoUrl(bool testnet) {
+    std::string baseUrl = testnet ? "https://testnet.binancefuture.com" : "https://fapi.binance.com";
+    return baseUrl + "/fapi/v1/exchangeInfo";
+}
+
+bool TradingRuleManager::startAutoRefresh(const std::string& apiKey, bool testnet, const std::string& source,
+                                          std::chrono::milliseconds interval) {
+    ExchangeRulesRefresher::Config config;
+    config.source = source.empty() ? exchangeInfoUrl(testnet) : source;
+    config.api_key = apiKey;
+    config.snapshot_path = SNAPSHOT_PATH;
+    config.json_path = EXCHANGE_INFO_JSON_PATH;
+    config.refresh_interval = interval;
+    return refresher_.start(config);
+}
+
+void TradingRuleManager::stopAutoRefresh() {
+    refresher_.stop();
+}
+
 std::string TradingRuleManager::makeHttpRequest(const std::string& url, const std::string& apiKey) const {
     try {
         ix::HttpClient httpClient;
@@ -2553,77 +2827,43 @@ std::string TradingRuleManager::makeHttpRequest(const std::string& url, const st
 }
 
 bool TradingRuleManager::parseExchangeInfo(const std::string& jsonData) {
-    try {
-        nlohmann::json exchangeInfo = nlohmann::json::parse(jsonData);
-        
-        if (!exchangeInfo.contains("symbols") || !exchangeInfo["symbols"].is_array()) {
-            std::cerr << "[ERROR] Invalid exchange info format: missing symbols array" << std::endl;
-            return false;
-        }
-        
-        std::lock_guard<std::mutex> lock(rules_mutex_);
-        trading_rules_.clear();
-        
-        for (const auto& symbolInfo : exchangeInfo["symbols"]) {
-            if (!symbolInfo.contains("symbol") || !symbolInfo.contains("filters")) {
-                continue;
-            }
-            
-            TradingRule rule;
-            rule.symbol = symbolInfo["symbol"];
-            rule.quantityPrecision = symbolInfo.value("quantityPrecision", 0);
-            rule.pricePrecision = symbolInfo.value("pricePrecision", 0);
-            
-            // 解析过滤器
-            for (const auto& filter : symbolInfo["filters"]) {
-                if (!filter.contains("filterType")) continue;
-                
-                std::string filterType = filter["filterType"];
-                
-                if (filterType == "LOT_SIZE") {
-                    rule.minQty = std::stod(filter.value("minQty", "0"));
-                    rule.maxQty = std::stod(filter.value("maxQty", "0"));
-                    rule.stepSize = std::stod(filter.value("stepSize", "0"));
-                } else if (filterType == "PRICE_FILTER") {
-                    rule.tickSize = std::stod(filter.value("tickSize", "0"));
-                } else if (filterType == "MIN_NOTIONAL") {
-                    rule.minNotional = std::stod(filter.value("notional", "0"));
-                }
-            }
-            
-            trading_rules_[rule.symbol] = rule;
-            
-            // 输出APRUSDT的规则信息用于调试
-            if (rule.symbol == "APRUSDT") {
-                std::cout << "[INFO] APRUSDT Trading Rules:" << std::endl;
-                std::cout << "  - Quantity Precision: " << rule.quantityPrecision << std::endl;
-                std::cout << "  - Price Precision: " << rule.pricePrecision << std::endl;
-                std::cout << "  - Min Qty: " << rule.minQty << std::endl;
-                std::cout << "  - Max Qty: " << rule.maxQty << std::endl;
-                std::cout << "  - Step Size: " << rule.stepSize << std::endl;
-                std::cout << "  - Tick Size: " << rule.tickSize << std::endl;
-                std::cout << "  - Min Notional: " << rule.minNotional << std::endl;
-            }
-        }
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "[ERROR] Exception parsing exchange info: " << e.what() << std::endl;
+    std::vector<SymbolRule> rules;
+    if (!TradingRuleTable::parse_exchange_info(jsonData, rules)) {
+        return false;
+    }
+    
+    std::unique_ptr<TradingRuleTable> table = TradingRuleTable::build(rules);
+    if (!table) {
+        std::cerr << "[ERROR] Failed to build trading rule table" << std::endl;
         return false;
     }
+    
+    // 输出APRUSDT的规则信息用于调试
+    int32_t index = table->find("APRUSDT");
+    if (index != TradingRuleTable::NOT_FOUND) {
+        std::cout << "[INFO] APRUSDT Trading Rules:" << std::endl;
+        std::cout << "  - Quantity Precision: " << table->quantity_precision(index) << std::endl;
+        std::cout << "  - Price Precision: " << table->price_precision(index) << std::endl;
+        std::cout << "  - Min Qty: " << table->min_qty(index) << std::endl;
+        std::cout << "  - Max Qty: " << table->max_qty(index) << std::endl;
+        std::cout << "  - Step Size: " << table->step_size(index) << std::endl;
+        std::cout << "  - Tick Size: " << table->tick_size(index) << std::endl;
+        std::cout << "  - Min Notional: " << table->min_notional(index) << std::endl;
+    }
+    
+    TradingRuleRegistry::getInstance().publish(std::move(table));
+    return true;
 }
 
 bool TradingRuleManager::saveExchangeInfoToFile(const std::string& jsonData) const {
     try {
-        std::ofstream file("config/exchange_info.json");
+        // 原样落盘，不再重新解析和格式化整个文档
+        std::ofstream file(EXCHANGE_INFO_JSON_PATH, std::ios::binary);
         if (!file.is_open()) {
             return false;
         }
         
-        // 格式化JSON输出
-        nlohmann::json parsed = nlohmann::json::parse(jsonData);
-        file << parsed.dump(2);
+        file.write(jsonData.data(), jsonData.size());
         file.close();
         
         std::cout << "[INFO] Exchange info saved to config/exchange_info.json" << std::endl;
@@ -2636,12 +2876,26 @@ bool TradingRuleManager::saveExchangeInfoToFile(const std::string& jsonData) con
 }
 
 TradingRule TradingRuleManager::getTradingRule(const std::string& symbol) const {
-    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(rules_mutex_));
-    auto it = trading_rules_.find(symbol);
-    if (it != trading_rules_.end()) {
-        return it->second;
+    TradingRule rule;
+    TradingRuleTablePtr table = TradingRuleRegistry::getInstance().current();
+    if (!table) {
+        return rule; // 返回默认规则
     }
-    return TradingRule(); // 返回默认规则
+    
+    int32_t index = table->find(symbol);
+    if (index == TradingRuleTable::NOT_FOUND) {
+        return rule; // 返回默认规则
+    }
+    
+    rule.symbol = symbol;
+    rule.quantityPrecision = table->quantity_precision(index);
+    rule.pricePrecision = table->price_precision(index);
+    rule.minQty = table->min_qty(index);
+    rule.maxQty = table->max_qty(index);
+    rule.stepSize = table->step_size(index);
+    rule.tickSize = table->tick_size(index);
+    rule.minNotional = table->min_notional(index);
+    return rule;
 }
 
 double TradingRuleManager::formatQuantity(const std::string& symbol, double quantity) const {
@@ -2684,25 +2938,24 @@ double TradingRuleManager::formatPrice(const std::string& symbol, double price)
 }
 
 bool TradingRuleManager::isValidOrder(const std::string& symbol, double quantity, double price) const {
-    TradingRule rule = getTradingRule(symbol);
-    
-    // 检查数量范围
-    if (quantity < rule.minQty || quantity > rule.maxQty) {
-        std::cout << "[ERROR] Invalid quantity for " << symbol 
-                  << ": " << quantity << " (min: " << rule.minQty 
-                  << ", max: " << rule.maxQty << ")" << std::endl;
-        return false;
+    // 与TradingRuleChecker共用同一规则引擎
+    TradingRuleTablePtr table = TradingRuleRegistry::getInstance().current();
+    int32_t index = table ? table->find(symbol) : TradingRuleTable::NOT_FOUND;
+    TradingRuleCheckResult result = TradingRuleChecker::evaluate(table, index, quantity, price);
+    if (result == TradingRuleCheckResult::PASS) {
+        return true;
     }
     
-    // 检查最小名义价值
-    double notional = quantity * price;
-    if (notional < rule.minNotional) {
-        std::cout << "[ERROR] Invalid notional for " << symbol 
-                  << ": " << notional << " (min: " << rule.minNotional << ")" << std::endl;
-        return false;
+    std::cout << "[ERROR] Invalid order for " << symbol << ": "
+              << TradingRuleChecker::get_trading_rule_result_description(result)
+              << " (quantity: " << quantity << ", price: " << price;
+    if (index != TradingRuleTable::NOT_FOUND) {
+        std::cout << ", minQty: " << table->min_qty(index) << ", maxQty: " << table->max_qty(index)
+                  << ", stepSize: " << table->step_size(index) << ", tickSize: " << table->tick_size(index)
+                  << ", minNotional: " << table->min_notional(index);
     }
-    
-    return true;
+    std::cout << ")" << std::endl;
+    return false;
 }
 
 int main(int argc, char* argv[])
@@ -0,0 +1,285 @@
+#include "allocation_tracker.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+// 只含平凡类型，operator new中访问不会触发动态初始化或分配
+struct ThreadAllocationState {
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t bytes;
+    ScopedNoAllocRegion* region;
+    bool handling;              // 处理违规期间的分配（如输出）不再计入，防止递归
+};
+
+thread_local ThreadAllocationState thread_state = {0, 0, 0, nullptr, false};
+
+AllocationRegionStats regions[AllocationTracker::MAX_REGIONS];
+std::atomic<size_t> region_count{0};
+std::mutex region_mutex;
+
+std::atomic<int> policy_state{-1};     // -1表示尚未读取环境变量
+std::atomic<uint64_t> reported_violations{0};
+
+AllocationPolicy policy_from_environment()
+{
+    const char* value = std::getenv("TES_ALLOC_POLICY");
+    if (value) {
+        if (std::strcmp(value, "count") == 0) {
+            return AllocationPolicy::COUNT;
+        }
+        if (std::strcmp(value, "abort") == 0) {
+            return AllocationPolicy::ABORT;
+        }
+    }
+    return AllocationPolicy::REPORT;
+}
+
+// 直接写stderr，不经过iostream，避免在钩子中再分配
+void write_violation(const char* region, size_t size)
+{
+    char message[192];
+    int length = std::snprintf(message, sizeof(message),
+                               "[allocation_tracker] %zu bytes allocated in no-alloc region '%s' (tid %ld)\n",
+                               size, region, static_cast<long>(syscall(SYS_gettid)));
+    if (length > 0) {
+        ssize_t written = write(STDERR_FILENO, message, std::min<size_t>(static_cast<size_t>(length), sizeof(message) - 1));
+        (void)written;
+    }
+}
+
+} // namespace
+
+bool AllocationTracker::enabled()
+{
+#ifdef TES_ENABLE_ALLOCATION_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+AllocationCounters AllocationTracker::thread_counters()
+{
+    return {thread_state.allocations, thread_state.deallocations, thread_state.bytes};
+}
+
+AllocationPolicy AllocationTracker::policy()
+{
+    int state = policy_state.load(std::memory_order_relaxed);
+    if (state < 0) {
+        state = static_cast<int>(policy_from_environment());
+        policy_state.store(state, std::memory_order_relaxed);
+    }
+    return static_cast<AllocationPolicy>(state);
+}
+
+void AllocationTracker::set_policy(AllocationPolicy policy)
+{
+    policy_state.store(static_cast<int>(policy), std::memory_order_relaxed);
+}
+
+AllocationRegionStats* AllocationTracker::register_region(const char* name)
+{
+    const char* region_name = name ? name : "unnamed";
+
+    std::lock_guard<std::mutex> lock(region_mutex);
+    size_t count = region_count.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (std::strncmp(regions[i].name, region_name, AllocationRegionStats::MAX_NAME_LENGTH - 1) == 0) {
+            return &regions[i];
+        }
+    }
+    if (count >= MAX_REGIONS) {
+        return nullptr;
+    }
+
+    AllocationRegionStats& stats = regions[count];
+    std::strncpy(stats.name, region_name, AllocationRegionStats::MAX_NAME_LENGTH - 1);
+    stats.name[AllocationRegionStats::MAX_NAME_LENGTH - 1] = '\0';
+    region_count.store(count + 1, std::memory_order_release);
+    return &stats;
+}
+
+std::vector<AllocationRegionReport> AllocationTracker::get_region_reports()
+{
+    std::vector<AllocationRegionReport> reports;
+    size_t count = region_count.load(std::memory_order_acquire);
+    reports.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const AllocationRegionStats& stats = regions[i];
+        reports.push_back({stats.name,
+                           stats.entries.load(std::memory_order_relaxed),
+                           stats.violating_entries.load(std::memory_order_relaxed),
+                           stats.allocations.load(std::memory_order_relaxed),
+                           stats.bytes.load(std::memory_order_relaxed)});
+    }
+    return reports;
+}
+
+std::string AllocationTracker::generate_report()
+{
+    std::ostringstream report;
+    report << "No-Alloc Regions:\n";
+    for (const auto& region : get_region_reports()) {
+        double violating_ratio = region.entries
+            ? static_cast<double>(region.violating_entries) / static_cast<double>(region.entries) : 0.0;
+        report << "  " << region.name << ": entries=" << region.entries
+               << " violating=" << region.violating_entries
+               << " (" << std::fixed << std::setprecision(1) << violating_ratio * 100.0 << "%)"
+               << " allocations=" << region.allocations
+               << " bytes=" << region.bytes << "\n";
+    }
+    return report.str();
+}
+
+void AllocationTracker::on_allocate(size_t size)
+{
+    ThreadAllocationState& state = thread_state;
+    ++state.allocations;
+    state.bytes += size;
+
+    ScopedNoAllocRegion* region = state.region;
+    if (!region || state.handling) {
+        return;
+    }
+
+    state.handling = true;
+    if (region->allocations_++ == 0 && region->stats_) {
+        region->stats_->violating_entries.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (region->stats_) {
+        region->stats_->allocations.fetch_add(1, std::memory_order_relaxed);
+        region->stats_->bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    AllocationPolicy current_policy = policy();
+    if (current_policy == AllocationPolicy::ABORT) {
+        write_violation(region->name(), size);
+        std::abort();
+    }
+    if (current_policy == AllocationPolicy::REPORT &&
+        reported_violations.fetch_add(1, std::memory_order_relaxed) < MAX_REPORTED_VIOLATIONS) {
+        write_violation(region->name(), size);
+    }
+    state.handling = false;
+}
+
+void AllocationTracker::on_deallocate()
+{
+    ++thread_state.deallocations;
+}
+
+ScopedNoAllocRegion::ScopedNoAllocRegion(AllocationRegionStats* stats)
+    : stats_(stats), parent_(nullptr), allocations_(0)
+{
+    enter();
+}
+
+ScopedNoAllocRegion::ScopedNoAllocRegion(const char* name)
+    : stats_(AllocationTracker::register_region(name)), parent_(nullptr), allocations_(0)
+{
+    enter();
+}
+
+void ScopedNoAllocRegion::enter()
+{
+    if (stats_) {
+        stats_->entries.fetch_add(1, std::memory_order_relaxed);
+    }
+    parent_ = thread_state.region;
+    thread_state.region = this;
+}
+
+ScopedNoAllocRegion::~ScopedNoAllocRegion()
+{
+    thread_state.region = parent_;
+}
+
+} // namespace execution
+} // namespace tes
+
+#ifdef TES_ENABLE_ALLOCATION_TRACKING
+
+// 全局operator new/delete替换：分配走malloc/posix_memalign，记账后返回
+namespace {
+
+void* tracked_allocate(std::size_t size, std::size_t alignment)
+{
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        void* ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t)) {
+            ptr = std::malloc(size);
+        } else if (posix_memalign(&ptr, alignment, size) != 0) {
+            ptr = nullptr;
+        }
+        if (ptr) {
+            tes::execution::AllocationTracker::on_allocate(size);
+            return ptr;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* tracked_allocate_nothrow(std::size_t size, std::size_t alignment) noexcept
+{
+    try {
+        return tracked_allocate(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void tracked_free(void* ptr) noexcept
+{
+    if (ptr) {
+        tes::execution::AllocationTracker::on_deallocate();
+        std::free(ptr);
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return tracked_allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return tracked_allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return tracked_allocate_nothrow(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return tracked_allocate_nothrow(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return tracked_allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return tracked_allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tracked_allocate_nothrow(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return tracked_allocate_nothrow(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void* ptr) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { tracked_free(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { tracked_free(ptr); }
+
+#endif
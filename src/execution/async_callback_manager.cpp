@@ -1,4 +1,6 @@
 #include "async_callback_manager.h"
+#include "thread_accounting.h"
+#include "shared_memory/core/tsc_clock.h"
 #include <algorithm>
 #include <sstream>
 #include <shared_mutex>
@@ -159,7 +161,7 @@ bool AsyncCallbackManager::publish_event(const AsyncCallbackEvent& event) {
 }
 
 bool AsyncCallbackManager::publish_event(CallbackEventType type, const std::string& execution_id, const std::string& data) {
-    AsyncCallbackEvent event(type, execution_id, data);
+    AsyncCallbackEvent event(type, execution_id, data, shared_memory::TscClock::instance().now());
     return publish_event(event);
 }
 
@@ -209,6 +211,8 @@ bool AsyncCallbackManager::is_queue_full() const {
 }
 
 void AsyncCallbackManager::event_processing_worker() {
+    ThreadAccounting::set_current_thread_name("tes-callback");
+
     while (running_.load()) {
         process_event_batch();
         
@@ -2,7 +2,9 @@
 #include "execution/config_manager.h"
 #include "execution/signal_transmission_manager.h"
 #include "execution/json_feedback_writer.h"
+#include "shared_memory/core/position_table.h"
 #include "common/common_types.h"
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <memory>
@@ -95,13 +97,26 @@ ExecutionController::~ExecutionController()
 
 bool ExecutionController::initialize()
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     
     if (initialized_.load()) {
         return true;
     }
     
     try {
+        // 首次取实例时完成TSC标定，之后由后台线程修正漂移
+        shared_memory::TscClock::instance().start_drift_correction(
+            std::chrono::milliseconds(config_.clock_drift_correction_interval_ms));
+        
+        // 飞行记录器打开失败不影响交易，只是没有事后分析数据
+        if (config_.enable_flight_recorder &&
+            !shared_memory::FlightRecorder::instance().open(config_.flight_recorder_path, config_.flight_recorder_capacity)) {
+            std::cerr << "Failed to open flight recorder at " << config_.flight_recorder_path << std::endl;
+        }
+        // 与轨迹ID相同，以启动时刻为基数，重启后生成的clientOrderId不与仍挂着的旧订单重复
+        next_flight_id_.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count()) * 1000, std::memory_order_relaxed);
+        
         // 初始化Gateway适配器（替代BinanceTradingInterface）
         if (is_exchange_enabled("binance")) {
             gateway_adapter_ = &GatewayAdapter::getInstance();
@@ -233,6 +248,16 @@ bool ExecutionController::initialize()
             return false;
         }
         
+        // 持仓和盈亏写入共享内存，策略进程直接读取，不必从回报或文件推算
+        if (config_.enable_position_tracking) {
+            try {
+                position_manager_->set_shared_position_table(
+                    std::make_shared<shared_memory::PositionTable>(shared_memory::PositionTable::EXECUTION_TABLE, true));
+            } catch (const std::exception& e) {
+                std::cerr << "[WARNING] Shared position table unavailable: " << e.what() << std::endl;
+            }
+        }
+        
         // 将PositionManager集成到Gateway适配器
         if (is_exchange_enabled("binance") && gateway_adapter_) {
             // TODO: 实现Gateway适配器的PositionManager集成
@@ -321,6 +346,56 @@ bool ExecutionController::initialize()
             return false;
         }
         
+        // 热路径指标在启动时注册一次，之后按句柄记录
+        signal_metrics_.queue_size = performance_monitor_->register_histogram("queue_size_signal_queue");
+        signal_metrics_.serial_latency = performance_monitor_->register_histogram("latency_signal_processing");
+        signal_metrics_.concurrent_latency = performance_monitor_->register_histogram("latency_signal_processing_concurrent");
+        signal_metrics_.serial_throughput = performance_monitor_->register_histogram("throughput_signal_processing_serial");
+        signal_metrics_.concurrent_throughput = performance_monitor_->register_histogram("throughput_signal_processing_concurrent");
+        signal_metrics_.serial_success = performance_monitor_->register_counter("signal_processing.success");
+        signal_metrics_.serial_error = performance_monitor_->register_counter("signal_processing.error");
+        signal_metrics_.concurrent_success = performance_monitor_->register_counter("signal_processing_concurrent.success");
+        signal_metrics_.concurrent_error = performance_monitor_->register_counter("signal_processing_concurrent.error");
+        
+        // 端到端延迟跟踪：网关在初始化时已创建，这里再挂上下单链路打点
+        if (config_.enable_latency_tracing) {
+            latency_tracer_ = std::unique_ptr<LatencyTracer>(new LatencyTracer());
+            if (!latency_tracer_->initialize(config_.latency_tracer_config, performance_monitor_.get())) {
+                latency_tracer_.reset();
+            }
+        }
+        
+        // 下单链路打点同时写入飞行记录器，事件ID取clientOrderId中的轨迹ID
+        if (gateway_adapter_ && (latency_tracer_ || config_.enable_flight_recorder)) {
+            LatencyTracer* tracer = latency_tracer_.get();
+            gateway_adapter_->set_order_trace_callback(
+                [tracer](const char* client_order_id, TraceHop hop, int64_t ns) {
+                    if (tracer) {
+                        tracer->mark(client_order_id, hop, ns);
+                    }
+                    shared_memory::FlightEventType type = shared_memory::FlightEventType::ORDER_ACK;
+                    if (hop == TraceHop::SERIALIZE) {
+                        type = shared_memory::FlightEventType::ORDER_SERIALIZED;
+                    } else if (hop == TraceHop::SEND) {
+                        type = shared_memory::FlightEventType::ORDER_SENT;
+                    }
+                    shared_memory::FlightRecorder::instance().record(
+                        type, LatencyTracer::parse_client_order_id(client_order_id));
+                });
+        }
+        
+        // 交易所侧延迟：往返按请求方法分开统计，偏移与不确定度记为gauge(微秒)
+        exchange_latency_metrics_.exchange_processing = performance_monitor_->register_histogram("latency_exchange_processing");
+        exchange_latency_metrics_.event_delivery = performance_monitor_->register_histogram("latency_exchange_delivery");
+        exchange_latency_metrics_.clock_offset = performance_monitor_->register_gauge("exchange_clock_offset_us");
+        exchange_latency_metrics_.clock_uncertainty = performance_monitor_->register_gauge("exchange_clock_uncertainty_us");
+        if (gateway_adapter_) {
+            gateway_adapter_->set_exchange_latency_callback(
+                [this](ExchangeLatencyKind kind, const char* name, int64_t value_ns) {
+                    handle_exchange_latency(kind, name, value_ns);
+                });
+        }
+        
         // 设置事件回调
         setup_event_callbacks();
         
@@ -497,6 +572,23 @@ void ExecutionController::cleanup()
         order_manager_.reset();
     }
     
+    if (gateway_adapter_) {
+        gateway_adapter_->set_exchange_latency_callback(nullptr);
+    }
+    
+    if (gateway_adapter_) {
+        gateway_adapter_->set_order_trace_callback(nullptr);
+    }
+    
+    if (latency_tracer_) {
+        latency_tracer_->flush();
+        latency_tracer_.reset();
+    }
+    
+    shared_memory::FlightRecorder::instance().close();
+    
+    shared_memory::TscClock::instance().stop_drift_correction();
+    
     initialized_.store(false);
 }
 
@@ -542,42 +634,88 @@ void ExecutionController::process_trading_signal(const shared_memory::TradingSig
     }
     
     try {
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
-        statistics_.signals_processed++;
-        statistics_.last_signal_time = std::chrono::high_resolution_clock::now();
+        // 每个信号只读一次时钟，统计和订单共用
+        auto now = shared_memory::TscClock::instance().now();
+        
+        {
+            std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
+            statistics_.signals_processed++;
+            statistics_.last_signal_time = now;
+        }
+        
+        Order order(now);
+        uint64_t trace_id = 0;
+        uint64_t flight_id = 0;
+        TradingRuleCheckResult rule_result = TradingRuleCheckResult::PASS;
+        bool use_twap = false;
+        
+        {
+            // 信号到订单（转换、打点、风控、路由判断）不应分配内存；打开分配跟踪时逐次统计，
+            // TES_ALLOC_POLICY=abort可在回归运行中直接中止。下单报文和订单簿记属于执行路径，不在区域内
+            TES_NO_ALLOC_REGION("signal_to_order");
+            
+            // 创建订单
+            order.strategy_id = signal.strategy_id;
+            order.instrument_id = signal.instrument_id;
+            order.side = convert_order_side(signal.side);
+            order.type = convert_order_type(signal.order_type);
+            order.quantity = signal.quantity;
+            order.price = signal.price;
+            order.time_in_force = convert_time_in_force(signal.time_in_force);
+            
+            if (latency_tracer_) {
+                trace_id = latency_tracer_->begin_trace(signal.trace_id, signal.signal_id, signal.instrument_id,
+                                                        signal.shm_write_ns, signal.shm_read_ns);
+            }
+            // 飞行记录器中的事件ID：启用追踪时即轨迹ID，否则单独分配；两者都编码进clientOrderId
+            flight_id = trace_id;
+            if (flight_id == 0 && shared_memory::FlightRecorder::instance().is_open()) {
+                flight_id = signal.trace_id ? signal.trace_id
+                                            : next_flight_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+            }
+            shared_memory::FlightRecorder::instance().record(
+                shared_memory::FlightEventType::SIGNAL_IN, flight_id,
+                (signal.shm_write_ns && signal.shm_read_ns) ? signal.shm_read_ns - signal.shm_write_ns : 0);
+            
+            // 交易规则检查
+            if (config_.enable_risk_checking) {
+                rule_result = trading_rule_checker_->check_order(order);
+            }
+            
+            if (rule_result == TradingRuleCheckResult::PASS) {
+                if (latency_tracer_) {
+                    latency_tracer_->mark(trace_id, TraceHop::RISK_PASS, LatencyTracer::now_ns());
+                }
+                // 判断是否使用TWAP算法执行
+                use_twap = should_use_twap_execution(signal);
+            }
+        }
         
-        // 创建订单
-        Order order;
-        order.strategy_id = signal.strategy_id;
-        order.instrument_id = signal.instrument_id;
-        order.side = convert_order_side(signal.side);
-        order.type = convert_order_type(signal.order_type);
-        order.quantity = signal.quantity;
-        order.price = signal.price;
-        order.time_in_force = convert_time_in_force(signal.time_in_force);
-        order.timestamp = std::chrono::high_resolution_clock::now();
-        
-        // 交易规则检查
-        if (config_.enable_risk_checking) {
-            TradingRuleCheckResult rule_result = trading_rule_checker_->check_order(order);
-            if (rule_result != TradingRuleCheckResult::PASS) {
+        if (rule_result != TradingRuleCheckResult::PASS) {
+            {
+                std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
                 statistics_.risk_violations++;
-                
-                // 发送拒绝回报
+            }
+            shared_memory::FlightRecorder::instance().record(
+                shared_memory::FlightEventType::ORDER_REJECT, flight_id, static_cast<int64_t>(rule_result));
+            
+            // 发送拒绝回报（文件模式下没有共享内存接口）
+            if (shared_memory_interface_) {
                 shared_memory::OrderFeedback feedback;
                 feedback.set_order_id("");
                 feedback.status = shared_memory::OrderStatus::REJECTED;
                 feedback.set_error_message(trading_rule_checker_->get_trading_rule_result_description(rule_result));
-                feedback.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+                feedback.timestamp = shared_memory::TscClock::instance().realtime_ns();
                 
                 shared_memory_interface_->send_order_feedback(feedback);
-                return;
             }
+            return;
         }
         
-        // 判断是否使用TWAP算法执行
-        bool use_twap = should_use_twap_execution(signal);
+        if (flight_id != 0) {
+            // 轨迹ID编码进clientOrderId，网关应答和成交回报据此回到同一条轨迹；TWAP子单沿用自己的ID
+            order.client_order_id = LatencyTracer::make_client_order_id(flight_id);
+        }
         
         if (use_twap) {
             // 使用TWAP算法执行大额订单
@@ -598,8 +736,11 @@ void ExecutionController::process_trading_signals(const std::vector<shared_memor
         return;
     }
     
-    // 记录信号处理开始时间
-    auto start_time = std::chrono::high_resolution_clock::now();
+#ifdef TES_ENABLE_METRICS
+    // 记录信号处理开始时间（TSC计数，结束时再换算）
+    const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+    uint64_t start_ticks = clock.ticks();
+#endif
     
     // 将信号放入无锁队列
     for (const auto& signal : signals) {
@@ -607,46 +748,40 @@ void ExecutionController::process_trading_signals(const std::vector<shared_memor
     }
     
     // 记录队列大小
-    if (performance_monitor_) {
-        performance_monitor_->record_queue_size("signal_queue", signals.size());
-    }
+    TES_METRIC_RECORD(performance_monitor_, signal_metrics_.queue_size, static_cast<double>(signals.size()));
+    shared_memory::FlightRecorder::instance().record(
+        shared_memory::FlightEventType::QUEUE_DEPTH, 0, static_cast<int64_t>(signals.size()));
     
     // 如果信号数量较少或线程池未初始化，使用串行处理
     if (signals.size() <= 2 || !signal_thread_pool_) {
         shared_memory::TradingSignal signal;
         size_t processed_count = 0;
         while (signal_queue_->dequeue(signal)) {
-            auto signal_start = std::chrono::high_resolution_clock::now();
+            // 记录单个信号处理延迟
+            TES_METRIC_SCOPED_LATENCY(performance_monitor_, signal_metrics_.serial_latency);
             
             try {
                 process_trading_signal(signal);
                 processed_count++;
                 
                 // 记录成功处理
-                if (performance_monitor_) {
-                    performance_monitor_->record_success("signal_processing");
-                }
+                TES_METRIC_INCREMENT(performance_monitor_, signal_metrics_.serial_success);
             } catch (const std::exception& e) {
                 // 记录处理错误
-                if (performance_monitor_) {
-                    performance_monitor_->record_error("signal_processing");
-                }
-            }
-            
-            // 记录单个信号处理延迟
-            if (performance_monitor_) {
-                auto signal_end = std::chrono::high_resolution_clock::now();
-                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(signal_end - signal_start).count();
-                performance_monitor_->record_latency("signal_processing", static_cast<double>(latency));
+                TES_METRIC_INCREMENT(performance_monitor_, signal_metrics_.serial_error);
             }
         }
         
+#ifdef TES_ENABLE_METRICS
         // 记录串行处理吞吐量
-        if (performance_monitor_ && processed_count > 0) {
-            auto end_time = std::chrono::high_resolution_clock::now();
-            auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-            performance_monitor_->record_throughput("signal_processing_serial", processed_count, duration_ms);
+        if (processed_count > 0) {
+            int64_t duration_ms = clock.ticks_to_ns(clock.ticks() - start_ticks) / 1000000;
+            if (duration_ms > 0) {
+                TES_METRIC_RECORD(performance_monitor_, signal_metrics_.serial_throughput,
+                                  processed_count * 1000.0 / duration_ms);
+            }
         }
+#endif
         return;
     }
     
@@ -658,29 +793,19 @@ void ExecutionController::process_trading_signals(const std::vector<shared_memor
         auto future = signal_thread_pool_->enqueue([this]() {
             shared_memory::TradingSignal signal;
             if (signal_queue_->dequeue(signal)) {
-                auto signal_start = std::chrono::high_resolution_clock::now();
+                // 记录单个信号处理延迟
+                TES_METRIC_SCOPED_LATENCY(performance_monitor_, signal_metrics_.concurrent_latency);
                 
                 try {
                     process_trading_signal(signal);
                     
                     // 记录成功处理
-                    if (performance_monitor_) {
-                        performance_monitor_->record_success("signal_processing_concurrent");
-                    }
+                    TES_METRIC_INCREMENT(performance_monitor_, signal_metrics_.concurrent_success);
                 } catch (const std::exception& e) {
                     set_error("Concurrent signal processing error: " + std::string(e.what()));
                     
                     // 记录处理错误
-                    if (performance_monitor_) {
-                        performance_monitor_->record_error("signal_processing_concurrent");
-                    }
-                }
-                
-                // 记录单个信号处理延迟
-                if (performance_monitor_) {
-                    auto signal_end = std::chrono::high_resolution_clock::now();
-                    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(signal_end - signal_start).count();
-                    performance_monitor_->record_latency("signal_processing_concurrent", static_cast<double>(latency));
+                    TES_METRIC_INCREMENT(performance_monitor_, signal_metrics_.concurrent_error);
                 }
             }
         });
@@ -698,12 +823,16 @@ void ExecutionController::process_trading_signals(const std::vector<shared_memor
         }
     }
     
+#ifdef TES_ENABLE_METRICS
     // 记录并发处理吞吐量
-    if (performance_monitor_ && completed_count > 0) {
-        auto end_time = std::chrono::high_resolution_clock::now();
-        auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
-        performance_monitor_->record_throughput("signal_processing_concurrent", completed_count, duration_ms);
+    if (completed_count > 0) {
+        int64_t duration_ms = clock.ticks_to_ns(clock.ticks() - start_ticks) / 1000000;
+        if (duration_ms > 0) {
+            TES_METRIC_RECORD(performance_monitor_, signal_metrics_.concurrent_throughput,
+                              completed_count * 1000.0 / duration_ms);
+        }
     }
+#endif
 }
 
 std::string ExecutionController::create_order(const Order& order)
@@ -789,7 +918,7 @@ std::string ExecutionController::start_twap_execution(const std::string& strateg
     
     std::string execution_id = twap_algorithm_->start_execution(strategy_id, instrument_id, side, params);
     if (!execution_id.empty()) {
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         statistics_.algorithm_executions++;
     }
     
@@ -892,43 +1021,43 @@ void ExecutionController::update_account_info(const AccountInfo& account_info)
 
 void ExecutionController::set_order_event_callback(OrderEventCallback callback)
 {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     order_event_callback_ = callback;
 }
 
 void ExecutionController::set_trade_event_callback(TradeEventCallback callback)
 {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     trade_event_callback_ = callback;
 }
 
 void ExecutionController::set_trading_rule_event_callback(TradingRuleEventCallback callback)
 {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     trading_rule_event_callback_ = callback;
 }
 
 void ExecutionController::set_position_event_callback(PositionEventCallback callback)
 {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     position_event_callback_ = callback;
 }
 
 void ExecutionController::set_config(const Config& config)
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     config_ = config;
 }
 
 ExecutionController::Config ExecutionController::get_config() const
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     return config_;
 }
 
 ExecutionStatistics ExecutionController::get_statistics() const
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     return statistics_;
 }
 
@@ -947,12 +1076,14 @@ bool ExecutionController::is_connected() const
 
 std::string ExecutionController::get_last_error() const
 {
-    std::lock_guard<std::mutex> lock(error_mutex_);
+    std::lock_guard<NamedMutex> lock(error_mutex_);
     return last_error_;
 }
 
 void ExecutionController::signal_processing_worker()
 {
+    ThreadAccounting::set_current_thread_name("tes-signal");
+
     while (running_.load()) {
         try {
             std::vector<shared_memory::TradingSignal> signals;
@@ -969,6 +1100,8 @@ void ExecutionController::signal_processing_worker()
 
 void ExecutionController::heartbeat_worker()
 {
+    ThreadAccounting::set_current_thread_name("tes-heartbeat");
+
     while (running_.load()) {
         try {
             if (shared_memory_interface_) {
@@ -984,10 +1117,16 @@ void ExecutionController::heartbeat_worker()
 
 void ExecutionController::statistics_worker()
 {
+    ThreadAccounting::set_current_thread_name("tes-stats");
+
     while (running_.load()) {
         try {
             update_statistics();
             
+            if (latency_tracer_) {
+                latency_tracer_->flush();
+            }
+            
             std::this_thread::sleep_for(std::chrono::milliseconds(config_.statistics_update_interval_ms));
         } catch (const std::exception& e) {
             set_error("Exception in statistics_worker: " + std::string(e.what()));
@@ -1012,15 +1151,66 @@ void ExecutionController::setup_event_callbacks()
     }
 }
 
+void ExecutionController::handle_exchange_latency(ExchangeLatencyKind kind, const char* name, int64_t value_ns)
+{
+    if (!performance_monitor_) {
+        return;
+    }
+
+    double value_us = static_cast<double>(value_ns) / 1000.0;
+    switch (kind) {
+        case ExchangeLatencyKind::REQUEST_RTT: {
+            HistogramHandle handle;
+            {
+                std::lock_guard<NamedMutex> lock(exchange_latency_metrics_.mutex);
+                std::string method = name ? name : "unknown";
+                auto it = exchange_latency_metrics_.request_rtt.find(method);
+                if (it == exchange_latency_metrics_.request_rtt.end()) {
+                    handle = performance_monitor_->register_histogram("latency_exchange_rtt_" + method);
+                    exchange_latency_metrics_.request_rtt.emplace(method, handle);
+                } else {
+                    handle = it->second;
+                }
+            }
+            performance_monitor_->record(handle, value_us);
+            break;
+        }
+        case ExchangeLatencyKind::EXCHANGE_PROCESSING:
+            performance_monitor_->record(exchange_latency_metrics_.exchange_processing, value_us);
+            break;
+        case ExchangeLatencyKind::EVENT_DELIVERY:
+            performance_monitor_->record(exchange_latency_metrics_.event_delivery, value_us);
+            break;
+        case ExchangeLatencyKind::CLOCK_OFFSET: {
+            performance_monitor_->set_gauge(exchange_latency_metrics_.clock_offset, value_us);
+            if (gateway_adapter_) {
+                ExchangeClockStatus status = gateway_adapter_->get_exchange_clock_status();
+                performance_monitor_->set_gauge(exchange_latency_metrics_.clock_uncertainty,
+                                                static_cast<double>(status.uncertainty_ns) / 1000.0);
+            }
+            break;
+        }
+    }
+}
+
 void ExecutionController::handle_order_event(const Order& order)
 {
+    if (order.status == OrderStatus::FILLED || order.status == OrderStatus::PARTIALLY_FILLED) {
+        if (latency_tracer_) {
+            latency_tracer_->mark(order.client_order_id.c_str(), TraceHop::FILL, LatencyTracer::now_ns());
+        }
+        shared_memory::FlightRecorder::instance().record(
+            shared_memory::FlightEventType::FILL, LatencyTracer::parse_client_order_id(order.client_order_id.c_str()),
+            static_cast<int64_t>(order.filled_quantity * 1e8));
+    }
+    
     // 发送订单回报
     if (config_.enable_order_feedback) {
         send_order_feedback(order);
     }
     
     // 调用用户回调
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     if (order_event_callback_) {
         order_event_callback_(order);
     }
@@ -1039,13 +1229,13 @@ void ExecutionController::handle_trade_event(const Trade& trade)
     
     // 更新统计
     {
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         statistics_.trades_processed++;
         statistics_.last_trade_time = std::chrono::high_resolution_clock::now();
     }
     
     // 调用用户回调
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     if (trade_event_callback_) {
         trade_event_callback_(trade);
     }
@@ -1053,7 +1243,7 @@ void ExecutionController::handle_trade_event(const Trade& trade)
 
 void ExecutionController::handle_trading_rule_event(const TradingRuleEvent& event)
 {
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     if (trading_rule_event_callback_) {
         trading_rule_event_callback_(event);
     }
@@ -1062,7 +1252,7 @@ void ExecutionController::handle_trading_rule_event(const TradingRuleEvent& even
 void ExecutionController::handle_position_event(const PositionEvent& event)
 {
     // 调用用户回调
-    std::lock_guard<std::mutex> lock(callbacks_mutex_);
+    std::lock_guard<NamedMutex> lock(callbacks_mutex_);
     if (position_event_callback_) {
         position_event_callback_(event);
     }
@@ -1150,10 +1340,9 @@ bool ExecutionController::should_use_twap_execution(const shared_memory::Trading
         return true;
     }
     
-    // 4. 策略配置强制使用TWAP
-    std::string strategy_id = signal.get_strategy_id();
-    if (strategy_id.find("TWAP") != std::string::npos || 
-        strategy_id.find("twap") != std::string::npos) {
+    // 4. 策略配置强制使用TWAP（直接在定长数组上查找，不构造std::string）
+    if (std::strstr(signal.strategy_id, "TWAP") != nullptr ||
+        std::strstr(signal.strategy_id, "twap") != nullptr) {
         return true;
     }
     
@@ -1257,7 +1446,7 @@ void ExecutionController::execute_direct_order(const Order& order)
         if (is_exchange_enabled("binance") && gateway_adapter_) {
             std::string order_id = gateway_adapter_->submit_order(order);
             if (!order_id.empty()) {
-                std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+                std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
                 statistics_.orders_created++;
                 statistics_.orders_executed++;
                 statistics_.last_order_time = std::chrono::high_resolution_clock::now();
@@ -1273,9 +1462,11 @@ void ExecutionController::execute_direct_order(const Order& order)
         // 直接创建并提交订单
         std::string order_id = order_manager_->create_order(order);
         if (!order_id.empty()) {
-            statistics_.orders_created++;
+            bool submitted = order_manager_->submit_order(order_id);
             
-            if (order_manager_->submit_order(order_id)) {
+            std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
+            statistics_.orders_created++;
+            if (submitted) {
                 statistics_.orders_executed++;
                 statistics_.last_order_time = std::chrono::high_resolution_clock::now();
             }
@@ -1287,7 +1478,7 @@ void ExecutionController::execute_direct_order(const Order& order)
 
 void ExecutionController::set_error(const std::string& error)
 {
-    std::lock_guard<std::mutex> lock(error_mutex_);
+    std::lock_guard<NamedMutex> lock(error_mutex_);
     last_error_ = error;
     
     // 记录错误日志
@@ -1,8 +1,11 @@
 #include "execution/gateway_adapter.h"
+#include "shared_memory/core/flight_recorder.h"
+#include "shared_memory/core/tsc_clock.h"
 #include "../../3rd/gateway/include/exchange_interface.h"
 #include "../../3rd/gateway/include/binance_websocket.h"
 #include "../../3rd/gateway/include/config_manager.h"
 #include "../../3rd/gateway/include/data_structures.h"
+#include "../../3rd/gateway/include/order_template.h"
 #include <iostream>
 #include <sstream>
 #include <memory>
@@ -150,8 +153,10 @@ std::string GatewayAdapter::submit_order(const Order& order) {
         // 使用trading命名空间的OrderRequest（在data_structures.h中定义）
         trading::OrderRequest request;
         request.symbol = order.instrument_id;
-        request.quantity = std::to_string(order.quantity);
-        request.price = std::to_string(order.price);
+        // 无交易规则时按8位小数定点输出，避免std::to_string固定6位截断小数量
+        trading::DecimalFormat decimal_format;
+        request.quantity = decimal_format.toString(order.quantity);
+        request.price = decimal_format.toString(order.price);
         request.newClientOrderId = order.client_order_id;
         
         // 转换订单方向
@@ -169,6 +174,8 @@ std::string GatewayAdapter::submit_order(const Order& order) {
             request.type = "MARKET";
         }
         
+        request.strategySlot = get_strategy_rate_limit_slot(order.strategy_id);
+        
         websocket_client_->placeOrder(request, request_id);
         return request_id;
         
@@ -178,6 +185,24 @@ std::string GatewayAdapter::submit_order(const Order& order) {
     }
 }
 
+int GatewayAdapter::get_strategy_rate_limit_slot(const std::string& strategy_id) {
+    if (strategy_id.empty()) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(strategy_slot_mutex_);
+    auto it = strategy_rate_limit_slots_.find(strategy_id);
+    if (it != strategy_rate_limit_slots_.end()) {
+        return it->second;
+    }
+    
+    RiskLimits limits;
+    int slot = websocket_client_->registerStrategyRateLimit(
+        strategy_id, limits.max_orders_per_second, limits.max_orders_per_minute);
+    strategy_rate_limit_slots_[strategy_id] = slot;
+    return slot;
+}
+
 bool GatewayAdapter::cancel_order(const std::string& order_id) {
     if (!websocket_client_ || !connected_.load()) {
         last_error_ = "Gateway not connected";
@@ -240,8 +265,8 @@ void GatewayAdapter::setup_callbacks() {
             on_position_update(update);
         });
 
-    websocket_client_->setOrderUpdateCallback(
-        [this](const trading::OrderUpdate& update) {
+    websocket_client_->setOrderUpdateViewCallback(
+        [this](const trading::OrderUpdateView& update) {
             on_order_update(update);
         });
 
@@ -287,7 +312,7 @@ void GatewayAdapter::on_position_update(const trading::PositionUpdate& update) {
     }
 }
 
-void GatewayAdapter::on_order_update(const trading::OrderUpdate& update) {
+void GatewayAdapter::on_order_update(const trading::OrderUpdateView& update) {
     if (order_update_callback_) {
         Order tes_order = convert_gateway_order_to_tes(update);
         order_update_callback_(tes_order);
@@ -296,6 +321,22 @@ void GatewayAdapter::on_order_update(const trading::OrderUpdate& update) {
 
 void GatewayAdapter::on_connection_status(trading::ConnectionStatus status) {
     connected_.store(status == trading::ConnectionStatus::CONNECTED);
+    
+    shared_memory::FlightRecorder& recorder = shared_memory::FlightRecorder::instance();
+    switch (status) {
+        case trading::ConnectionStatus::CONNECTED:
+            recorder.record(shared_memory::FlightEventType::CONNECTED, 0);
+            break;
+        case trading::ConnectionStatus::RECONNECTING:
+            recorder.record(shared_memory::FlightEventType::RECONNECTING, 0);
+            break;
+        case trading::ConnectionStatus::DISCONNECTED:
+        case trading::ConnectionStatus::ERROR:
+            recorder.record(shared_memory::FlightEventType::DISCONNECTED, 0, static_cast<int64_t>(status));
+            break;
+        default:
+            break;
+    }
 }
 
 void GatewayAdapter::on_error(const std::string& error) {
@@ -305,29 +346,31 @@ void GatewayAdapter::on_error(const std::string& error) {
     }
 }
 
-Order GatewayAdapter::convert_gateway_order_to_tes(const trading::OrderUpdate& gateway_order) const {
-    Order tes_order;
-    tes_order.order_id = gateway_order.orderId;
-    tes_order.client_order_id = gateway_order.clientOrderId;
-    tes_order.instrument_id = gateway_order.symbol;
-    tes_order.quantity = std::stod(gateway_order.originalQuantity);
-    tes_order.price = std::stod(gateway_order.originalPrice);
+Order GatewayAdapter::convert_gateway_order_to_tes(const trading::OrderUpdateView& gateway_order) const {
+    // 回报没有携带本地时间，以收到时刻为订单更新时间
+    Order tes_order(shared_memory::TscClock::instance().now());
+    tes_order.order_id = std::to_string(gateway_order.orderId());
+    tes_order.client_order_id = std::string(gateway_order.clientOrderId());
+    tes_order.instrument_id = std::string(gateway_order.symbol());
+    tes_order.quantity = gateway_order.originalQuantityValue();
+    tes_order.price = gateway_order.originalPriceValue();
     
     // 转换订单方向
-    if (gateway_order.side == "BUY") {
+    if (gateway_order.side() == "BUY") {
         tes_order.side = OrderSide::BUY;
     } else {
         tes_order.side = OrderSide::SELL;
     }
     
     // 转换订单状态
-    if (gateway_order.orderStatus == "NEW") {
+    std::string_view status = gateway_order.orderStatus();
+    if (status == "NEW") {
         tes_order.status = OrderStatus::SUBMITTED;
-    } else if (gateway_order.orderStatus == "FILLED") {
+    } else if (status == "FILLED") {
         tes_order.status = OrderStatus::FILLED;
-    } else if (gateway_order.orderStatus == "CANCELED") {
+    } else if (status == "CANCELED") {
         tes_order.status = OrderStatus::CANCELLED;
-    } else if (gateway_order.orderStatus == "PARTIALLY_FILLED") {
+    } else if (status == "PARTIALLY_FILLED") {
         tes_order.status = OrderStatus::PARTIALLY_FILLED;
     }
     
@@ -335,7 +378,7 @@ Order GatewayAdapter::convert_gateway_order_to_tes(const trading::OrderUpdate& g
 }
 
 tes::execution::Position GatewayAdapter::convert_gateway_position_to_tes(const trading::Position& gateway_position) const {
-    tes::execution::Position tes_position;
+    tes::execution::Position tes_position(shared_memory::TscClock::instance().now());
     tes_position.instrument_id = gateway_position.symbol;
     
     double pos_amount = std::stod(gateway_position.positionAmount);
@@ -371,6 +414,81 @@ void GatewayAdapter::set_error_callback(ErrorCallback callback) {
     error_callback_ = callback;
 }
 
+void GatewayAdapter::set_order_trace_callback(OrderTraceCallback callback) {
+    order_trace_callback_ = callback;
+    if (!websocket_client_) {
+        return;
+    }
+    
+    // 网关在替换回调时加锁，置空返回后不再有打点在执行；
+    // 转发lambda按值持有回调，WS线程不读取order_trace_callback_成员
+    if (!callback) {
+        websocket_client_->setOrderTraceCallback(nullptr);
+        return;
+    }
+    
+    websocket_client_->setOrderTraceCallback(
+        [callback](const char* client_order_id, trading::OrderTraceStage stage, int64_t ns) {
+            switch (stage) {
+                case trading::OrderTraceStage::SERIALIZED:
+                    callback(client_order_id, TraceHop::SERIALIZE, ns);
+                    break;
+                case trading::OrderTraceStage::SENT:
+                    callback(client_order_id, TraceHop::SEND, ns);
+                    break;
+                case trading::OrderTraceStage::ACKNOWLEDGED:
+                    callback(client_order_id, TraceHop::ACK, ns);
+                    break;
+            }
+        });
+}
+
+void GatewayAdapter::set_exchange_latency_callback(ExchangeLatencyCallback callback) {
+    exchange_latency_callback_ = callback;
+    if (!websocket_client_) {
+        return;
+    }
+
+    if (!exchange_latency_callback_) {
+        websocket_client_->setLatencySampleCallback(nullptr);
+        return;
+    }
+
+    websocket_client_->setLatencySampleCallback(
+        [this](const trading::LatencySample& sample) {
+            switch (sample.kind) {
+                case trading::LatencySampleKind::REQUEST_RTT:
+                    exchange_latency_callback_(ExchangeLatencyKind::REQUEST_RTT, sample.name, sample.valueNs);
+                    break;
+                case trading::LatencySampleKind::EXCHANGE_PROCESSING:
+                    exchange_latency_callback_(ExchangeLatencyKind::EXCHANGE_PROCESSING, sample.name, sample.valueNs);
+                    break;
+                case trading::LatencySampleKind::EVENT_DELIVERY:
+                    exchange_latency_callback_(ExchangeLatencyKind::EVENT_DELIVERY, sample.name, sample.valueNs);
+                    break;
+                case trading::LatencySampleKind::CLOCK_OFFSET:
+                    exchange_latency_callback_(ExchangeLatencyKind::CLOCK_OFFSET, sample.name, sample.valueNs);
+                    break;
+            }
+        });
+}
+
+ExchangeClockStatus GatewayAdapter::get_exchange_clock_status() const {
+    ExchangeClockStatus status;
+    if (!websocket_client_) {
+        return status;
+    }
+
+    trading::ClockSyncStatus gateway_status = websocket_client_->getClockSyncStatus();
+    status.synchronized = gateway_status.synchronized;
+    status.offset_ns = gateway_status.offsetNs;
+    status.uncertainty_ns = gateway_status.uncertaintyNs;
+    status.min_rtt_ns = gateway_status.minRttNs;
+    status.offset_samples = gateway_status.offsetSamples;
+    status.rtt_samples = gateway_status.rttSamples;
+    return status;
+}
+
 std::string GatewayAdapter::get_last_error() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return last_error_;
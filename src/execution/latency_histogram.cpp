@@ -0,0 +1,190 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <limits>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+// 进程内线程槽位分配，线程首次记录时取号
+std::atomic<size_t> next_thread_slot{0};
+
+inline void update_min(std::atomic<uint64_t>& target, uint64_t value)
+{
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+inline void update_max(std::atomic<uint64_t>& target, uint64_t value)
+{
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+uint64_t HistogramSnapshot::value_at_percentile(double percentile) const
+{
+    if (total_count == 0 || counts.empty()) {
+        return 0;
+    }
+    if (percentile >= 100.0) {
+        return max_value;
+    }
+
+    // 与原先排序取下标floor(n*p)一致：第floor(n*p)+1个样本
+    uint64_t rank = static_cast<uint64_t>(std::max(0.0, percentile) / 100.0 * total_count) + 1;
+    rank = std::min(rank, total_count);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            uint64_t lower = LatencyHistogram::bucket_lower_bound(i);
+            uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+            uint64_t middle = lower + (upper - lower) / 2;
+            return std::min(std::max(middle, min_value), max_value);
+        }
+    }
+    return max_value;
+}
+
+LatencyHistogram::Shard::Shard()
+{
+    reset();
+}
+
+void LatencyHistogram::Shard::reset()
+{
+    for (auto& count : counts) {
+        count.store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    min_value.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    for (auto& shard : shards_) {
+        shard.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+    for (auto& shard : shards_) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::thread_slot()
+{
+    static thread_local size_t slot = next_thread_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    if (value >> MAX_VALUE_BITS) {
+        return BUCKET_COUNT - 1;
+    }
+    // 最高位决定所在的2的幂区间，其下SUB_BUCKET_BITS位决定区间内的线性子桶
+    unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+    unsigned shift = msb - SUB_BUCKET_BITS;
+    uint64_t sub_bucket = value >> shift;          // [SUB_BUCKET_COUNT, 2*SUB_BUCKET_COUNT)
+    return (shift + 1) * SUB_BUCKET_COUNT + static_cast<size_t>(sub_bucket - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKET_COUNT) - 1;
+    uint64_t sub_bucket = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+    return sub_bucket << shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    unsigned shift = static_cast<unsigned>(index / SUB_BUCKET_COUNT) - 1;
+    uint64_t sub_bucket = SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+LatencyHistogram::Shard& LatencyHistogram::local_shard()
+{
+    std::atomic<Shard*>& slot = shards_[thread_slot() % MAX_SHARDS];
+    Shard* shard = slot.load(std::memory_order_acquire);
+    if (shard) {
+        return *shard;
+    }
+
+    // 回绕共享同一槽位的线程可能同时分配，输掉CAS的一方释放自己的分片
+    Shard* created = new Shard();
+    if (slot.compare_exchange_strong(shard, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *created;
+    }
+    delete created;
+    return *shard;
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+    Shard& shard = local_shard();
+    shard.counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    update_min(shard.min_value, value);
+    update_max(shard.max_value, value);
+}
+
+void LatencyHistogram::snapshot(HistogramSnapshot& snapshot) const
+{
+    snapshot.counts.assign(BUCKET_COUNT, 0);
+    snapshot.total_count = 0;
+    snapshot.sum = 0;
+    snapshot.min_value = std::numeric_limits<uint64_t>::max();
+    snapshot.max_value = 0;
+
+    for (const auto& slot : shards_) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            uint64_t count = shard->counts[i].load(std::memory_order_relaxed);
+            snapshot.counts[i] += count;
+            snapshot.total_count += count;
+        }
+        snapshot.sum += shard->sum.load(std::memory_order_relaxed);
+        snapshot.min_value = std::min(snapshot.min_value, shard->min_value.load(std::memory_order_relaxed));
+        snapshot.max_value = std::max(snapshot.max_value, shard->max_value.load(std::memory_order_relaxed));
+    }
+
+    if (snapshot.total_count == 0) {
+        snapshot.min_value = 0;
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& slot : shards_) {
+        Shard* shard = slot.load(std::memory_order_acquire);
+        if (shard) {
+            shard->reset();
+        }
+    }
+}
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,242 @@
+#include "latency_tracer.h"
+#include "shared_memory/core/tsc_clock.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+const char* const HOP_NAMES[TRACE_HOP_COUNT] = {
+    "shm_write", "shm_read", "risk_pass", "serialize", "send", "ack", "fill"
+};
+
+constexpr uint32_t TRACE_FILE_VERSION = 1;
+
+} // namespace
+
+const char* trace_hop_name(TraceHop hop)
+{
+    size_t index = static_cast<size_t>(hop);
+    return index < TRACE_HOP_COUNT ? HOP_NAMES[index] : "unknown";
+}
+
+LatencyTracer::LatencyTracer()
+    : monitor_(nullptr)
+    , traces_(new ActiveTrace[ACTIVE_TRACES]())
+    , next_trace_id_(0)
+{
+}
+
+LatencyTracer::~LatencyTracer()
+{
+    flush();
+}
+
+int64_t LatencyTracer::now_ns()
+{
+    return shared_memory::TscClock::instance().monotonic_ns();
+}
+
+std::string LatencyTracer::make_client_order_id(uint64_t trace_id)
+{
+    return CLIENT_ORDER_ID_PREFIX + std::to_string(trace_id);
+}
+
+uint64_t LatencyTracer::parse_client_order_id(const char* client_order_id)
+{
+    size_t prefix_length = std::strlen(CLIENT_ORDER_ID_PREFIX);
+    if (!client_order_id || std::strncmp(client_order_id, CLIENT_ORDER_ID_PREFIX, prefix_length) != 0) {
+        return 0;
+    }
+    const char* digits = client_order_id + prefix_length;
+    char* end = nullptr;
+    unsigned long long trace_id = std::strtoull(digits, &end, 10);
+    if (end == digits || *end != '\0') {
+        return 0;
+    }
+    return trace_id;
+}
+
+bool LatencyTracer::initialize(const Config& config, PerformanceMonitor* monitor)
+{
+    config_ = config;
+    monitor_ = monitor;
+
+    // 以启动时刻为轨迹ID基数，重启后生成的clientOrderId不会与仍挂着的旧订单重复
+    uint64_t base = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()) * 1000;
+    next_trace_id_.store(base, std::memory_order_relaxed);
+
+    if (monitor_) {
+        for (size_t i = 0; i < TRACE_HOP_COUNT; ++i) {
+            hop_histograms_[i] = monitor_->register_histogram(std::string("latency_trace_") + HOP_NAMES[i]);
+        }
+        tick_to_send_ = monitor_->register_histogram("latency_trace_tick_to_send");
+        tick_to_ack_ = monitor_->register_histogram("latency_trace_tick_to_ack");
+    }
+
+    if (config_.sample_every > 0 && !config_.trace_file_path.empty()) {
+        trace_file_.open(config_.trace_file_path, std::ios::binary | std::ios::app);
+        if (!trace_file_.is_open()) {
+            return false;
+        }
+        // 新文件先写文件头
+        if (trace_file_.tellp() == 0) {
+            TraceFileHeader header;
+            std::memcpy(header.magic, "TESTRACE", sizeof(header.magic));
+            header.version = TRACE_FILE_VERSION;
+            header.record_size = sizeof(TraceFileRecord);
+            trace_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            trace_file_.flush();
+        }
+    }
+    return true;
+}
+
+uint64_t LatencyTracer::begin_trace(uint64_t trace_id, uint64_t signal_id, const char* instrument_id,
+                                    int64_t shm_write_ns, int64_t shm_read_ns)
+{
+    uint64_t sequence = traces_started_.fetch_add(1, std::memory_order_relaxed);
+    if (trace_id == 0) {
+        trace_id = next_trace_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ActiveTrace& trace = traces_[trace_id & (ACTIVE_TRACES - 1)];
+    // 被覆盖的采样轨迹没等到成交，也照样写出
+    if (trace.trace_id.load(std::memory_order_acquire) != 0 && trace.sampled.load(std::memory_order_relaxed) &&
+        !trace.emitted.exchange(true, std::memory_order_relaxed)) {
+        emit_sample(trace);
+    }
+
+    // 先摘下旧ID让迟到的打点失效，再重置并发布新轨迹
+    trace.trace_id.store(0, std::memory_order_release);
+    for (auto& hop : trace.hop_ns) {
+        hop.store(0, std::memory_order_relaxed);
+    }
+    trace.signal_id = signal_id;
+    std::memset(trace.instrument_id, 0, sizeof(trace.instrument_id));
+    if (instrument_id) {
+        std::strncpy(trace.instrument_id, instrument_id, sizeof(trace.instrument_id) - 1);
+    }
+    trace.sampled.store(config_.sample_every > 0 && sequence % config_.sample_every == 0, std::memory_order_relaxed);
+    trace.emitted.store(false, std::memory_order_relaxed);
+    trace.trace_id.store(trace_id, std::memory_order_release);
+
+    if (shm_write_ns > 0) {
+        record_hop(trace, TraceHop::SHM_WRITE, shm_write_ns);
+    }
+    if (shm_read_ns > 0) {
+        record_hop(trace, TraceHop::SHM_READ, shm_read_ns);
+    }
+    return trace_id;
+}
+
+void LatencyTracer::mark(uint64_t trace_id, TraceHop hop, int64_t ns)
+{
+    if (trace_id == 0) {
+        return;
+    }
+    ActiveTrace& trace = traces_[trace_id & (ACTIVE_TRACES - 1)];
+    if (trace.trace_id.load(std::memory_order_acquire) != trace_id) {
+        stale_marks_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    record_hop(trace, hop, ns);
+}
+
+void LatencyTracer::mark(const char* client_order_id, TraceHop hop, int64_t ns)
+{
+    uint64_t trace_id = parse_client_order_id(client_order_id);
+    if (trace_id == 0) {
+        return;     // 不是带轨迹的订单
+    }
+    mark(trace_id, hop, ns);
+}
+
+void LatencyTracer::record_hop(ActiveTrace& trace, TraceHop hop, int64_t ns)
+{
+    size_t index = static_cast<size_t>(hop);
+    if (index >= TRACE_HOP_COUNT) {
+        return;
+    }
+
+    // 每跳只记第一次（部分成交、撤单应答等重复事件不覆盖）
+    int64_t expected = 0;
+    if (!trace.hop_ns[index].compare_exchange_strong(expected, ns, std::memory_order_acq_rel)) {
+        return;
+    }
+    hops_recorded_.fetch_add(1, std::memory_order_relaxed);
+
+    if (monitor_) {
+        // 与最近一个已发生的前序跳的间隔；跨进程的时钟读数可能略有倒挂，按0计
+        for (size_t previous = index; previous-- > 0;) {
+            int64_t previous_ns = trace.hop_ns[previous].load(std::memory_order_acquire);
+            if (previous_ns > 0) {
+                monitor_->record(hop_histograms_[index], std::max<int64_t>(0, ns - previous_ns) / 1000.0);
+                break;
+            }
+        }
+
+        int64_t write_ns = trace.hop_ns[static_cast<size_t>(TraceHop::SHM_WRITE)].load(std::memory_order_acquire);
+        if (write_ns > 0 && hop == TraceHop::SEND) {
+            monitor_->record(tick_to_send_, std::max<int64_t>(0, ns - write_ns) / 1000.0);
+        } else if (write_ns > 0 && hop == TraceHop::ACK) {
+            monitor_->record(tick_to_ack_, std::max<int64_t>(0, ns - write_ns) / 1000.0);
+        }
+    }
+
+    if (hop == TraceHop::FILL && trace.sampled.load(std::memory_order_relaxed) &&
+        !trace.emitted.exchange(true, std::memory_order_relaxed)) {
+        emit_sample(trace);
+    }
+}
+
+void LatencyTracer::emit_sample(ActiveTrace& trace)
+{
+    TraceFileRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.trace_id = trace.trace_id.load(std::memory_order_acquire);
+    record.signal_id = trace.signal_id;
+    for (size_t i = 0; i < TRACE_HOP_COUNT; ++i) {
+        record.hop_ns[i] = trace.hop_ns[i].load(std::memory_order_acquire);
+    }
+    std::string client_order_id = make_client_order_id(record.trace_id);
+    std::strncpy(record.client_order_id, client_order_id.c_str(), sizeof(record.client_order_id) - 1);
+    std::memcpy(record.instrument_id, trace.instrument_id, sizeof(record.instrument_id));
+
+    std::lock_guard<std::mutex> lock(sample_mutex_);
+    pending_samples_.push_back(record);
+}
+
+void LatencyTracer::flush()
+{
+    std::vector<TraceFileRecord> samples;
+    {
+        std::lock_guard<std::mutex> lock(sample_mutex_);
+        samples.swap(pending_samples_);
+    }
+    if (samples.empty() || !trace_file_.is_open()) {
+        return;
+    }
+
+    trace_file_.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(TraceFileRecord));
+    trace_file_.flush();
+    samples_written_.fetch_add(samples.size(), std::memory_order_relaxed);
+}
+
+LatencyTracer::Statistics LatencyTracer::get_statistics() const
+{
+    return {
+        traces_started_.load(),
+        hops_recorded_.load(),
+        stale_marks_.load(),
+        samples_written_.load()
+    };
+}
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,218 @@
+#include "lock_profiler.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+// 每个线程同时持有的共享锁很少，超过容量的持有不计时
+constexpr size_t MAX_SHARED_HOLDS = 16;
+
+struct SharedHold {
+    const void* mutex;
+    uint64_t start_ticks;
+};
+
+thread_local SharedHold shared_holds[MAX_SHARED_HOLDS];
+thread_local size_t shared_hold_count = 0;
+
+inline void push_shared_hold(const void* mutex, uint64_t start_ticks)
+{
+    if (shared_hold_count < MAX_SHARED_HOLDS) {
+        shared_holds[shared_hold_count++] = {mutex, start_ticks};
+    }
+}
+
+// 找不到（入栈时已满）返回false
+inline bool pop_shared_hold(const void* mutex, uint64_t& start_ticks)
+{
+    for (size_t i = shared_hold_count; i > 0; --i) {
+        if (shared_holds[i - 1].mutex == mutex) {
+            start_ticks = shared_holds[i - 1].start_ticks;
+            shared_holds[i - 1] = shared_holds[--shared_hold_count];
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+LockProfiler& LockProfiler::instance()
+{
+    static LockProfiler profiler;
+    return profiler;
+}
+
+LockStats* LockProfiler::register_lock(const char* name)
+{
+    const char* lock_name = name ? name : "unnamed";
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (size_t i = 0; i < lock_count_; ++i) {
+        if (std::strncmp(locks_[i]->name, lock_name, LockStats::MAX_NAME_LENGTH - 1) == 0) {
+            return locks_[i].get();
+        }
+    }
+    if (lock_count_ >= MAX_LOCKS) {
+        return nullptr;
+    }
+
+    std::unique_ptr<LockStats> stats(new LockStats());
+    std::strncpy(stats->name, lock_name, LockStats::MAX_NAME_LENGTH - 1);
+    stats->name[LockStats::MAX_NAME_LENGTH - 1] = '\0';
+    locks_[lock_count_] = std::move(stats);
+    return locks_[lock_count_++].get();
+}
+
+std::vector<LockReport> LockProfiler::get_reports() const
+{
+    std::vector<LockReport> reports;
+    HistogramSnapshot wait;
+    HistogramSnapshot hold;
+    HistogramSnapshot shared_hold;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    reports.reserve(lock_count_);
+    for (size_t i = 0; i < lock_count_; ++i) {
+        const LockStats& stats = *locks_[i];
+        stats.wait_ns.snapshot(wait);
+        stats.hold_ns.snapshot(hold);
+        stats.shared_hold_ns.snapshot(shared_hold);
+
+        LockReport report;
+        report.name = stats.name;
+        report.acquisitions = hold.total_count;
+        report.shared_acquisitions = shared_hold.total_count;
+        report.contended = wait.total_count;
+        uint64_t total_acquisitions = report.acquisitions + report.shared_acquisitions;
+        report.contention_ratio = total_acquisitions
+            ? static_cast<double>(report.contended) / static_cast<double>(total_acquisitions) : 0.0;
+        report.total_wait_ns = wait.sum;
+        report.wait_p50_ns = wait.value_at_percentile(50.0);
+        report.wait_p99_ns = wait.value_at_percentile(99.0);
+        report.wait_max_ns = wait.max_value;
+        report.total_hold_ns = hold.sum;
+        report.hold_p50_ns = hold.value_at_percentile(50.0);
+        report.hold_p99_ns = hold.value_at_percentile(99.0);
+        report.hold_max_ns = hold.max_value;
+        reports.push_back(report);
+    }
+
+    std::sort(reports.begin(), reports.end(), [](const LockReport& a, const LockReport& b) {
+        return a.total_wait_ns > b.total_wait_ns;
+    });
+    return reports;
+}
+
+std::string LockProfiler::generate_report() const
+{
+    std::vector<LockReport> reports = get_reports();
+    std::ostringstream report;
+
+    report << "Lock Contention (ns, by total wait):\n";
+    report << "  " << std::left << std::setw(40) << "lock" << std::right
+           << std::setw(12) << "acquire" << std::setw(10) << "shared"
+           << std::setw(10) << "contend" << std::setw(8) << "ratio"
+           << std::setw(14) << "wait_total" << std::setw(10) << "wait_p99" << std::setw(12) << "wait_max"
+           << std::setw(14) << "hold_total" << std::setw(10) << "hold_p99" << std::setw(12) << "hold_max" << "\n";
+    for (const auto& entry : reports) {
+        report << "  " << std::left << std::setw(40) << entry.name << std::right
+               << std::setw(12) << entry.acquisitions << std::setw(10) << entry.shared_acquisitions
+               << std::setw(10) << entry.contended
+               << std::setw(8) << std::fixed << std::setprecision(3) << entry.contention_ratio
+               << std::setw(14) << entry.total_wait_ns << std::setw(10) << entry.wait_p99_ns
+               << std::setw(12) << entry.wait_max_ns
+               << std::setw(14) << entry.total_hold_ns << std::setw(10) << entry.hold_p99_ns
+               << std::setw(12) << entry.hold_max_ns << "\n";
+    }
+    return report.str();
+}
+
+void LockProfiler::reset()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    for (size_t i = 0; i < lock_count_; ++i) {
+        locks_[i]->wait_ns.reset();
+        locks_[i]->hold_ns.reset();
+        locks_[i]->shared_hold_ns.reset();
+    }
+}
+
+void ProfiledSharedMutex::lock()
+{
+    const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+    if (mutex_.try_lock()) {
+        hold_start_ticks_ = clock.ticks();
+        return;
+    }
+    uint64_t wait_start = clock.ticks();
+    mutex_.lock();
+    hold_start_ticks_ = clock.ticks();
+    if (stats_) {
+        stats_->wait_ns.record(clock.ticks_to_ns(hold_start_ticks_ - wait_start));
+    }
+}
+
+bool ProfiledSharedMutex::try_lock()
+{
+    if (!mutex_.try_lock()) {
+        return false;
+    }
+    hold_start_ticks_ = shared_memory::TscClock::instance().ticks();
+    return true;
+}
+
+void ProfiledSharedMutex::unlock()
+{
+    const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+    uint64_t held_ticks = clock.ticks() - hold_start_ticks_;
+    mutex_.unlock();
+    if (stats_) {
+        stats_->hold_ns.record(clock.ticks_to_ns(held_ticks));
+    }
+}
+
+void ProfiledSharedMutex::lock_shared()
+{
+    const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+    if (mutex_.try_lock_shared()) {
+        push_shared_hold(this, clock.ticks());
+        return;
+    }
+    uint64_t wait_start = clock.ticks();
+    mutex_.lock_shared();
+    uint64_t acquired = clock.ticks();
+    push_shared_hold(this, acquired);
+    if (stats_) {
+        stats_->wait_ns.record(clock.ticks_to_ns(acquired - wait_start));
+    }
+}
+
+bool ProfiledSharedMutex::try_lock_shared()
+{
+    if (!mutex_.try_lock_shared()) {
+        return false;
+    }
+    push_shared_hold(this, shared_memory::TscClock::instance().ticks());
+    return true;
+}
+
+void ProfiledSharedMutex::unlock_shared()
+{
+    const shared_memory::TscClock& clock = shared_memory::TscClock::instance();
+    uint64_t end_ticks = clock.ticks();
+    mutex_.unlock_shared();
+
+    uint64_t start_ticks = 0;
+    if (pop_shared_hold(this, start_ticks) && stats_) {
+        stats_->shared_hold_ns.record(clock.ticks_to_ns(end_ticks - start_ticks));
+    }
+}
+
+} // namespace execution
+} // namespace tes
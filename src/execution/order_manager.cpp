@@ -1,4 +1,6 @@
 #include "execution/order_manager.h"
+#include "execution/thread_accounting.h"
+#include "shared_memory/core/tsc_clock.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -42,8 +44,8 @@ bool OrderManager::initialize()
     try {
         // 清理现有数据
         {
-            std::lock_guard<std::mutex> orders_lock(orders_mutex_);
-            std::lock_guard<std::mutex> trades_lock(trades_mutex_);
+            std::lock_guard<NamedMutex> orders_lock(orders_mutex_);
+            std::lock_guard<NamedMutex> trades_lock(trades_mutex_);
             orders_.clear();
             trades_by_order_.clear();
         }
@@ -90,7 +92,11 @@ void OrderManager::stop()
     running_.store(false);
     
     // 停止清理线程
-    cleanup_running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(cleanup_wake_mutex_);
+        cleanup_running_.store(false);
+    }
+    cleanup_wake_cv_.notify_all();
     if (cleanup_thread_.joinable()) {
         cleanup_thread_.join();
     }
@@ -101,8 +107,8 @@ void OrderManager::cleanup()
     stop();
     
     {
-        std::lock_guard<std::mutex> orders_lock(orders_mutex_);
-        std::lock_guard<std::mutex> trades_lock(trades_mutex_);
+        std::lock_guard<NamedMutex> orders_lock(orders_mutex_);
+        std::lock_guard<NamedMutex> trades_lock(trades_mutex_);
         orders_.clear();
         trades_by_order_.clear();
     }
@@ -133,7 +139,7 @@ std::string OrderManager::create_order(const Order& order)
     
     // 检查待处理订单数量限制
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         if (orders_.size() >= config_.max_pending_orders) {
             return "";
         }
@@ -147,18 +153,18 @@ std::string OrderManager::create_order(const Order& order)
     // 将字符串ID转换为数字ID（使用哈希或简单的数字转换）
     new_order->order_id = std::hash<std::string>{}(order_id_str);
     new_order->status = OrderStatus::PENDING;
-    new_order->create_time = std::chrono::high_resolution_clock::now();
+    new_order->create_time = shared_memory::TscClock::instance().now();
     new_order->update_time = new_order->create_time;
     
     // 存储订单（使用字符串ID作为键）
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         orders_[order_id_str] = new_order;
     }
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.total_orders_created++;
         statistics_.last_order_time = new_order->create_time;
         statistics_.active_orders++;
@@ -175,7 +181,7 @@ bool OrderManager::submit_order(const std::string& order_id)
     std::shared_ptr<Order> order;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         auto it = orders_.find(order_id);
         if (it == orders_.end()) {
             return false;
@@ -195,7 +201,7 @@ bool OrderManager::submit_order(const std::string& order_id)
             if (!exchange_order_id.empty()) {
                 // 更新订单的交易所ID
                 {
-                    std::lock_guard<std::mutex> lock(orders_mutex_);
+                    std::lock_guard<NamedMutex> lock(orders_mutex_);
                     // Note: Order struct doesn't have exchange_order_id field
                     // The exchange order ID is managed internally by the exchange adapter
                 }
@@ -212,7 +218,7 @@ bool OrderManager::submit_order(const std::string& order_id)
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.total_orders_submitted++;
     }
     
@@ -224,7 +230,7 @@ bool OrderManager::cancel_order(const std::string& order_id)
     std::shared_ptr<Order> order;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         auto it = orders_.find(order_id);
         if (it == orders_.end()) {
             return false;
@@ -254,7 +260,7 @@ bool OrderManager::cancel_order(const std::string& order_id)
         
         // 更新统计信息
         {
-            std::lock_guard<std::mutex> lock(statistics_mutex_);
+            std::lock_guard<NamedMutex> lock(statistics_mutex_);
             statistics_.total_orders_cancelled++;
             if (statistics_.active_orders > 0) {
                 statistics_.active_orders--;
@@ -272,7 +278,7 @@ bool OrderManager::modify_order(const std::string& order_id, double new_quantity
     std::shared_ptr<Order> order;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         auto it = orders_.find(order_id);
         if (it == orders_.end()) {
             return false;
@@ -303,10 +309,10 @@ bool OrderManager::modify_order(const std::string& order_id, double new_quantity
     if (exchange_modify_success) {
         // 更新订单
         {
-            std::lock_guard<std::mutex> lock(orders_mutex_);
+            std::lock_guard<NamedMutex> lock(orders_mutex_);
             order->quantity = new_quantity;
             order->price = new_price;
-            order->update_time = std::chrono::high_resolution_clock::now();
+            order->update_time = shared_memory::TscClock::instance().now();
         }
         
         // 通知订单事件
@@ -320,7 +326,7 @@ bool OrderManager::modify_order(const std::string& order_id, double new_quantity
 
 std::shared_ptr<Order> OrderManager::get_order(const std::string& order_id) const
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     auto it = orders_.find(order_id);
     return (it != orders_.end()) ? it->second : nullptr;
 }
@@ -329,7 +335,7 @@ std::vector<std::shared_ptr<Order>> OrderManager::get_orders_by_strategy(const s
 {
     std::vector<std::shared_ptr<Order>> result;
     
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     for (const auto& pair : orders_) {
         if (pair.second->strategy_id == strategy_id) {
             result.push_back(pair.second);
@@ -343,7 +349,7 @@ std::vector<std::shared_ptr<Order>> OrderManager::get_orders_by_instrument(const
 {
     std::vector<std::shared_ptr<Order>> result;
     
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     for (const auto& pair : orders_) {
         if (pair.second->instrument_id == instrument_id) {
             result.push_back(pair.second);
@@ -357,7 +363,7 @@ std::vector<std::shared_ptr<Order>> OrderManager::get_active_orders() const
 {
     std::vector<std::shared_ptr<Order>> result;
     
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     for (const auto& pair : orders_) {
         if (pair.second->status == OrderStatus::PENDING ||
             pair.second->status == OrderStatus::SUBMITTED ||
@@ -373,7 +379,7 @@ std::vector<std::shared_ptr<Order>> OrderManager::get_all_orders() const
 {
     std::vector<std::shared_ptr<Order>> result;
     
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     for (const auto& pair : orders_) {
         result.push_back(pair.second);
     }
@@ -390,7 +396,7 @@ void OrderManager::process_trade(const Trade& trade)
     std::shared_ptr<Order> order;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         auto it = orders_.find(trade.order_id);
         if (it == orders_.end()) {
             return; // 订单不存在
@@ -400,7 +406,7 @@ void OrderManager::process_trade(const Trade& trade)
     
     // 更新订单信息
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         order->filled_quantity += trade.quantity;
         
         // 计算平均成交价格
@@ -416,18 +422,18 @@ void OrderManager::process_trade(const Trade& trade)
             order->status = OrderStatus::PARTIALLY_FILLED;
         }
         
-        order->update_time = std::chrono::high_resolution_clock::now();
+        order->update_time = shared_memory::TscClock::instance().now();
     }
     
     // 存储成交记录
     {
-        std::lock_guard<std::mutex> lock(trades_mutex_);
+        std::lock_guard<NamedMutex> lock(trades_mutex_);
         trades_by_order_[trade.order_id].push_back(trade);
     }
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.total_trades++;
         statistics_.last_trade_time = trade.trade_time;
         
@@ -451,7 +457,7 @@ void OrderManager::process_trade(const Trade& trade)
 
 std::vector<Trade> OrderManager::get_trades_by_order(const std::string& order_id) const
 {
-    std::lock_guard<std::mutex> lock(trades_mutex_);
+    std::lock_guard<NamedMutex> lock(trades_mutex_);
     auto it = trades_by_order_.find(order_id);
     return (it != trades_by_order_.end()) ? it->second : std::vector<Trade>();
 }
@@ -460,8 +466,8 @@ std::vector<Trade> OrderManager::get_trades_by_strategy(const std::string& strat
 {
     std::vector<Trade> result;
     
-    std::lock_guard<std::mutex> orders_lock(orders_mutex_);
-    std::lock_guard<std::mutex> trades_lock(trades_mutex_);
+    std::lock_guard<NamedMutex> orders_lock(orders_mutex_);
+    std::lock_guard<NamedMutex> trades_lock(trades_mutex_);
     
     for (const auto& order_pair : orders_) {
         if (order_pair.second->strategy_id == strategy_id) {
@@ -487,19 +493,19 @@ void OrderManager::set_trade_event_callback(TradeEventCallback callback)
 
 void OrderManager::set_config(const Config& config)
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     config_ = config;
 }
 
 OrderManager::Config OrderManager::get_config() const
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     return config_;
 }
 
 OrderManager::Statistics OrderManager::get_statistics() const
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     return statistics_;
 }
 
@@ -519,7 +525,7 @@ bool OrderManager::validate_order(const Order& order) const
 
 bool OrderManager::check_duplicate_order(const Order& order) const
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     
     for (const auto& pair : orders_) {
         const auto& existing_order = pair.second;
@@ -555,7 +561,7 @@ void OrderManager::update_order_status(const std::string& order_id, OrderStatus
     std::shared_ptr<Order> order;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         auto it = orders_.find(order_id);
         if (it == orders_.end()) {
             return;
@@ -563,7 +569,7 @@ void OrderManager::update_order_status(const std::string& order_id, OrderStatus
         order = it->second;
         
         order->status = status;
-        order->update_time = std::chrono::high_resolution_clock::now();
+        order->update_time = shared_memory::TscClock::instance().now();
         if (!error_message.empty()) {
             order->error_message = error_message;
         }
@@ -571,7 +577,7 @@ void OrderManager::update_order_status(const std::string& order_id, OrderStatus
     
     // 更新统计信息
     if (status == OrderStatus::REJECTED) {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.total_orders_rejected++;
         if (statistics_.active_orders > 0) {
             statistics_.active_orders--;
@@ -610,7 +616,7 @@ void OrderManager::cleanup_expired_orders()
     std::vector<std::string> expired_orders;
     
     {
-        std::lock_guard<std::mutex> lock(orders_mutex_);
+        std::lock_guard<NamedMutex> lock(orders_mutex_);
         for (const auto& pair : orders_) {
             const auto& order = pair.second;
             if ((order->status == OrderStatus::PENDING || order->status == OrderStatus::SUBMITTED) &&
@@ -628,8 +634,8 @@ void OrderManager::cleanup_expired_orders()
 
 void OrderManager::update_statistics()
 {
-    std::lock_guard<std::mutex> orders_lock(orders_mutex_);
-    std::lock_guard<std::mutex> statistics_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> orders_lock(orders_mutex_);
+    std::lock_guard<NamedMutex> statistics_lock(statistics_mutex_);
     
     uint32_t active_count = 0;
     for (const auto& pair : orders_) {
@@ -645,13 +651,17 @@ void OrderManager::update_statistics()
 
 void OrderManager::cleanup_worker()
 {
+    ThreadAccounting::set_current_thread_name("tes-order-gc");
+
     while (cleanup_running_.load()) {
         try {
             cleanup_expired_orders();
             update_statistics();
             
-            // 休眠
-            std::this_thread::sleep_for(std::chrono::seconds(config_.cleanup_interval_seconds));
+            // 休眠，stop()时提前唤醒
+            std::unique_lock<std::mutex> lock(cleanup_wake_mutex_);
+            cleanup_wake_cv_.wait_for(lock, std::chrono::seconds(config_.cleanup_interval_seconds),
+                                      [this] { return !cleanup_running_.load(); });
         } catch (const std::exception& e) {
             // 记录错误但继续运行
         }
@@ -661,7 +671,7 @@ void OrderManager::cleanup_worker()
 // 外部订单同步方法实现
 void OrderManager::sync_order_from_exchange(const Order& order)
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     
     auto it = orders_.find(order.order_id);
     if (it != orders_.end()) {
@@ -674,7 +684,7 @@ void OrderManager::sync_order_from_exchange(const Order& order)
         new_order->update_time = std::chrono::high_resolution_clock::now();
         orders_[order.order_id] = new_order;
         
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         statistics_.total_orders_created++;
         if (order.status == OrderStatus::PENDING || order.status == OrderStatus::SUBMITTED || order.status == OrderStatus::PARTIALLY_FILLED) {
             statistics_.active_orders++;
@@ -694,13 +704,13 @@ void OrderManager::sync_orders_from_exchange(const std::vector<Order>& orders)
 
 bool OrderManager::remove_order(const std::string& order_id)
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     
     auto it = orders_.find(order_id);
     if (it != orders_.end()) {
         orders_.erase(it);
         
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         if (statistics_.active_orders > 0) {
             statistics_.active_orders--;
         }
@@ -712,19 +722,19 @@ bool OrderManager::remove_order(const std::string& order_id)
 // 交易所适配器管理方法实现
 void OrderManager::set_exchange_adapter(std::shared_ptr<ExchangeAdapter> adapter)
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     exchange_adapter_ = adapter;
 }
 
 std::shared_ptr<ExchangeAdapter> OrderManager::get_exchange_adapter() const
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     return exchange_adapter_;
 }
 
 bool OrderManager::has_exchange_adapter() const
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     return exchange_adapter_ != nullptr;
 }
 
@@ -736,7 +746,7 @@ void OrderManager::force_update_order_status(const std::string& order_id, OrderS
 
 void OrderManager::batch_update_orders(const std::vector<Order>& orders)
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     
     for (const auto& order : orders) {
         auto it = orders_.find(order.order_id);
@@ -752,7 +762,7 @@ void OrderManager::batch_update_orders(const std::vector<Order>& orders)
 
 void OrderManager::clear_expired_orders(std::chrono::seconds max_age)
 {
-    std::lock_guard<std::mutex> lock(orders_mutex_);
+    std::lock_guard<NamedMutex> lock(orders_mutex_);
     
     auto now = std::chrono::high_resolution_clock::now();
     auto it = orders_.begin();
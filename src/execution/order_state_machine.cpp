@@ -1,4 +1,5 @@
 #include "execution/order_state_machine.h"
+#include "shared_memory/core/tsc_clock.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -117,7 +118,8 @@ std::string OrderStateMachine::create_order(const Order& order)
     std::string order_id = generate_order_id();
     
     // 创建订单状态信息
-    auto state_info = std::make_shared<OrderStateInfo>();
+    auto now = shared_memory::TscClock::instance().now();
+    auto state_info = std::make_shared<OrderStateInfo>(now);
     state_info->order_id = order_id;
     state_info->client_order_id = order.client_order_id;
     state_info->instrument_id = order.instrument_id;
@@ -132,11 +134,6 @@ std::string OrderStateMachine::create_order(const Order& order)
     state_info->submit_timeout = config_.default_submit_timeout;
     state_info->cancel_timeout = config_.default_cancel_timeout;
     
-    auto now = std::chrono::high_resolution_clock::now();
-    state_info->create_time = now;
-    state_info->state_change_time = now;
-    state_info->last_update_time = now;
-    
     // 存储订单状态
     {
         std::lock_guard<std::mutex> lock(orders_mutex_);
@@ -277,7 +274,7 @@ bool OrderStateMachine::update_fill_info(const std::string& order_id, double fil
     // 更新成交信息
     state_info->filled_quantity = filled_qty;
     state_info->average_price = avg_price;
-    state_info->last_update_time = std::chrono::high_resolution_clock::now();
+    state_info->last_update_time = shared_memory::TscClock::instance().now();
     
     // 根据成交情况更新状态
     if (filled_qty >= state_info->quantity) {
@@ -303,7 +300,7 @@ bool OrderStateMachine::set_error(const std::string& order_id, const std::string
     }
     
     state_info->last_error_message = error_message;
-    state_info->last_update_time = std::chrono::high_resolution_clock::now();
+    state_info->last_update_time = shared_memory::TscClock::instance().now();
     
     return process_event(order_id, OrderEvent::ERROR_OCCURRED);
 }
@@ -568,7 +565,7 @@ bool OrderStateMachine::change_state(const std::string& order_id, OrderState new
         // 更新状态
         state_info->previous_state = old_state;
         state_info->current_state = new_state;
-        state_info->state_change_time = std::chrono::high_resolution_clock::now();
+        state_info->state_change_time = shared_memory::TscClock::instance().now();
         state_info->last_update_time = state_info->state_change_time;
         state_info->state_change_count++;
     }
@@ -1,4 +1,7 @@
 #include "performance_monitor.h"
+#include "lock_profiler.h"
+#include "allocation_tracker.h"
+#include "shared_memory/core/flight_recorder.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
@@ -16,11 +19,24 @@ PerformanceMonitor::PerformanceMonitor()
     , initialized_(false)
     , current_cpu_usage_(0.0)
     , current_memory_usage_(0.0) {
+    for (auto& slab : counter_slabs_) {
+        slab.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto& gauge : gauges_) {
+        gauge.store(0.0, std::memory_order_relaxed);
+    }
+    for (auto& slot : histogram_slots_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 PerformanceMonitor::~PerformanceMonitor() {
     stop();
     cleanup();
+    
+    for (auto& slab : counter_slabs_) {
+        delete slab.load(std::memory_order_relaxed);
+    }
 }
 
 bool PerformanceMonitor::initialize(const Config& config) {
@@ -83,9 +99,13 @@ void PerformanceMonitor::stop() {
 void PerformanceMonitor::cleanup() {
     stop();
     
-    // 清理指标数据
+    // 清理指标数据；直方图句柄随之失效，须在记录线程停止后调用
     {
         std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
+        for (auto& slot : histogram_slots_) {
+            slot.store(nullptr, std::memory_order_release);
+        }
+        histogram_names_.clear();
         metrics_.clear();
     }
     
@@ -97,49 +117,125 @@ void PerformanceMonitor::cleanup() {
     initialized_.store(false);
 }
 
-void PerformanceMonitor::record_latency(const std::string& operation, double latency_us) {
-    std::shared_lock<std::shared_mutex> read_lock(metrics_mutex_);
-    
-    auto it = metrics_.find("latency_" + operation);
-    if (it == metrics_.end()) {
-        read_lock.unlock();
-        std::unique_lock<std::shared_mutex> write_lock(metrics_mutex_);
-        metrics_["latency_" + operation] = std::make_unique<MetricCollection>();
-        it = metrics_.find("latency_" + operation);
+PerformanceMonitor::MetricCollection& PerformanceMonitor::get_or_create_collection_locked(const std::string& name) {
+    auto& collection = metrics_[name];
+    if (!collection) {
+        collection = std::make_unique<MetricCollection>();
+    }
+    return *collection;
+}
+
+PerformanceMonitor::CounterSlab& PerformanceMonitor::allocate_counter_slab(std::atomic<CounterSlab*>& slot) {
+    // 共享槽位的线程可能同时分配，输掉CAS的一方释放自己的
+    CounterSlab* slab = nullptr;
+    CounterSlab* created = new CounterSlab();
+    if (slot.compare_exchange_strong(slab, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        return *created;
+    }
+    delete created;
+    return *slab;
+}
+
+CounterHandle PerformanceMonitor::register_counter(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
+    CounterHandle handle;
+    auto it = std::find(counter_names_.begin(), counter_names_.end(), name);
+    if (it != counter_names_.end()) {
+        handle.index = static_cast<uint32_t>(it - counter_names_.begin());
+    } else if (counter_names_.size() < MAX_COUNTERS) {
+        handle.index = static_cast<uint32_t>(counter_names_.size());
+        counter_names_.push_back(name);
+    }
+    return handle;
+}
+
+GaugeHandle PerformanceMonitor::register_gauge(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
+    GaugeHandle handle;
+    auto it = std::find(gauge_names_.begin(), gauge_names_.end(), name);
+    if (it != gauge_names_.end()) {
+        handle.index = static_cast<uint32_t>(it - gauge_names_.begin());
+    } else if (gauge_names_.size() < MAX_GAUGES) {
+        handle.index = static_cast<uint32_t>(gauge_names_.size());
+        gauge_names_.push_back(name);
+    }
+    return handle;
+}
+
+HistogramHandle PerformanceMonitor::register_histogram(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
+    HistogramHandle handle;
+    auto it = std::find(histogram_names_.begin(), histogram_names_.end(), name);
+    if (it != histogram_names_.end()) {
+        handle.index = static_cast<uint32_t>(it - histogram_names_.begin());
+    } else if (histogram_names_.size() < MAX_HISTOGRAMS) {
+        handle.index = static_cast<uint32_t>(histogram_names_.size());
+        histogram_names_.push_back(name);
+        histogram_slots_[handle.index].store(&get_or_create_collection_locked(name), std::memory_order_release);
+    }
+    return handle;
+}
+
+uint64_t PerformanceMonitor::get_counter(CounterHandle handle) const {
+    if (handle.index >= MAX_COUNTERS) {
+        return 0;
+    }
+    uint64_t total = 0;
+    for (const auto& slot : counter_slabs_) {
+        const CounterSlab* slab = slot.load(std::memory_order_acquire);
+        if (slab) {
+            total += slab->values[handle.index].load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+double PerformanceMonitor::get_gauge(GaugeHandle handle) const {
+    if (handle.index >= MAX_GAUGES) {
+        return 0.0;
     }
+    return gauges_[handle.index].load(std::memory_order_relaxed);
+}
+
+PerformanceStats PerformanceMonitor::get_histogram_stats(HistogramHandle handle) const {
+    if (handle.index >= MAX_HISTOGRAMS) {
+        return PerformanceStats();
+    }
+    const MetricCollection* collection = histogram_slots_[handle.index].load(std::memory_order_acquire);
+    if (!collection) {
+        return PerformanceStats();
+    }
+    HistogramSnapshot snapshot;
+    collection->histogram.snapshot(snapshot);
+    return calculate_stats(snapshot);
+}
+
+void PerformanceMonitor::record_value(const std::string& name, double value) {
+    uint64_t fixed_value = to_fixed(value);
     
-    if (it != metrics_.end()) {
-        std::lock_guard<std::mutex> lock(it->second->mutex);
-        it->second->data_points.emplace_back(latency_us, operation);
-        it->second->stats_dirty = true;
-        
-        // 清理旧数据
-        cleanup_old_data(*it->second);
+    {
+        std::shared_lock<std::shared_mutex> read_lock(metrics_mutex_);
+        auto it = metrics_.find(name);
+        if (it != metrics_.end()) {
+            it->second->histogram.record(fixed_value);
+            return;
+        }
     }
+    
+    // 首次出现的指标：独占锁下创建，记录期间持有锁防止被clear_metrics释放
+    std::unique_lock<std::shared_mutex> write_lock(metrics_mutex_);
+    get_or_create_collection_locked(name).histogram.record(fixed_value);
+}
+
+void PerformanceMonitor::record_latency(const std::string& operation, double latency_us) {
+    record_value("latency_" + operation, latency_us);
 }
 
 void PerformanceMonitor::record_throughput(const std::string& operation, uint64_t count, uint64_t duration_ms) {
     if (duration_ms == 0) return;
     
     double throughput = static_cast<double>(count) / (static_cast<double>(duration_ms) / 1000.0);
-    
-    std::shared_lock<std::shared_mutex> read_lock(metrics_mutex_);
-    
-    auto it = metrics_.find("throughput_" + operation);
-    if (it == metrics_.end()) {
-        read_lock.unlock();
-        std::unique_lock<std::shared_mutex> write_lock(metrics_mutex_);
-        metrics_["throughput_" + operation] = std::make_unique<MetricCollection>();
-        it = metrics_.find("throughput_" + operation);
-    }
-    
-    if (it != metrics_.end()) {
-        std::lock_guard<std::mutex> lock(it->second->mutex);
-        it->second->data_points.emplace_back(throughput, operation);
-        it->second->stats_dirty = true;
-        
-        cleanup_old_data(*it->second);
-    }
+    record_value("throughput_" + operation, throughput);
 }
 
 void PerformanceMonitor::record_queue_size(const std::string& queue_name, size_t size) {
@@ -157,23 +253,8 @@ void PerformanceMonitor::record_success(const std::string& operation) {
 }
 
 void PerformanceMonitor::record_custom_metric(const std::string& name, double value, const std::string& label) {
-    std::shared_lock<std::shared_mutex> read_lock(metrics_mutex_);
-    
-    auto it = metrics_.find(name);
-    if (it == metrics_.end()) {
-        read_lock.unlock();
-        std::unique_lock<std::shared_mutex> write_lock(metrics_mutex_);
-        metrics_[name] = std::make_unique<MetricCollection>();
-        it = metrics_.find(name);
-    }
-    
-    if (it != metrics_.end()) {
-        std::lock_guard<std::mutex> lock(it->second->mutex);
-        it->second->data_points.emplace_back(value, label);
-        it->second->stats_dirty = true;
-        
-        cleanup_old_data(*it->second);
-    }
+    (void)label;    // 直方图不保存逐点标签
+    record_value(name, value);
 }
 
 PerformanceStats PerformanceMonitor::get_latency_stats(const std::string& operation) const {
@@ -189,18 +270,18 @@ PerformanceStats PerformanceMonitor::get_custom_stats(const std::string& name) c
     
     auto it = metrics_.find(name);
     if (it != metrics_.end()) {
-        std::lock_guard<std::mutex> metric_lock(it->second->mutex);
-        
-        if (it->second->stats_dirty) {
-            const_cast<PerformanceMonitor*>(this)->update_stats(*it->second);
-        }
-        
-        return it->second->cached_stats;
+        HistogramSnapshot snapshot;
+        it->second->histogram.snapshot(snapshot);
+        return calculate_stats(snapshot);
     }
     
     return PerformanceStats();
 }
 
+std::vector<ThreadUsage> PerformanceMonitor::get_thread_usage() const {
+    return thread_accounting_.get_last_sample();
+}
+
 double PerformanceMonitor::get_cpu_usage() const {
     return current_cpu_usage_.load();
 }
@@ -220,17 +301,29 @@ std::string PerformanceMonitor::generate_report() const {
     report << "  CPU Usage: " << std::fixed << std::setprecision(2) << get_cpu_usage() << "%\n";
     report << "  Memory Usage: " << std::fixed << std::setprecision(2) << get_memory_usage() << "%\n\n";
     
+    // 按线程：CPU占用、每秒切换次数、运行队列排队
+    std::vector<ThreadUsage> threads = get_thread_usage();
+    if (!threads.empty()) {
+        report << "Threads:\n";
+        for (const auto& thread : threads) {
+            report << "  " << thread.name << " [" << thread.tid << "]"
+                   << " user=" << std::fixed << std::setprecision(1) << thread.user_cpu_percent << "%"
+                   << " sys=" << thread.system_cpu_percent << "%"
+                   << " vcsw/s=" << thread.voluntary_switches_per_sec
+                   << " ivcsw/s=" << thread.involuntary_switches_per_sec
+                   << " runq=" << std::setprecision(2) << thread.run_delay_percent << "%"
+                   << " runq_avg=" << thread.avg_run_delay_us << "us\n";
+        }
+        report << "\n";
+    }
+    
     // 指标统计
     std::shared_lock<std::shared_mutex> lock(metrics_mutex_);
     
+    HistogramSnapshot snapshot;
     for (const auto& [name, collection] : metrics_) {
-        std::lock_guard<std::mutex> metric_lock(collection->mutex);
-        
-        if (collection->stats_dirty) {
-            const_cast<PerformanceMonitor*>(this)->update_stats(*collection);
-        }
-        
-        const auto& stats = collection->cached_stats;
+        collection->histogram.snapshot(snapshot);
+        PerformanceStats stats = calculate_stats(snapshot);
         
         report << "Metric: " << name << "\n";
         report << "  Sample Count: " << stats.sample_count << "\n";
@@ -242,29 +335,84 @@ std::string PerformanceMonitor::generate_report() const {
         report << "  P99: " << std::fixed << std::setprecision(3) << stats.p99_value << "\n\n";
     }
     
+    // 句柄计数器和仪表
+    if (!counter_names_.empty()) {
+        report << "Counters:\n";
+        for (size_t i = 0; i < counter_names_.size(); ++i) {
+            CounterHandle handle;
+            handle.index = static_cast<uint32_t>(i);
+            report << "  " << counter_names_[i] << ": " << get_counter(handle) << "\n";
+        }
+        report << "\n";
+    }
+    
+    if (!gauge_names_.empty()) {
+        report << "Gauges:\n";
+        for (size_t i = 0; i < gauge_names_.size(); ++i) {
+            report << "  " << gauge_names_[i] << ": " << std::fixed << std::setprecision(3)
+                   << gauges_[i].load(std::memory_order_relaxed) << "\n";
+        }
+        report << "\n";
+    }
+    
     // 错误和成功率
+    auto report_rates = [&report](const std::string& operation, uint64_t errors, uint64_t successes) {
+        uint64_t total = errors + successes;
+        double error_rate = total > 0 ? (static_cast<double>(errors) / total) * 100.0 : 0.0;
+        double success_rate = total > 0 ? (static_cast<double>(successes) / total) * 100.0 : 0.0;
+        
+        report << "  " << operation << ":\n";
+        report << "    Total: " << total << ", Errors: " << errors << ", Successes: " << successes << "\n";
+        report << "    Error Rate: " << std::fixed << std::setprecision(2) << error_rate << "%\n";
+        report << "    Success Rate: " << std::fixed << std::setprecision(2) << success_rate << "%\n\n";
+    };
+    
     std::lock_guard<std::mutex> counters_lock(counters_mutex_);
     
     report << "Error/Success Rates:\n";
     for (const auto& [operation, error_count] : error_counts_) {
-        uint64_t errors = error_count.load();
         uint64_t successes = 0;
-        
         auto success_it = success_counts_.find(operation);
         if (success_it != success_counts_.end()) {
             successes = success_it->second.load();
         }
+        report_rates(operation, error_count.load(), successes);
+    }
+    
+    // 热路径上改用句柄计数的操作：按"<操作>.error"/"<操作>.success"命名配对
+    static const std::string ERROR_SUFFIX = ".error";
+    static const std::string SUCCESS_SUFFIX = ".success";
+    for (size_t i = 0; i < counter_names_.size(); ++i) {
+        const std::string& name = counter_names_[i];
+        if (name.size() <= ERROR_SUFFIX.size() ||
+            name.compare(name.size() - ERROR_SUFFIX.size(), ERROR_SUFFIX.size(), ERROR_SUFFIX) != 0) {
+            continue;
+        }
+        std::string operation = name.substr(0, name.size() - ERROR_SUFFIX.size());
+        if (error_counts_.count(operation) > 0) {
+            continue;
+        }
         
-        uint64_t total = errors + successes;
-        double error_rate = total > 0 ? (static_cast<double>(errors) / total) * 100.0 : 0.0;
-        double success_rate = total > 0 ? (static_cast<double>(successes) / total) * 100.0 : 0.0;
-        
-        report << "  " << operation << ":\n";
-        report << "    Total: " << total << ", Errors: " << errors << ", Successes: " << successes << "\n";
-        report << "    Error Rate: " << std::fixed << std::setprecision(2) << error_rate << "%\n";
-        report << "    Success Rate: " << std::fixed << std::setprecision(2) << success_rate << "%\n\n";
+        CounterHandle error_handle;
+        error_handle.index = static_cast<uint32_t>(i);
+        uint64_t successes = 0;
+        auto success_it = std::find(counter_names_.begin(), counter_names_.end(), operation + SUCCESS_SUFFIX);
+        if (success_it != counter_names_.end()) {
+            CounterHandle success_handle;
+            success_handle.index = static_cast<uint32_t>(success_it - counter_names_.begin());
+            successes = get_counter(success_handle);
+        }
+        report_rates(operation, get_counter(error_handle), successes);
     }
     
+#ifdef TES_ENABLE_LOCK_PROFILING
+    report << LockProfiler::instance().generate_report() << "\n";
+#endif
+    
+#ifdef TES_ENABLE_ALLOCATION_TRACKING
+    report << AllocationTracker::generate_report() << "\n";
+#endif
+    
     return report.str();
 }
 
@@ -298,16 +446,35 @@ PerformanceMonitor::Config PerformanceMonitor::get_config() const {
 }
 
 void PerformanceMonitor::clear_metrics() {
+    // 只清零不释放，已注册的句柄仍然有效
     std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
-    metrics_.clear();
+    for (auto& [name, collection] : metrics_) {
+        collection->histogram.reset();
+    }
+    for (auto& slot : counter_slabs_) {
+        CounterSlab* slab = slot.load(std::memory_order_acquire);
+        if (slab) {
+            for (auto& value : slab->values) {
+                value.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+    for (auto& gauge : gauges_) {
+        gauge.store(0.0, std::memory_order_relaxed);
+    }
 }
 
 void PerformanceMonitor::clear_metric(const std::string& name) {
     std::unique_lock<std::shared_mutex> lock(metrics_mutex_);
-    metrics_.erase(name);
+    auto it = metrics_.find(name);
+    if (it != metrics_.end()) {
+        it->second->histogram.reset();
+    }
 }
 
 void PerformanceMonitor::monitoring_worker() {
+    ThreadAccounting::set_current_thread_name("tes-perfmon");
+    
     while (running_.load()) {
         collect_system_metrics();
         
@@ -317,7 +484,16 @@ void PerformanceMonitor::monitoring_worker() {
             *output_file_ << generate_report() << std::flush;
         }
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.collection_interval_ms));
+        // 睡眠明显超时说明整个进程被挂起或调度不到（页回收、换页、宿主机争用等），记入飞行记录器
+        auto interval = std::chrono::milliseconds(config_.collection_interval_ms);
+        auto sleep_start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(interval);
+        auto oversleep = std::chrono::steady_clock::now() - sleep_start - interval;
+        if (oversleep > std::chrono::milliseconds(config_.stall_threshold_ms)) {
+            shared_memory::FlightRecorder::instance().record(
+                shared_memory::FlightEventType::STALL, 0,
+                std::chrono::duration_cast<std::chrono::nanoseconds>(oversleep).count());
+        }
     }
 }
 
@@ -329,59 +505,37 @@ void PerformanceMonitor::collect_system_metrics() {
     if (config_.enable_memory_monitoring) {
         current_memory_usage_.store(read_memory_usage());
     }
+    
+    if (config_.enable_thread_monitoring) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_thread_sample_ >= std::chrono::milliseconds(config_.thread_sampling_interval_ms)) {
+            thread_accounting_.sample();
+            last_thread_sample_ = now;
+        }
+    }
 }
 
-void PerformanceMonitor::update_stats(MetricCollection& collection) {
-    collection.cached_stats = calculate_stats(collection.data_points);
-    collection.stats_dirty = false;
-}
-
-PerformanceStats PerformanceMonitor::calculate_stats(const std::vector<MetricDataPoint>& data_points) const {
+PerformanceStats PerformanceMonitor::calculate_stats(const HistogramSnapshot& snapshot) const {
     PerformanceStats stats;
     
-    if (data_points.empty()) {
+    if (snapshot.total_count == 0) {
         return stats;
     }
     
-    std::vector<double> values;
-    values.reserve(data_points.size());
-    
-    double sum = 0.0;
-    for (const auto& point : data_points) {
-        values.push_back(point.value);
-        sum += point.value;
-    }
-    
-    std::sort(values.begin(), values.end());
-    
-    stats.sample_count = values.size();
-    stats.min_value = values.front();
-    stats.max_value = values.back();
-    stats.avg_value = sum / values.size();
-    
-    // 计算百分位数
-    size_t p50_idx = static_cast<size_t>(values.size() * 0.5);
-    size_t p95_idx = static_cast<size_t>(values.size() * 0.95);
-    size_t p99_idx = static_cast<size_t>(values.size() * 0.99);
-    
-    stats.p50_value = values[std::min(p50_idx, values.size() - 1)];
-    stats.p95_value = values[std::min(p95_idx, values.size() - 1)];
-    stats.p99_value = values[std::min(p99_idx, values.size() - 1)];
+    // 百分位数按桶合并计算，O(桶数)，覆盖自启动（或清理）以来的全部样本
+    stats.sample_count = snapshot.total_count;
+    stats.min_value = snapshot.min_value / VALUE_SCALE;
+    stats.max_value = snapshot.max_value / VALUE_SCALE;
+    stats.avg_value = snapshot.mean() / VALUE_SCALE;
+    stats.p50_value = snapshot.value_at_percentile(50.0) / VALUE_SCALE;
+    stats.p95_value = snapshot.value_at_percentile(95.0) / VALUE_SCALE;
+    stats.p99_value = snapshot.value_at_percentile(99.0) / VALUE_SCALE;
     
     stats.last_update = std::chrono::high_resolution_clock::now();
     
     return stats;
 }
 
-void PerformanceMonitor::cleanup_old_data(MetricCollection& collection) {
-    if (collection.data_points.size() > config_.max_data_points) {
-        size_t remove_count = collection.data_points.size() - config_.max_data_points;
-        collection.data_points.erase(collection.data_points.begin(), 
-                                   collection.data_points.begin() + remove_count);
-        collection.stats_dirty = true;
-    }
-}
-
 std::string PerformanceMonitor::format_timestamp(const std::chrono::high_resolution_clock::time_point& tp) const {
     auto time_t = std::chrono::system_clock::to_time_t(
         std::chrono::system_clock::now() + 
@@ -0,0 +1,377 @@
+#include "execution/position_alignment_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+inline double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+inline bool is_terminal(AlignmentState state) {
+    return state == AlignmentState::ALIGNED || state == AlignmentState::FAILED;
+}
+
+} // namespace
+
+PositionAlignmentEngine::PositionAlignmentEngine()
+    : running_(false)
+    , active_(false)
+    , rebalance_id_(0)
+    , success_count_(0)
+    , orders_dispatched_(0)
+    , last_wall_time_ms_(0.0)
+    , max_wall_time_ms_(0.0)
+    , total_wall_time_ms_(0.0)
+{
+}
+
+PositionAlignmentEngine::~PositionAlignmentEngine()
+{
+    stop();
+}
+
+bool PositionAlignmentEngine::initialize(const Config& config, OrderDispatcher dispatcher,
+                                         CompletionCallback on_complete)
+{
+    if (!dispatcher) {
+        std::cerr << "[PositionAlignmentEngine] Order dispatcher not set" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    dispatcher_ = std::move(dispatcher);
+    on_complete_ = std::move(on_complete);
+    return true;
+}
+
+bool PositionAlignmentEngine::start()
+{
+    if (running_.load()) {
+        return true;
+    }
+
+    running_.store(true);
+    timer_thread_.reset(new std::thread(&PositionAlignmentEngine::timer_worker, this));
+    return true;
+}
+
+void PositionAlignmentEngine::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    cv_.notify_all();
+
+    if (timer_thread_ && timer_thread_->joinable()) {
+        timer_thread_->join();
+    }
+    timer_thread_.reset();
+    active_.store(false);
+}
+
+bool PositionAlignmentEngine::begin(const std::vector<AlignmentTarget>& targets)
+{
+    std::vector<PendingDispatch> dispatches;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (active_.load() || finished_report_) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        ++rebalance_id_;
+        begin_time_ = now;
+        symbols_.clear();
+
+        for (const auto& target : targets) {
+            SymbolAlignment& entry = symbols_[target.symbol];
+            entry = SymbolAlignment();
+            entry.symbol = target.symbol;
+            entry.target_quantity = target.target_quantity;
+            entry.current_quantity = target.current_quantity;
+            entry.tolerance = std::max(config_.absolute_tolerance,
+                                       std::abs(target.target_quantity) * config_.relative_tolerance);
+
+            if (within_tolerance(entry)) {
+                entry.state = AlignmentState::ALIGNED;
+                entry.align_time_ms = 0.0;
+            } else if (!target.tradable) {
+                entry.state = AlignmentState::FAILED;
+            } else {
+                schedule_dispatch_locked(entry, now, dispatches);
+            }
+        }
+
+        active_.store(true);
+        std::cout << "[PositionAlignmentEngine] Rebalance " << rebalance_id_ << " started with "
+                  << symbols_.size() << " symbols, " << dispatches.size() << " to adjust" << std::endl;
+        check_complete_locked(now, false);
+    }
+    cv_.notify_all();
+
+    // 所有交易对的调整单一次性发出，不逐个等待成交
+    run_dispatches(dispatches);
+    return true;
+}
+
+void PositionAlignmentEngine::on_position_update(const std::string& symbol, double quantity)
+{
+    if (!active_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = symbols_.find(symbol);
+        if (!active_.load() || it == symbols_.end()) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        it->second.current_quantity = quantity;
+        evaluate_locked(it->second, now);
+        check_complete_locked(now, false);
+        notify = true;
+    }
+    if (notify) {
+        cv_.notify_all();
+    }
+}
+
+void PositionAlignmentEngine::on_order_finished(const std::string& symbol)
+{
+    if (!active_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = symbols_.find(symbol);
+        if (!active_.load() || it == symbols_.end()) {
+            return;
+        }
+
+        SymbolAlignment& entry = it->second;
+        auto now = std::chrono::steady_clock::now();
+        if (entry.state == AlignmentState::WORKING) {
+            // 订单已终态，仓位推送通常紧随其后；短暂等待后仍未到位再补单
+            entry.state = AlignmentState::SETTLING;
+            entry.deadline = now + config_.settle_timeout;
+        }
+        evaluate_locked(entry, now);
+        check_complete_locked(now, false);
+    }
+    cv_.notify_all();
+}
+
+AlignmentStatistics PositionAlignmentEngine::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    AlignmentStatistics stats;
+    uint64_t completed = rebalance_id_ - (active_.load() ? 1 : 0);
+    stats.rebalance_count = completed;
+    stats.success_count = success_count_;
+    stats.orders_dispatched = orders_dispatched_;
+    stats.last_wall_time_ms = last_wall_time_ms_;
+    stats.max_wall_time_ms = max_wall_time_ms_;
+    stats.avg_wall_time_ms = completed > 0 ? total_wall_time_ms_ / completed : 0.0;
+    return stats;
+}
+
+void PositionAlignmentEngine::timer_worker()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (running_.load()) {
+        if (finished_report_) {
+            std::unique_ptr<AlignmentReport> report = std::move(finished_report_);
+            lock.unlock();
+            if (on_complete_) {
+                try {
+                    on_complete_(*report);
+                } catch (const std::exception& e) {
+                    std::cerr << "[PositionAlignmentEngine] Exception in completion callback: " << e.what() << std::endl;
+                }
+            }
+            lock.lock();
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!active_.load()) {
+            cv_.wait(lock, [this] { return !running_.load() || active_.load() || finished_report_; });
+            continue;
+        }
+
+        // 处理到期的交易对，并找出下一个超时点
+        std::vector<PendingDispatch> dispatches;
+        auto next_deadline = begin_time_ + config_.rebalance_timeout;
+        if (now >= next_deadline) {
+            for (auto& pair : symbols_) {
+                if (!is_terminal(pair.second.state)) {
+                    pair.second.state = AlignmentState::FAILED;
+                }
+            }
+            std::cout << "[PositionAlignmentEngine] Rebalance " << rebalance_id_ << " timed out" << std::endl;
+            check_complete_locked(now, true);
+            continue;
+        }
+
+        for (auto& pair : symbols_) {
+            SymbolAlignment& entry = pair.second;
+            if (is_terminal(entry.state)) {
+                continue;
+            }
+            if (entry.deadline <= now) {
+                if (entry.state == AlignmentState::WORKING) {
+                    std::cout << "[PositionAlignmentEngine] No order result for " << entry.symbol
+                              << " within " << config_.order_timeout.count() << "ms" << std::endl;
+                }
+                // 订单超时或仓位未推到目标：按最新仓位重新下单
+                schedule_dispatch_locked(entry, now, dispatches);
+            }
+            if (!is_terminal(entry.state)) {
+                next_deadline = std::min(next_deadline, entry.deadline);
+            }
+        }
+        check_complete_locked(now, false);
+
+        if (!dispatches.empty()) {
+            lock.unlock();
+            run_dispatches(dispatches);
+            lock.lock();
+            continue;
+        }
+
+        if (active_.load()) {
+            cv_.wait_until(lock, next_deadline);
+        }
+    }
+}
+
+void PositionAlignmentEngine::evaluate_locked(SymbolAlignment& entry, std::chrono::steady_clock::time_point now)
+{
+    if (within_tolerance(entry)) {
+        if (entry.state != AlignmentState::ALIGNED) {
+            entry.state = AlignmentState::ALIGNED;
+            entry.align_time_ms = elapsed_ms(begin_time_, now);
+            std::cout << "[PositionAlignmentEngine] " << entry.symbol << " aligned at "
+                      << entry.current_quantity << " (target " << entry.target_quantity << ") after "
+                      << entry.align_time_ms << "ms" << std::endl;
+        }
+    } else if (entry.state == AlignmentState::ALIGNED) {
+        // 后续成交把仓位推出了容差，重新进入等待
+        entry.state = AlignmentState::SETTLING;
+        entry.deadline = now + config_.settle_timeout;
+        entry.align_time_ms = -1.0;
+    }
+}
+
+void PositionAlignmentEngine::schedule_dispatch_locked(SymbolAlignment& entry,
+                                                       std::chrono::steady_clock::time_point now,
+                                                       std::vector<PendingDispatch>& dispatches)
+{
+    if (entry.attempts >= config_.max_attempts) {
+        entry.state = AlignmentState::FAILED;
+        std::cout << "[PositionAlignmentEngine] " << entry.symbol << " not aligned after "
+                  << entry.attempts << " attempts, current " << entry.current_quantity
+                  << " target " << entry.target_quantity << std::endl;
+        return;
+    }
+
+    entry.state = AlignmentState::WORKING;
+    entry.deadline = now + config_.order_timeout;
+    dispatches.push_back(PendingDispatch{entry.symbol, entry.current_quantity, entry.target_quantity, rebalance_id_});
+}
+
+void PositionAlignmentEngine::check_complete_locked(std::chrono::steady_clock::time_point now, bool timed_out)
+{
+    if (!active_.load()) {
+        return;
+    }
+
+    size_t aligned = 0;
+    size_t failed = 0;
+    for (const auto& pair : symbols_) {
+        if (pair.second.state == AlignmentState::ALIGNED) {
+            ++aligned;
+        } else if (pair.second.state == AlignmentState::FAILED) {
+            ++failed;
+        } else {
+            return;
+        }
+    }
+
+    std::unique_ptr<AlignmentReport> report(new AlignmentReport());
+    report->rebalance_id = rebalance_id_;
+    report->success = failed == 0;
+    report->timed_out = timed_out;
+    report->wall_time_ms = elapsed_ms(begin_time_, now);
+    report->aligned_count = aligned;
+    report->failed_count = failed;
+    report->symbols.reserve(symbols_.size());
+    for (const auto& pair : symbols_) {
+        report->symbols.push_back(pair.second);
+    }
+
+    if (report->success) {
+        ++success_count_;
+    }
+    last_wall_time_ms_ = report->wall_time_ms;
+    max_wall_time_ms_ = std::max(max_wall_time_ms_, report->wall_time_ms);
+    total_wall_time_ms_ += report->wall_time_ms;
+
+    std::cout << "[PositionAlignmentEngine] Rebalance " << rebalance_id_ << " finished in "
+              << report->wall_time_ms << "ms: " << aligned << " aligned, " << failed << " failed" << std::endl;
+
+    finished_report_ = std::move(report);
+    active_.store(false);
+}
+
+bool PositionAlignmentEngine::within_tolerance(const SymbolAlignment& entry) const
+{
+    return std::abs(entry.current_quantity - entry.target_quantity) <= entry.tolerance;
+}
+
+void PositionAlignmentEngine::run_dispatches(const std::vector<PendingDispatch>& dispatches)
+{
+    for (const auto& dispatch : dispatches) {
+        AlignmentDispatch result = AlignmentDispatch::REJECTED;
+        try {
+            result = dispatcher_(dispatch.symbol, dispatch.current_quantity, dispatch.target_quantity);
+        } catch (const std::exception& e) {
+            std::cerr << "[PositionAlignmentEngine] Exception dispatching " << dispatch.symbol << ": " << e.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = symbols_.find(dispatch.symbol);
+            if (!active_.load() || dispatch.rebalance_id != rebalance_id_ || it == symbols_.end()) {
+                continue;
+            }
+
+            SymbolAlignment& entry = it->second;
+            if (result == AlignmentDispatch::SUBMITTED) {
+                ++entry.attempts;
+                ++orders_dispatched_;
+            } else if (result == AlignmentDispatch::REJECTED && entry.state == AlignmentState::WORKING) {
+                entry.state = AlignmentState::FAILED;
+                check_complete_locked(std::chrono::steady_clock::now(), false);
+            }
+        }
+        cv_.notify_all();
+    }
+}
+
+} // namespace execution
+} // namespace tes
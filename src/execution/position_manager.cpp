@@ -1,4 +1,6 @@
 #include "execution/position_manager.h"
+#include "execution/thread_accounting.h"
+#include "shared_memory/core/position_table.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -24,7 +26,7 @@ PositionManager::~PositionManager()
 
 bool PositionManager::initialize()
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     
     if (initialized_.load()) {
         return true;
@@ -64,7 +66,11 @@ void PositionManager::stop()
         return;
     }
     
-    running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        running_.store(false);
+    }
+    wake_cv_.notify_all();
     
     // 等待工作线程结束
     if (worker_thread_ && (*worker_thread_).joinable()) {
@@ -81,17 +87,17 @@ void PositionManager::cleanup()
     stop();
     
     {
-        std::lock_guard<std::mutex> lock(positions_mutex_);
+        std::lock_guard<NamedMutex> lock(positions_mutex_);
         positions_.clear();
     }
     
     {
-        std::lock_guard<std::mutex> lock(market_data_mutex_);
+        std::lock_guard<NamedMutex> lock(market_data_mutex_);
         current_prices_.clear();
     }
     
     {
-        std::lock_guard<std::mutex> lock(events_mutex_);
+        std::lock_guard<NamedMutex> lock(events_mutex_);
         recent_events_.clear();
     }
     
@@ -100,8 +106,8 @@ void PositionManager::cleanup()
 
 void PositionManager::process_trade(const Trade& trade, const std::string& strategy_id)
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
     
     statistics_.total_trades_processed++;
     statistics_.last_trade_time = std::chrono::high_resolution_clock::now();
@@ -124,6 +130,7 @@ void PositionManager::process_trade(const Trade& trade, const std::string& strat
         positions_[position_key] = position_data;
         statistics_.total_positions++;
         statistics_.active_positions++;
+        publish_shared_position(position_data.position, trade.price);
         
         // 记录开仓事件
         if (config_.enable_event_logging) {
@@ -165,6 +172,12 @@ void PositionManager::process_trade(const Trade& trade, const std::string& strat
         if (new_quantity == 0) {
             // 持仓完全平仓
             if (config_.auto_close_zero_positions) {
+                // 共享表中的行保留，数量归零但保留已实现盈亏
+                Position closed = position;
+                closed.net_quantity = 0;
+                closed.average_cost = 0;
+                closed.unrealized_pnl = 0;
+                publish_shared_position(closed, trade.price);
                 positions_.erase(it);
                 statistics_.active_positions--;
                 statistics_.closed_positions++;
@@ -196,6 +209,7 @@ void PositionManager::process_trade(const Trade& trade, const std::string& strat
         
         position.update_time = trade.trade_time;
         position_data.last_update_time = std::chrono::high_resolution_clock::now();
+        publish_shared_position(position, trade.price);
         
         // 记录更新事件
         if (config_.enable_event_logging) {
@@ -223,7 +237,7 @@ void PositionManager::process_trades(const std::vector<Trade>& trades)
 
 Position PositionManager::get_position(const std::string& strategy_id, const std::string& instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::string position_key = get_position_key(strategy_id, instrument_id);
     auto it = positions_.find(position_key);
@@ -236,7 +250,7 @@ Position PositionManager::get_position(const std::string& strategy_id, const std
 
 std::vector<Position> PositionManager::get_positions_by_strategy(const std::string& strategy_id) const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::vector<Position> positions;
     for (const auto& pair : positions_) {
@@ -250,7 +264,7 @@ std::vector<Position> PositionManager::get_positions_by_strategy(const std::stri
 
 std::vector<Position> PositionManager::get_positions_by_instrument(const std::string& instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::vector<Position> positions;
     for (const auto& pair : positions_) {
@@ -264,7 +278,7 @@ std::vector<Position> PositionManager::get_positions_by_instrument(const std::st
 
 std::vector<Position> PositionManager::get_all_positions() const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::vector<Position> positions;
     for (const auto& pair : positions_) {
@@ -276,14 +290,14 @@ std::vector<Position> PositionManager::get_all_positions() const
 
 void PositionManager::update_position(const Position& position)
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     update_position_internal(position);
 }
 
 void PositionManager::close_position(const std::string& strategy_id, const std::string& instrument_id)
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
     
     std::string position_key = get_position_key(strategy_id, instrument_id);
     auto it = positions_.find(position_key);
@@ -293,6 +307,11 @@ void PositionManager::close_position(const std::string& strategy_id, const std::
         statistics_.active_positions--;
         statistics_.closed_positions++;
         
+        Position closed = position;
+        closed.net_quantity = 0;
+        closed.unrealized_pnl = 0;
+        publish_shared_position(closed, 0.0);
+        
         // 记录平仓事件
         if (config_.enable_event_logging) {
             PositionEvent event;
@@ -307,8 +326,8 @@ void PositionManager::close_position(const std::string& strategy_id, const std::
 
 void PositionManager::close_all_positions(const std::string& strategy_id)
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
     
     auto it = positions_.begin();
     while (it != positions_.end()) {
@@ -318,6 +337,11 @@ void PositionManager::close_all_positions(const std::string& strategy_id)
             statistics_.active_positions--;
             statistics_.closed_positions++;
             
+            Position closed = position;
+            closed.net_quantity = 0;
+            closed.unrealized_pnl = 0;
+            publish_shared_position(closed, 0.0);
+            
             // 记录平仓事件
             if (config_.enable_event_logging) {
                 PositionEvent event;
@@ -336,14 +360,14 @@ void PositionManager::close_all_positions(const std::string& strategy_id)
 void PositionManager::update_market_data(const MarketData& market_data)
 {
     {
-        std::lock_guard<std::mutex> lock(market_data_mutex_);
+        std::lock_guard<NamedMutex> lock(market_data_mutex_);
         current_prices_[market_data.instrument_id] = market_data.last_price;
     }
     
     // 更新未实现盈亏
     if (config_.enable_pnl_calculation) {
-        std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         
         double total_unrealized_pnl = 0.0;
         for (auto& pair : positions_) {
@@ -353,6 +377,7 @@ void PositionManager::update_market_data(const MarketData& market_data)
                 position_data.position.unrealized_pnl = calculate_unrealized_pnl(
                     position_data.position, market_data.last_price);
                 total_unrealized_pnl += position_data.position.unrealized_pnl;
+                publish_shared_position(position_data.position, market_data.last_price);
             }
         }
         
@@ -379,7 +404,7 @@ double PositionManager::calculate_unrealized_pnl(const Position& position, doubl
 
 double PositionManager::calculate_realized_pnl(const std::string& strategy_id) const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     double total_realized_pnl = 0.0;
     for (const auto& pair : positions_) {
@@ -393,8 +418,8 @@ double PositionManager::calculate_realized_pnl(const std::string& strategy_id) c
 
 double PositionManager::calculate_unrealized_pnl(const std::string& strategy_id) const
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> market_lock(market_data_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> market_lock(market_data_mutex_);
     
     double total_unrealized_pnl = 0.0;
     for (const auto& pair : positions_) {
@@ -420,8 +445,8 @@ double PositionManager::calculate_total_pnl(const std::string& strategy_id) cons
 
 double PositionManager::calculate_total_exposure(const std::string& strategy_id) const
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> market_lock(market_data_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> market_lock(market_data_mutex_);
     
     double total_exposure = 0.0;
     for (const auto& pair : positions_) {
@@ -447,8 +472,8 @@ double PositionManager::calculate_net_position(const std::string& strategy_id, c
 
 std::unordered_map<std::string, double> PositionManager::get_exposure_by_instrument() const
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> market_lock(market_data_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> market_lock(market_data_mutex_);
     
     std::unordered_map<std::string, double> exposure_map;
     
@@ -474,7 +499,7 @@ void PositionManager::set_position_event_callback(PositionEventCallback callback
 
 std::vector<PositionEvent> PositionManager::get_recent_events(uint32_t count) const
 {
-    std::lock_guard<std::mutex> lock(events_mutex_);
+    std::lock_guard<NamedMutex> lock(events_mutex_);
     
     std::vector<PositionEvent> events;
     uint32_t start_index = 0;
@@ -491,25 +516,25 @@ std::vector<PositionEvent> PositionManager::get_recent_events(uint32_t count) co
 
 void PositionManager::set_config(const Config& config)
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     config_ = config;
 }
 
 PositionManager::Config PositionManager::get_config() const
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     return config_;
 }
 
 PositionStatistics PositionManager::get_statistics() const
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     return statistics_;
 }
 
 bool PositionManager::is_position_exists(const std::string& strategy_id, const std::string& instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     std::string position_key = get_position_key(strategy_id, instrument_id);
     return positions_.find(position_key) != positions_.end();
 }
@@ -533,7 +558,7 @@ std::string PositionManager::generate_event_id()
 void PositionManager::log_position_event(const PositionEvent& event)
 {
     {
-        std::lock_guard<std::mutex> lock(events_mutex_);
+        std::lock_guard<NamedMutex> lock(events_mutex_);
         recent_events_.push_back(event);
         
         // 保持事件列表大小
@@ -573,10 +598,39 @@ void PositionManager::update_position_internal(const Position& position)
         position_data.last_update_time = std::chrono::high_resolution_clock::now();
         positions_[position_key] = position_data;
         
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         statistics_.total_positions++;
         statistics_.active_positions++;
     }
+    publish_shared_position(position, 0.0);
+}
+
+void PositionManager::publish_shared_position(const Position& position, double mark_price)
+{
+    if (!shared_position_table_) {
+        return;
+    }
+    
+    shared_memory::PositionRecord record;
+    record.strategy_id = position.strategy_id;
+    record.instrument_id = position.instrument_id;
+    record.net_quantity = position.net_quantity;
+    record.average_cost = position.average_cost;
+    record.realized_pnl = position.realized_pnl;
+    record.unrealized_pnl = position.unrealized_pnl;
+    record.mark_price = mark_price;
+    shared_position_table_->update_position(record);
+}
+
+void PositionManager::set_shared_position_table(std::shared_ptr<shared_memory::PositionTable> table)
+{
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
+    shared_position_table_ = table;
+    
+    // 已有持仓立即写入一次
+    for (const auto& pair : positions_) {
+        publish_shared_position(pair.second.position, pair.second.current_price);
+    }
 }
 
 void PositionManager::cleanup_zero_positions()
@@ -585,8 +639,8 @@ void PositionManager::cleanup_zero_positions()
         return;
     }
     
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
     
     auto it = positions_.begin();
     while (it != positions_.end()) {
@@ -613,8 +667,8 @@ void PositionManager::cleanup_zero_positions()
 
 void PositionManager::update_statistics()
 {
-    std::lock_guard<std::mutex> pos_lock(positions_mutex_);
-    std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> pos_lock(positions_mutex_);
+    std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
     
     statistics_.active_positions = positions_.size();
     
@@ -629,6 +683,8 @@ void PositionManager::update_statistics()
 
 void PositionManager::worker_thread()
 {
+    ThreadAccounting::set_current_thread_name("tes-position");
+
     while (running_.load()) {
         try {
             // 清理零持仓
@@ -637,8 +693,10 @@ void PositionManager::worker_thread()
             // 更新统计信息
             update_statistics();
             
-            // 休眠
-            std::this_thread::sleep_for(std::chrono::seconds(config_.position_cleanup_interval_seconds));
+            // 休眠，stop()时提前唤醒
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, std::chrono::seconds(config_.position_cleanup_interval_seconds),
+                              [this] { return !running_.load(); });
         } catch (const std::exception& e) {
             std::cerr << "PositionManager worker thread error: " << e.what() << std::endl;
         }
@@ -648,7 +706,7 @@ void PositionManager::worker_thread()
 // 外部持仓同步方法实现
 void PositionManager::sync_position_from_exchange(const Position& position)
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::string position_key = get_position_key(position.strategy_id, position.instrument_id);
     auto it = positions_.find(position_key);
@@ -664,12 +722,13 @@ void PositionManager::sync_position_from_exchange(const Position& position)
         position_data.last_update_time = std::chrono::high_resolution_clock::now();
         positions_[position_key] = position_data;
         
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         statistics_.total_positions++;
         if (position.net_quantity != 0.0) {
             statistics_.active_positions++;
         }
     }
+    publish_shared_position(position, 0.0);
     
     // 记录持仓事件
     PositionEvent event;
@@ -689,7 +748,7 @@ void PositionManager::sync_positions_from_exchange(const std::vector<Position>&
 
 bool PositionManager::remove_position(const std::string& strategy_id, const std::string& instrument_id)
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     std::string position_key = get_position_key(strategy_id, instrument_id);
     auto it = positions_.find(position_key);
@@ -697,7 +756,7 @@ bool PositionManager::remove_position(const std::string& strategy_id, const std:
     if (it != positions_.end()) {
         positions_.erase(it);
         
-        std::lock_guard<std::mutex> stats_lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> stats_lock(statistics_mutex_);
         if (statistics_.active_positions > 0) {
             statistics_.active_positions--;
         }
@@ -709,19 +768,19 @@ bool PositionManager::remove_position(const std::string& strategy_id, const std:
 // 交易所适配器管理方法实现
 void PositionManager::set_exchange_adapter(std::shared_ptr<PositionExchangeAdapter> adapter)
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     exchange_adapter_ = adapter;
 }
 
 std::shared_ptr<PositionExchangeAdapter> PositionManager::get_exchange_adapter() const
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     return exchange_adapter_;
 }
 
 bool PositionManager::has_exchange_adapter() const
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     return exchange_adapter_ != nullptr;
 }
 
@@ -733,7 +792,7 @@ void PositionManager::force_update_position(const Position& position)
 
 void PositionManager::batch_update_positions(const std::vector<Position>& positions)
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     for (const auto& position : positions) {
         std::string position_key = get_position_key(position.strategy_id, position.instrument_id);
@@ -748,6 +807,7 @@ void PositionManager::batch_update_positions(const std::vector<Position>& positi
             position_data.last_update_time = std::chrono::high_resolution_clock::now();
             positions_[position_key] = position_data;
         }
+        publish_shared_position(position, 0.0);
         
         // 记录持仓事件
         PositionEvent event;
@@ -761,7 +821,7 @@ void PositionManager::batch_update_positions(const std::vector<Position>& positi
 
 void PositionManager::refresh_positions_from_exchange()
 {
-    std::lock_guard<std::mutex> lock(adapter_mutex_);
+    std::lock_guard<NamedMutex> lock(adapter_mutex_);
     
     if (exchange_adapter_) {
         try {
@@ -775,7 +835,7 @@ void PositionManager::refresh_positions_from_exchange()
 
 void PositionManager::clear_stale_positions(std::chrono::seconds max_age)
 {
-    std::lock_guard<std::mutex> lock(positions_mutex_);
+    std::lock_guard<NamedMutex> lock(positions_mutex_);
     
     auto now = std::chrono::high_resolution_clock::now();
     auto it = positions_.begin();
@@ -793,13 +853,13 @@ void PositionManager::clear_stale_positions(std::chrono::seconds max_age)
 // 策略映射功能实现
 void PositionManager::set_strategy_mapping_callback(StrategyMappingCallback callback)
 {
-    std::lock_guard<std::mutex> lock(strategy_mapping_mutex_);
+    std::lock_guard<NamedMutex> lock(strategy_mapping_mutex_);
     strategy_mapping_callback_ = callback;
 }
 
 std::string PositionManager::map_exchange_strategy_id(const std::string& exchange_strategy_id) const
 {
-    std::lock_guard<std::mutex> lock(strategy_mapping_mutex_);
+    std::lock_guard<NamedMutex> lock(strategy_mapping_mutex_);
     
     // 首先尝试使用映射表
     auto it = strategy_mappings_.find(exchange_strategy_id);
@@ -818,19 +878,19 @@ std::string PositionManager::map_exchange_strategy_id(const std::string& exchang
 
 void PositionManager::add_strategy_mapping(const std::string& exchange_strategy_id, const std::string& internal_strategy_id)
 {
-    std::lock_guard<std::mutex> lock(strategy_mapping_mutex_);
+    std::lock_guard<NamedMutex> lock(strategy_mapping_mutex_);
     strategy_mappings_[exchange_strategy_id] = internal_strategy_id;
 }
 
 void PositionManager::remove_strategy_mapping(const std::string& exchange_strategy_id)
 {
-    std::lock_guard<std::mutex> lock(strategy_mapping_mutex_);
+    std::lock_guard<NamedMutex> lock(strategy_mapping_mutex_);
     strategy_mappings_.erase(exchange_strategy_id);
 }
 
 std::unordered_map<std::string, std::string> PositionManager::get_strategy_mappings() const
 {
-    std::lock_guard<std::mutex> lock(strategy_mapping_mutex_);
+    std::lock_guard<NamedMutex> lock(strategy_mapping_mutex_);
     return strategy_mappings_;
 }
 
@@ -35,6 +35,9 @@ static std::unordered_map<std::string, PendingOrderInfo> pending_orders; // clie
 SignalTransmissionManager::SignalTransmissionManager()
     : initialized_(false)
     , running_(false)
+    , json_subscription_id_(0)
+    , json_changed_(false)
+    , loaded_table_generation_(0)
 {
     last_json_update_time_ = std::chrono::high_resolution_clock::now();
 }
@@ -69,6 +72,15 @@ bool SignalTransmissionManager::initialize(const Config& config)
             return false;
         }
     }
+    else if (config_.mode == SignalTransmissionMode::SHARED_MEMORY_TABLE) {
+        try {
+            target_table_ = std::make_unique<shared_memory::TargetPositionTable>(config_.target_table_name, true);
+        }
+        catch (const std::exception& e) {
+            set_error("Cannot create target position table: " + std::string(e.what()));
+            return false;
+        }
+    }
     
     initialized_.store(true);
     return true;
@@ -90,10 +102,23 @@ bool SignalTransmissionManager::start()
     // 根据模式启动相应的工作线程
     if (config_.mode == SignalTransmissionMode::JSON_FILE) {
         if (config_.enable_auto_sync) {
+            json_watcher_ = TargetFileWatcher::acquire(config_.json_file_path);
+            json_subscription_id_ = json_watcher_->subscribe([this](const TargetFileDelta&) {
+                {
+                    std::lock_guard<std::mutex> lock(json_event_mutex_);
+                    json_changed_ = true;
+                }
+                json_event_cv_.notify_one();
+            });
             json_monitoring_thread_ = std::make_unique<std::thread>(&SignalTransmissionManager::json_monitoring_worker, this);
             position_sync_thread_ = std::make_unique<std::thread>(&SignalTransmissionManager::position_sync_worker, this);
         }
     }
+    else if (config_.mode == SignalTransmissionMode::SHARED_MEMORY_TABLE) {
+        if (config_.enable_auto_sync) {
+            json_monitoring_thread_ = std::make_unique<std::thread>(&SignalTransmissionManager::target_table_worker, this);
+        }
+    }
     
     return true;
 }
@@ -104,7 +129,15 @@ void SignalTransmissionManager::stop()
         return;
     }
     
-    running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(json_event_mutex_);
+        running_.store(false);
+    }
+    json_event_cv_.notify_all();
+    
+    if (json_watcher_) {
+        json_watcher_->unsubscribe(json_subscription_id_);
+    }
     
     // 等待工作线程结束
     if (json_monitoring_thread_ && json_monitoring_thread_->joinable()) {
@@ -122,6 +155,8 @@ void SignalTransmissionManager::cleanup()
     
     position_manager_.reset();
     shared_memory_interface_.reset();
+    json_watcher_.reset();
+    target_table_.reset();
     
     initialized_.store(false);
 }
@@ -158,7 +193,8 @@ bool SignalTransmissionManager::receive_signals(std::vector<shared_memory::Tradi
         size_t count = shared_memory_interface_->receive_signals_batch(signals, max_count);
         return count > 0;
     }
-    else if (config_.mode == SignalTransmissionMode::JSON_FILE) {
+    else if (config_.mode == SignalTransmissionMode::JSON_FILE ||
+             config_.mode == SignalTransmissionMode::SHARED_MEMORY_TABLE) {
         // JSON文件模式下，信号通过仓位同步触发
         // 这里可以根据需要实现信号生成逻辑
         return true;
@@ -176,62 +212,56 @@ bool SignalTransmissionManager::load_json_position_data(JsonPositionUpdate& data
 {
     std::lock_guard<std::mutex> lock(json_mutex_);
     
-    try {
-        std::ifstream file(config_.json_file_path);
-        if (!file.is_open()) {
-            set_error("Cannot open JSON file: " + config_.json_file_path);
+    if (config_.mode == SignalTransmissionMode::SHARED_MEMORY_TABLE) {
+        shared_memory::TargetPositionSnapshot snapshot;
+        if (!target_table_ || !target_table_->read_snapshot(snapshot)) {
+            set_error("Cannot read target position table: " + config_.target_table_name);
             return false;
         }
         
-        nlohmann::json json_data;
-        file >> json_data;
-        
-        // 解析JSON数据
-        if (json_data.is_array() && json_data.size() >= 4) {
-            // 解析has_position
-            if (json_data[0].contains("has_position")) {
-                for (const auto& pos : json_data[0]["has_position"]) {
-                    JsonPositionData position;
-                    position.id = pos["id"];
-                    position.symbol = pos["symbol"];
-                    position.quantity = pos["quantity"];
-                    data.has_position.push_back(position);
-                }
-            }
-            
-            // 解析no_position
-            if (json_data[1].contains("no_position")) {
-                for (const auto& pos : json_data[1]["no_position"]) {
-                    JsonPositionData position;
-                    position.id = pos["id"];
-                    position.symbol = pos["symbol"];
-                    position.quantity = pos["quantity"];
-                    data.no_position.push_back(position);
-                }
-            }
-            
-            // 解析booksize等字段
-            if (json_data.size() > 2) {
-                data.booksize = json_data[2].value("booksize", 0.0);
-                data.targetvalue = json_data[2].value("targetvalue", 0.0);
-                data.longtarget = json_data[2].value("longtarget", 0.0);
-                data.shorttarget = json_data[2].value("shorttarget", 0.0);
-            }
-            
-            // 解析状态字段
-            if (json_data.size() > 3) {
-                data.isFinished = json_data[3].value("isFinished", 0);
-                data.errorstring = json_data[3].value("errorstring", "");
-                data.update_timestamp = json_data[3].value("update_timestamp", 0.0);
-            }
+        int id = 0;
+        for (const auto& entry : snapshot.targets) {
+            data.has_position.push_back(JsonPositionData{++id, entry.symbol, std::to_string(entry.quantity)});
         }
+        data.booksize = 0.0;
+        data.targetvalue = 0.0;
+        data.longtarget = 0.0;
+        data.shorttarget = 0.0;
         
+        // 已确认到当前代数时沿用确认状态，否则视为待处理
+        uint64_t ack_generation = 0;
+        shared_memory::TargetAckStatus ack_status = shared_memory::TargetAckStatus::PENDING;
+        target_table_->get_acknowledgement(ack_generation, ack_status);
+        data.isFinished = ack_generation >= snapshot.generation ? static_cast<int>(ack_status) : 0;
+        data.update_timestamp = static_cast<double>(snapshot.generation);
+        loaded_table_generation_.store(snapshot.generation);
         return true;
     }
-    catch (const std::exception& e) {
-        set_error("Failed to parse JSON file: " + std::string(e.what()));
+    
+    // 直接取监听器里最新的解析结果，文件只在变化时解析一次
+    std::shared_ptr<TargetFileWatcher> watcher = json_watcher_ ? json_watcher_
+                                                               : TargetFileWatcher::acquire(config_.json_file_path);
+    std::shared_ptr<const TargetFileSnapshot> snapshot = watcher->current();
+    if (!snapshot) {
+        set_error("Cannot load JSON file: " + config_.json_file_path);
         return false;
     }
+    
+    for (const auto& entry : snapshot->targets) {
+        data.has_position.push_back(JsonPositionData{entry.id, entry.symbol, entry.quantity});
+    }
+    for (const auto& entry : snapshot->closed) {
+        data.no_position.push_back(JsonPositionData{entry.id, entry.symbol, entry.quantity});
+    }
+    data.booksize = snapshot->booksize;
+    data.targetvalue = snapshot->targetvalue;
+    data.longtarget = snapshot->longtarget;
+    data.shorttarget = snapshot->shorttarget;
+    data.isFinished = snapshot->is_finished < 0 ? 0 : snapshot->is_finished;
+    data.errorstring = snapshot->errorstring;
+    data.update_timestamp = snapshot->update_timestamp;
+    
+    return true;
 }
 
 bool SignalTransmissionManager::save_json_position_data(const JsonPositionUpdate& data)
@@ -290,6 +320,12 @@ bool SignalTransmissionManager::save_json_position_data(const JsonPositionUpdate
         }
         
         file << json_data.dump(2);
+        file.close();
+        
+        // 不等inotify事件，立即让监听器和其他订阅者看到新状态
+        if (json_watcher_) {
+            json_watcher_->reload();
+        }
         return true;
     }
     catch (const std::exception& e) {
@@ -394,6 +430,16 @@ std::string SignalTransmissionManager::get_last_error() const
 void SignalTransmissionManager::json_monitoring_worker()
 {
     while (running_.load()) {
+        {
+            // 等待文件变化推送，不再按间隔重新解析
+            std::unique_lock<std::mutex> lock(json_event_mutex_);
+            json_event_cv_.wait(lock, [this] { return json_changed_ || !running_.load(); });
+            if (!running_.load()) {
+                break;
+            }
+            json_changed_ = false;
+        }
+        
         try {
             // 检查JSON文件更新时间
             JsonPositionUpdate current_data;
@@ -419,8 +465,39 @@ void SignalTransmissionManager::json_monitoring_worker()
         catch (const std::exception& e) {
             set_error("JSON monitoring error: " + std::string(e.what()));
         }
+    }
+}
+
+void SignalTransmissionManager::target_table_worker()
+{
+    uint64_t seen_generation = 0;
+    
+    while (running_.load()) {
+        // 等待策略发布新一代目标，超时只为检查退出标志
+        if (!target_table_->wait_for_generation(seen_generation, std::chrono::milliseconds(config_.json_update_interval_ms))) {
+            continue;
+        }
         
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.json_update_interval_ms));
+        try {
+            JsonPositionUpdate current_data;
+            if (load_json_position_data(current_data)) {
+                seen_generation = loaded_table_generation_.load();
+                last_json_data_ = current_data;
+                last_json_update_time_ = std::chrono::high_resolution_clock::now();
+                
+                if (current_data.isFinished == 1) {
+                    continue;
+                }
+                
+                if (position_sync_callback_) {
+                    auto result = sync_positions_with_json();
+                    position_sync_callback_(result);
+                }
+            }
+        }
+        catch (const std::exception& e) {
+            set_error("Target table monitoring error: " + std::string(e.what()));
+        }
     }
 }
 
@@ -845,6 +922,15 @@ bool SignalTransmissionManager::validate_booksize_and_targets(const JsonPosition
 
 void SignalTransmissionManager::update_json_status(int isFinished, const std::string& errorstring)
 {
+    if (config_.mode == SignalTransmissionMode::SHARED_MEMORY_TABLE) {
+        // 只确认实际同步过的那一代，期间新发布的目标留给下一轮
+        if (target_table_) {
+            target_table_->acknowledge(loaded_table_generation_.load(),
+                                       static_cast<shared_memory::TargetAckStatus>(isFinished));
+        }
+        return;
+    }
+    
     JsonPositionUpdate data;
     if (load_json_position_data(data)) {
         data.isFinished = isFinished;
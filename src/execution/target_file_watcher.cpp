@@ -0,0 +1,476 @@
+#include "execution/target_file_watcher.h"
+#include "yyjson.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+std::mutex g_watchers_mutex;
+std::unordered_map<std::string, std::weak_ptr<TargetFileWatcher>> g_watchers;
+
+bool read_number(yyjson_val* obj, const char* key, double& out) {
+    yyjson_val* val = yyjson_obj_get(obj, key);
+    if (!val || !yyjson_is_num(val)) {
+        return false;
+    }
+    out = yyjson_get_num(val);
+    return true;
+}
+
+// 解析一条{id, symbol, quantity}，quantity兼容字符串和数字
+bool parse_entry(yyjson_val* obj, TargetFileEntry& entry) {
+    yyjson_val* symbol = yyjson_obj_get(obj, "symbol");
+    yyjson_val* quantity = yyjson_obj_get(obj, "quantity");
+    if (!symbol || !yyjson_is_str(symbol) || !quantity) {
+        return false;
+    }
+
+    entry.symbol.assign(yyjson_get_str(symbol), yyjson_get_len(symbol));
+    if (yyjson_is_str(quantity)) {
+        entry.quantity.assign(yyjson_get_str(quantity), yyjson_get_len(quantity));
+        char* end = nullptr;
+        entry.quantity_value = std::strtod(entry.quantity.c_str(), &end);
+        if (end == entry.quantity.c_str()) {
+            return false;
+        }
+    } else if (yyjson_is_num(quantity)) {
+        entry.quantity_value = yyjson_get_num(quantity);
+        std::ostringstream oss;
+        oss << entry.quantity_value;
+        entry.quantity = oss.str();
+    } else {
+        return false;
+    }
+
+    yyjson_val* id = yyjson_obj_get(obj, "id");
+    entry.id = (id && yyjson_is_num(id)) ? static_cast<int>(yyjson_get_num(id)) : 0;
+    return true;
+}
+
+void parse_entry_array(yyjson_val* arr, std::vector<TargetFileEntry>& out) {
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_arr_foreach(arr, idx, max, item) {
+        TargetFileEntry entry;
+        if (yyjson_is_obj(item) && parse_entry(item, entry)) {
+            out.push_back(std::move(entry));
+        }
+    }
+}
+
+bool same_symbols(const std::vector<TargetFileEntry>& a, const std::vector<TargetFileEntry>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].symbol != b[i].symbol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64_t file_mtime_ns(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+const TargetFileEntry* TargetFileSnapshot::find_target(const std::string& symbol) const
+{
+    for (const auto& entry : targets) {
+        if (entry.symbol == symbol) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool TargetFileDelta::symbols_changed() const
+{
+    for (const auto& change : changes) {
+        if (change.type != TargetChangeType::MODIFIED) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<TargetFileWatcher> TargetFileWatcher::acquire(const std::string& path)
+{
+    std::error_code ec;
+    std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+    std::string key = ec ? path : absolute.lexically_normal().string();
+
+    std::lock_guard<std::mutex> lock(g_watchers_mutex);
+    auto it = g_watchers.find(key);
+    if (it != g_watchers.end()) {
+        if (auto watcher = it->second.lock()) {
+            return watcher;
+        }
+    }
+
+    std::shared_ptr<TargetFileWatcher> watcher(new TargetFileWatcher(path));
+    watcher->reload();
+    watcher->start();
+    g_watchers[key] = watcher;
+    return watcher;
+}
+
+TargetFileWatcher::TargetFileWatcher(const std::string& path)
+    : path_(path)
+    , inotify_fd_(-1)
+    , wake_fd_(-1)
+    , running_(false)
+    , fallback_poll_interval_(1000)
+    , last_mtime_ns_(-1)
+    , next_subscription_id_(1)
+    , parse_count_(0)
+{
+    std::filesystem::path file_path(path);
+    directory_ = file_path.has_parent_path() ? file_path.parent_path().string() : ".";
+    file_name_ = file_path.filename().string();
+}
+
+TargetFileWatcher::~TargetFileWatcher()
+{
+    stop();
+}
+
+void TargetFileWatcher::start()
+{
+    inotify_fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ >= 0) {
+        // 监听目录而不是文件：rename替换后文件的inode会变
+        if (::inotify_add_watch(inotify_fd_, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            std::cerr << "[TargetFileWatcher] inotify_add_watch failed for " << directory_ << ": "
+                      << std::strerror(errno) << ", falling back to polling" << std::endl;
+            ::close(inotify_fd_);
+            inotify_fd_ = -1;
+        }
+    } else {
+        std::cerr << "[TargetFileWatcher] inotify_init1 failed: " << std::strerror(errno)
+                  << ", falling back to polling" << std::endl;
+    }
+    wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    last_mtime_ns_ = file_mtime_ns(path_);
+
+    running_.store(true);
+    thread_.reset(new std::thread(&TargetFileWatcher::worker, this));
+}
+
+void TargetFileWatcher::stop()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = ::write(wake_fd_, &one, sizeof(one));
+        (void)written;
+    }
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+
+    if (inotify_fd_ >= 0) {
+        ::close(inotify_fd_);
+        inotify_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        ::close(wake_fd_);
+        wake_fd_ = -1;
+    }
+}
+
+std::shared_ptr<const TargetFileSnapshot> TargetFileWatcher::current() const
+{
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    return snapshot_;
+}
+
+uint64_t TargetFileWatcher::subscribe(Listener listener)
+{
+    if (!listener) {
+        return 0;
+    }
+
+    // 在dispatch_mutex_内登记并补发，保证不会先收到新增量再收到旧快照
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        id = next_subscription_id_++;
+        listeners_.emplace_back(id, listener);
+    }
+
+    std::shared_ptr<const TargetFileSnapshot> snapshot = current();
+    if (snapshot) {
+        TargetFileDelta delta;
+        delta.snapshot = snapshot;
+        delta.initial = true;
+        delta.status_changed = true;
+        for (const auto& entry : snapshot->targets) {
+            delta.changes.push_back(TargetChange{entry.symbol, TargetChangeType::ADDED, 0.0, entry.quantity_value});
+        }
+        dispatching_thread_.store(std::this_thread::get_id());
+        try {
+            listener(delta);
+        } catch (const std::exception& e) {
+            std::cerr << "[TargetFileWatcher] Exception in listener: " << e.what() << std::endl;
+        }
+        dispatching_thread_.store(std::thread::id());
+    }
+    return id;
+}
+
+void TargetFileWatcher::unsubscribe(uint64_t subscription_id)
+{
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners_.erase(std::remove_if(listeners_.begin(), listeners_.end(),
+                                        [subscription_id](const std::pair<uint64_t, Listener>& item) {
+                                            return item.first == subscription_id;
+                                        }),
+                         listeners_.end());
+    }
+
+    // 等待进行中的回调结束；在回调内退订时不能等自己
+    if (dispatching_thread_.load() != std::this_thread::get_id()) {
+        std::lock_guard<std::mutex> wait(dispatch_mutex_);
+    }
+}
+
+bool TargetFileWatcher::reload()
+{
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+
+    std::ifstream file(path_, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // 内容没变（例如只是touch或重复写入同样内容）不解析
+    if (content == last_content_ && current()) {
+        return true;
+    }
+
+    std::shared_ptr<TargetFileSnapshot> snapshot(new TargetFileSnapshot());
+    parse_count_.fetch_add(1);
+    if (!parse(content, *snapshot)) {
+        std::cerr << "[TargetFileWatcher] Failed to parse " << path_ << ", keeping previous targets" << std::endl;
+        return false;
+    }
+    last_content_.swap(content);
+    publish(std::move(snapshot));
+    return true;
+}
+
+void TargetFileWatcher::worker()
+{
+    alignas(struct inotify_event) char buffer[4096];
+
+    while (running_.load()) {
+        struct pollfd fds[2];
+        nfds_t count = 0;
+        fds[count++] = {wake_fd_, POLLIN, 0};
+        if (inotify_fd_ >= 0) {
+            fds[count++] = {inotify_fd_, POLLIN, 0};
+        }
+
+        int timeout = inotify_fd_ >= 0 ? -1 : static_cast<int>(fallback_poll_interval_.count());
+        int ready = ::poll(fds, count, timeout);
+        if (!running_.load()) {
+            break;
+        }
+        if (ready < 0) {
+            if (errno != EINTR) {
+                std::cerr << "[TargetFileWatcher] poll failed: " << std::strerror(errno) << std::endl;
+                std::this_thread::sleep_for(fallback_poll_interval_);
+            }
+            continue;
+        }
+
+        bool changed = false;
+        if (inotify_fd_ >= 0 && (fds[1].revents & POLLIN)) {
+            // 一次取完所有事件，多次写入合并为一次解析
+            ssize_t length;
+            while ((length = ::read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                for (char* ptr = buffer; ptr < buffer + length;) {
+                    const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(ptr);
+                    if ((event->mask & IN_Q_OVERFLOW) ||
+                        (event->len > 0 && file_name_ == event->name)) {
+                        changed = true;
+                    }
+                    ptr += sizeof(struct inotify_event) + event->len;
+                }
+            }
+        } else if (inotify_fd_ < 0 && ready == 0) {
+            int64_t mtime = file_mtime_ns(path_);
+            if (mtime != last_mtime_ns_) {
+                last_mtime_ns_ = mtime;
+                changed = true;
+            }
+        }
+
+        if (changed) {
+            reload();
+        }
+    }
+}
+
+bool TargetFileWatcher::parse(const std::string& content, TargetFileSnapshot& snapshot) const
+{
+    yyjson_doc* doc = yyjson_read(content.data(), content.size(), YYJSON_READ_NOFLAG);
+    if (!doc) {
+        return false;
+    }
+
+    yyjson_val* root = yyjson_doc_get_root(doc);
+    if (!root || !yyjson_is_arr(root)) {
+        yyjson_doc_free(doc);
+        return false;
+    }
+
+    // 兼容两种布局：[{id,symbol,quantity}..., {isFinished,...}]
+    // 以及[{has_position:[...]}, {no_position:[...]}, {booksize,...}, {isFinished,...}]
+    bool has_finished = false;
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_arr_foreach(root, idx, max, item) {
+        if (!yyjson_is_obj(item)) {
+            continue;
+        }
+
+        yyjson_val* has_position = yyjson_obj_get(item, "has_position");
+        if (has_position && yyjson_is_arr(has_position)) {
+            parse_entry_array(has_position, snapshot.targets);
+        }
+        yyjson_val* no_position = yyjson_obj_get(item, "no_position");
+        if (no_position && yyjson_is_arr(no_position)) {
+            parse_entry_array(no_position, snapshot.closed);
+        }
+
+        TargetFileEntry entry;
+        if (yyjson_obj_get(item, "id") && parse_entry(item, entry)) {
+            snapshot.targets.push_back(std::move(entry));
+        }
+
+        double value;
+        if (!has_finished && read_number(item, "isFinished", value)) {
+            snapshot.is_finished = static_cast<int>(value);
+            has_finished = true;
+        }
+        yyjson_val* errorstring = yyjson_obj_get(item, "errorstring");
+        if (errorstring && yyjson_is_str(errorstring)) {
+            snapshot.errorstring.assign(yyjson_get_str(errorstring), yyjson_get_len(errorstring));
+        }
+        read_number(item, "update_timestamp", snapshot.update_timestamp);
+        read_number(item, "booksize", snapshot.booksize);
+        read_number(item, "targetvalue", snapshot.targetvalue);
+        read_number(item, "longtarget", snapshot.longtarget);
+        read_number(item, "shorttarget", snapshot.shorttarget);
+    }
+
+    yyjson_doc_free(doc);
+    return true;
+}
+
+void TargetFileWatcher::publish(std::shared_ptr<TargetFileSnapshot> snapshot)
+{
+    std::shared_ptr<const TargetFileSnapshot> previous = current();
+
+    TargetFileDelta delta;
+    if (!previous) {
+        delta.status_changed = true;
+        for (const auto& entry : snapshot->targets) {
+            delta.changes.push_back(TargetChange{entry.symbol, TargetChangeType::ADDED, 0.0, entry.quantity_value});
+        }
+    } else {
+        std::unordered_map<std::string, double> old_targets;
+        old_targets.reserve(previous->targets.size());
+        for (const auto& entry : previous->targets) {
+            old_targets[entry.symbol] = entry.quantity_value;
+        }
+
+        std::unordered_set<std::string> seen;
+        for (const auto& entry : snapshot->targets) {
+            seen.insert(entry.symbol);
+            auto it = old_targets.find(entry.symbol);
+            if (it == old_targets.end()) {
+                delta.changes.push_back(TargetChange{entry.symbol, TargetChangeType::ADDED, 0.0, entry.quantity_value});
+            } else if (it->second != entry.quantity_value) {
+                delta.changes.push_back(TargetChange{entry.symbol, TargetChangeType::MODIFIED, it->second, entry.quantity_value});
+            }
+        }
+        for (const auto& entry : previous->targets) {
+            if (seen.find(entry.symbol) == seen.end()) {
+                delta.changes.push_back(TargetChange{entry.symbol, TargetChangeType::REMOVED, entry.quantity_value, 0.0});
+            }
+        }
+
+        delta.status_changed = snapshot->is_finished != previous->is_finished ||
+                               snapshot->errorstring != previous->errorstring ||
+                               snapshot->update_timestamp != previous->update_timestamp ||
+                               snapshot->booksize != previous->booksize ||
+                               snapshot->targetvalue != previous->targetvalue ||
+                               snapshot->longtarget != previous->longtarget ||
+                               snapshot->shorttarget != previous->shorttarget ||
+                               !same_symbols(snapshot->closed, previous->closed);
+
+        // 只是格式变化（空白、数量写法），不发布
+        if (delta.changes.empty() && !delta.status_changed) {
+            return;
+        }
+    }
+
+    snapshot->version = previous ? previous->version + 1 : 1;
+    delta.snapshot = snapshot;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        snapshot_ = snapshot;
+    }
+
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+    std::vector<std::pair<uint64_t, Listener>> listeners;
+    {
+        std::lock_guard<std::mutex> lock(listeners_mutex_);
+        listeners = listeners_;
+    }
+
+    dispatching_thread_.store(std::this_thread::get_id());
+    for (const auto& listener : listeners) {
+        try {
+            listener.second(delta);
+        } catch (const std::exception& e) {
+            std::cerr << "[TargetFileWatcher] Exception in listener: " << e.what() << std::endl;
+        }
+    }
+    dispatching_thread_.store(std::thread::id());
+}
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,219 @@
+#include "thread_accounting.h"
+#include "shared_memory/core/tsc_clock.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <pthread.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+constexpr size_t MAX_THREAD_NAME_LENGTH = 15;
+
+uint64_t timeval_ns(const struct timeval& tv)
+{
+    return static_cast<uint64_t>(tv.tv_sec) * 1000000000ULL + static_cast<uint64_t>(tv.tv_usec) * 1000ULL;
+}
+
+uint64_t clock_ticks_to_ns(uint64_t ticks)
+{
+    static const long ticks_per_second = sysconf(_SC_CLK_TCK);
+    return ticks_per_second > 0 ? ticks * (1000000000ULL / static_cast<uint64_t>(ticks_per_second)) : 0;
+}
+
+// schedstat: "运行纳秒 排队纳秒 时间片数"
+bool read_schedstat(const std::string& path, ThreadCounters& counters)
+{
+    std::ifstream file(path);
+    unsigned long long run_ns = 0, delay_ns = 0, timeslices = 0;
+    if (!(file >> run_ns >> delay_ns >> timeslices)) {
+        return false;
+    }
+    counters.run_ns = run_ns;
+    counters.run_delay_ns = delay_ns;
+    counters.timeslices = timeslices;
+    return true;
+}
+
+// stat中comm可能含空格和括号，从最后一个')'之后按字段解析；utime/stime是第14、15个字段
+bool read_stat(const std::string& path, ThreadCounters& counters)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!std::getline(file, line)) {
+        return false;
+    }
+    size_t end = line.rfind(')');
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    std::istringstream fields(line.substr(end + 1));
+    std::string skipped;
+    for (int field = 3; field < 14; ++field) {
+        fields >> skipped;
+    }
+    unsigned long long utime = 0, stime = 0;
+    if (!(fields >> utime >> stime)) {
+        return false;
+    }
+    counters.user_ns = clock_ticks_to_ns(utime);
+    counters.system_ns = clock_ticks_to_ns(stime);
+    return true;
+}
+
+bool read_status_switches(const std::string& path, ThreadCounters& counters)
+{
+    std::ifstream file(path);
+    std::string line;
+    int found = 0;
+    while (found < 2 && std::getline(file, line)) {
+        if (line.compare(0, 24, "voluntary_ctxt_switches:") == 0) {
+            counters.voluntary_switches = std::strtoull(line.c_str() + 24, nullptr, 10);
+            ++found;
+        } else if (line.compare(0, 27, "nonvoluntary_ctxt_switches:") == 0) {
+            counters.involuntary_switches = std::strtoull(line.c_str() + 27, nullptr, 10);
+            ++found;
+        }
+    }
+    return found == 2;
+}
+
+double per_second(uint64_t delta, double interval_sec)
+{
+    return interval_sec > 0.0 ? static_cast<double>(delta) / interval_sec : 0.0;
+}
+
+// 计数器单调递增，线程号被复用时可能变小，按0处理
+uint64_t delta_of(uint64_t current, uint64_t previous)
+{
+    return current > previous ? current - previous : 0;
+}
+
+} // namespace
+
+ThreadAccounting::ThreadAccounting()
+    : last_sample_ns_(0)
+{
+}
+
+void ThreadAccounting::set_current_thread_name(const char* name)
+{
+    if (!name) {
+        return;
+    }
+    char truncated[MAX_THREAD_NAME_LENGTH + 1];
+    std::strncpy(truncated, name, MAX_THREAD_NAME_LENGTH);
+    truncated[MAX_THREAD_NAME_LENGTH] = '\0';
+    pthread_setname_np(pthread_self(), truncated);
+}
+
+bool ThreadAccounting::read_current_thread(ThreadCounters& counters)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return false;
+    }
+    counters.user_ns = timeval_ns(usage.ru_utime);
+    counters.system_ns = timeval_ns(usage.ru_stime);
+    counters.voluntary_switches = static_cast<uint64_t>(usage.ru_nvcsw);
+    counters.involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+    read_schedstat("/proc/thread-self/schedstat", counters);
+    return true;
+}
+
+bool ThreadAccounting::read_thread(pid_t tid, ThreadCounters& counters, std::string& name)
+{
+    std::string base = "/proc/self/task/" + std::to_string(tid) + "/";
+
+    // 线程可能在读取途中退出，stat读不到即视为不存在
+    if (!read_stat(base + "stat", counters)) {
+        return false;
+    }
+    read_status_switches(base + "status", counters);
+    read_schedstat(base + "schedstat", counters);
+
+    std::ifstream comm(base + "comm");
+    if (!std::getline(comm, name)) {
+        name.clear();
+    }
+    return true;
+}
+
+std::vector<ThreadUsage> ThreadAccounting::sample()
+{
+    std::vector<ThreadUsage> usages;
+    DIR* dir = opendir("/proc/self/task");
+    if (!dir) {
+        return usages;
+    }
+
+    int64_t now_ns = shared_memory::TscClock::instance().monotonic_ns();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    double interval_sec = last_sample_ns_ > 0 ? static_cast<double>(now_ns - last_sample_ns_) / 1e9 : 0.0;
+    double interval_ns = interval_sec * 1e9;
+
+    std::unordered_map<pid_t, ThreadCounters> current;
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        pid_t tid = static_cast<pid_t>(std::atoi(entry->d_name));
+
+        ThreadUsage usage;
+        usage.tid = tid;
+        if (!read_thread(tid, usage.totals, usage.name)) {
+            continue;
+        }
+        current[tid] = usage.totals;
+
+        auto previous = baseline_.find(tid);
+        if (previous == baseline_.end() || interval_sec <= 0.0) {
+            continue;
+        }
+        const ThreadCounters& before = previous->second;
+        const ThreadCounters& after = usage.totals;
+
+        usage.user_cpu_percent = delta_of(after.user_ns, before.user_ns) / interval_ns * 100.0;
+        usage.system_cpu_percent = delta_of(after.system_ns, before.system_ns) / interval_ns * 100.0;
+        usage.voluntary_switches_per_sec =
+            per_second(delta_of(after.voluntary_switches, before.voluntary_switches), interval_sec);
+        usage.involuntary_switches_per_sec =
+            per_second(delta_of(after.involuntary_switches, before.involuntary_switches), interval_sec);
+
+        uint64_t delay_ns = delta_of(after.run_delay_ns, before.run_delay_ns);
+        uint64_t slices = delta_of(after.timeslices, before.timeslices);
+        usage.run_delay_percent = static_cast<double>(delay_ns) / interval_ns * 100.0;
+        usage.avg_run_delay_us = slices ? static_cast<double>(delay_ns) / slices / 1000.0 : 0.0;
+        usages.push_back(usage);
+    }
+    closedir(dir);
+
+    // 已退出的线程随基线一起丢弃
+    baseline_.swap(current);
+    last_sample_ns_ = now_ns;
+
+    std::sort(usages.begin(), usages.end(), [](const ThreadUsage& a, const ThreadUsage& b) {
+        return a.user_cpu_percent + a.system_cpu_percent > b.user_cpu_percent + b.system_cpu_percent;
+    });
+    last_sample_ = usages;
+    return usages;
+}
+
+std::vector<ThreadUsage> ThreadAccounting::get_last_sample() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_sample_;
+}
+
+} // namespace execution
+} // namespace tes
@@ -1,4 +1,5 @@
 #include "execution/thread_pool.h"
+#include "execution/thread_accounting.h"
 
 namespace tes {
 namespace execution {
@@ -11,6 +12,8 @@ ThreadPool::ThreadPool(size_t threads)
         workers.emplace_back(
             [this]
             {
+                ThreadAccounting::set_current_thread_name("tes-pool");
+
                 for(;;)
                 {
                     std::function<void()> task;
@@ -0,0 +1,297 @@
+#include "execution/timer_wheel.h"
+#include <algorithm>
+#include <iostream>
+
+namespace tes {
+namespace execution {
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick)
+    : tick_(tick.count() > 0 ? tick : std::chrono::microseconds(1000))
+    , epoch_(std::chrono::steady_clock::now())
+    , running_(false)
+    , wheel_tick_(0)
+    , free_list_(NIL)
+    , pending_(0)
+    , scheduled_count_(0)
+    , fired_count_(0)
+    , cancelled_count_(0)
+    , max_lateness_ticks_(0)
+{
+    std::fill(std::begin(level0_), std::end(level0_), NIL);
+    for (auto& level : levels_) {
+        std::fill(std::begin(level), std::end(level), NIL);
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    stop();
+}
+
+bool TimerWheel::start()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_.load()) {
+        return true;
+    }
+
+    wheel_tick_ = current_tick();
+    running_.store(true);
+    thread_.reset(new std::thread(&TimerWheel::worker, this));
+    return true;
+}
+
+void TimerWheel::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    cv_.notify_all();
+
+    if (thread_ && thread_->joinable()) {
+        thread_->join();
+    }
+    thread_.reset();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_ > 0) {
+        std::cout << "[TimerWheel] Stopped with " << pending_ << " pending timers discarded" << std::endl;
+    }
+    std::fill(std::begin(level0_), std::end(level0_), NIL);
+    for (auto& level : levels_) {
+        std::fill(std::begin(level), std::end(level), NIL);
+    }
+    nodes_.clear();
+    free_list_ = NIL;
+    pending_ = 0;
+}
+
+TimerId TimerWheel::schedule_after(std::chrono::microseconds delay, Callback callback)
+{
+    if (!callback) {
+        return INVALID_TIMER_ID;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_.load()) {
+        return INVALID_TIMER_ID;
+    }
+
+    uint64_t now = current_tick();
+    if (pending_ == 0) {
+        // 轮上没有定时器时直接跳到当前tick，省去空转追赶
+        wheel_tick_ = std::max(wheel_tick_, now);
+    }
+
+    int32_t index = free_list_;
+    if (index == NIL) {
+        index = static_cast<int32_t>(nodes_.size());
+        nodes_.emplace_back();
+        nodes_[index].generation = 1;
+    } else {
+        free_list_ = nodes_[index].next;
+    }
+
+    // 向上取整到tick，保证不早于请求的延时触发
+    uint64_t delay_ticks = delay.count() <= 0 ? 0 : (delay.count() + tick_.count() - 1) / tick_.count();
+    Node& node = nodes_[index];
+    node.callback = std::move(callback);
+    node.expires = now + delay_ticks;
+    add_locked(index);
+
+    ++pending_;
+    ++scheduled_count_;
+    cv_.notify_one();
+    return (static_cast<uint64_t>(node.generation) << 32) | static_cast<uint32_t>(index);
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    if (id == INVALID_TIMER_ID) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t index = static_cast<uint32_t>(id & 0xffffffffu);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index >= nodes_.size() || nodes_[index].slot == nullptr || nodes_[index].generation != generation) {
+        return false;
+    }
+
+    unlink_locked(static_cast<int32_t>(index));
+    free_node_locked(static_cast<int32_t>(index));
+    --pending_;
+    ++cancelled_count_;
+    return true;
+}
+
+TimerWheelStatistics TimerWheel::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    TimerWheelStatistics stats;
+    stats.scheduled = scheduled_count_;
+    stats.fired = fired_count_;
+    stats.cancelled = cancelled_count_;
+    stats.pending = pending_;
+    stats.max_lateness_us = max_lateness_ticks_ * tick_.count();
+    return stats;
+}
+
+void TimerWheel::worker()
+{
+    std::vector<Callback> expired;
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (running_.load()) {
+        uint64_t now = current_tick();
+        while (pending_ > 0 && wheel_tick_ <= now) {
+            advance_locked(now, expired, max_lateness_ticks_);
+        }
+
+        if (!expired.empty()) {
+            lock.unlock();
+            for (auto& callback : expired) {
+                try {
+                    callback();
+                } catch (const std::exception& e) {
+                    std::cerr << "[TimerWheel] Exception in timer callback: " << e.what() << std::endl;
+                }
+            }
+            expired.clear();
+            lock.lock();
+            continue;
+        }
+
+        if (pending_ == 0) {
+            cv_.wait(lock, [this] { return !running_.load() || pending_ > 0; });
+        } else {
+            cv_.wait_until(lock, epoch_ + tick_ * next_wakeup_tick_locked());
+        }
+    }
+}
+
+uint64_t TimerWheel::current_tick() const
+{
+    return static_cast<uint64_t>((std::chrono::steady_clock::now() - epoch_) / tick_);
+}
+
+uint64_t TimerWheel::next_wakeup_tick_locked() const
+{
+    // 只扫描到第0层的下一次回绕：更远的定时器要等级联后才落到第0层
+    uint64_t base = wheel_tick_;
+    if ((base & (LEVEL0_SIZE - 1)) == 0) {
+        return base;
+    }
+    uint64_t boundary = (base | (LEVEL0_SIZE - 1)) + 1;
+    for (uint64_t tick = base; tick < boundary; ++tick) {
+        if (level0_[tick & (LEVEL0_SIZE - 1)] != NIL) {
+            return tick;
+        }
+    }
+    return boundary;
+}
+
+void TimerWheel::add_locked(int32_t index)
+{
+    Node& node = nodes_[index];
+    uint64_t expires = std::max(node.expires, wheel_tick_);
+    uint64_t delta = expires - wheel_tick_;
+
+    int32_t* slot;
+    if (delta < LEVEL0_SIZE) {
+        slot = &level0_[expires & (LEVEL0_SIZE - 1)];
+    } else if (delta < (1ull << (LEVEL0_BITS + LEVEL_BITS))) {
+        slot = &levels_[0][(expires >> LEVEL0_BITS) & (LEVEL_SIZE - 1)];
+    } else if (delta < (1ull << (LEVEL0_BITS + 2 * LEVEL_BITS))) {
+        slot = &levels_[1][(expires >> (LEVEL0_BITS + LEVEL_BITS)) & (LEVEL_SIZE - 1)];
+    } else {
+        // 超出范围的先挂在最外层最远的槽，级联时再按真实到期时间重新分配
+        if (delta > MAX_DELTA) {
+            expires = wheel_tick_ + MAX_DELTA;
+        }
+        slot = &levels_[2][(expires >> (LEVEL0_BITS + 2 * LEVEL_BITS)) & (LEVEL_SIZE - 1)];
+    }
+
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = *slot;
+    if (*slot != NIL) {
+        nodes_[*slot].prev = index;
+    }
+    *slot = index;
+}
+
+void TimerWheel::unlink_locked(int32_t index)
+{
+    Node& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        *node.slot = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.slot = nullptr;
+    node.prev = NIL;
+    node.next = NIL;
+}
+
+void TimerWheel::free_node_locked(int32_t index)
+{
+    Node& node = nodes_[index];
+    node.callback = nullptr;
+    node.slot = nullptr;
+    ++node.generation;
+    if (node.generation == 0) {
+        node.generation = 1;
+    }
+    node.next = free_list_;
+    free_list_ = index;
+}
+
+uint32_t TimerWheel::cascade_locked(int level)
+{
+    uint32_t slot_index = static_cast<uint32_t>(
+        (wheel_tick_ >> (LEVEL0_BITS + (level - 1) * LEVEL_BITS)) & (LEVEL_SIZE - 1));
+    int32_t index = levels_[level - 1][slot_index];
+    levels_[level - 1][slot_index] = NIL;
+
+    while (index != NIL) {
+        int32_t next = nodes_[index].next;
+        add_locked(index);
+        index = next;
+    }
+    return slot_index;
+}
+
+void TimerWheel::advance_locked(uint64_t now, std::vector<Callback>& expired, uint64_t& max_lateness_ticks)
+{
+    uint32_t slot_index = static_cast<uint32_t>(wheel_tick_ & (LEVEL0_SIZE - 1));
+    if (slot_index == 0 && cascade_locked(1) == 0 && cascade_locked(2) == 0) {
+        cascade_locked(3);
+    }
+
+    int32_t index = level0_[slot_index];
+    level0_[slot_index] = NIL;
+    ++wheel_tick_;
+
+    while (index != NIL) {
+        Node& node = nodes_[index];
+        int32_t next = node.next;
+        if (now > node.expires) {
+            max_lateness_ticks = std::max(max_lateness_ticks, now - node.expires);
+        }
+        expired.push_back(std::move(node.callback));
+        free_node_locked(index);
+        --pending_;
+        ++fired_count_;
+        index = next;
+    }
+}
+
+} // namespace execution
+} // namespace tes
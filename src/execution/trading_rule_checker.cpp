@@ -1,18 +1,219 @@
 #include "execution/trading_rule_checker.h"
+#include "execution/trading_rule_registry.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <iomanip>
 #include <cmath>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 namespace tes {
 namespace execution {
 
+namespace {
+
+// 违规位，位序即check_order中各项检查的先后顺序，结果取最低位
+enum ViolationBit : uint32_t {
+    BIT_SYMBOL_NOT_FOUND = 0,
+    BIT_SYMBOL_NOT_TRADING,
+    BIT_QUANTITY_TOO_SMALL,
+    BIT_QUANTITY_TOO_LARGE,
+    BIT_QUANTITY_PRECISION,
+    BIT_PRICE_TOO_LOW,
+    BIT_PRICE_PRECISION,
+    BIT_MIN_NOTIONAL,
+    VIOLATION_BIT_COUNT
+};
+
+const TradingRuleCheckResult VIOLATION_RESULTS[VIOLATION_BIT_COUNT] = {
+    TradingRuleCheckResult::REJECT_SYMBOL_NOT_FOUND,
+    TradingRuleCheckResult::REJECT_SYMBOL_NOT_TRADING,
+    TradingRuleCheckResult::REJECT_QUANTITY_TOO_SMALL,
+    TradingRuleCheckResult::REJECT_QUANTITY_TOO_LARGE,
+    TradingRuleCheckResult::REJECT_QUANTITY_PRECISION,
+    TradingRuleCheckResult::REJECT_PRICE_TOO_LOW,
+    TradingRuleCheckResult::REJECT_PRICE_PRECISION,
+    TradingRuleCheckResult::REJECT_MIN_NOTIONAL
+};
+
+// 各检查项掩码展开为违规位掩码
+inline uint32_t violation_mask(uint32_t check_mask) {
+    uint32_t bits = 0;
+    if (check_mask & CHECK_SYMBOL_STATUS) bits |= (1u << BIT_SYMBOL_NOT_FOUND) | (1u << BIT_SYMBOL_NOT_TRADING);
+    if (check_mask & CHECK_QUANTITY)      bits |= (1u << BIT_QUANTITY_TOO_SMALL) | (1u << BIT_QUANTITY_TOO_LARGE);
+    if (check_mask & CHECK_PRICE)         bits |= (1u << BIT_PRICE_TOO_LOW);
+    if (check_mask & CHECK_PRECISION)     bits |= (1u << BIT_QUANTITY_PRECISION) | (1u << BIT_PRICE_PRECISION);
+    if (check_mask & CHECK_MIN_NOTIONAL)  bits |= (1u << BIT_MIN_NOTIONAL);
+    return bits;
+}
+
+// 已加载规则表时未知交易对无论检查项掩码如何都拒绝：下标为NOT_FOUND时各列取的是第0行的限制，
+// 只有NOT_FOUND位（最低位，优先级最高）能保证结果不依赖那一行；未加载规则表时跳过交易对检查
+inline uint32_t effective_bit_mask(const TradingRuleTable* table, uint32_t check_mask) {
+    return table ? (violation_mask(check_mask) | (1u << BIT_SYMBOL_NOT_FOUND))
+                 : violation_mask(check_mask & ~CHECK_SYMBOL_STATUS);
+}
+
+inline uint32_t check_mask_from_config(const TradingRuleChecker::Config& config) {
+    uint32_t mask = 0;
+    if (config.enable_symbol_status_check) mask |= CHECK_SYMBOL_STATUS;
+    if (config.enable_quantity_check) mask |= CHECK_QUANTITY;
+    if (config.enable_price_check) mask |= CHECK_PRICE;
+    if (config.enable_precision_check) mask |= CHECK_PRECISION;
+    if (config.enable_min_notional_check) mask |= CHECK_MIN_NOTIONAL;
+    return mask;
+}
+
+inline TradingRuleCheckResult result_from_bits(uint32_t bits) {
+    return bits ? VIOLATION_RESULTS[__builtin_ctz(bits)] : TradingRuleCheckResult::PASS;
+}
+
+// 步长整数倍判断的容差（以步长为单位）
+constexpr double GRID_TOLERANCE = 1e-6;
+
+inline uint32_t off_grid(double value, double increment) {
+    double units = value / increment;
+    return static_cast<uint32_t>((increment > 0.0) & (std::fabs(units - std::nearbyint(units)) > GRID_TOLERANCE));
+}
+
+// 单笔校验核心：所有比较都转为0/1再按位合并，不按检查项分支
+inline uint32_t violation_bits(bool found, uint8_t status, double min_qty, double max_qty,
+                               double step, double tick, double min_notional,
+                               double quantity, double price) {
+    uint32_t has_price = static_cast<uint32_t>(price > 0.0);
+    uint32_t bits = 0;
+    bits |= static_cast<uint32_t>(!found) << BIT_SYMBOL_NOT_FOUND;
+    bits |= static_cast<uint32_t>(found & (status != static_cast<uint8_t>(SymbolTradingStatus::TRADING))) << BIT_SYMBOL_NOT_TRADING;
+    // 取反比较使NaN也判为违规
+    bits |= static_cast<uint32_t>(!(quantity > 0.0) | !(quantity >= min_qty)) << BIT_QUANTITY_TOO_SMALL;
+    bits |= static_cast<uint32_t>((max_qty > 0.0) & (quantity > max_qty)) << BIT_QUANTITY_TOO_LARGE;
+    bits |= off_grid(quantity, step) << BIT_QUANTITY_PRECISION;
+    bits |= static_cast<uint32_t>(!(price >= 0.0)) << BIT_PRICE_TOO_LOW;
+    bits |= (has_price & off_grid(price, tick)) << BIT_PRICE_PRECISION;
+    bits |= (has_price & static_cast<uint32_t>(quantity * price < min_notional)) << BIT_MIN_NOTIONAL;
+    return bits;
+}
+
+inline uint32_t evaluate_one(const TradingRuleTable* table, int32_t index, double quantity, double price) {
+    if (!table) {
+        // 规则表尚未加载：按无限制规则校验，交易对检查由调用方屏蔽
+        return violation_bits(true, static_cast<uint8_t>(SymbolTradingStatus::TRADING),
+                              0.0, 0.0, 0.0, 0.0, 0.0, quantity, price);
+    }
+    bool found = index >= 0;
+    int32_t i = found ? index : 0;
+    if (table->size() == 0) {
+        return violation_bits(false, 0, 0.0, 0.0, 0.0, 0.0, 0.0, quantity, price);
+    }
+    return violation_bits(found, table->status_column()[i], table->min_qty(i), table->max_qty(i),
+                          table->step_size(i), table->tick_size(i), table->min_notional(i),
+                          quantity, price);
+}
+
+#ifdef __AVX2__
+// 4笔一组：按下标gather各列限制，向量比较得到每项检查的4位掩码
+inline __m256d off_grid_avx2(__m256d value, __m256d increment) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    __m256d units = _mm256_div_pd(value, increment);
+    __m256d diff = _mm256_and_pd(_mm256_sub_pd(units, _mm256_round_pd(units, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)), abs_mask);
+    return _mm256_and_pd(_mm256_cmp_pd(increment, zero, _CMP_GT_OQ),
+                         _mm256_cmp_pd(diff, _mm256_set1_pd(GRID_TOLERANCE), _CMP_GT_OQ));
+}
+
+inline void evaluate_block_avx2(const TradingRuleTable* table, const int32_t* indices,
+                                const double* quantities, const double* prices,
+                                uint32_t bit_mask, TradingRuleCheckResult* results) {
+    const __m256d zero = _mm256_setzero_pd();
+
+    __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices));
+    __m128i found = _mm_cmpgt_epi32(index, _mm_set1_epi32(-1));
+    __m128i safe_index = _mm_and_si128(index, found);
+
+    __m256d min_qty = _mm256_i32gather_pd(table->min_qty_column(), safe_index, 8);
+    __m256d max_qty = _mm256_i32gather_pd(table->max_qty_column(), safe_index, 8);
+    __m256d step = _mm256_i32gather_pd(table->step_size_column(), safe_index, 8);
+    __m256d tick = _mm256_i32gather_pd(table->tick_size_column(), safe_index, 8);
+    __m256d min_notional = _mm256_i32gather_pd(table->min_notional_column(), safe_index, 8);
+    __m256d quantity = _mm256_loadu_pd(quantities);
+    __m256d price = _mm256_loadu_pd(prices);
+
+    __m256d has_price = _mm256_cmp_pd(price, zero, _CMP_GT_OQ);
+    __m256d qty_small = _mm256_or_pd(_mm256_cmp_pd(quantity, zero, _CMP_NGT_UQ),
+                                     _mm256_cmp_pd(quantity, min_qty, _CMP_NGE_UQ));
+    __m256d qty_large = _mm256_and_pd(_mm256_cmp_pd(max_qty, zero, _CMP_GT_OQ),
+                                      _mm256_cmp_pd(quantity, max_qty, _CMP_GT_OQ));
+    __m256d qty_precision = off_grid_avx2(quantity, step);
+    __m256d price_low = _mm256_cmp_pd(price, zero, _CMP_NGE_UQ);
+    __m256d price_precision = _mm256_and_pd(has_price, off_grid_avx2(price, tick));
+    __m256d notional = _mm256_and_pd(has_price, _mm256_cmp_pd(_mm256_mul_pd(quantity, price), min_notional, _CMP_LT_OQ));
+
+    uint32_t not_found = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(found))) ^ 0xFu;
+    uint32_t lanes[VIOLATION_BIT_COUNT] = {
+        not_found,
+        0,
+        static_cast<uint32_t>(_mm256_movemask_pd(qty_small)),
+        static_cast<uint32_t>(_mm256_movemask_pd(qty_large)),
+        static_cast<uint32_t>(_mm256_movemask_pd(qty_precision)),
+        static_cast<uint32_t>(_mm256_movemask_pd(price_low)),
+        static_cast<uint32_t>(_mm256_movemask_pd(price_precision)),
+        static_cast<uint32_t>(_mm256_movemask_pd(notional))
+    };
+
+    // 状态列为uint8，逐笔读取（避免32位gather越过列尾）
+    const uint8_t* status = table->status_column();
+    for (int lane = 0; lane < 4; ++lane) {
+        uint32_t is_found = ((not_found >> lane) & 1u) ^ 1u;
+        uint32_t not_trading = is_found & static_cast<uint32_t>(
+            status[is_found ? indices[lane] : 0] != static_cast<uint8_t>(SymbolTradingStatus::TRADING));
+        lanes[BIT_SYMBOL_NOT_TRADING] |= not_trading << lane;
+    }
+
+    for (int lane = 0; lane < 4; ++lane) {
+        uint32_t bits = 0;
+        for (uint32_t bit = 0; bit < VIOLATION_BIT_COUNT; ++bit) {
+            bits |= ((lanes[bit] >> lane) & 1u) << bit;
+        }
+        results[lane] = result_from_bits(bits & bit_mask);
+    }
+}
+#endif
+
+} // namespace
+
+// TradingRuleBatch 实现
+void TradingRuleBatch::reset(TradingRuleTablePtr rule_table)
+{
+    table = rule_table;
+    rule_indices.clear();
+    quantities.clear();
+    prices.clear();
+    results.clear();
+}
+
+void TradingRuleBatch::add(std::string_view symbol, double quantity, double price)
+{
+    rule_indices.push_back(table ? table->find(symbol) : TradingRuleTable::NOT_FOUND);
+    quantities.push_back(quantity);
+    prices.push_back(price);
+}
+
 TradingRuleChecker::TradingRuleChecker() 
-    : initialized_(false)
+    : check_mask_(check_mask_from_config(Config()))
+    , log_violations_(Config().log_violations)
+    , initialized_(false)
     , event_sequence_(0)
+    , total_checks_(0)
+    , passed_checks_(0)
+    , rejected_checks_(0)
+    , last_check_ns_(0)
+    , last_violation_ns_(0)
 {
-    statistics_ = {};
+    for (auto& counter : violations_) {
+        counter.store(0);
+    }
 }
 
 TradingRuleChecker::~TradingRuleChecker()
@@ -22,15 +223,19 @@ TradingRuleChecker::~TradingRuleChecker()
 
 bool TradingRuleChecker::initialize()
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
-    
     if (initialized_.load()) {
         return true;
     }
     
     // 初始化统计信息
-    statistics_ = {};
-    statistics_.last_check_time = std::chrono::high_resolution_clock::now();
+    total_checks_.store(0);
+    passed_checks_.store(0);
+    rejected_checks_.store(0);
+    for (auto& counter : violations_) {
+        counter.store(0);
+    }
+    last_check_ns_.store(now_ns());
+    last_violation_ns_.store(0);
     
     initialized_.store(true);
     return true;
@@ -50,219 +255,180 @@ void TradingRuleChecker::cleanup()
     initialized_.store(false);
 }
 
-TradingRuleCheckResult TradingRuleChecker::check_order(const Order& order, bool is_futures)
+TradingRuleCheckResult TradingRuleChecker::evaluate(const TradingRuleTable* table, int32_t index,
+                                                    double quantity, double price, uint32_t mask)
 {
-    if (!initialized_.load()) {
-        return TradingRuleCheckResult::REJECT_SYSTEM_ERROR;
-    }
-    
-    // 更新统计信息
-    {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
-        statistics_.total_checks++;
-        statistics_.last_check_time = std::chrono::high_resolution_clock::now();
-    }
+    uint32_t bit_mask = effective_bit_mask(table, mask);
+    return result_from_bits(evaluate_one(table, index, quantity, price) & bit_mask);
+}
+
+size_t TradingRuleChecker::evaluate_batch(const TradingRuleTable* table, const int32_t* indices,
+                                          const double* quantities, const double* prices, size_t count,
+                                          uint32_t mask, TradingRuleCheckResult* results)
+{
+    uint32_t bit_mask = effective_bit_mask(table, mask);
+    size_t i = 0;
     
-    // 检查交易对状态
-    if (config_.enable_symbol_status_check) {
-        auto result = check_symbol_status(order.instrument_id, is_futures);
-        if (result != TradingRuleCheckResult::PASS) {
-            return result;
+#ifdef __AVX2__
+    if (table && table->size() > 0) {
+        for (; i + 4 <= count; i += 4) {
+            evaluate_block_avx2(table, indices + i, quantities + i, prices + i, bit_mask, results + i);
         }
     }
+#endif
     
-    // 检查数量规则
-    if (config_.enable_quantity_check) {
-        auto result = check_quantity_rules(order.instrument_id, order.quantity, is_futures);
-        if (result != TradingRuleCheckResult::PASS) {
-            return result;
-        }
+    for (; i < count; ++i) {
+        results[i] = result_from_bits(evaluate_one(table, indices[i], quantities[i], prices[i]) & bit_mask);
     }
     
-    // 检查价格规则
-    if (config_.enable_price_check && order.price > 0) {
-        auto result = check_price_rules(order.instrument_id, order.price, is_futures);
-        if (result != TradingRuleCheckResult::PASS) {
-            return result;
-        }
+    size_t passed = 0;
+    for (size_t j = 0; j < count; ++j) {
+        passed += results[j] == TradingRuleCheckResult::PASS;
     }
+    return passed;
+}
+
+TradingRuleCheckResult TradingRuleChecker::check_order(const Order& order, bool is_futures)
+{
+    (void)is_futures;  // 规则表目前只加载合约交易规则
     
-    // 检查最小名义价值
-    if (config_.enable_min_notional_check && order.price > 0) {
-        auto result = check_min_notional(order.instrument_id, order.quantity, order.price, is_futures);
-        if (result != TradingRuleCheckResult::PASS) {
-            return result;
-        }
+    if (!initialized_.load()) {
+        return TradingRuleCheckResult::REJECT_SYSTEM_ERROR;
     }
     
-    // 更新通过统计
-    {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
-        statistics_.passed_checks++;
-    }
+    int64_t now = now_ns();
+    total_checks_.fetch_add(1, std::memory_order_relaxed);
+    last_check_ns_.store(now, std::memory_order_relaxed);
+    
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(order.instrument_id, table);
+    TradingRuleCheckResult result = evaluate(table, index, order.quantity, order.price, config_mask());
     
-    return TradingRuleCheckResult::PASS;
+    if (result == TradingRuleCheckResult::PASS) {
+        passed_checks_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        record_rejection(order.instrument_id, result, order.quantity, order.price, now);
+    }
+    return result;
 }
 
 TradingRuleCheckResult TradingRuleChecker::check_symbol_status(const std::string& symbol, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时跳过符号状态检查
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
-    
-    if (!config_.enable_symbol_status_check) {
-        return TradingRuleCheckResult::PASS;
-    }
-    
-    // 暂时返回PASS，实际应用中需要实现符号状态检查
-    return TradingRuleCheckResult::PASS;
+    (void)is_futures;
+    return run_check(symbol, 1.0, 0.0, config_mask() & CHECK_SYMBOL_STATUS);
 }
 
 TradingRuleCheckResult TradingRuleChecker::check_quantity_rules(const std::string& symbol, double quantity, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时跳过数量规则检查
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
-    
-    if (!config_.enable_quantity_check) {
-        return TradingRuleCheckResult::PASS;
-    }
-    
-    // 基本的数量检查
-    if (quantity <= 0) {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
-        statistics_.rejected_checks++;
-        statistics_.quantity_violations++;
-        statistics_.last_violation_time = std::chrono::high_resolution_clock::now();
-        
-        if (config_.log_violations) {
-            TradingRuleEvent event;
-            event.event_id = generate_event_id();
-            event.instrument_id = symbol;
-            event.result = TradingRuleCheckResult::REJECT_QUANTITY_TOO_SMALL;
-            event.description = "Quantity " + std::to_string(quantity) + " must be positive";
-            event.timestamp = std::chrono::high_resolution_clock::now();
-            log_trading_rule_event(event);
-        }
-        
-        return TradingRuleCheckResult::REJECT_QUANTITY_TOO_SMALL;
-    }
-    
-    // 暂时返回PASS，实际应用中需要实现完整的数量规则检查
-    return TradingRuleCheckResult::PASS;
+    (void)is_futures;
+    return run_check(symbol, quantity, 0.0, config_mask() & (CHECK_QUANTITY | CHECK_PRECISION));
 }
 
 TradingRuleCheckResult TradingRuleChecker::check_price_rules(const std::string& symbol, double price, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时跳过价格规则检查
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
-    
-    if (!config_.enable_price_check) {
-        return TradingRuleCheckResult::PASS;
-    }
+    (void)is_futures;
     
-    // 基本的价格检查
-    if (price <= 0) {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
-        statistics_.rejected_checks++;
-        statistics_.price_violations++;
-        statistics_.last_violation_time = std::chrono::high_resolution_clock::now();
-        
-        if (config_.log_violations) {
-            TradingRuleEvent event;
-            event.event_id = generate_event_id();
-            event.instrument_id = symbol;
-            event.result = TradingRuleCheckResult::REJECT_PRICE_TOO_LOW;
-            event.description = "Price " + std::to_string(price) + " must be positive";
-            event.timestamp = std::chrono::high_resolution_clock::now();
-            log_trading_rule_event(event);
-        }
-        
+    uint32_t mask = config_mask() & (CHECK_PRICE | CHECK_PRECISION);
+    if ((mask & CHECK_PRICE) && price == 0.0) {
+        // 单独检查价格时0也视为无效价格
+        record_rejection(symbol, TradingRuleCheckResult::REJECT_PRICE_TOO_LOW, 0.0, price, now_ns());
         return TradingRuleCheckResult::REJECT_PRICE_TOO_LOW;
     }
     
-    // 暂时返回PASS，实际应用中需要实现完整的价格规则检查
-    return TradingRuleCheckResult::PASS;
+    // 精度检查项同时包含数量步长位，这里没有真实数量，屏蔽该位，只做价格检查
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(symbol, table);
+    uint32_t bit_mask = effective_bit_mask(table, mask) & ~(1u << BIT_QUANTITY_PRECISION);
+    TradingRuleCheckResult result = result_from_bits(evaluate_one(table, index, 1.0, price) & bit_mask);
+    if (result != TradingRuleCheckResult::PASS) {
+        record_rejection(symbol, result, 0.0, price, now_ns());
+    }
+    return result;
 }
 
 TradingRuleCheckResult TradingRuleChecker::check_min_notional(const std::string& symbol, double quantity, double price, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时跳过最小名义价值检查
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
-    
-    if (!config_.enable_min_notional_check) {
-        return TradingRuleCheckResult::PASS;
-    }
-    
-    // 基本的名义价值检查
-    double notional = quantity * price;
-    if (notional <= 0) {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
-        statistics_.rejected_checks++;
-        statistics_.min_notional_violations++;
-        statistics_.last_violation_time = std::chrono::high_resolution_clock::now();
-        
-        if (config_.log_violations) {
-            TradingRuleEvent event;
-            event.event_id = generate_event_id();
-            event.instrument_id = symbol;
-            event.result = TradingRuleCheckResult::REJECT_MIN_NOTIONAL;
-            event.description = "Notional value " + std::to_string(notional) + " must be positive";
-            event.timestamp = std::chrono::high_resolution_clock::now();
-            log_trading_rule_event(event);
-        }
-        
-        return TradingRuleCheckResult::REJECT_MIN_NOTIONAL;
-    }
-    
-    // 暂时返回PASS，实际应用中需要实现完整的最小名义价值检查
-    return TradingRuleCheckResult::PASS;
+    (void)is_futures;
+    return run_check(symbol, quantity, price, config_mask() & CHECK_MIN_NOTIONAL);
 }
 
 TradingRuleCheckResult TradingRuleChecker::check_twap_slice(const std::string& symbol, double slice_quantity, double price, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时跳过TWAP切片检查
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
+    (void)is_futures;
     
     // 基本的切片检查
-    if (slice_quantity <= 0) {
+    if (!(slice_quantity > 0)) {
         return TradingRuleCheckResult::REJECT_QUANTITY_TOO_SMALL;
     }
     
-    if (price <= 0) {
+    if (!(price > 0)) {
         return TradingRuleCheckResult::REJECT_PRICE_TOO_LOW;
     }
     
-    // 暂时返回PASS，实际应用中需要实现完整的TWAP切片检查
-    return TradingRuleCheckResult::PASS;
+    // 拆单前只检查交易对状态，数量/价格精度在拆分后由fix_*_precision修正
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(symbol, table);
+    return evaluate(table, index, slice_quantity, price, config_mask() & CHECK_SYMBOL_STATUS);
+}
+
+size_t TradingRuleChecker::check_batch(TradingRuleBatch& batch)
+{
+    size_t count = batch.size();
+    batch.results.resize(count);
+    if (!initialized_.load()) {
+        std::fill(batch.results.begin(), batch.results.end(), TradingRuleCheckResult::REJECT_SYSTEM_ERROR);
+        return 0;
+    }
+    
+    size_t passed = evaluate_batch(batch.table, batch.rule_indices.data(), batch.quantities.data(),
+                                   batch.prices.data(), count, config_mask(), batch.results.data());
+    
+    // 统计整批汇总后各加一次
+    int64_t now = now_ns();
+    total_checks_.fetch_add(count, std::memory_order_relaxed);
+    passed_checks_.fetch_add(passed, std::memory_order_relaxed);
+    last_check_ns_.store(now, std::memory_order_relaxed);
+    
+    if (passed != count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (batch.results[i] != TradingRuleCheckResult::PASS) {
+                std::string symbol = batch.table && batch.rule_indices[i] >= 0
+                                     ? std::string(batch.table->symbol(batch.rule_indices[i]))
+                                     : std::string();
+                record_rejection(symbol, batch.results[i], batch.quantities[i], batch.prices[i], now);
+            }
+        }
+    }
+    return passed;
 }
 
 double TradingRuleChecker::fix_quantity_precision(const std::string& symbol, double quantity, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时返回原始数量
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
+    (void)is_futures;
+    
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(symbol, table);
+    if (index == TradingRuleTable::NOT_FOUND || table->step_size(index) <= 0) {
+        return quantity;
+    }
     
-    return quantity;
+    // 向下取整到stepSize，加少量epsilon抵消二进制浮点误差
+    double step = table->step_size(index);
+    return std::floor(quantity / step + 1e-9) * step;
 }
 
 double TradingRuleChecker::fix_price_precision(const std::string& symbol, double price, bool is_futures)
 {
-    // 由于get_symbol_info返回nullptr，暂时返回原始价格
-    // 在实际部署时需要实现符号信息获取功能
-    (void)symbol;      // 避免未使用参数警告
-    (void)is_futures;  // 避免未使用参数警告
+    (void)is_futures;
     
-    return price;
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(symbol, table);
+    if (index == TradingRuleTable::NOT_FOUND || table->tick_size(index) <= 0) {
+        return price;
+    }
+    
+    double tick = table->tick_size(index);
+    return std::round(price / tick) * tick;
 }
 
 void TradingRuleChecker::set_binance_client(std::shared_ptr<trading::BinanceWebSocket> client)
@@ -293,6 +459,8 @@ void TradingRuleChecker::set_config(const Config& config)
 {
     std::lock_guard<std::mutex> lock(config_mutex_);
     config_ = config;
+    check_mask_.store(check_mask_from_config(config), std::memory_order_relaxed);
+    log_violations_.store(config.log_violations, std::memory_order_relaxed);
 }
 
 TradingRuleChecker::Config TradingRuleChecker::get_config() const
@@ -315,8 +483,22 @@ TradingRuleLimits TradingRuleChecker::get_limits() const
 
 TradingRuleStatistics TradingRuleChecker::get_statistics() const
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
-    return statistics_;
+    using clock = std::chrono::high_resolution_clock;
+    
+    TradingRuleStatistics stats;
+    stats.total_checks = total_checks_.load(std::memory_order_relaxed);
+    stats.passed_checks = passed_checks_.load(std::memory_order_relaxed);
+    stats.rejected_checks = rejected_checks_.load(std::memory_order_relaxed);
+    stats.symbol_not_trading_violations = violations_[VIOLATION_SYMBOL].load(std::memory_order_relaxed);
+    stats.quantity_violations = violations_[VIOLATION_QUANTITY].load(std::memory_order_relaxed);
+    stats.price_violations = violations_[VIOLATION_PRICE].load(std::memory_order_relaxed);
+    stats.precision_violations = violations_[VIOLATION_PRECISION].load(std::memory_order_relaxed);
+    stats.min_notional_violations = violations_[VIOLATION_MIN_NOTIONAL].load(std::memory_order_relaxed);
+    stats.last_check_time = clock::time_point(std::chrono::duration_cast<clock::duration>(
+        std::chrono::nanoseconds(last_check_ns_.load(std::memory_order_relaxed))));
+    stats.last_violation_time = clock::time_point(std::chrono::duration_cast<clock::duration>(
+        std::chrono::nanoseconds(last_violation_ns_.load(std::memory_order_relaxed))));
+    return stats;
 }
 
 std::vector<TradingRuleEvent> TradingRuleChecker::get_recent_events(uint32_t count) const
@@ -336,7 +518,7 @@ std::vector<TradingRuleEvent> TradingRuleChecker::get_recent_events(uint32_t cou
     return result;
 }
 
-std::string TradingRuleChecker::get_trading_rule_result_description(TradingRuleCheckResult result) const
+std::string TradingRuleChecker::get_trading_rule_result_description(TradingRuleCheckResult result)
 {
     switch (result) {
         case TradingRuleCheckResult::PASS:
@@ -394,22 +576,79 @@ void TradingRuleChecker::log_trading_rule_event(const TradingRuleEvent& event)
     }
     
     // 可选：输出到日志
-    if (config_.log_violations) {
+    if (log_violations_.load(std::memory_order_relaxed)) {
         std::cout << "[TradingRule] " << event.event_id << " - " 
                   << event.instrument_id << ": " << event.description << std::endl;
     }
 }
 
-const void* TradingRuleChecker::get_symbol_info(const std::string& symbol, bool is_futures) const
+int32_t TradingRuleChecker::find_symbol_rule(const std::string& symbol, TradingRuleTablePtr& table) const
 {
-    std::lock_guard<std::mutex> lock(binance_client_mutex_);
-    if (!binance_client_) {
-        return nullptr;
+    // 取当前规则表指针，只在本次检查内使用；注册表保留最近若干版本，刷新线程替换规则表不会释放正在使用的表
+    table = TradingRuleRegistry::getInstance().current();
+    if (!table) {
+        return TradingRuleTable::NOT_FOUND;
     }
-    
-    // BinanceWebSocket doesn't have getSymbolInfo method, return nullptr for now
-    // This functionality needs to be implemented in the gateway
-    return nullptr;
+    return table->find(symbol);
+}
+
+uint32_t TradingRuleChecker::config_mask() const
+{
+    return check_mask_.load(std::memory_order_relaxed);
+}
+
+TradingRuleCheckResult TradingRuleChecker::run_check(const std::string& symbol, double quantity, double price, uint32_t mask)
+{
+    TradingRuleTablePtr table;
+    int32_t index = find_symbol_rule(symbol, table);
+    TradingRuleCheckResult result = evaluate(table, index, quantity, price, mask);
+    if (result != TradingRuleCheckResult::PASS) {
+        record_rejection(symbol, result, quantity, price, now_ns());
+    }
+    return result;
+}
+
+void TradingRuleChecker::record_rejection(const std::string& symbol, TradingRuleCheckResult result,
+                                          double quantity, double price, int64_t now)
+{
+    rejected_checks_.fetch_add(1, std::memory_order_relaxed);
+    violations_[violation_category(result)].fetch_add(1, std::memory_order_relaxed);
+    last_violation_ns_.store(now, std::memory_order_relaxed);
+    
+    if (log_violations_.load(std::memory_order_relaxed)) {
+        TradingRuleEvent event;
+        event.event_id = generate_event_id();
+        event.instrument_id = symbol;
+        event.result = result;
+        event.description = get_trading_rule_result_description(result) + " (quantity " + std::to_string(quantity)
+                            + ", price " + std::to_string(price) + ")";
+        log_trading_rule_event(event);
+    }
+}
+
+TradingRuleChecker::ViolationCategory TradingRuleChecker::violation_category(TradingRuleCheckResult result)
+{
+    switch (result) {
+        case TradingRuleCheckResult::REJECT_SYMBOL_NOT_TRADING:
+        case TradingRuleCheckResult::REJECT_SYMBOL_NOT_FOUND:
+            return VIOLATION_SYMBOL;
+        case TradingRuleCheckResult::REJECT_QUANTITY_TOO_SMALL:
+        case TradingRuleCheckResult::REJECT_QUANTITY_TOO_LARGE:
+            return VIOLATION_QUANTITY;
+        case TradingRuleCheckResult::REJECT_QUANTITY_PRECISION:
+        case TradingRuleCheckResult::REJECT_PRICE_PRECISION:
+            return VIOLATION_PRECISION;
+        case TradingRuleCheckResult::REJECT_MIN_NOTIONAL:
+            return VIOLATION_MIN_NOTIONAL;
+        default:
+            return VIOLATION_PRICE;
+    }
+}
+
+int64_t TradingRuleChecker::now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
 }
 
 } // namespace execution
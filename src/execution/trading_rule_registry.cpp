@@ -0,0 +1,259 @@
+#include "execution/trading_rule_registry.h"
+#include <ixwebsocket/IXHttpClient.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+inline uint64_t current_time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+inline void fnv1a64_update(uint64_t& hash, const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+}
+
+// 只对解析出的规则字段求哈希：exchangeInfo响应里的serverTime等字段每次都变，不能按原文比较
+uint64_t rules_hash(const std::vector<SymbolRule>& rules) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const SymbolRule& rule : rules) {
+        fnv1a64_update(hash, rule.symbol.data(), rule.symbol.size() + 1);
+        int32_t status = static_cast<int32_t>(rule.status);
+        fnv1a64_update(hash, &status, sizeof(status));
+        fnv1a64_update(hash, &rule.quantity_precision, sizeof(rule.quantity_precision));
+        fnv1a64_update(hash, &rule.price_precision, sizeof(rule.price_precision));
+        fnv1a64_update(hash, &rule.min_qty, sizeof(rule.min_qty));
+        fnv1a64_update(hash, &rule.max_qty, sizeof(rule.max_qty));
+        fnv1a64_update(hash, &rule.step_size, sizeof(rule.step_size));
+        fnv1a64_update(hash, &rule.tick_size, sizeof(rule.tick_size));
+        fnv1a64_update(hash, &rule.min_notional, sizeof(rule.min_notional));
+    }
+    return hash;
+}
+
+inline bool is_http_source(const std::string& source) {
+    return source.compare(0, 7, "http://") == 0 || source.compare(0, 8, "https://") == 0;
+}
+
+} // namespace
+
+// TradingRuleRegistry 实现
+TradingRuleRegistry& TradingRuleRegistry::getInstance()
+{
+    static TradingRuleRegistry instance;
+    return instance;
+}
+
+TradingRuleRegistry::TradingRuleRegistry()
+    : current_(nullptr)
+    , version_(0)
+{
+}
+
+TradingRuleRegistry::~TradingRuleRegistry()
+{
+}
+
+void TradingRuleRegistry::publish(std::unique_ptr<TradingRuleTable> table)
+{
+    if (!table) {
+        return;
+    }
+
+    // 新版本占用的槽位里是RETAINED_TABLES个版本之前的表，此时它早已不是当前表，
+    // 先释放它再放入新表，最后才发布指针，新进入的读者只会看到新表
+    std::lock_guard<std::mutex> lock(publish_mutex_);
+    uint64_t next_version = version_.load(std::memory_order_relaxed) + 1;
+    std::unique_ptr<const TradingRuleTable>& slot = retained_[next_version % RETAINED_TABLES];
+    slot = std::move(table);
+    current_.store(slot.get(), std::memory_order_release);
+    version_.store(next_version, std::memory_order_release);
+}
+
+// ExchangeRulesRefresher 实现
+ExchangeRulesRefresher::ExchangeRulesRefresher()
+    : running_(false)
+    , last_content_hash_(0)
+    , refresh_count_(0)
+    , unchanged_count_(0)
+    , failure_count_(0)
+    , last_success_ms_(0)
+    , last_build_us_(0)
+{
+}
+
+ExchangeRulesRefresher::~ExchangeRulesRefresher()
+{
+    stop();
+}
+
+bool ExchangeRulesRefresher::start(const Config& config)
+{
+    if (running_.load()) {
+        return true;
+    }
+    if (config.source.empty() || config.refresh_interval.count() <= 0) {
+        std::cerr << "[ExchangeRulesRefresher] Invalid config: source or refresh interval not set" << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        config_ = config;
+    }
+
+    running_.store(true);
+    refresh_thread_.reset(new std::thread(&ExchangeRulesRefresher::refresh_worker, this));
+
+    std::cout << "[ExchangeRulesRefresher] Started, source: " << config.source
+              << ", interval: " << config.refresh_interval.count() << "ms" << std::endl;
+    return true;
+}
+
+void ExchangeRulesRefresher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    wake_cv_.notify_all();
+
+    if (refresh_thread_ && refresh_thread_->joinable()) {
+        refresh_thread_->join();
+    }
+    refresh_thread_.reset();
+}
+
+bool ExchangeRulesRefresher::refresh_now()
+{
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+
+    std::string body;
+    if (!fetch(body)) {
+        failure_count_.fetch_add(1);
+        return false;
+    }
+
+    auto build_start = std::chrono::steady_clock::now();
+    std::vector<SymbolRule> rules;
+    if (!TradingRuleTable::parse_exchange_info(body, rules) || rules.empty()) {
+        std::cerr << "[ExchangeRulesRefresher] Failed to parse exchange info from " << config_.source << std::endl;
+        failure_count_.fetch_add(1);
+        return false;
+    }
+
+    uint64_t content_hash = rules_hash(rules);
+    if (content_hash == last_content_hash_ && TradingRuleRegistry::getInstance().current()) {
+        unchanged_count_.fetch_add(1);
+        last_success_ms_.store(current_time_ms());
+        return true;
+    }
+
+    std::unique_ptr<TradingRuleTable> table = TradingRuleTable::build(rules);
+    if (!table) {
+        std::cerr << "[ExchangeRulesRefresher] Failed to build trading rule table" << std::endl;
+        failure_count_.fetch_add(1);
+        return false;
+    }
+    last_build_us_.store(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - build_start).count());
+
+    // 落盘在发布前完成，发布后表只读，写快照不影响读者
+    if (!config_.snapshot_path.empty() && !table->save_snapshot(config_.snapshot_path)) {
+        std::cerr << "[ExchangeRulesRefresher] Failed to save snapshot: " << config_.snapshot_path << std::endl;
+    }
+    if (!config_.json_path.empty() && config_.json_path != config_.source) {
+        std::ofstream file(config_.json_path, std::ios::binary);
+        if (file.is_open()) {
+            file.write(body.data(), body.size());
+        }
+    }
+
+    size_t symbol_count = table->size();
+    TradingRuleRegistry::getInstance().publish(std::move(table));
+    last_content_hash_ = content_hash;
+    refresh_count_.fetch_add(1);
+    last_success_ms_.store(current_time_ms());
+
+    std::cout << "[ExchangeRulesRefresher] Published " << symbol_count << " trading rules (version "
+              << TradingRuleRegistry::getInstance().version() << ", build "
+              << last_build_us_.load() << "us)" << std::endl;
+    return true;
+}
+
+ExchangeRulesRefreshStatistics ExchangeRulesRefresher::get_statistics() const
+{
+    ExchangeRulesRefreshStatistics stats;
+    stats.refresh_count = refresh_count_.load();
+    stats.unchanged_count = unchanged_count_.load();
+    stats.failure_count = failure_count_.load();
+    stats.last_success_ms = last_success_ms_.load();
+    stats.last_build_us = last_build_us_.load();
+    TradingRuleTablePtr table = TradingRuleRegistry::getInstance().current();
+    stats.symbol_count = table ? table->size() : 0;
+    return stats;
+}
+
+void ExchangeRulesRefresher::refresh_worker()
+{
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait_for(lock, config_.refresh_interval, [this] { return !running_.load(); });
+        }
+        if (!running_.load()) {
+            break;
+        }
+
+        try {
+            refresh_now();
+        } catch (const std::exception& e) {
+            failure_count_.fetch_add(1);
+            std::cerr << "[ExchangeRulesRefresher] Exception in refresh: " << e.what() << std::endl;
+        }
+    }
+}
+
+bool ExchangeRulesRefresher::fetch(std::string& body) const
+{
+    if (is_http_source(config_.source)) {
+        ix::HttpClient http_client;
+        ix::HttpRequestArgsPtr args = http_client.createRequest();
+        if (!config_.api_key.empty()) {
+            args->extraHeaders["X-MBX-APIKEY"] = config_.api_key;
+        }
+        args->connectTimeout = config_.http_timeout_s;
+        args->transferTimeout = config_.http_timeout_s;
+
+        ix::HttpResponsePtr response = http_client.get(config_.source, args);
+        if (!response || response->statusCode != 200) {
+            std::cerr << "[ExchangeRulesRefresher] HTTP request failed with status: "
+                      << (response ? response->statusCode : -1) << std::endl;
+            return false;
+        }
+        body = std::move(response->body);
+        return !body.empty();
+    }
+
+    std::ifstream file(config_.source, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[ExchangeRulesRefresher] Failed to open exchange info file: " << config_.source << std::endl;
+        return false;
+    }
+    body.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !body.empty();
+}
+
+} // namespace execution
+} // namespace tes
@@ -0,0 +1,461 @@
+#include "execution/trading_rule_table.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tes {
+namespace execution {
+
+namespace {
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x31545254;   // "TRT1"
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+constexpr uint32_t MAX_DISPLACEMENT = 1u << 20;
+
+inline uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+inline uint64_t current_time_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+// 快照文件头，各段偏移量相对文件起始且按8字节对齐
+struct TradingRuleTable::SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t created_ms;
+    uint64_t total_size;
+    uint32_t count;
+    uint32_t bucket_count;
+    uint32_t slot_count;
+    uint32_t reserved;
+    uint64_t displacements_offset;
+    uint64_t slots_offset;
+    uint64_t symbols_offset;
+    uint64_t min_qty_offset;
+    uint64_t max_qty_offset;
+    uint64_t step_size_offset;
+    uint64_t tick_size_offset;
+    uint64_t min_notional_offset;
+    uint64_t quantity_precision_offset;
+    uint64_t price_precision_offset;
+    uint64_t status_offset;
+};
+
+TradingRuleTable::TradingRuleTable()
+    : mapped_(nullptr)
+    , mapped_size_(0)
+    , header_(nullptr)
+    , displacements_(nullptr)
+    , slots_(nullptr)
+    , symbols_(nullptr)
+    , min_qty_(nullptr)
+    , max_qty_(nullptr)
+    , step_size_(nullptr)
+    , tick_size_(nullptr)
+    , min_notional_(nullptr)
+    , quantity_precision_(nullptr)
+    , price_precision_(nullptr)
+    , status_(nullptr)
+    , count_(0)
+    , bucket_count_(0)
+    , slot_count_(0) {
+}
+
+TradingRuleTable::~TradingRuleTable() {
+    if (mapped_) {
+        munmap(mapped_, mapped_size_);
+    }
+}
+
+uint64_t TradingRuleTable::hash_symbol(std::string_view symbol) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : symbol) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint32_t TradingRuleTable::slot_for(uint64_t hash, uint32_t displacement, uint32_t slot_count) {
+    return static_cast<uint32_t>(mix64(hash + displacement * 0x9e3779b97f4a7c15ULL) % slot_count);
+}
+
+std::unique_ptr<TradingRuleTable> TradingRuleTable::build(const std::vector<SymbolRule>& rules, uint64_t created_ms) {
+    // 过滤非法和重复的交易对
+    std::vector<const SymbolRule*> entries;
+    entries.reserve(rules.size());
+    {
+        std::vector<std::string_view> seen;
+        seen.reserve(rules.size());
+        for (const auto& rule : rules) {
+            if (rule.symbol.empty() || rule.symbol.size() >= MAX_SYMBOL_LENGTH) {
+                std::cerr << "Skipping invalid symbol in trading rules: " << rule.symbol << std::endl;
+                continue;
+            }
+            seen.push_back(rule.symbol);
+            entries.push_back(&rule);
+        }
+        std::vector<size_t> order(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return seen[a] < seen[b]; });
+        std::vector<const SymbolRule*> unique;
+        unique.reserve(entries.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            if (i > 0 && seen[order[i]] == seen[order[i - 1]]) {
+                unique.back() = entries[order[i]];  // 重复时保留后出现的规则
+                continue;
+            }
+            unique.push_back(entries[order[i]]);
+        }
+        entries.swap(unique);
+    }
+
+    const uint32_t count = static_cast<uint32_t>(entries.size());
+    std::vector<uint64_t> hashes(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        hashes[i] = hash_symbol(entries[i]->symbol);
+    }
+
+    // hash-and-displace：按桶从大到小为每个桶寻找无冲突的位移
+    uint32_t bucket_count = std::max<uint32_t>(1, count / 4 + 1);
+    uint32_t slot_count = std::max<uint32_t>(1, count + count / 4 + 1);
+    std::vector<uint32_t> displacements;
+    std::vector<uint32_t> slots;
+
+    for (int attempt = 0; ; ++attempt) {
+        std::vector<std::vector<uint32_t>> buckets(bucket_count);
+        for (uint32_t i = 0; i < count; ++i) {
+            buckets[(hashes[i] >> 32) % bucket_count].push_back(i);
+        }
+        std::vector<uint32_t> bucket_order(bucket_count);
+        for (uint32_t b = 0; b < bucket_count; ++b) bucket_order[b] = b;
+        std::sort(bucket_order.begin(), bucket_order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        displacements.assign(bucket_count, 0);
+        slots.assign(slot_count, EMPTY_SLOT);
+        bool ok = true;
+        std::vector<uint32_t> candidate;
+
+        for (uint32_t b : bucket_order) {
+            const auto& members = buckets[b];
+            if (members.empty()) break;
+
+            bool placed = false;
+            for (uint32_t d = 0; d < MAX_DISPLACEMENT && !placed; ++d) {
+                candidate.clear();
+                placed = true;
+                for (uint32_t idx : members) {
+                    uint32_t slot = slot_for(hashes[idx], d, slot_count);
+                    if (slots[slot] != EMPTY_SLOT ||
+                        std::find(candidate.begin(), candidate.end(), slot) != candidate.end()) {
+                        placed = false;
+                        break;
+                    }
+                    candidate.push_back(slot);
+                }
+                if (placed) {
+                    displacements[b] = d;
+                    for (size_t k = 0; k < members.size(); ++k) {
+                        slots[candidate[k]] = members[k];
+                    }
+                }
+            }
+            if (!placed) {
+                ok = false;
+                break;
+            }
+        }
+
+        if (ok) break;
+        if (attempt >= 8) {
+            std::cerr << "Failed to build perfect hash for trading rules" << std::endl;
+            return nullptr;
+        }
+        // 放宽负载因子后重试
+        slot_count = slot_count + slot_count / 2 + 1;
+    }
+
+    // 计算布局
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.created_ms = created_ms ? created_ms : current_time_ms();
+    header.count = count;
+    header.bucket_count = bucket_count;
+    header.slot_count = slot_count;
+
+    uint64_t offset = align8(sizeof(SnapshotHeader));
+    header.displacements_offset = offset;       offset = align8(offset + sizeof(uint32_t) * bucket_count);
+    header.slots_offset = offset;               offset = align8(offset + sizeof(uint32_t) * slot_count);
+    header.symbols_offset = offset;             offset = align8(offset + MAX_SYMBOL_LENGTH * count);
+    header.min_qty_offset = offset;             offset = align8(offset + sizeof(double) * count);
+    header.max_qty_offset = offset;             offset = align8(offset + sizeof(double) * count);
+    header.step_size_offset = offset;           offset = align8(offset + sizeof(double) * count);
+    header.tick_size_offset = offset;           offset = align8(offset + sizeof(double) * count);
+    header.min_notional_offset = offset;        offset = align8(offset + sizeof(double) * count);
+    header.quantity_precision_offset = offset;  offset = align8(offset + sizeof(int32_t) * count);
+    header.price_precision_offset = offset;     offset = align8(offset + sizeof(int32_t) * count);
+    header.status_offset = offset;              offset = align8(offset + sizeof(uint8_t) * count);
+    header.total_size = offset;
+
+    std::unique_ptr<TradingRuleTable> table(new TradingRuleTable());
+    table->storage_.assign(header.total_size, 0);
+    uint8_t* base = table->storage_.data();
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base + header.displacements_offset, displacements.data(), sizeof(uint32_t) * bucket_count);
+    std::memcpy(base + header.slots_offset, slots.data(), sizeof(uint32_t) * slot_count);
+
+    auto* symbols = reinterpret_cast<char*>(base + header.symbols_offset);
+    auto* min_qty = reinterpret_cast<double*>(base + header.min_qty_offset);
+    auto* max_qty = reinterpret_cast<double*>(base + header.max_qty_offset);
+    auto* step_size = reinterpret_cast<double*>(base + header.step_size_offset);
+    auto* tick_size = reinterpret_cast<double*>(base + header.tick_size_offset);
+    auto* min_notional = reinterpret_cast<double*>(base + header.min_notional_offset);
+    auto* quantity_precision = reinterpret_cast<int32_t*>(base + header.quantity_precision_offset);
+    auto* price_precision = reinterpret_cast<int32_t*>(base + header.price_precision_offset);
+    auto* status = base + header.status_offset;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const SymbolRule& rule = *entries[i];
+        std::memcpy(symbols + i * MAX_SYMBOL_LENGTH, rule.symbol.data(), rule.symbol.size());
+        min_qty[i] = rule.min_qty;
+        max_qty[i] = rule.max_qty;
+        step_size[i] = rule.step_size;
+        tick_size[i] = rule.tick_size;
+        min_notional[i] = rule.min_notional;
+        quantity_precision[i] = rule.quantity_precision;
+        price_precision[i] = rule.price_precision;
+        status[i] = static_cast<uint8_t>(rule.status);
+    }
+
+    if (!table->bind(base, table->storage_.size())) {
+        return nullptr;
+    }
+    return table;
+}
+
+bool TradingRuleTable::bind(const uint8_t* data, size_t size) {
+    if (size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+    const auto* header = reinterpret_cast<const SnapshotHeader*>(data);
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION ||
+        header->total_size != size || header->slot_count == 0 || header->bucket_count == 0) {
+        return false;
+    }
+
+    // 校验各段均落在文件范围内
+    auto in_range = [&](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+    };
+    const uint64_t n = header->count;
+    if (!in_range(header->displacements_offset, sizeof(uint32_t) * header->bucket_count) ||
+        !in_range(header->slots_offset, sizeof(uint32_t) * header->slot_count) ||
+        !in_range(header->symbols_offset, MAX_SYMBOL_LENGTH * n) ||
+        !in_range(header->min_qty_offset, sizeof(double) * n) ||
+        !in_range(header->max_qty_offset, sizeof(double) * n) ||
+        !in_range(header->step_size_offset, sizeof(double) * n) ||
+        !in_range(header->tick_size_offset, sizeof(double) * n) ||
+        !in_range(header->min_notional_offset, sizeof(double) * n) ||
+        !in_range(header->quantity_precision_offset, sizeof(int32_t) * n) ||
+        !in_range(header->price_precision_offset, sizeof(int32_t) * n) ||
+        !in_range(header->status_offset, n)) {
+        return false;
+    }
+
+    header_ = header;
+    count_ = header->count;
+    bucket_count_ = header->bucket_count;
+    slot_count_ = header->slot_count;
+    displacements_ = reinterpret_cast<const uint32_t*>(data + header->displacements_offset);
+    slots_ = reinterpret_cast<const uint32_t*>(data + header->slots_offset);
+    symbols_ = reinterpret_cast<const char*>(data + header->symbols_offset);
+    min_qty_ = reinterpret_cast<const double*>(data + header->min_qty_offset);
+    max_qty_ = reinterpret_cast<const double*>(data + header->max_qty_offset);
+    step_size_ = reinterpret_cast<const double*>(data + header->step_size_offset);
+    tick_size_ = reinterpret_cast<const double*>(data + header->tick_size_offset);
+    min_notional_ = reinterpret_cast<const double*>(data + header->min_notional_offset);
+    quantity_precision_ = reinterpret_cast<const int32_t*>(data + header->quantity_precision_offset);
+    price_precision_ = reinterpret_cast<const int32_t*>(data + header->price_precision_offset);
+    status_ = data + header->status_offset;
+
+    // 槽位中的下标必须有效
+    for (uint32_t i = 0; i < slot_count_; ++i) {
+        if (slots_[i] != EMPTY_SLOT && slots_[i] >= count_) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int32_t TradingRuleTable::find(std::string_view symbol) const {
+    if (count_ == 0 || symbol.empty() || symbol.size() >= MAX_SYMBOL_LENGTH) {
+        return NOT_FOUND;
+    }
+    uint64_t hash = hash_symbol(symbol);
+    uint32_t displacement = displacements_[(hash >> 32) % bucket_count_];
+    uint32_t index = slots_[slot_for(hash, displacement, slot_count_)];
+    if (index == EMPTY_SLOT) {
+        return NOT_FOUND;
+    }
+    // 完美哈希只保证已知交易对无冲突，未知交易对需比对名称
+    const char* stored = symbols_ + static_cast<size_t>(index) * MAX_SYMBOL_LENGTH;
+    if (stored[symbol.size()] != '\0' || std::memcmp(stored, symbol.data(), symbol.size()) != 0) {
+        return NOT_FOUND;
+    }
+    return static_cast<int32_t>(index);
+}
+
+uint64_t TradingRuleTable::created_ms() const {
+    return header_ ? header_->created_ms : 0;
+}
+
+std::string_view TradingRuleTable::symbol(int32_t index) const {
+    const char* stored = symbols_ + static_cast<size_t>(index) * MAX_SYMBOL_LENGTH;
+    return std::string_view(stored, strnlen(stored, MAX_SYMBOL_LENGTH));
+}
+
+SymbolRule TradingRuleTable::rule(int32_t index) const {
+    SymbolRule rule;
+    rule.symbol = std::string(symbol(index));
+    rule.status = status(index);
+    rule.quantity_precision = quantity_precision_[index];
+    rule.price_precision = price_precision_[index];
+    rule.min_qty = min_qty_[index];
+    rule.max_qty = max_qty_[index];
+    rule.step_size = step_size_[index];
+    rule.tick_size = tick_size_[index];
+    rule.min_notional = min_notional_[index];
+    return rule;
+}
+
+std::unique_ptr<TradingRuleTable> TradingRuleTable::load_snapshot(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        std::cerr << "Failed to mmap trading rule snapshot: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<TradingRuleTable> table(new TradingRuleTable());
+    table->mapped_ = addr;
+    table->mapped_size_ = st.st_size;
+    if (!table->bind(static_cast<const uint8_t*>(addr), st.st_size)) {
+        std::cerr << "Invalid trading rule snapshot: " << path << std::endl;
+        return nullptr;
+    }
+    return table;
+}
+
+bool TradingRuleTable::save_snapshot(const std::string& path) const {
+    const uint8_t* data = storage_.empty() ? static_cast<const uint8_t*>(mapped_) : storage_.data();
+    size_t size = storage_.empty() ? mapped_size_ : storage_.size();
+    if (!data || size == 0) {
+        return false;
+    }
+
+    std::string tmp_path = path + ".tmp";
+    FILE* file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Failed to open trading rule snapshot for writing: " << tmp_path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(data, 1, size, file) == size;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write trading rule snapshot: " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool TradingRuleTable::parse_exchange_info(const std::string& json_data, std::vector<SymbolRule>& rules) {
+    try {
+        nlohmann::json exchange_info = nlohmann::json::parse(json_data);
+
+        if (!exchange_info.contains("symbols") || !exchange_info["symbols"].is_array()) {
+            std::cerr << "Invalid exchange info format: missing symbols array" << std::endl;
+            return false;
+        }
+
+        rules.clear();
+        rules.reserve(exchange_info["symbols"].size());
+
+        for (const auto& symbol_info : exchange_info["symbols"]) {
+            if (!symbol_info.contains("symbol") || !symbol_info.contains("filters")) {
+                continue;
+            }
+
+            SymbolRule rule;
+            rule.symbol = symbol_info["symbol"].get<std::string>();
+            rule.quantity_precision = symbol_info.value("quantityPrecision", 0);
+            rule.price_precision = symbol_info.value("pricePrecision", 0);
+            rule.status = symbol_info.value("status", std::string()) == "TRADING"
+                ? SymbolTradingStatus::TRADING : SymbolTradingStatus::SUSPENDED;
+
+            // 解析过滤器
+            for (const auto& filter : symbol_info["filters"]) {
+                if (!filter.contains("filterType")) continue;
+
+                const std::string filter_type = filter["filterType"].get<std::string>();
+                if (filter_type == "LOT_SIZE") {
+                    rule.min_qty = std::stod(filter.value("minQty", "0"));
+                    rule.max_qty = std::stod(filter.value("maxQty", "0"));
+                    rule.step_size = std::stod(filter.value("stepSize", "0"));
+                } else if (filter_type == "PRICE_FILTER") {
+                    rule.tick_size = std::stod(filter.value("tickSize", "0"));
+                } else if (filter_type == "MIN_NOTIONAL") {
+                    rule.min_notional = std::stod(filter.value("notional", "0"));
+                }
+            }
+
+            rules.push_back(std::move(rule));
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Exception parsing exchange info: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // namespace execution
+} // namespace tes
@@ -1,5 +1,7 @@
 #include "execution/twap_algorithm.h"
+#include "execution/thread_accounting.h"
 #include "execution/order_manager.h"
+#include "shared_memory/core/tsc_clock.h"
 #include "common/common_types.h"
 #include <algorithm>
 #include <cmath>
@@ -53,8 +55,8 @@ bool TWAPAlgorithm::initialize()
         
         // 清理现有数据
         {
-            std::unique_lock<std::shared_mutex> executions_lock(executions_mutex_);
-            std::lock_guard<std::mutex> slices_lock(slices_mutex_);
+            std::unique_lock<NamedSharedMutex> executions_lock(executions_mutex_);
+            std::lock_guard<NamedMutex> slices_lock(slices_mutex_);
             executions_.clear();
             execution_slices_.clear();
             while (!scheduled_slices_.empty()) {
@@ -113,8 +115,8 @@ void TWAPAlgorithm::cleanup()
     stop();
     
     {
-        std::unique_lock<std::shared_mutex> executions_lock(executions_mutex_);
-        std::lock_guard<std::mutex> slices_lock(slices_mutex_);
+        std::unique_lock<NamedSharedMutex> executions_lock(executions_mutex_);
+        std::lock_guard<NamedMutex> slices_lock(slices_mutex_);
         executions_.clear();
         execution_slices_.clear();
         while (!scheduled_slices_.empty()) {
@@ -163,7 +165,7 @@ std::string TWAPAlgorithm::start_execution(const std::string& strategy_id,
     
     // 存储执行对象
     {
-        std::unique_lock<std::shared_mutex> lock(executions_mutex_);
+        std::unique_lock<NamedSharedMutex> lock(executions_mutex_);
         executions_[execution_id] = execution;
     }
     
@@ -175,7 +177,7 @@ std::string TWAPAlgorithm::start_execution(const std::string& strategy_id,
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.total_executions++;
         statistics_.last_execution_time = execution->start_time;
     }
@@ -191,7 +193,7 @@ bool TWAPAlgorithm::pause_execution(const std::string& execution_id)
     std::shared_ptr<AlgorithmExecution> execution;
     
     {
-        std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+        std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
         auto it = executions_.find(execution_id);
         if (it == executions_.end()) {
             return false;
@@ -214,7 +216,7 @@ bool TWAPAlgorithm::resume_execution(const std::string& execution_id)
     std::shared_ptr<AlgorithmExecution> execution;
     
     {
-        std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+        std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
         auto it = executions_.find(execution_id);
         if (it == executions_.end()) {
             return false;
@@ -238,7 +240,7 @@ bool TWAPAlgorithm::cancel_execution(const std::string& execution_id)
     std::shared_ptr<AlgorithmExecution> execution;
     
     {
-        std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+        std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
         auto it = executions_.find(execution_id);
         if (it == executions_.end()) {
             return false;
@@ -261,7 +263,7 @@ bool TWAPAlgorithm::cancel_execution(const std::string& execution_id)
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.cancelled_executions++;
     }
     
@@ -272,7 +274,7 @@ bool TWAPAlgorithm::cancel_execution(const std::string& execution_id)
 
 std::shared_ptr<AlgorithmExecution> TWAPAlgorithm::get_execution(const std::string& execution_id) const
 {
-    std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+    std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
     auto it = executions_.find(execution_id);
     return (it != executions_.end()) ? it->second : nullptr;
 }
@@ -282,7 +284,7 @@ std::vector<std::shared_ptr<AlgorithmExecution>> TWAPAlgorithm::get_executions_b
 {
     std::vector<std::shared_ptr<AlgorithmExecution>> result;
     
-    std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+    std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
     for (const auto& pair : executions_) {
         if (pair.second->strategy_id == strategy_id) {
             result.push_back(pair.second);
@@ -296,7 +298,7 @@ std::vector<std::shared_ptr<AlgorithmExecution>> TWAPAlgorithm::get_active_execu
 {
     std::vector<std::shared_ptr<AlgorithmExecution>> result;
     
-    std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+    std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
     for (const auto& pair : executions_) {
         if (pair.second->status == AlgorithmStatus::RUNNING ||
             pair.second->status == AlgorithmStatus::PAUSED) {
@@ -311,7 +313,7 @@ std::vector<std::shared_ptr<AlgorithmExecution>> TWAPAlgorithm::get_all_executio
 {
     std::vector<std::shared_ptr<AlgorithmExecution>> result;
     
-    std::shared_lock<std::shared_mutex> lock(executions_mutex_);
+    std::shared_lock<NamedSharedMutex> lock(executions_mutex_);
     for (const auto& pair : executions_) {
         result.push_back(pair.second);
     }
@@ -321,7 +323,7 @@ std::vector<std::shared_ptr<AlgorithmExecution>> TWAPAlgorithm::get_all_executio
 
 void TWAPAlgorithm::update_market_data(const execution::MarketData& market_data)
 {
-    std::unique_lock<std::shared_mutex> lock(market_data_mutex_);
+    std::unique_lock<NamedSharedMutex> lock(market_data_mutex_);
     market_data_cache_[market_data.instrument_id] = market_data;
 }
 
@@ -337,19 +339,19 @@ void TWAPAlgorithm::set_order_callback(TWAPOrderCallback callback)
 
 void TWAPAlgorithm::set_config(const Config& config)
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     config_ = config;
 }
 
 TWAPAlgorithm::Config TWAPAlgorithm::get_config() const
 {
-    std::lock_guard<std::mutex> lock(config_mutex_);
+    std::lock_guard<NamedMutex> lock(config_mutex_);
     return config_;
 }
 
 TWAPAlgorithm::Statistics TWAPAlgorithm::get_statistics() const
 {
-    std::lock_guard<std::mutex> lock(statistics_mutex_);
+    std::lock_guard<NamedMutex> lock(statistics_mutex_);
     return statistics_;
 }
 
@@ -400,14 +402,14 @@ void TWAPAlgorithm::calculate_slices(std::shared_ptr<AlgorithmExecution> executi
     }
     
     {
-        std::lock_guard<std::mutex> lock(slices_mutex_);
+        std::lock_guard<NamedMutex> lock(slices_mutex_);
         execution_slices_[execution->execution_id] = slices;
     }
 }
 
 void TWAPAlgorithm::schedule_next_slice(const std::string& execution_id)
 {
-    std::lock_guard<std::mutex> lock(slices_mutex_);
+    std::lock_guard<NamedMutex> lock(slices_mutex_);
     
     auto slices_it = execution_slices_.find(execution_id);
     if (slices_it == execution_slices_.end()) {
@@ -433,7 +435,7 @@ void TWAPAlgorithm::execute_slice(const std::string& execution_id, const Executi
     // 从缓存获取市场数据，而不是从MarketDataManager
     execution::MarketData market_data;
     {
-        std::shared_lock<std::shared_mutex> lock(market_data_mutex_);
+        std::shared_lock<NamedSharedMutex> lock(market_data_mutex_);
         auto it = market_data_cache_.find(execution->instrument_id);
         if (it != market_data_cache_.end()) {
             market_data = it->second;
@@ -488,7 +490,7 @@ void TWAPAlgorithm::execute_slice(const std::string& execution_id, const Executi
         
         // 标记切片为已执行
         {
-            std::lock_guard<std::mutex> lock(slices_mutex_);
+            std::lock_guard<NamedMutex> lock(slices_mutex_);
             auto slices_it = execution_slices_.find(execution_id);
             if (slices_it != execution_slices_.end()) {
                 for (auto& s : slices_it->second) {
@@ -504,7 +506,7 @@ void TWAPAlgorithm::execute_slice(const std::string& execution_id, const Executi
         // 通知订单事件 - 使用适当的Order对象
         if (gateway_adapter_) {
             // 为Gateway接口创建Order用于通知
-            Order notification_order;
+            Order notification_order(shared_memory::TscClock::instance().now());
             notification_order.order_id = order_id;
             notification_order.client_order_id = slice.slice_id;
             notification_order.instrument_id = execution->instrument_id;
@@ -517,7 +519,7 @@ void TWAPAlgorithm::execute_slice(const std::string& execution_id, const Executi
             notify_order_event(execution_id, notification_order);
         } else if (order_manager_) {
             // 使用已创建的order对象
-            Order notification_order;
+            Order notification_order(shared_memory::TscClock::instance().now());
             notification_order.order_id = order_id;
             notification_order.client_order_id = slice.slice_id;
             notification_order.instrument_id = execution->instrument_id;
@@ -573,7 +575,7 @@ void TWAPAlgorithm::complete_execution(const std::string& execution_id)
     
     // 更新统计信息
     {
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.completed_executions++;
         statistics_.total_volume_executed += execution->executed_quantity;
         
@@ -690,6 +692,8 @@ bool TWAPAlgorithm::should_adjust_execution(const std::shared_ptr<AlgorithmExecu
 
 void TWAPAlgorithm::execution_worker()
 {
+    ThreadAccounting::set_current_thread_name("tes-twap");
+
     while (running_.load()) {
         try {
             process_scheduled_slices();
@@ -711,7 +715,7 @@ void TWAPAlgorithm::process_scheduled_slices()
     std::vector<std::pair<std::string, ExecutionSlice>> slices_to_execute;
     
     {
-        std::lock_guard<std::mutex> lock(slices_mutex_);
+        std::lock_guard<NamedMutex> lock(slices_mutex_);
         
         while (!scheduled_slices_.empty() && scheduled_slices_.top().first <= now) {
             std::string execution_id = scheduled_slices_.top().second;
@@ -781,7 +785,7 @@ void TWAPAlgorithm::execute_slice_async(const std::string& execution_id, const E
         execute_slice(execution_id, slice);
     } catch (const std::exception& e) {
         // 异步执行异常处理
-        std::lock_guard<std::mutex> lock(statistics_mutex_);
+        std::lock_guard<NamedMutex> lock(statistics_mutex_);
         statistics_.error_executions++;
     }
 }
@@ -790,7 +794,7 @@ void TWAPAlgorithm::process_instrument_executions(const std::string& instrument_
     std::queue<std::string> execution_queue;
     
     {
-        std::lock_guard<std::mutex> lock(instrument_queues_mutex_);
+        std::lock_guard<NamedMutex> lock(instrument_queues_mutex_);
         auto it = instrument_execution_queues_.find(instrument_id);
         if (it != instrument_execution_queues_.end()) {
             execution_queue = std::move(it->second);
@@ -805,7 +809,7 @@ void TWAPAlgorithm::process_instrument_executions(const std::string& instrument_
         auto execution = get_execution(execution_id);
         if (execution && execution->status == AlgorithmStatus::RUNNING) {
             // 处理该执行的下一个切片
-            std::lock_guard<std::mutex> lock(slices_mutex_);
+            std::lock_guard<NamedMutex> lock(slices_mutex_);
             auto slices_it = execution_slices_.find(execution_id);
             if (slices_it != execution_slices_.end()) {
                 for (const auto& slice : slices_it->second) {
@@ -820,11 +824,11 @@ void TWAPAlgorithm::process_instrument_executions(const std::string& instrument_
 }
 
 void TWAPAlgorithm::distribute_executions_to_threads() {
-    std::unique_lock<std::shared_mutex> lock(executions_mutex_);
+    std::unique_lock<NamedSharedMutex> lock(executions_mutex_);
     
     for (const auto& [execution_id, execution] : executions_) {
         if (execution->status == AlgorithmStatus::RUNNING) {
-            std::lock_guard<std::mutex> queue_lock(instrument_queues_mutex_);
+            std::lock_guard<NamedMutex> queue_lock(instrument_queues_mutex_);
             instrument_execution_queues_[execution->instrument_id].push(execution_id);
         }
     }
@@ -0,0 +1,273 @@
+#include "shared_memory/core/flight_recorder.h"
+#include "shared_memory/core/tsc_clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace tes {
+namespace shared_memory {
+
+namespace {
+
+constexpr char MAGIC[8] = {'T', 'E', 'S', 'F', 'L', 'R', 'E', 'C'};
+constexpr int MAX_READ_ATTEMPTS = 16;
+
+inline uint32_t current_thread_id()
+{
+    thread_local uint32_t thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+    return thread_id;
+}
+
+inline size_t round_up_power_of_two(size_t value)
+{
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+inline size_t events_offset()
+{
+    return (sizeof(FlightRecorderHeader) + 63) & ~size_t(63);
+}
+
+bool valid_header(const FlightRecorderHeader& header, size_t file_size)
+{
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           header.version == FlightRecorder::VERSION &&
+           header.event_size == sizeof(FlightEvent) &&
+           header.capacity > 0 && (header.capacity & (header.capacity - 1)) == 0 &&
+           events_offset() + header.capacity * sizeof(FlightEvent) <= file_size;
+}
+
+// 上次崩溃留下的记录改名保留，不被新会话覆盖
+void preserve_crashed_recording(const std::string& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat st;
+    bool crashed = false;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(FlightRecorderHeader)) {
+        FlightRecorderHeader header;
+        if (pread(fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))) {
+            crashed = valid_header(header, static_cast<size_t>(st.st_size)) &&
+                      header.clean_shutdown.load(std::memory_order_relaxed) == 0;
+        }
+    }
+    ::close(fd);
+
+    if (crashed) {
+        std::rename(path.c_str(), (path + ".prev").c_str());
+    }
+}
+
+} // namespace
+
+const char* flight_event_type_name(FlightEventType type)
+{
+    switch (type) {
+        case FlightEventType::SIGNAL_IN: return "SIGNAL_IN";
+        case FlightEventType::ORDER_SERIALIZED: return "ORDER_SERIALIZED";
+        case FlightEventType::ORDER_SENT: return "ORDER_SENT";
+        case FlightEventType::ORDER_ACK: return "ORDER_ACK";
+        case FlightEventType::FILL: return "FILL";
+        case FlightEventType::ORDER_REJECT: return "ORDER_REJECT";
+        case FlightEventType::CONNECTED: return "CONNECTED";
+        case FlightEventType::DISCONNECTED: return "DISCONNECTED";
+        case FlightEventType::RECONNECTING: return "RECONNECTING";
+        case FlightEventType::STALL: return "STALL";
+        case FlightEventType::QUEUE_DEPTH: return "QUEUE_DEPTH";
+        case FlightEventType::MARK: return "MARK";
+    }
+    return "UNKNOWN";
+}
+
+FlightRecorder& FlightRecorder::instance()
+{
+    static FlightRecorder recorder;
+    return recorder;
+}
+
+FlightRecorder::FlightRecorder()
+    : header_(nullptr), events_(nullptr), mask_(0), mapped_size_(0), fd_(-1)
+{
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    close();
+    unmap();
+}
+
+bool FlightRecorder::open(const std::string& path, size_t capacity)
+{
+    close();
+    unmap();
+    preserve_crashed_recording(path);
+
+    capacity = round_up_power_of_two(capacity > 0 ? capacity : DEFAULT_CAPACITY);
+    size_t size = events_offset() + capacity * sizeof(FlightEvent);
+
+    fd_ = ::open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd_ == -1) {
+        return false;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(size)) == -1) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    mapped_size_ = size;
+
+    // ftruncate得到的是全零页，只需写文件头；事件槽序号为0表示从未写过
+    header_ = static_cast<FlightRecorderHeader*>(addr);
+    std::memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+    header_->version = VERSION;
+    header_->event_size = sizeof(FlightEvent);
+    header_->capacity = capacity;
+    header_->created_realtime_ns = TscClock::instance().realtime_ns();
+    header_->pid = static_cast<int32_t>(getpid());
+    header_->clean_shutdown.store(0, std::memory_order_relaxed);
+    header_->write_index.store(0, std::memory_order_relaxed);
+
+    mask_ = capacity - 1;
+    events_.store(reinterpret_cast<FlightEvent*>(static_cast<char*>(addr) + events_offset()),
+                  std::memory_order_release);
+    return true;
+}
+
+void FlightRecorder::close()
+{
+    if (!events_.exchange(nullptr, std::memory_order_acq_rel)) {
+        return;
+    }
+    header_->clean_shutdown.store(1, std::memory_order_release);
+    msync(header_, mapped_size_, MS_ASYNC);
+}
+
+void FlightRecorder::unmap()
+{
+    if (header_) {
+        munmap(header_, mapped_size_);
+        header_ = nullptr;
+        mapped_size_ = 0;
+    }
+    if (fd_ != -1) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void FlightRecorder::append(FlightEvent* events, FlightEventType type, uint64_t id, int64_t value)
+{
+    uint64_t position = header_->write_index.fetch_add(1, std::memory_order_relaxed);
+    FlightEvent& event = events[position & mask_];
+
+    event.sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.timestamp_ns = TscClock::instance().realtime_ns();
+    event.id = id;
+    event.value = value;
+    event.type = static_cast<uint16_t>(type);
+    event.reserved = 0;
+    event.thread_id = current_thread_id();
+
+    event.sequence.store(2 * (position + 1), std::memory_order_release);
+}
+
+bool FlightRecorder::load(const std::string& path, FlightRecorderHeader& header,
+                          std::vector<FlightEventRecord>& events, std::string& error)
+{
+    events.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < events_offset()) {
+        ::close(fd);
+        error = "file too small";
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+
+    void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        error = std::string("mmap failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    const FlightRecorderHeader* mapped_header = static_cast<const FlightRecorderHeader*>(addr);
+    if (!valid_header(*mapped_header, size)) {
+        munmap(addr, size);
+        error = "not a flight recorder file or unsupported version";
+        return false;
+    }
+
+    std::memcpy(header.magic, mapped_header->magic, sizeof(header.magic));
+    header.version = mapped_header->version;
+    header.event_size = mapped_header->event_size;
+    header.capacity = mapped_header->capacity;
+    header.created_realtime_ns = mapped_header->created_realtime_ns;
+    header.pid = mapped_header->pid;
+    header.clean_shutdown.store(mapped_header->clean_shutdown.load(std::memory_order_acquire));
+    header.write_index.store(mapped_header->write_index.load(std::memory_order_acquire));
+
+    // 记录进程可能仍在写：序号为奇数或前后不一致的槽位跳过
+    const FlightEvent* slots = reinterpret_cast<const FlightEvent*>(static_cast<const char*>(addr) + events_offset());
+    events.reserve(static_cast<size_t>(header.capacity));
+    for (uint64_t i = 0; i < header.capacity; ++i) {
+        const FlightEvent& slot = slots[i];
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == 0 || (sequence & 1)) {
+                break;
+            }
+
+            FlightEventRecord record;
+            record.position = sequence / 2 - 1;
+            record.timestamp_ns = slot.timestamp_ns;
+            record.id = slot.id;
+            record.value = slot.value;
+            record.type = static_cast<FlightEventType>(slot.type);
+            record.thread_id = slot.thread_id;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+                events.push_back(record);
+                break;
+            }
+        }
+    }
+    munmap(addr, size);
+
+    std::sort(events.begin(), events.end(), [](const FlightEventRecord& a, const FlightEventRecord& b) {
+        return a.position < b.position;
+    });
+    return true;
+}
+
+} // namespace shared_memory
+} // namespace tes
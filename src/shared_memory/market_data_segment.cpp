@@ -0,0 +1,377 @@
+#include "shared_memory/core/market_data_segment.h"
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace tes {
+namespace shared_memory {
+
+namespace {
+
+constexpr int MAX_READ_ATTEMPTS = 1000;
+constexpr uint64_t TICK_RING_MASK = MarketDataSegment::TICK_RING_SIZE - 1;
+
+static_assert((MarketDataSegment::TICK_RING_SIZE & TICK_RING_MASK) == 0, "TICK_RING_SIZE must be a power of two");
+
+// 行情环槽位写完后的序号，与位置一一对应，读者据此判断是否被下一圈覆盖
+inline uint64_t tick_sequence(uint64_t position) {
+    return 2 * (position + 1);
+}
+
+} // namespace
+
+MarketDataSegment::MarketDataSegment(const std::string& name, bool create)
+    : shm_name_("/tes_market_data_" + name), shm_fd_(-1), shared_data_(nullptr), is_creator_(create)
+{
+    if (create) {
+        if (!create_shared_memory()) {
+            throw std::runtime_error("Failed to create shared memory for MarketDataSegment");
+        }
+    } else {
+        if (!open_shared_memory()) {
+            throw std::runtime_error("Failed to open shared memory for MarketDataSegment");
+        }
+    }
+}
+
+MarketDataSegment::~MarketDataSegment()
+{
+    cleanup();
+}
+
+bool MarketDataSegment::create_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+    if (shm_fd_ == -1) {
+        // 如果已存在，先删除再创建
+        shm_unlink(shm_name_.c_str());
+        shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+        if (shm_fd_ == -1) {
+            return false;
+        }
+    }
+
+    if (ftruncate(shm_fd_, sizeof(SharedData)) == -1) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    new (shared_data_) SharedData();
+    shared_data_->is_initialized.store(true);
+
+    return true;
+}
+
+bool MarketDataSegment::open_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+    if (shm_fd_ == -1) {
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        return false;
+    }
+
+    // 等待初始化完成
+    while (!shared_data_->is_initialized.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+
+    return true;
+}
+
+void MarketDataSegment::cleanup()
+{
+    if (shared_data_ != nullptr && shared_data_ != MAP_FAILED) {
+        munmap(shared_data_, sizeof(SharedData));
+        shared_data_ = nullptr;
+    }
+
+    if (shm_fd_ != -1) {
+        close(shm_fd_);
+        shm_fd_ = -1;
+    }
+
+    if (is_creator_) {
+        shm_unlink(shm_name_.c_str());
+    }
+}
+
+uint32_t MarketDataSegment::intern_symbol_locked(const std::string& symbol)
+{
+    if (symbol.empty() || symbol.size() >= SYMBOL_LENGTH) {
+        return INVALID_SYMBOL_INDEX;
+    }
+
+    auto it = symbol_cache_.find(symbol);
+    if (it != symbol_cache_.end()) {
+        return it->second;
+    }
+
+    uint32_t count = shared_data_->symbol_count.load(std::memory_order_relaxed);
+    if (count >= MAX_SYMBOLS) {
+        return INVALID_SYMBOL_INDEX;
+    }
+
+    // 先写名字再发布下标，读者看到的目录项总是完整的
+    std::memset(shared_data_->symbols[count], 0, SYMBOL_LENGTH);
+    std::memcpy(shared_data_->symbols[count], symbol.data(), symbol.size());
+    shared_data_->symbol_count.store(count + 1, std::memory_order_release);
+    symbol_cache_[symbol] = count;
+    return count;
+}
+
+uint32_t MarketDataSegment::register_symbol(const std::string& symbol)
+{
+    if (!shared_data_) {
+        return INVALID_SYMBOL_INDEX;
+    }
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    return intern_symbol_locked(symbol);
+}
+
+void MarketDataSegment::push_tick_locked(const MarketTick& tick)
+{
+    uint64_t position = shared_data_->write_index.load(std::memory_order_relaxed);
+    TickSlot& slot = shared_data_->ticks[position & TICK_RING_MASK];
+
+    slot.sequence.store(tick_sequence(position) - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.symbol_index.store(tick.symbol_index, std::memory_order_relaxed);
+    slot.type.store(static_cast<uint8_t>(tick.type), std::memory_order_relaxed);
+    slot.side.store(static_cast<uint8_t>(tick.side), std::memory_order_relaxed);
+    slot.price.store(tick.price, std::memory_order_relaxed);
+    slot.quantity.store(tick.quantity, std::memory_order_relaxed);
+    slot.ask_price.store(tick.ask_price, std::memory_order_relaxed);
+    slot.ask_quantity.store(tick.ask_quantity, std::memory_order_relaxed);
+    slot.trade_id.store(tick.trade_id, std::memory_order_relaxed);
+    slot.exchange_timestamp.store(tick.exchange_timestamp, std::memory_order_relaxed);
+    slot.local_timestamp.store(tick.local_timestamp, std::memory_order_relaxed);
+
+    slot.sequence.store(tick_sequence(position), std::memory_order_release);
+    shared_data_->write_index.store(position + 1, std::memory_order_release);
+    ticks_published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool MarketDataSegment::publish_quote(const std::string& symbol, const TopOfBook& quote)
+{
+    if (!shared_data_) {
+        publish_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    uint32_t index = intern_symbol_locked(symbol);
+    if (index == INVALID_SYMBOL_INDEX) {
+        publish_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    QuoteSlot& slot = shared_data_->quotes[index];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.bid_price.store(quote.bid_price, std::memory_order_relaxed);
+    slot.bid_volume.store(quote.bid_volume, std::memory_order_relaxed);
+    slot.ask_price.store(quote.ask_price, std::memory_order_relaxed);
+    slot.ask_volume.store(quote.ask_volume, std::memory_order_relaxed);
+    slot.exchange_timestamp.store(quote.exchange_timestamp, std::memory_order_relaxed);
+    slot.local_timestamp.store(quote.local_timestamp, std::memory_order_relaxed);
+    slot.update_id.store(quote.update_id, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    quotes_published_.fetch_add(1, std::memory_order_relaxed);
+
+    // 最优价变化同时进入行情环，按序消费的读者不会漏掉中间状态
+    MarketTick tick;
+    tick.symbol_index = index;
+    tick.type = MarketTickType::QUOTE;
+    tick.price = quote.bid_price;
+    tick.quantity = quote.bid_volume;
+    tick.ask_price = quote.ask_price;
+    tick.ask_quantity = quote.ask_volume;
+    tick.trade_id = quote.update_id;
+    tick.exchange_timestamp = quote.exchange_timestamp;
+    tick.local_timestamp = quote.local_timestamp;
+    push_tick_locked(tick);
+
+    return true;
+}
+
+bool MarketDataSegment::publish_trade(const std::string& symbol, const MarketTick& trade)
+{
+    if (!shared_data_) {
+        publish_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    uint32_t index = intern_symbol_locked(symbol);
+    if (index == INVALID_SYMBOL_INDEX) {
+        publish_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    MarketTick tick = trade;
+    tick.symbol_index = index;
+    tick.type = MarketTickType::TRADE;
+    push_tick_locked(tick);
+    return true;
+}
+
+uint32_t MarketDataSegment::find_symbol(const std::string& symbol) const
+{
+    if (!shared_data_) {
+        return INVALID_SYMBOL_INDEX;
+    }
+
+    uint32_t count = shared_data_->symbol_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (symbol == shared_data_->symbols[i]) {
+            return i;
+        }
+    }
+    return INVALID_SYMBOL_INDEX;
+}
+
+std::string MarketDataSegment::symbol_at(uint32_t index) const
+{
+    if (!shared_data_ || index >= shared_data_->symbol_count.load(std::memory_order_acquire)) {
+        return std::string();
+    }
+    return std::string(shared_data_->symbols[index]);
+}
+
+bool MarketDataSegment::read_quote(uint32_t symbol_index, TopOfBook& quote) const
+{
+    if (!shared_data_ || symbol_index >= shared_data_->symbol_count.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const QuoteSlot& slot = shared_data_->quotes[symbol_index];
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t begin = slot.sequence.load(std::memory_order_acquire);
+        if (begin & 1) {
+            quote_read_retries_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+            continue;
+        }
+
+        quote.bid_price = slot.bid_price.load(std::memory_order_relaxed);
+        quote.bid_volume = slot.bid_volume.load(std::memory_order_relaxed);
+        quote.ask_price = slot.ask_price.load(std::memory_order_relaxed);
+        quote.ask_volume = slot.ask_volume.load(std::memory_order_relaxed);
+        quote.exchange_timestamp = slot.exchange_timestamp.load(std::memory_order_relaxed);
+        quote.local_timestamp = slot.local_timestamp.load(std::memory_order_relaxed);
+        quote.update_id = slot.update_id.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == begin) {
+            quote.version = begin / 2;
+            return begin != 0;
+        }
+        quote_read_retries_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+uint64_t MarketDataSegment::tick_cursor() const
+{
+    if (!shared_data_) {
+        return 0;
+    }
+    return shared_data_->write_index.load(std::memory_order_acquire);
+}
+
+size_t MarketDataSegment::read_ticks(uint64_t& cursor, MarketTick* ticks, size_t max_count, uint64_t* lost) const
+{
+    if (lost) {
+        *lost = 0;
+    }
+    if (!shared_data_) {
+        return 0;
+    }
+
+    size_t count = 0;
+    uint64_t skipped = 0;
+    uint64_t head = shared_data_->write_index.load(std::memory_order_acquire);
+
+    while (count < max_count && cursor < head) {
+        // 落后超过一圈：写者正在覆盖最旧的槽位，跳到仍然有效的最旧记录
+        if (head - cursor >= TICK_RING_SIZE) {
+            uint64_t oldest = head - TICK_RING_SIZE + 1;
+            skipped += oldest - cursor;
+            cursor = oldest;
+        }
+
+        const TickSlot& slot = shared_data_->ticks[cursor & TICK_RING_MASK];
+        uint64_t expected = tick_sequence(cursor);
+        if (slot.sequence.load(std::memory_order_acquire) != expected) {
+            head = shared_data_->write_index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        MarketTick& tick = ticks[count];
+        tick.symbol_index = slot.symbol_index.load(std::memory_order_relaxed);
+        tick.type = static_cast<MarketTickType>(slot.type.load(std::memory_order_relaxed));
+        tick.side = static_cast<OrderSide>(slot.side.load(std::memory_order_relaxed));
+        tick.price = slot.price.load(std::memory_order_relaxed);
+        tick.quantity = slot.quantity.load(std::memory_order_relaxed);
+        tick.ask_price = slot.ask_price.load(std::memory_order_relaxed);
+        tick.ask_quantity = slot.ask_quantity.load(std::memory_order_relaxed);
+        tick.trade_id = slot.trade_id.load(std::memory_order_relaxed);
+        tick.exchange_timestamp = slot.exchange_timestamp.load(std::memory_order_relaxed);
+        tick.local_timestamp = slot.local_timestamp.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+            // 读的过程中被下一圈覆盖
+            head = shared_data_->write_index.load(std::memory_order_acquire);
+            continue;
+        }
+
+        ++count;
+        ++cursor;
+    }
+
+    if (skipped > 0) {
+        ticks_lost_.fetch_add(skipped, std::memory_order_relaxed);
+    }
+    if (lost) {
+        *lost = skipped;
+    }
+    return count;
+}
+
+MarketDataSegment::Statistics MarketDataSegment::get_statistics() const
+{
+    return {
+        quotes_published_.load(),
+        ticks_published_.load(),
+        publish_failures_.load(),
+        quote_read_retries_.load(),
+        ticks_lost_.load()
+    };
+}
+
+} // namespace shared_memory
+} // namespace tes
@@ -2,10 +2,42 @@
 #include <stdexcept>
 #include <cstring>
 #include <algorithm>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 
 namespace tes {
 namespace shared_memory {
 
+namespace {
+
+constexpr int MAX_READ_ATTEMPTS = 1000;
+
+// FNV-1a 64位；0保留给空索引项
+inline uint64_t order_id_hash(const char* order_id)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char* p = order_id; *p != '\0'; ++p) {
+        hash ^= static_cast<unsigned char>(*p);
+        hash *= 1099511628211ULL;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+// 共享内存中的futex字跨进程使用，不能带FUTEX_PRIVATE_FLAG
+inline long futex_wait(std::atomic<uint32_t>* word, uint32_t expected, const struct timespec* timeout)
+{
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, timeout, nullptr, 0);
+}
+
+inline long futex_wake(std::atomic<uint32_t>* word)
+{
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
 OrderFeedbackBuffer::OrderFeedbackBuffer(const std::string& name, bool create)
     : shm_name_("/tes_feedback_" + name), shm_fd_(-1), shared_data_(nullptr), is_creator_(create)
 {
@@ -123,12 +155,19 @@ bool OrderFeedbackBuffer::write_feedback(const OrderFeedback& feedback)
         return false;
     }
     
-    // 写入回报
+    // 写入回报，槽位序号置奇数期间按订单ID查找的读者会重试
     size_t index = current_write % BUFFER_SIZE;
+    std::atomic<uint64_t>& slot_sequence = shared_data_->slot_sequences[index];
+    slot_sequence.store(2 * current_write + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    
     shared_data_->feedbacks[index] = feedback;
     shared_data_->feedbacks[index].sequence_id = current_write;
     shared_data_->feedbacks[index].timestamp = get_current_timestamp_ns();
     
+    slot_sequence.store(2 * (current_write + 1), std::memory_order_release);
+    index_feedback(shared_data_->feedbacks[index].order_id, current_write);
+    
     // 更新写索引
     shared_data_->write_index.store(current_write + 1);
     total_writes_.fetch_add(1);
@@ -180,27 +219,171 @@ size_t OrderFeedbackBuffer::read_feedbacks(OrderFeedback* feedbacks, size_t max_
     return count;
 }
 
-bool OrderFeedbackBuffer::find_feedback_by_order_id(OrderId order_id, OrderFeedback& feedback)
+void OrderFeedbackBuffer::index_feedback(const char* order_id, uint64_t position)
 {
-    if (!shared_data_ || !shared_data_->is_initialized.load()) {
-        return false;
+    // 只有写者修改索引：先在探测窗口内找同一订单，找不到再占用第一个空项或已过期项。
+    // 项一旦占用就不再置空，探测链不会断开
+    uint64_t hash = order_id_hash(order_id);
+    IndexEntry* reusable = nullptr;
+    size_t slot = hash & (INDEX_SIZE - 1);
+    for (size_t probe = 0; probe < MAX_INDEX_PROBES; ++probe) {
+        IndexEntry& entry = shared_data_->order_index[(slot + probe) & (INDEX_SIZE - 1)];
+        uint64_t entry_hash = entry.hash.load(std::memory_order_relaxed);
+        if (entry_hash == hash) {
+            entry.position.store(position + 1, std::memory_order_release);
+            return;
+        }
+        if (entry_hash == 0) {
+            if (!reusable) {
+                reusable = &entry;
+            }
+            break;
+        }
+        // 指向的槽位已被环覆盖，这一项可以复用
+        uint64_t entry_position = entry.position.load(std::memory_order_relaxed);
+        if (!reusable && entry_position + BUFFER_SIZE <= position + 1) {
+            reusable = &entry;
+        }
     }
     
-    uint64_t current_read = shared_data_->read_index.load();
-    uint64_t current_write = shared_data_->write_index.load();
+    if (!reusable) {
+        shared_data_->index_overflows.fetch_add(1, std::memory_order_relaxed);
+        shared_data_->last_unindexed.store(position + 1, std::memory_order_release);
+        return;
+    }
+    
+    // 先写位置再发布哈希；命中旧哈希的读者会在校验订单ID时失败
+    reusable->position.store(position + 1, std::memory_order_release);
+    reusable->hash.store(hash, std::memory_order_release);
+}
+
+bool OrderFeedbackBuffer::read_slot(uint64_t position, OrderFeedback& feedback) const
+{
+    size_t index = position % BUFFER_SIZE;
+    const std::atomic<uint64_t>& slot_sequence = shared_data_->slot_sequences[index];
+    uint64_t expected = 2 * (position + 1);
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t begin = slot_sequence.load(std::memory_order_acquire);
+        if (begin & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (begin != expected) {
+            return false;   // 已被环覆盖
+        }
+        
+        feedback = shared_data_->feedbacks[index];
+        
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot_sequence.load(std::memory_order_relaxed) == begin) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OrderFeedbackBuffer::scan_feedback(const char* order_id, uint64_t newest_end, OrderFeedback& feedback) const
+{
+    // 只扫描最近一条漏登记回报及更早的槽位：之后写入的回报都已登记，索引未命中即不在其中
+    uint64_t current_write = std::max(shared_data_->write_index.load(), newest_end);
+    uint64_t oldest = current_write > BUFFER_SIZE ? current_write - BUFFER_SIZE : 0;
     
     // 从最新的回报开始搜索
-    for (uint64_t i = current_write; i > current_read; --i) {
-        size_t index = (i - 1) % BUFFER_SIZE;
-        if (shared_data_->feedbacks[index].order_id == order_id) {
-            feedback = shared_data_->feedbacks[index];
+    for (uint64_t i = newest_end; i > oldest; --i) {
+        if (read_slot(i - 1, feedback) && std::strcmp(feedback.order_id, order_id) == 0) {
             return true;
         }
     }
+    return false;
+}
+
+bool OrderFeedbackBuffer::find_feedback_by_order_id(const OrderId& order_id, OrderFeedback& feedback) const
+{
+    if (!shared_data_ || !shared_data_->is_initialized.load()) {
+        return false;
+    }
     
+    const char* key = order_id.c_str();
+    uint64_t hash = order_id_hash(key);
+    size_t slot = hash & (INDEX_SIZE - 1);
+    for (size_t probe = 0; probe < MAX_INDEX_PROBES; ++probe) {
+        const IndexEntry& entry = shared_data_->order_index[(slot + probe) & (INDEX_SIZE - 1)];
+        uint64_t entry_hash = entry.hash.load(std::memory_order_acquire);
+        if (entry_hash == 0) {
+            break;
+        }
+        if (entry_hash != hash) {
+            continue;
+        }
+        
+        uint64_t position = entry.position.load(std::memory_order_acquire);
+        if (position != 0 && read_slot(position - 1, feedback) && std::strcmp(feedback.order_id, key) == 0) {
+            index_hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        break;
+    }
+    
+    index_misses_.fetch_add(1, std::memory_order_relaxed);
+    // 环内还有因探测窗口满而漏登记的回报时回退到扫描；漏登记的回报全部被环覆盖后不再扫描
+    uint64_t unindexed_end = shared_data_->last_unindexed.load(std::memory_order_acquire);
+    if (unindexed_end != 0 && unindexed_end + BUFFER_SIZE > shared_data_->write_index.load()) {
+        fallback_scans_.fetch_add(1, std::memory_order_relaxed);
+        return scan_feedback(key, unindexed_end, feedback);
+    }
     return false;
 }
 
+bool OrderFeedbackBuffer::notify_readers()
+{
+    if (!shared_data_) {
+        return false;
+    }
+    
+    // 与wait_for_feedback中"先登记挂起再检查写索引"配对：
+    // 写索引已按seq_cst发布，这里要么看到挂起的读者，要么读者能看到新回报
+    if (shared_data_->parked_readers.load(std::memory_order_seq_cst) == 0) {
+        return false;
+    }
+    
+    shared_data_->notify_word.fetch_add(1, std::memory_order_release);
+    futex_wake(&shared_data_->notify_word);
+    reader_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool OrderFeedbackBuffer::wait_for_feedback(std::chrono::microseconds timeout)
+{
+    if (!shared_data_ || !shared_data_->is_initialized.load()) {
+        return false;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (available_feedbacks() == 0) {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        
+        uint32_t word = shared_data_->notify_word.load(std::memory_order_acquire);
+        shared_data_->parked_readers.fetch_add(1, std::memory_order_seq_cst);
+        if (available_feedbacks() != 0) {
+            shared_data_->parked_readers.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        
+        auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now).count();
+        struct timespec ts;
+        ts.tv_sec = remaining / 1000000000LL;
+        ts.tv_nsec = remaining % 1000000000LL;
+        // 写者在读取word之后已唤醒时futex直接返回EAGAIN，不会丢失唤醒
+        futex_wait(&shared_data_->notify_word, word, &ts);
+        shared_data_->parked_readers.fetch_sub(1, std::memory_order_relaxed);
+        reader_waits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
 size_t OrderFeedbackBuffer::available_feedbacks() const
 {
     if (!shared_data_ || !shared_data_->is_initialized.load()) {
@@ -247,7 +430,13 @@ OrderFeedbackBuffer::Statistics OrderFeedbackBuffer::get_statistics() const
         total_reads_.load(),
         write_failures_.load(),
         read_failures_.load(),
-        duplicate_orders_.load()
+        duplicate_orders_.load(),
+        index_hits_.load(),
+        index_misses_.load(),
+        shared_data_ ? shared_data_->index_overflows.load() : 0,
+        fallback_scans_.load(),
+        reader_wakeups_.load(),
+        reader_waits_.load()
     };
 }
 
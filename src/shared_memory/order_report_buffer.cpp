@@ -2,12 +2,28 @@
 #include <stdexcept>
 #include <chrono>
 #include <cstring>
+#include <algorithm>
 
 namespace tes {
 namespace shared_memory {
 
+namespace {
+
+// 容量向上取2的幂，槽位计算只需一次与运算
+size_t round_up_capacity(size_t capacity)
+{
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+
+} // namespace
+
 OrderReportBuffer::OrderReportBuffer(const std::string& name, size_t capacity, bool create)
     : shm_name_("/tes_order_report_" + name), shm_fd_(-1), buffer_(nullptr), is_creator_(create)
+    , cached_head_(0), cached_tail_(0)
 {
     if (create) {
         if (!create_shared_memory(capacity)) {
@@ -25,8 +41,14 @@ OrderReportBuffer::~OrderReportBuffer()
     cleanup();
 }
 
+size_t OrderReportBuffer::mapped_size() const
+{
+    return sizeof(SharedOrderReportBuffer) + buffer_->capacity * sizeof(OrderReport);
+}
+
 bool OrderReportBuffer::create_shared_memory(size_t capacity)
 {
+    capacity = round_up_capacity(capacity);
     size_t total_size = sizeof(SharedOrderReportBuffer) + capacity * sizeof(OrderReport);
     
     // 创建共享内存
@@ -58,12 +80,13 @@ bool OrderReportBuffer::create_shared_memory(size_t capacity)
         return false;
     }
     
-    // 初始化缓冲区
+    // 初始化缓冲区（槽位由ftruncate清零，OrderReport可按字节拷贝，无需逐个构造）
     new (buffer_) SharedOrderReportBuffer();
     buffer_->capacity = capacity;
+    buffer_->mask = capacity - 1;
     buffer_->head.store(0);
     buffer_->tail.store(0);
-    buffer_->is_initialized.store(true);
+    buffer_->is_initialized.store(true, std::memory_order_release);
     
     return true;
 }
@@ -93,18 +116,19 @@ bool OrderReportBuffer::open_shared_memory()
     }
     
     // 等待初始化完成
-    while (!buffer_->is_initialized.load()) {
+    while (!buffer_->is_initialized.load(std::memory_order_acquire)) {
         std::this_thread::sleep_for(std::chrono::microseconds(1));
     }
     
+    cached_head_ = buffer_->head.load(std::memory_order_acquire);
+    cached_tail_ = buffer_->tail.load(std::memory_order_acquire);
     return true;
 }
 
 void OrderReportBuffer::cleanup()
 {
     if (buffer_ != nullptr && buffer_ != MAP_FAILED) {
-        size_t total_size = sizeof(SharedOrderReportBuffer) + buffer_->capacity * sizeof(OrderReport);
-        munmap(buffer_, total_size);
+        munmap(buffer_, mapped_size());
         buffer_ = nullptr;
     }
     
@@ -120,51 +144,63 @@ void OrderReportBuffer::cleanup()
 
 bool OrderReportBuffer::push(const OrderReport& report)
 {
-    if (!buffer_ || !buffer_->is_initialized.load()) {
+    if (!buffer_) {
         return false;
     }
     
-    size_t current_tail = buffer_->tail.load();
-    size_t next_tail = (current_tail + 1) % buffer_->capacity;
+    uint64_t current_tail = buffer_->tail.load(std::memory_order_relaxed);
     
-    // 检查缓冲区是否已满
-    if (next_tail == buffer_->head.load()) {
-        return false; // 缓冲区已满
+    // 检查缓冲区是否已满，先用缓存的head判断
+    if (current_tail - cached_head_ >= buffer_->capacity) {
+        cached_head_ = buffer_->head.load(std::memory_order_acquire);
+        if (current_tail - cached_head_ >= buffer_->capacity) {
+            return false; // 缓冲区已满
+        }
     }
     
     // 写入数据
-    buffer_->reports[current_tail] = report;
-    buffer_->reports[current_tail].timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    OrderReport& slot = buffer_->reports[current_tail & buffer_->mask];
+    std::memcpy(&slot, &report, sizeof(OrderReport));
+    slot.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()
     ).count();
     
-    // 更新尾指针
-    buffer_->tail.store(next_tail);
+    // 发布写入，消费者acquire读tail后可见整个槽位
+    buffer_->tail.store(current_tail + 1, std::memory_order_release);
     
     return true;
 }
 
 bool OrderReportBuffer::pop(OrderReport& report)
 {
-    if (!buffer_ || !buffer_->is_initialized.load()) {
-        return false;
+    return pop_batch(&report, 1) == 1;
+}
+
+size_t OrderReportBuffer::pop_batch(OrderReport* reports, size_t max_count)
+{
+    if (!buffer_ || max_count == 0) {
+        return 0;
     }
     
-    size_t current_head = buffer_->head.load();
+    uint64_t current_head = buffer_->head.load(std::memory_order_relaxed);
     
-    // 检查缓冲区是否为空
-    if (current_head == buffer_->tail.load()) {
-        return false; // 缓冲区为空
+    // 检查缓冲区是否为空，先用缓存的tail判断
+    if (current_head == cached_tail_) {
+        cached_tail_ = buffer_->tail.load(std::memory_order_acquire);
+        if (current_head == cached_tail_) {
+            return 0; // 缓冲区为空
+        }
     }
     
-    // 读取数据
-    report = buffer_->reports[current_head];
+    size_t count = static_cast<size_t>(std::min<uint64_t>(cached_tail_ - current_head, max_count));
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(&reports[i], &buffer_->reports[(current_head + i) & buffer_->mask], sizeof(OrderReport));
+    }
     
-    // 更新头指针
-    size_t next_head = (current_head + 1) % buffer_->capacity;
-    buffer_->head.store(next_head);
+    // 一次性归还槽位
+    buffer_->head.store(current_head + count, std::memory_order_release);
     
-    return true;
+    return count;
 }
 
 bool OrderReportBuffer::try_pop(OrderReport& report, std::chrono::milliseconds timeout)
@@ -187,14 +223,9 @@ size_t OrderReportBuffer::size() const
         return 0;
     }
     
-    size_t head = buffer_->head.load();
-    size_t tail = buffer_->tail.load();
-    
-    if (tail >= head) {
-        return tail - head;
-    } else {
-        return buffer_->capacity - head + tail;
-    }
+    uint64_t head = buffer_->head.load(std::memory_order_acquire);
+    uint64_t tail = buffer_->tail.load(std::memory_order_acquire);
+    return tail >= head ? static_cast<size_t>(tail - head) : 0;
 }
 
 size_t OrderReportBuffer::capacity() const
@@ -207,10 +238,7 @@ size_t OrderReportBuffer::capacity() const
 
 bool OrderReportBuffer::empty() const
 {
-    if (!buffer_ || !buffer_->is_initialized.load()) {
-        return true;
-    }
-    return buffer_->head.load() == buffer_->tail.load();
+    return size() == 0;
 }
 
 bool OrderReportBuffer::full() const
@@ -218,12 +246,7 @@ bool OrderReportBuffer::full() const
     if (!buffer_ || !buffer_->is_initialized.load()) {
         return false;
     }
-    
-    size_t head = buffer_->head.load();
-    size_t tail = buffer_->tail.load();
-    size_t next_tail = (tail + 1) % buffer_->capacity;
-    
-    return next_tail == head;
+    return size() >= buffer_->capacity;
 }
 
 void OrderReportBuffer::clear()
@@ -232,8 +255,8 @@ void OrderReportBuffer::clear()
         return;
     }
     
-    buffer_->head.store(0);
-    buffer_->tail.store(0);
+    // 只能由消费者调用：丢弃所有未读回报
+    buffer_->head.store(buffer_->tail.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 OrderReportBuffer::Statistics OrderReportBuffer::get_statistics() const
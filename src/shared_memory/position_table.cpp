@@ -0,0 +1,322 @@
+#include "shared_memory/core/position_table.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace tes {
+namespace shared_memory {
+
+namespace {
+
+constexpr int MAX_READ_ATTEMPTS = 1000;
+
+inline std::string row_key(const std::string& strategy_id, const std::string& instrument_id) {
+    std::string key;
+    key.reserve(strategy_id.size() + instrument_id.size() + 1);
+    key.append(strategy_id).push_back('\0');
+    key.append(instrument_id);
+    return key;
+}
+
+inline uint64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+PositionTable::PositionTable(const std::string& name, bool create)
+    : shm_name_("/tes_positions_" + name), shm_fd_(-1), shared_data_(nullptr), is_creator_(create)
+{
+    if (create) {
+        if (!create_shared_memory()) {
+            throw std::runtime_error("Failed to create shared memory for PositionTable");
+        }
+    } else {
+        if (!open_shared_memory()) {
+            throw std::runtime_error("Failed to open shared memory for PositionTable");
+        }
+    }
+}
+
+PositionTable::~PositionTable()
+{
+    cleanup();
+}
+
+bool PositionTable::create_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+    if (shm_fd_ == -1) {
+        // 如果已存在，先删除再创建
+        shm_unlink(shm_name_.c_str());
+        shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+        if (shm_fd_ == -1) {
+            return false;
+        }
+    }
+
+    if (ftruncate(shm_fd_, sizeof(SharedData)) == -1) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    new (shared_data_) SharedData();
+    shared_data_->is_initialized.store(true);
+
+    return true;
+}
+
+bool PositionTable::open_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+    if (shm_fd_ == -1) {
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        return false;
+    }
+
+    // 等待初始化完成
+    while (!shared_data_->is_initialized.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+
+    return true;
+}
+
+void PositionTable::cleanup()
+{
+    if (shared_data_ != nullptr && shared_data_ != MAP_FAILED) {
+        munmap(shared_data_, sizeof(SharedData));
+        shared_data_ = nullptr;
+    }
+
+    if (shm_fd_ != -1) {
+        close(shm_fd_);
+        shm_fd_ = -1;
+    }
+
+    if (is_creator_) {
+        shm_unlink(shm_name_.c_str());
+    }
+}
+
+uint32_t PositionTable::acquire_row_locked(const std::string& strategy_id, const std::string& instrument_id)
+{
+    std::string key = row_key(strategy_id, instrument_id);
+    auto it = row_cache_.find(key);
+    if (it != row_cache_.end()) {
+        return it->second;
+    }
+
+    if (strategy_id.size() >= STRATEGY_ID_LENGTH || instrument_id.empty() ||
+        instrument_id.size() >= INSTRUMENT_ID_LENGTH) {
+        return INVALID_ROW;
+    }
+
+    uint32_t count = shared_data_->row_count.load(std::memory_order_relaxed);
+    if (count >= MAX_ROWS) {
+        return INVALID_ROW;
+    }
+
+    // 先写键再发布行数，读者看到的行键总是完整的
+    PositionRow& row = shared_data_->rows[count];
+    std::memset(row.strategy_id, 0, STRATEGY_ID_LENGTH);
+    std::memcpy(row.strategy_id, strategy_id.data(), strategy_id.size());
+    std::memset(row.instrument_id, 0, INSTRUMENT_ID_LENGTH);
+    std::memcpy(row.instrument_id, instrument_id.data(), instrument_id.size());
+    shared_data_->row_count.store(count + 1, std::memory_order_release);
+
+    row_cache_.emplace(std::move(key), count);
+    instrument_rows_[instrument_id].push_back(count);
+    return count;
+}
+
+void PositionTable::write_row_locked(PositionRow& row, double net_quantity, double average_cost,
+                                     double realized_pnl, double unrealized_pnl, double mark_price)
+{
+    uint64_t update_sequence = shared_data_->update_sequence.load(std::memory_order_relaxed) + 1;
+    uint64_t sequence = row.sequence.load(std::memory_order_relaxed);
+    row.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    row.net_quantity.store(net_quantity, std::memory_order_relaxed);
+    row.average_cost.store(average_cost, std::memory_order_relaxed);
+    row.realized_pnl.store(realized_pnl, std::memory_order_relaxed);
+    row.unrealized_pnl.store(unrealized_pnl, std::memory_order_relaxed);
+    row.mark_price.store(mark_price, std::memory_order_relaxed);
+    row.update_sequence.store(update_sequence, std::memory_order_relaxed);
+    row.update_time.store(monotonic_ns(), std::memory_order_relaxed);
+
+    row.sequence.store(sequence + 2, std::memory_order_release);
+    shared_data_->update_sequence.store(update_sequence, std::memory_order_release);
+}
+
+bool PositionTable::update_position(const PositionRecord& record)
+{
+    if (!shared_data_) {
+        update_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    uint32_t index = acquire_row_locked(record.strategy_id, record.instrument_id);
+    if (index == INVALID_ROW) {
+        update_failures_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    PositionRow& row = shared_data_->rows[index];
+    // 调用方没有标记价格时沿用上一次的
+    double mark_price = record.mark_price > 0.0 ? record.mark_price
+                                                : row.mark_price.load(std::memory_order_relaxed);
+    write_row_locked(row, record.net_quantity, record.average_cost, record.realized_pnl,
+                     record.unrealized_pnl, mark_price);
+    position_updates_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+size_t PositionTable::update_mark_price(const std::string& instrument_id, double mark_price)
+{
+    if (!shared_data_ || mark_price <= 0.0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    auto it = instrument_rows_.find(instrument_id);
+    if (it == instrument_rows_.end()) {
+        return 0;
+    }
+
+    // 行只由本写者修改，读自己的值不需要seqlock
+    for (uint32_t index : it->second) {
+        PositionRow& row = shared_data_->rows[index];
+        double net_quantity = row.net_quantity.load(std::memory_order_relaxed);
+        double average_cost = row.average_cost.load(std::memory_order_relaxed);
+        double unrealized_pnl = net_quantity * (mark_price - average_cost);
+        write_row_locked(row, net_quantity, average_cost, row.realized_pnl.load(std::memory_order_relaxed),
+                         unrealized_pnl, mark_price);
+    }
+    mark_updates_.fetch_add(1, std::memory_order_relaxed);
+    return it->second.size();
+}
+
+uint64_t PositionTable::update_sequence() const
+{
+    if (!shared_data_) {
+        return 0;
+    }
+    return shared_data_->update_sequence.load(std::memory_order_acquire);
+}
+
+uint32_t PositionTable::row_count() const
+{
+    if (!shared_data_) {
+        return 0;
+    }
+    return shared_data_->row_count.load(std::memory_order_acquire);
+}
+
+uint32_t PositionTable::find_row(const std::string& strategy_id, const std::string& instrument_id) const
+{
+    uint32_t count = row_count();
+    for (uint32_t i = 0; i < count; ++i) {
+        const PositionRow& row = shared_data_->rows[i];
+        if (instrument_id == row.instrument_id && strategy_id == row.strategy_id) {
+            return i;
+        }
+    }
+    return INVALID_ROW;
+}
+
+bool PositionTable::read_row(uint32_t index, PositionRecord& record) const
+{
+    if (index >= row_count()) {
+        return false;
+    }
+
+    const PositionRow& row = shared_data_->rows[index];
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t begin = row.sequence.load(std::memory_order_acquire);
+        if (begin & 1) {
+            read_retries_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+            continue;
+        }
+
+        record.net_quantity = row.net_quantity.load(std::memory_order_relaxed);
+        record.average_cost = row.average_cost.load(std::memory_order_relaxed);
+        record.realized_pnl = row.realized_pnl.load(std::memory_order_relaxed);
+        record.unrealized_pnl = row.unrealized_pnl.load(std::memory_order_relaxed);
+        record.mark_price = row.mark_price.load(std::memory_order_relaxed);
+        record.update_sequence = row.update_sequence.load(std::memory_order_relaxed);
+        record.update_time = row.update_time.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (row.sequence.load(std::memory_order_relaxed) == begin) {
+            record.strategy_id = row.strategy_id;
+            record.instrument_id = row.instrument_id;
+            return true;
+        }
+        read_retries_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return false;
+}
+
+bool PositionTable::read_position(const std::string& strategy_id, const std::string& instrument_id,
+                                  PositionRecord& record) const
+{
+    uint32_t index = find_row(strategy_id, instrument_id);
+    if (index == INVALID_ROW) {
+        return false;
+    }
+    return read_row(index, record);
+}
+
+size_t PositionTable::read_positions(const std::string& strategy_id, std::vector<PositionRecord>& records) const
+{
+    records.clear();
+    uint32_t count = row_count();
+    PositionRecord record;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!strategy_id.empty() && strategy_id != shared_data_->rows[i].strategy_id) {
+            continue;
+        }
+        if (read_row(i, record)) {
+            records.push_back(record);
+        }
+    }
+    return records.size();
+}
+
+PositionTable::Statistics PositionTable::get_statistics() const
+{
+    return {
+        position_updates_.load(),
+        mark_updates_.load(),
+        update_failures_.load(),
+        read_retries_.load()
+    };
+}
+
+} // namespace shared_memory
+} // namespace tes
@@ -128,6 +128,7 @@ bool SignalBuffer::write_signal(const TradingSignal& signal)
     size_t index = current_write % BUFFER_SIZE;
     shared_data_->signals[index] = signal;
     shared_data_->signals[index].sequence_id = current_write;
+    shared_data_->signals[index].shm_write_ns = get_monotonic_timestamp_ns();
     
     // 更新写索引
     shared_data_->write_index.store(current_write + 1);
@@ -155,6 +156,7 @@ bool SignalBuffer::read_signal(TradingSignal& signal)
     // 读取信号
     size_t index = current_read % BUFFER_SIZE;
     signal = shared_data_->signals[index];
+    signal.shm_read_ns = get_monotonic_timestamp_ns();
     
     // 更新读索引
     shared_data_->read_index.store(current_read + 1);
@@ -0,0 +1,387 @@
+#include "shared_memory/core/target_position_table.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+namespace tes {
+namespace shared_memory {
+
+namespace {
+
+constexpr int MAX_READ_ATTEMPTS = 1000;
+
+inline int64_t to_fixed(double quantity) {
+    return static_cast<int64_t>(std::llround(quantity * TargetPositionTable::QUANTITY_SCALE));
+}
+
+inline double from_fixed(int64_t quantity) {
+    return static_cast<double>(quantity) / TargetPositionTable::QUANTITY_SCALE;
+}
+
+inline uint64_t pack_ack(uint64_t generation, TargetAckStatus status) {
+    return (generation << 8) | static_cast<uint8_t>(status);
+}
+
+// 短暂自旋后让出CPU，等待者不必独占一个核
+inline void backoff(int& spins) {
+    if (++spins < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+}
+
+} // namespace
+
+TargetPositionTable::TargetPositionTable(const std::string& name, bool create)
+    : shm_name_("/tes_target_" + name), shm_fd_(-1), shared_data_(nullptr), is_creator_(create)
+{
+    if (create) {
+        if (!create_shared_memory()) {
+            throw std::runtime_error("Failed to create shared memory for TargetPositionTable");
+        }
+    } else {
+        if (!open_shared_memory()) {
+            throw std::runtime_error("Failed to open shared memory for TargetPositionTable");
+        }
+    }
+}
+
+TargetPositionTable::~TargetPositionTable()
+{
+    cleanup();
+}
+
+bool TargetPositionTable::create_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+    if (shm_fd_ == -1) {
+        // 如果已存在，先删除再创建
+        shm_unlink(shm_name_.c_str());
+        shm_fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+        if (shm_fd_ == -1) {
+            return false;
+        }
+    }
+
+    if (ftruncate(shm_fd_, sizeof(SharedData)) == -1) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        shm_unlink(shm_name_.c_str());
+        return false;
+    }
+
+    new (shared_data_) SharedData();
+    shared_data_->is_initialized.store(true);
+
+    return true;
+}
+
+bool TargetPositionTable::open_shared_memory()
+{
+    shm_fd_ = shm_open(shm_name_.c_str(), O_RDWR, 0666);
+    if (shm_fd_ == -1) {
+        return false;
+    }
+
+    shared_data_ = static_cast<SharedData*>(
+        mmap(nullptr, sizeof(SharedData), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd_, 0)
+    );
+
+    if (shared_data_ == MAP_FAILED) {
+        close(shm_fd_);
+        return false;
+    }
+
+    // 等待初始化完成
+    while (!shared_data_->is_initialized.load()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+
+    return true;
+}
+
+void TargetPositionTable::cleanup()
+{
+    if (shared_data_ != nullptr && shared_data_ != MAP_FAILED) {
+        munmap(shared_data_, sizeof(SharedData));
+        shared_data_ = nullptr;
+    }
+
+    if (shm_fd_ != -1) {
+        close(shm_fd_);
+        shm_fd_ = -1;
+    }
+
+    if (is_creator_) {
+        shm_unlink(shm_name_.c_str());
+    }
+}
+
+uint32_t TargetPositionTable::intern_symbol_locked(const std::string& symbol)
+{
+    if (symbol.empty() || symbol.size() >= SYMBOL_LENGTH) {
+        return INVALID_SYMBOL_INDEX;
+    }
+
+    auto it = symbol_cache_.find(symbol);
+    if (it != symbol_cache_.end()) {
+        return it->second;
+    }
+
+    // 本进程缓存未命中时扫描目录（表可能由之前的写者填充过）
+    uint32_t count = shared_data_->symbol_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (symbol == shared_data_->symbols[i]) {
+            symbol_cache_[symbol] = i;
+            return i;
+        }
+    }
+
+    if (count >= MAX_SYMBOLS) {
+        return INVALID_SYMBOL_INDEX;
+    }
+
+    // 先写名字再发布下标，读者看到的目录项总是完整的
+    std::memset(shared_data_->symbols[count], 0, SYMBOL_LENGTH);
+    std::memcpy(shared_data_->symbols[count], symbol.data(), symbol.size());
+    shared_data_->symbol_count.store(count + 1, std::memory_order_release);
+    symbol_cache_[symbol] = count;
+    return count;
+}
+
+uint64_t TargetPositionTable::publish(const std::vector<TargetPositionEntry>& targets)
+{
+    if (!shared_data_ || !shared_data_->is_initialized.load() || targets.size() > MAX_ROWS) {
+        publish_failures_.fetch_add(1);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+
+    // 交易对目录在整表seqlock之外登记，失败时表内容保持不变
+    std::vector<uint32_t> indices(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i) {
+        indices[i] = intern_symbol_locked(targets[i].symbol);
+        if (indices[i] == INVALID_SYMBOL_INDEX) {
+            publish_failures_.fetch_add(1);
+            return 0;
+        }
+    }
+
+    uint64_t generation = shared_data_->generation.load(std::memory_order_relaxed) + 1;
+    uint32_t table_sequence = shared_data_->table_sequence.load(std::memory_order_relaxed);
+    shared_data_->table_sequence.store(table_sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        TargetRow& row = shared_data_->rows[i];
+        uint32_t row_sequence = row.sequence.load(std::memory_order_relaxed);
+        row.sequence.store(row_sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        row.symbol_index.store(indices[i], std::memory_order_relaxed);
+        row.quantity.store(to_fixed(targets[i].quantity), std::memory_order_relaxed);
+        row.generation.store(generation, std::memory_order_relaxed);
+
+        row.sequence.store(row_sequence + 2, std::memory_order_release);
+    }
+
+    shared_data_->row_count.store(static_cast<uint32_t>(targets.size()), std::memory_order_relaxed);
+    shared_data_->generation.store(generation, std::memory_order_relaxed);
+    shared_data_->table_sequence.store(table_sequence + 2, std::memory_order_release);
+
+    publishes_.fetch_add(1);
+    return generation;
+}
+
+uint64_t TargetPositionTable::generation() const
+{
+    if (!shared_data_) {
+        return 0;
+    }
+    return shared_data_->generation.load(std::memory_order_acquire);
+}
+
+bool TargetPositionTable::read_snapshot(TargetPositionSnapshot& snapshot) const
+{
+    if (!shared_data_ || !shared_data_->is_initialized.load()) {
+        return false;
+    }
+
+    std::vector<std::pair<uint32_t, int64_t>> rows;
+    rows.reserve(MAX_ROWS);
+    int spins = 0;
+
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint32_t begin = shared_data_->table_sequence.load(std::memory_order_acquire);
+        if (begin & 1) {
+            read_retries_.fetch_add(1);
+            backoff(spins);
+            continue;
+        }
+
+        uint64_t generation = shared_data_->generation.load(std::memory_order_relaxed);
+        uint32_t count = shared_data_->row_count.load(std::memory_order_relaxed);
+        if (count > MAX_ROWS) {
+            count = MAX_ROWS;
+        }
+
+        rows.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            const TargetRow& row = shared_data_->rows[i];
+            rows.emplace_back(row.symbol_index.load(std::memory_order_relaxed),
+                              row.quantity.load(std::memory_order_relaxed));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shared_data_->table_sequence.load(std::memory_order_relaxed) != begin) {
+            read_retries_.fetch_add(1);
+            continue;
+        }
+
+        // 快照已一致，再把下标翻译成交易对名（目录只追加，无需再校验）
+        snapshot.generation = generation;
+        snapshot.targets.clear();
+        snapshot.targets.reserve(rows.size());
+        uint32_t symbol_count = shared_data_->symbol_count.load(std::memory_order_acquire);
+        for (const auto& row : rows) {
+            if (row.first < symbol_count) {
+                snapshot.targets.emplace_back(shared_data_->symbols[row.first], from_fixed(row.second));
+            }
+        }
+        snapshot_reads_.fetch_add(1);
+        return true;
+    }
+
+    return false;
+}
+
+bool TargetPositionTable::read_target(const std::string& symbol, double& quantity, uint64_t& generation) const
+{
+    if (!shared_data_ || !shared_data_->is_initialized.load()) {
+        return false;
+    }
+
+    uint32_t symbol_count = shared_data_->symbol_count.load(std::memory_order_acquire);
+    uint32_t symbol_index = INVALID_SYMBOL_INDEX;
+    for (uint32_t i = 0; i < symbol_count; ++i) {
+        if (symbol == shared_data_->symbols[i]) {
+            symbol_index = i;
+            break;
+        }
+    }
+    if (symbol_index == INVALID_SYMBOL_INDEX) {
+        return false;
+    }
+
+    uint32_t count = std::min<uint32_t>(shared_data_->row_count.load(std::memory_order_acquire),
+                                        static_cast<uint32_t>(MAX_ROWS));
+    for (uint32_t i = 0; i < count; ++i) {
+        const TargetRow& row = shared_data_->rows[i];
+        int spins = 0;
+        for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+            uint32_t begin = row.sequence.load(std::memory_order_acquire);
+            if (begin & 1) {
+                backoff(spins);
+                continue;
+            }
+            uint32_t row_symbol = row.symbol_index.load(std::memory_order_relaxed);
+            int64_t row_quantity = row.quantity.load(std::memory_order_relaxed);
+            uint64_t row_generation = row.generation.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (row.sequence.load(std::memory_order_relaxed) != begin) {
+                read_retries_.fetch_add(1);
+                continue;
+            }
+            if (row_symbol == symbol_index) {
+                quantity = from_fixed(row_quantity);
+                generation = row_generation;
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+
+bool TargetPositionTable::wait_for_generation(uint64_t after, std::chrono::microseconds timeout) const
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    int spins = 0;
+    while (generation() <= after) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        backoff(spins);
+    }
+    return true;
+}
+
+void TargetPositionTable::acknowledge(uint64_t generation, TargetAckStatus status)
+{
+    if (!shared_data_) {
+        return;
+    }
+    shared_data_->ack_word.store(pack_ack(generation, status), std::memory_order_release);
+}
+
+bool TargetPositionTable::get_acknowledgement(uint64_t& generation, TargetAckStatus& status) const
+{
+    if (!shared_data_) {
+        return false;
+    }
+    uint64_t word = shared_data_->ack_word.load(std::memory_order_acquire);
+    generation = word >> 8;
+    status = static_cast<TargetAckStatus>(word & 0xff);
+    return true;
+}
+
+bool TargetPositionTable::wait_for_acknowledgement(uint64_t generation, TargetAckStatus& status,
+                                                   std::chrono::microseconds timeout) const
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    int spins = 0;
+    while (true) {
+        uint64_t acked = 0;
+        if (get_acknowledgement(acked, status) && acked >= generation && status != TargetAckStatus::PENDING) {
+            return true;
+        }
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        backoff(spins);
+    }
+}
+
+std::string TargetPositionTable::symbol_at(uint32_t index) const
+{
+    if (!shared_data_ || index >= shared_data_->symbol_count.load(std::memory_order_acquire)) {
+        return std::string();
+    }
+    return std::string(shared_data_->symbols[index]);
+}
+
+TargetPositionTable::Statistics TargetPositionTable::get_statistics() const
+{
+    return {
+        publishes_.load(),
+        publish_failures_.load(),
+        snapshot_reads_.load(),
+        read_retries_.load()
+    };
+}
+
+} // namespace shared_memory
+} // namespace tes
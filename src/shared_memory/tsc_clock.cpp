@@ -0,0 +1,291 @@
+#include "shared_memory/core/tsc_clock.h"
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <time.h>
+
+#if TES_HAS_TSC
+#include <cpuid.h>
+#endif
+
+namespace tes {
+namespace shared_memory {
+
+namespace {
+
+constexpr int SAMPLE_ATTEMPTS = 8;
+constexpr int MAX_READ_ATTEMPTS = 1000;
+constexpr auto CALIBRATION_PERIOD = std::chrono::milliseconds(10);
+
+inline int64_t clock_ns(clockid_t clock_id) {
+    struct timespec ts;
+    clock_gettime(clock_id, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+// 恒定TSC：频率不随变频/休眠变化，各核同步
+bool has_invariant_tsc() {
+#if TES_HAS_TSC
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+        return false;
+    }
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+TscClock& TscClock::instance()
+{
+    static TscClock clock;
+    return clock;
+}
+
+TscClock::TscClock()
+    : tsc_enabled_(has_invariant_tsc()), anchor_{0, 0, 0}, drift_interval_ns_(1000000000LL), worker_running_(false)
+{
+    calibrate();
+}
+
+TscClock::~TscClock()
+{
+    stop_drift_correction();
+}
+
+uint64_t TscClock::fallback_ticks()
+{
+    return static_cast<uint64_t>(clock_ns(CLOCK_MONOTONIC));
+}
+
+TscClock::Sample TscClock::take_sample() const
+{
+    // 取最窄的一次夹逼：两次读计数之间读系统时钟，计数取中点
+    Sample best{0, 0, 0};
+    uint64_t best_width = std::numeric_limits<uint64_t>::max();
+    for (int i = 0; i < SAMPLE_ATTEMPTS; ++i) {
+        uint64_t before = ticks_serialized();
+        int64_t mono_ns = clock_ns(CLOCK_MONOTONIC);
+        int64_t real_ns = clock_ns(CLOCK_REALTIME);
+        uint64_t after = ticks_serialized();
+        if (after - before < best_width) {
+            best_width = after - before;
+            best.ticks = before + (after - before) / 2;
+            best.mono_ns = mono_ns;
+            best.real_ns = real_ns;
+        }
+    }
+    if (!tsc_enabled_) {
+        best.ticks = static_cast<uint64_t>(best.mono_ns);
+    }
+    return best;
+}
+
+void TscClock::calibrate()
+{
+    std::lock_guard<std::mutex> lock(calibration_mutex_);
+    Params params{0, 0, uint64_t(1) << MULT_SHIFT, 0};
+
+    if (tsc_enabled_) {
+        anchor_ = take_sample();
+        std::this_thread::sleep_for(CALIBRATION_PERIOD);
+        Sample sample = take_sample();
+
+        uint64_t elapsed_ticks = sample.ticks - anchor_.ticks;
+        int64_t elapsed_ns = sample.mono_ns - anchor_.mono_ns;
+        if (elapsed_ticks > 0 && elapsed_ns > 0) {
+            params.base_ticks = sample.ticks;
+            params.base_mono_ns = sample.mono_ns;
+            params.mult = static_cast<uint64_t>(
+                (static_cast<unsigned __int128>(elapsed_ns) << MULT_SHIFT) / elapsed_ticks);
+            params.realtime_offset_ns = sample.real_ns - sample.mono_ns;
+        } else {
+            tsc_enabled_ = false;
+        }
+    }
+
+    if (!tsc_enabled_) {
+        anchor_ = take_sample();
+        params.base_ticks = anchor_.ticks;
+        params.base_mono_ns = anchor_.mono_ns;
+        params.realtime_offset_ns = anchor_.real_ns - anchor_.mono_ns;
+    }
+
+    store_params(params);
+}
+
+TscClock::Params TscClock::load_params() const
+{
+    Params params{0, 0, uint64_t(1) << MULT_SHIFT, 0};
+    for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+        uint64_t begin = sequence_.load(std::memory_order_acquire);
+        if (begin & 1) {
+            continue;
+        }
+
+        params.base_ticks = base_ticks_.load(std::memory_order_relaxed);
+        params.base_mono_ns = base_mono_ns_.load(std::memory_order_relaxed);
+        params.mult = mult_.load(std::memory_order_relaxed);
+        params.realtime_offset_ns = realtime_offset_ns_.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) == begin) {
+            break;
+        }
+    }
+    return params;
+}
+
+void TscClock::store_params(const Params& params)
+{
+    uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    base_ticks_.store(params.base_ticks, std::memory_order_relaxed);
+    base_mono_ns_.store(params.base_mono_ns, std::memory_order_relaxed);
+    mult_.store(params.mult, std::memory_order_relaxed);
+    realtime_offset_ns_.store(params.realtime_offset_ns, std::memory_order_relaxed);
+
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+int64_t TscClock::apply(const Params& params, uint64_t ticks)
+{
+    // 按有符号差值换算，修正后基点之前的计数也能正确换算
+    int64_t delta = static_cast<int64_t>(ticks - params.base_ticks);
+    __int128 scaled = static_cast<__int128>(delta) * static_cast<__int128>(params.mult);
+    return params.base_mono_ns + static_cast<int64_t>(scaled >> MULT_SHIFT);
+}
+
+int64_t TscClock::to_monotonic_ns(uint64_t ticks) const
+{
+    return apply(load_params(), ticks);
+}
+
+int64_t TscClock::to_realtime_ns(uint64_t ticks) const
+{
+    Params params = load_params();
+    return apply(params, ticks) + params.realtime_offset_ns;
+}
+
+TscClock::TimePoint TscClock::to_time_point(uint64_t ticks) const
+{
+    using Clock = std::chrono::high_resolution_clock;
+    int64_t ns = std::is_same<Clock, std::chrono::steady_clock>::value ? to_monotonic_ns(ticks)
+                                                                       : to_realtime_ns(ticks);
+    return TimePoint(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
+int64_t TscClock::ticks_to_ns(uint64_t delta_ticks) const
+{
+    uint64_t mult = mult_.load(std::memory_order_relaxed);
+    return static_cast<int64_t>((static_cast<unsigned __int128>(delta_ticks) * mult) >> MULT_SHIFT);
+}
+
+int64_t TscClock::recalibrate()
+{
+    std::lock_guard<std::mutex> lock(calibration_mutex_);
+    Sample sample = take_sample();
+    Params params = load_params();
+    int64_t predicted_ns = apply(params, sample.ticks);
+    int64_t drift_ns = sample.mono_ns - predicted_ns;
+
+    if (tsc_enabled_ && sample.ticks > anchor_.ticks && sample.mono_ns > anchor_.mono_ns) {
+        // 长期斜率：从启动标定点到现在的平均频率
+        uint64_t measured_mult = static_cast<uint64_t>(
+            (static_cast<unsigned __int128>(sample.mono_ns - anchor_.mono_ns) << MULT_SHIFT) /
+            (sample.ticks - anchor_.ticks));
+
+        params.base_ticks = sample.ticks;
+        if (drift_ns > STEP_THRESHOLD_NS || drift_ns < -STEP_THRESHOLD_NS) {
+            params.base_mono_ns = sample.mono_ns;
+            params.mult = measured_mult;
+            steps_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            // 从当前换算值出发，调整斜率使下一个修正周期结束时追上CLOCK_MONOTONIC
+            params.base_mono_ns = predicted_ns;
+            __int128 slewed = static_cast<__int128>(measured_mult) * (drift_interval_ns_ + drift_ns) / drift_interval_ns_;
+            __int128 limit = static_cast<__int128>(measured_mult) * MAX_SLEW_PPM / 1000000;
+            slewed = std::max<__int128>(measured_mult - limit, std::min<__int128>(measured_mult + limit, slewed));
+            params.mult = static_cast<uint64_t>(slewed);
+        }
+    } else if (!tsc_enabled_) {
+        drift_ns = 0;
+    }
+    // 系统时间可能被NTP或人工调整，偏移每次直接取最新值
+    params.realtime_offset_ns = sample.real_ns - sample.mono_ns;
+    store_params(params);
+
+    recalibrations_.fetch_add(1, std::memory_order_relaxed);
+    last_drift_ns_.store(drift_ns, std::memory_order_relaxed);
+    int64_t abs_drift = drift_ns < 0 ? -drift_ns : drift_ns;
+    if (abs_drift > max_abs_drift_ns_.load(std::memory_order_relaxed)) {
+        max_abs_drift_ns_.store(abs_drift, std::memory_order_relaxed);
+    }
+    return drift_ns;
+}
+
+void TscClock::start_drift_correction(std::chrono::milliseconds interval)
+{
+    std::lock_guard<std::mutex> lock(worker_mutex_);
+    if (worker_running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> calibration_lock(calibration_mutex_);
+        drift_interval_ns_ = std::max<int64_t>(1000000LL,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count());
+    }
+    worker_running_ = true;
+    worker_ = std::thread(&TscClock::drift_worker, this, interval);
+}
+
+void TscClock::stop_drift_correction()
+{
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex_);
+        if (!worker_running_) {
+            return;
+        }
+        worker_running_ = false;
+    }
+    worker_cv_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void TscClock::drift_worker(std::chrono::milliseconds interval)
+{
+    std::unique_lock<std::mutex> lock(worker_mutex_);
+    while (worker_running_) {
+        if (worker_cv_.wait_for(lock, interval, [this] { return !worker_running_; })) {
+            break;
+        }
+        lock.unlock();
+        recalibrate();
+        lock.lock();
+    }
+}
+
+TscClock::Statistics TscClock::get_statistics() const
+{
+    uint64_t mult = mult_.load(std::memory_order_relaxed);
+    return {
+        tsc_enabled_,
+        mult ? static_cast<double>(uint64_t(1) << MULT_SHIFT) / static_cast<double>(mult) : 0.0,
+        recalibrations_.load(),
+        steps_.load(),
+        last_drift_ns_.load(),
+        max_abs_drift_ns_.load()
+    };
+}
+
+} // namespace shared_memory
+} // namespace tes
@@ -0,0 +1,230 @@
+// 账户信息响应解析基准（300个交易对）
+// 对比两种解码方式处理同一条v2/account.status响应的耗时：
+//   eager - 原来的完整解码：每个资产/持仓的全部字段物化为AccountAsset/AccountPosition
+//   view  - AccountInfoView：只读取网关实际使用的symbol/positionAmt/entryPrice/unrealizedProfit
+// 两者都包含yyjson_read和释放文档；另单独给出yyjson_read本身的耗时作为下限。
+// 用法：bench_account_info_parse [迭代次数=2000] [交易对数=300]
+
+#include "data_structures.h"
+#include "message_views.h"
+#include "yyjson.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace trading;
+
+namespace {
+
+constexpr size_t ASSET_COUNT = 10;
+
+// 读取但不参与校验和的字段写到这里，防止被优化掉
+volatile double g_field_sink = 0.0;
+
+std::string build_account_response(size_t symbol_count)
+{
+    std::string json;
+    json.reserve(symbol_count * 700 + 4096);
+    json += "{\"id\":\"account-status-1\",\"status\":200,\"result\":{"
+            "\"totalInitialMargin\":\"1234.56\",\"totalMaintMargin\":\"123.45\",\"totalWalletBalance\":\"100000.00\","
+            "\"totalUnrealizedProfit\":\"-12.34\",\"totalMarginBalance\":\"99987.66\",\"totalPositionInitialMargin\":\"1234.56\","
+            "\"totalOpenOrderInitialMargin\":\"0.00\",\"totalCrossWalletBalance\":\"100000.00\",\"totalCrossUnPnl\":\"-12.34\","
+            "\"availableBalance\":\"98765.43\",\"maxWithdrawAmount\":\"98765.43\",\"assets\":[";
+    const char* assets[ASSET_COUNT] = {"USDT", "BTC", "ETH", "BNB", "USDC", "FDUSD", "SOL", "XRP", "DOGE", "TRX"};
+    for (size_t i = 0; i < ASSET_COUNT; ++i) {
+        json += i ? ",{" : "{";
+        json += "\"asset\":\"" + std::string(assets[i]) + "\",\"walletBalance\":\"1000.00000000\","
+                "\"unrealizedProfit\":\"0.00000000\",\"marginBalance\":\"1000.00000000\",\"maintMargin\":\"0.00000000\","
+                "\"initialMargin\":\"0.00000000\",\"positionInitialMargin\":\"0.00000000\","
+                "\"openOrderInitialMargin\":\"0.00000000\",\"crossWalletBalance\":\"1000.00000000\","
+                "\"crossUnPnl\":\"0.00000000\",\"availableBalance\":\"1000.00000000\","
+                "\"maxWithdrawAmount\":\"1000.00000000\",\"updateTime\":1700000000000}";
+    }
+    json += "],\"positions\":[";
+    for (size_t i = 0; i < symbol_count; ++i) {
+        char row[768];
+        double amount = (i % 3 == 0) ? 0.0 : (i % 2 ? 1.0 : -1.0) * (0.001 * (i + 1));
+        std::snprintf(row, sizeof(row),
+                      "%s{\"symbol\":\"SYM%03zuUSDT\",\"positionSide\":\"BOTH\",\"positionAmt\":\"%.3f\","
+                      "\"unrealizedProfit\":\"%.8f\",\"isolatedMargin\":\"0.00000000\",\"notional\":\"%.8f\","
+                      "\"isolatedWallet\":\"0\",\"initialMargin\":\"%.8f\",\"maintMargin\":\"%.8f\","
+                      "\"updateTime\":1700000000000,\"entryPrice\":\"%.4f\",\"breakEvenPrice\":\"%.4f\","
+                      "\"markPrice\":\"%.4f\",\"liquidationPrice\":\"0\",\"leverage\":\"20\","
+                      "\"maxNotionalValue\":\"25000000\",\"marginType\":\"cross\",\"isAutoAddMargin\":false,"
+                      "\"bidNotional\":\"0\",\"askNotional\":\"0\"}",
+                      i ? "," : "", i, amount, amount * 0.5, amount * 100.0, amount * 5.0, amount * 0.4,
+                      100.0 + i, 100.1 + i, 100.5 + i);
+        json += row;
+    }
+    json += "]}}";
+    return json;
+}
+
+void copy_str(yyjson_val* obj, const char* key, std::string& out)
+{
+    yyjson_val* val = yyjson_obj_get(obj, key);
+    if (val && yyjson_is_str(val)) {
+        out.assign(yyjson_get_str(val), yyjson_get_len(val));
+    }
+}
+
+int64_t copy_int(yyjson_val* obj, const char* key)
+{
+    yyjson_val* val = yyjson_obj_get(obj, key);
+    return val && yyjson_is_int(val) ? yyjson_get_sint(val) : 0;
+}
+
+// 原来的完整解码：与BinanceWebSocket::parseAccountInfoResponse物化相同的字段
+double decode_eager(const std::string& json)
+{
+    yyjson_doc* doc = yyjson_read(json.data(), json.size(), 0);
+    yyjson_val* root = yyjson_doc_get_root(doc);
+    AccountInfoResponse response;
+    copy_str(root, "id", response.id);
+    response.status = static_cast<int>(copy_int(root, "status"));
+
+    yyjson_val* result = yyjson_obj_get(root, "result");
+    copy_str(result, "totalInitialMargin", response.totalInitialMargin);
+    copy_str(result, "totalMaintMargin", response.totalMaintMargin);
+    copy_str(result, "totalWalletBalance", response.totalWalletBalance);
+    copy_str(result, "totalUnrealizedProfit", response.totalUnrealizedProfit);
+    copy_str(result, "totalMarginBalance", response.totalMarginBalance);
+    copy_str(result, "totalPositionInitialMargin", response.totalPositionInitialMargin);
+    copy_str(result, "totalOpenOrderInitialMargin", response.totalOpenOrderInitialMargin);
+    copy_str(result, "totalCrossWalletBalance", response.totalCrossWalletBalance);
+    copy_str(result, "totalCrossUnPnl", response.totalCrossUnPnl);
+    copy_str(result, "availableBalance", response.availableBalance);
+    copy_str(result, "maxWithdrawAmount", response.maxWithdrawAmount);
+
+    size_t idx, max;
+    yyjson_val* item;
+    yyjson_val* assets = yyjson_obj_get(result, "assets");
+    yyjson_arr_foreach(assets, idx, max, item) {
+        AccountAsset asset;
+        copy_str(item, "asset", asset.asset);
+        copy_str(item, "walletBalance", asset.walletBalance);
+        copy_str(item, "unrealizedProfit", asset.unrealizedProfit);
+        copy_str(item, "marginBalance", asset.marginBalance);
+        copy_str(item, "maintMargin", asset.maintMargin);
+        copy_str(item, "initialMargin", asset.initialMargin);
+        copy_str(item, "positionInitialMargin", asset.positionInitialMargin);
+        copy_str(item, "openOrderInitialMargin", asset.openOrderInitialMargin);
+        copy_str(item, "crossWalletBalance", asset.crossWalletBalance);
+        copy_str(item, "crossUnPnl", asset.crossUnPnl);
+        copy_str(item, "availableBalance", asset.availableBalance);
+        copy_str(item, "maxWithdrawAmount", asset.maxWithdrawAmount);
+        asset.updateTime = copy_int(item, "updateTime");
+        response.assets.push_back(std::move(asset));
+    }
+
+    yyjson_val* positions = yyjson_obj_get(result, "positions");
+    yyjson_arr_foreach(positions, idx, max, item) {
+        AccountPosition position;
+        copy_str(item, "symbol", position.symbol);
+        copy_str(item, "positionSide", position.positionSide);
+        copy_str(item, "positionAmt", position.positionAmt);
+        copy_str(item, "unrealizedProfit", position.unrealizedProfit);
+        copy_str(item, "isolatedMargin", position.isolatedMargin);
+        copy_str(item, "notional", position.notional);
+        copy_str(item, "isolatedWallet", position.isolatedWallet);
+        copy_str(item, "initialMargin", position.initialMargin);
+        copy_str(item, "maintMargin", position.maintMargin);
+        position.updateTime = copy_int(item, "updateTime");
+        copy_str(item, "entryPrice", position.entryPrice);
+        copy_str(item, "breakEvenPrice", position.breakEvenPrice);
+        copy_str(item, "markPrice", position.markPrice);
+        copy_str(item, "liquidationPrice", position.liquidationPrice);
+        copy_str(item, "leverage", position.leverage);
+        copy_str(item, "maxNotionalValue", position.maxNotionalValue);
+        copy_str(item, "marginType", position.marginType);
+        yyjson_val* auto_add = yyjson_obj_get(item, "isAutoAddMargin");
+        position.isAutoAddMargin = auto_add && yyjson_is_bool(auto_add) && yyjson_get_bool(auto_add);
+        copy_str(item, "bidNotional", position.bidNotional);
+        copy_str(item, "askNotional", position.askNotional);
+        response.positions.push_back(std::move(position));
+    }
+
+    // 消费者按字符串再转换数量
+    double checksum = 0.0;
+    for (const auto& position : response.positions) {
+        checksum += std::strtod(position.positionAmt.c_str(), nullptr);
+    }
+    yyjson_doc_free(doc);
+    return checksum;
+}
+
+// 视图解码：只触及网关账户快照处理实际读取的字段
+double decode_view(const std::string& json)
+{
+    yyjson_doc* doc = yyjson_read(json.data(), json.size(), 0);
+    AccountInfoView view(yyjson_doc_get_root(doc));
+    double checksum = 0.0;
+    double fields = 0.0;
+    view.forEachPosition([&checksum, &fields](const AccountPositionView& position) {
+        if (position.symbol().empty()) {
+            return;
+        }
+        checksum += position.positionAmtValue();
+        fields += position.entryPrice() + position.unrealizedProfit();
+    });
+    g_field_sink = g_field_sink + fields;
+    yyjson_doc_free(doc);
+    return checksum;
+}
+
+double parse_only(const std::string& json)
+{
+    yyjson_doc* doc = yyjson_read(json.data(), json.size(), 0);
+    double checksum = doc ? 1.0 : 0.0;
+    yyjson_doc_free(doc);
+    return checksum;
+}
+
+template <typename Fn>
+void run(const char* name, Fn&& fn, const std::string& json, size_t iterations, size_t symbol_count)
+{
+    std::vector<double> samples_us;
+    samples_us.reserve(iterations);
+    volatile double sink = 0.0;
+    for (size_t i = 0; i < iterations / 10 + 1; ++i) {
+        sink = sink + fn(json);     // 预热
+    }
+    for (size_t i = 0; i < iterations; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        sink = sink + fn(json);
+        samples_us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(samples_us.begin(), samples_us.end());
+    double p50 = samples_us[samples_us.size() / 2];
+    double p99 = samples_us[std::min(samples_us.size() - 1, samples_us.size() * 99 / 100)];
+    std::printf("%-10s %10.1f %10.1f %14.1f\n", name, p50, p99, p50 * 1000.0 / symbol_count);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t symbol_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 300;
+    if (iterations == 0 || symbol_count == 0) {
+        std::fprintf(stderr, "usage: %s [iterations] [symbols]\n", argv[0]);
+        return 1;
+    }
+
+    std::string json = build_account_response(symbol_count);
+    if (decode_eager(json) != decode_view(json)) {
+        std::fprintf(stderr, "eager and view decoding disagree\n");
+        return 1;
+    }
+
+    std::printf("account info parse, %zu positions, %zu bytes, %zu iterations\n",
+                symbol_count, json.size(), iterations);
+    std::printf("%-10s %10s %10s %14s\n", "mode", "p50_us", "p99_us", "ns_per_symbol");
+    run("parse", parse_only, json, iterations, symbol_count);
+    run("eager", decode_eager, json, iterations, symbol_count);
+    run("view", decode_view, json, iterations, symbol_count);
+    return 0;
+}
@@ -0,0 +1,131 @@
+// 订单回报唤醒延迟基准
+// 写者进程写入一条回报并调用notify_readers，fork出的读者进程等到回报后记录"写入->读者拿到"的延迟。
+// 对比两种等待方式：
+//   futex - OrderFeedbackBuffer::wait_for_feedback，无回报时挂起在段内futex字上
+//   poll  - 原来的轮询：available_feedbacks()为0时sleep_for固定间隔再查
+// 用法：bench_feedback_wake_latency [次数=5000] [轮询间隔us=100]
+
+#include "shared_memory/core/order_feedback_buffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::shared_memory;
+
+namespace {
+
+enum class WaitMode { FUTEX, POLL };
+
+uint64_t now_ns()
+{
+    return get_current_timestamp_ns();
+}
+
+// 读者进程：逐条等待回报，统计延迟分位数和本进程CPU时间
+[[noreturn]] void run_reader(const std::string& name, WaitMode mode, size_t iterations,
+                             std::chrono::microseconds poll_interval)
+{
+    OrderFeedbackBuffer buffer(name, false);
+    std::vector<uint64_t> latencies;
+    latencies.reserve(iterations);
+
+    OrderFeedback feedback;
+    while (latencies.size() < iterations) {
+        if (mode == WaitMode::FUTEX) {
+            if (!buffer.wait_for_feedback(std::chrono::seconds(5))) {
+                std::fprintf(stderr, "reader timed out after %zu feedbacks\n", latencies.size());
+                _exit(1);
+            }
+        } else {
+            while (buffer.available_feedbacks() == 0) {
+                std::this_thread::sleep_for(poll_interval);
+            }
+        }
+        while (buffer.read_feedback(feedback)) {
+            uint64_t received = now_ns();
+            latencies.push_back(received > feedback.timestamp ? received - feedback.timestamp : 0);
+        }
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t index = std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()));
+        return latencies[index] / 1000.0;
+    };
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    double cpu_ms = usage.ru_utime.tv_sec * 1e3 + usage.ru_utime.tv_usec / 1e3 +
+                    usage.ru_stime.tv_sec * 1e3 + usage.ru_stime.tv_usec / 1e3;
+
+    std::printf("%-6s %8zu %10.1f %10.1f %10.1f %10.1f %12.1f\n",
+                mode == WaitMode::FUTEX ? "futex" : "poll", latencies.size(),
+                percentile(0.50), percentile(0.90), percentile(0.99), latencies.back() / 1000.0, cpu_ms);
+    std::fflush(stdout);
+    _exit(0);
+}
+
+bool run_mode(WaitMode mode, size_t iterations, std::chrono::microseconds poll_interval)
+{
+    std::string name = "wake_bench_" + std::to_string(getpid());
+    OrderFeedbackBuffer buffer(name, true);
+
+    pid_t reader = fork();
+    if (reader == -1) {
+        std::perror("fork");
+        return false;
+    }
+    if (reader == 0) {
+        run_reader(name, mode, iterations, poll_interval);
+    }
+
+    // 每条回报之间随机间隔，让读者有机会挂起（futex）或进入睡眠（轮询）
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> gap_us(50, 500);
+    OrderFeedback feedback;
+    feedback.status = OrderStatus::FILLED;
+    for (size_t i = 0; i < iterations; ++i) {
+        while (buffer.available_feedbacks() != 0) {
+            std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(gap_us(rng)));
+
+        std::snprintf(feedback.order_id, sizeof(feedback.order_id), "bench_%zu", i);
+        while (!buffer.write_feedback(feedback)) {
+            std::this_thread::yield();
+        }
+        buffer.notify_readers();
+    }
+
+    int status = 0;
+    waitpid(reader, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 5000;
+    std::chrono::microseconds poll_interval(argc > 2 ? std::strtol(argv[2], nullptr, 10) : 100);
+    if (iterations == 0 || poll_interval.count() <= 0) {
+        std::fprintf(stderr, "usage: %s [iterations] [poll_interval_us]\n", argv[0]);
+        return 1;
+    }
+
+    std::printf("order feedback wake latency, %zu feedbacks, poll interval %ldus (latency in us)\n",
+                iterations, static_cast<long>(poll_interval.count()));
+    std::printf("%-6s %8s %10s %10s %10s %10s %12s\n", "mode", "count", "p50", "p90", "p99", "max", "reader_cpu_ms");
+    std::fflush(stdout);
+
+    bool ok = run_mode(WaitMode::FUTEX, iterations, poll_interval);
+    ok = run_mode(WaitMode::POLL, iterations, poll_interval) && ok;
+    return ok ? 0 : 1;
+}
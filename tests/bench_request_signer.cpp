@@ -0,0 +1,103 @@
+// 请求签名吞吐基准（每秒签名次数）
+// 对同一条下单参数串反复签名，对比：
+//   hmac           - RequestSigner预计算ipad/opad后的HMAC-SHA256
+//   ed25519        - RequestSigner启动时解析一次私钥，签名上下文复用
+//   ed25519_reload - 原来的做法：每次签名都重新打开并解析PEM私钥
+// 私钥为运行时临时生成的Ed25519密钥，写在/tmp下，结束后删除。
+// 用法：bench_request_signer [次数=20000]
+
+#include "request_signer.h"
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <unistd.h>
+
+using namespace trading;
+
+namespace {
+
+const std::string ORDER_PARAMS =
+    "apiKey=vmPUZE6mv9SD5VNHk4HlWFsOr6aKE2zvsw0MuIgwCIPy6utIco14y7Ju91duEh8A"
+    "&newClientOrderId=TES_BTCUSDT_1700000000000_42&price=43210.5&quantity=0.002"
+    "&side=BUY&symbol=BTCUSDT&timeInForce=GTC&timestamp=1700000000000&type=LIMIT";
+
+bool write_temp_ed25519_key(const std::string& path)
+{
+    EVP_PKEY* pkey = nullptr;
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_ED25519, nullptr);
+    bool ok = ctx && EVP_PKEY_keygen_init(ctx) > 0 && EVP_PKEY_keygen(ctx, &pkey) > 0;
+    EVP_PKEY_CTX_free(ctx);
+    if (!ok) {
+        return false;
+    }
+
+    FILE* file = std::fopen(path.c_str(), "w");
+    ok = file && PEM_write_PrivateKey(file, pkey, nullptr, nullptr, 0, nullptr, nullptr) > 0;
+    if (file) {
+        std::fclose(file);
+    }
+    EVP_PKEY_free(pkey);
+    return ok;
+}
+
+void run(const char* name, size_t iterations, const std::function<size_t()>& sign_once)
+{
+    size_t total_length = 0;
+    for (size_t i = 0; i < iterations / 10 + 1; ++i) {
+        total_length += sign_once();     // 预热
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        total_length += sign_once();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-16s %12.0f %12.2f %10zu\n", name, iterations / seconds, seconds * 1e6 / iterations,
+                total_length / (iterations + iterations / 10 + 1));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    if (iterations == 0) {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    std::string key_path = "/tmp/bench_request_signer_" + std::to_string(getpid()) + ".pem";
+    if (!write_temp_ed25519_key(key_path)) {
+        std::fprintf(stderr, "failed to generate Ed25519 key\n");
+        return 1;
+    }
+
+    RequestSigner signer;
+    bool ready = signer.initHmac("NhqPtmdSJYdKjVHjA7PZj4Mge3R5YNiP1e3UZjInClVN65XAbvqqM6A7H5fATj0j") &&
+                 signer.initEd25519FromFile(key_path);
+    if (!ready) {
+        std::fprintf(stderr, "failed to initialize signer\n");
+        std::remove(key_path.c_str());
+        return 1;
+    }
+
+    char out[RequestSigner::MAX_SIGNATURE_LENGTH];
+    std::printf("request signing, %zu-byte payload, %zu iterations\n", ORDER_PARAMS.size(), iterations);
+    std::printf("%-16s %12s %12s %10s\n", "mode", "signs_per_s", "us_per_sign", "sig_len");
+    run("hmac", iterations, [&] {
+        return signer.signHmacSha256(ORDER_PARAMS.data(), ORDER_PARAMS.size(), out, sizeof(out));
+    });
+    run("ed25519", iterations, [&] {
+        return signer.signEd25519(ORDER_PARAMS.data(), ORDER_PARAMS.size(), out, sizeof(out));
+    });
+    run("ed25519_reload", iterations, [&] {
+        signer.initEd25519FromFile(key_path);
+        return signer.signEd25519(ORDER_PARAMS.data(), ORDER_PARAMS.size(), out, sizeof(out));
+    });
+
+    std::remove(key_path.c_str());
+    return 0;
+}
@@ -0,0 +1,135 @@
+// 飞行记录器测试：写入后按位置顺序读回；环写满后只保留最近的事件；
+// 记录进程未正常关闭时，下次打开把原文件改名为.prev保留现场
+
+#include "shared_memory/core/flight_recorder.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::shared_memory;
+
+namespace {
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        path_ = "/tmp/flight_recorder_test_" + std::to_string(getpid());
+        std::remove(path_.c_str());
+        std::remove((path_ + ".prev").c_str());
+    }
+
+    void TearDown() override
+    {
+        FlightRecorder::instance().close();
+        std::remove(path_.c_str());
+        std::remove((path_ + ".prev").c_str());
+    }
+
+    std::string path_;
+};
+
+} // namespace
+
+TEST_F(FlightRecorderTest, WriteAndLoad)
+{
+    FlightRecorder& recorder = FlightRecorder::instance();
+    ASSERT_TRUE(recorder.open(path_, 64));
+    recorder.record(FlightEventType::SIGNAL_IN, 42, 1500);
+    recorder.record(FlightEventType::ORDER_SENT, 42);
+    recorder.record(FlightEventType::FILL, 42, 100000000);
+    recorder.close();
+
+    // 关闭后不再记录
+    recorder.record(FlightEventType::MARK, 7);
+
+    FlightRecorderHeader header;
+    std::vector<FlightEventRecord> events;
+    std::string error;
+    ASSERT_TRUE(FlightRecorder::load(path_, header, events, error)) << error;
+    EXPECT_EQ(64u, header.capacity);
+    EXPECT_EQ(1u, header.clean_shutdown.load());
+    EXPECT_EQ(getpid(), header.pid);
+
+    ASSERT_EQ(3u, events.size());
+    EXPECT_EQ(FlightEventType::SIGNAL_IN, events[0].type);
+    EXPECT_EQ(1500, events[0].value);
+    EXPECT_EQ(FlightEventType::ORDER_SENT, events[1].type);
+    EXPECT_EQ(FlightEventType::FILL, events[2].type);
+    EXPECT_EQ(100000000, events[2].value);
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(i, events[i].position);
+        EXPECT_EQ(42u, events[i].id);
+    }
+    EXPECT_LE(events[0].timestamp_ns, events[2].timestamp_ns);
+}
+
+TEST_F(FlightRecorderTest, LoadReturnsMostRecentEventsInOrder)
+{
+    // 容量8的环写入20条，读回的应是位置12..19，且按位置升序（与槽位顺序不同）
+    FlightRecorder& recorder = FlightRecorder::instance();
+    ASSERT_TRUE(recorder.open(path_, 8));
+    for (uint64_t i = 0; i < 20; ++i) {
+        recorder.record(FlightEventType::MARK, i);
+    }
+    recorder.close();
+
+    FlightRecorderHeader header;
+    std::vector<FlightEventRecord> events;
+    std::string error;
+    ASSERT_TRUE(FlightRecorder::load(path_, header, events, error)) << error;
+    EXPECT_EQ(20u, header.write_index.load());
+    ASSERT_EQ(8u, events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(12 + i, events[i].position);
+        EXPECT_EQ(12 + i, events[i].id);
+    }
+}
+
+TEST_F(FlightRecorderTest, ReopenAfterCrashKeepsPreviousRecording)
+{
+    // 子进程写入后不关闭直接退出，模拟崩溃
+    pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if (child == 0) {
+        FlightRecorder& recorder = FlightRecorder::instance();
+        if (!recorder.open(path_, 16)) {
+            _exit(1);
+        }
+        recorder.record(FlightEventType::SIGNAL_IN, 1001);
+        recorder.record(FlightEventType::ORDER_SENT, 1001);
+        _exit(0);
+    }
+    int status = 0;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    FlightRecorder& recorder = FlightRecorder::instance();
+    ASSERT_TRUE(recorder.open(path_, 16));
+    recorder.record(FlightEventType::MARK, 2002);
+    recorder.close();
+
+    FlightRecorderHeader header;
+    std::vector<FlightEventRecord> events;
+    std::string error;
+    ASSERT_TRUE(FlightRecorder::load(path_ + ".prev", header, events, error)) << error;
+    EXPECT_EQ(0u, header.clean_shutdown.load());
+    EXPECT_EQ(child, header.pid);
+    ASSERT_EQ(2u, events.size());
+    EXPECT_EQ(FlightEventType::SIGNAL_IN, events[0].type);
+    EXPECT_EQ(FlightEventType::ORDER_SENT, events[1].type);
+    EXPECT_EQ(1001u, events[1].id);
+
+    // 新会话从头记录，正常关闭后再打开不会覆盖.prev
+    ASSERT_TRUE(FlightRecorder::load(path_, header, events, error)) << error;
+    ASSERT_EQ(1u, events.size());
+    EXPECT_EQ(2002u, events[0].id);
+
+    ASSERT_TRUE(recorder.open(path_, 16));
+    recorder.close();
+    ASSERT_TRUE(FlightRecorder::load(path_ + ".prev", header, events, error)) << error;
+    EXPECT_EQ(2u, events.size());
+}
@@ -0,0 +1,88 @@
+// 订单回报索引溢出回退测试
+// 探测窗口满导致漏登记的回报仍在环内时，按订单ID查找回退到扫描；
+// 漏登记的回报被环覆盖之后，未命中的查找不再扫描整个环。
+
+#include "shared_memory/core/order_feedback_buffer.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::shared_memory;
+
+namespace {
+
+// 与order_feedback_buffer.cpp中的索引哈希一致（FNV-1a 64位），用于构造落在同一探测窗口的订单ID
+uint64_t fnv1a(const std::string& id)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : id) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+// 生成count个起始槽位相同的订单ID
+std::vector<std::string> colliding_ids(size_t count)
+{
+    const uint64_t mask = OrderFeedbackBuffer::INDEX_SIZE - 1;
+    std::vector<std::string> ids;
+    uint64_t target = fnv1a("ovf_0") & mask;
+    for (uint64_t n = 0; ids.size() < count; ++n) {
+        std::string id = "ovf_" + std::to_string(n);
+        if ((fnv1a(id) & mask) == target) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+bool write_and_consume(OrderFeedbackBuffer& buffer, const std::string& id)
+{
+    OrderFeedback feedback;
+    feedback.set_order_id(id);
+    feedback.status = OrderStatus::FILLED;
+    OrderFeedback consumed;
+    return buffer.write_feedback(feedback) && buffer.read_feedback(consumed);
+}
+
+} // namespace
+
+TEST(OrderFeedbackIndexTest, FallbackScanStopsAfterUnindexedFeedbackAgesOut)
+{
+    std::string name = "feedback_index_test_" + std::to_string(getpid());
+    std::unique_ptr<OrderFeedbackBuffer> buffer(new OrderFeedbackBuffer(name, true));
+
+    // 占满一个探测窗口，再多写一条使其漏登记
+    std::vector<std::string> ids = colliding_ids(OrderFeedbackBuffer::MAX_INDEX_PROBES + 1);
+    for (const auto& id : ids) {
+        ASSERT_TRUE(write_and_consume(*buffer, id));
+    }
+    ASSERT_EQ(1u, buffer->get_statistics().index_overflows);
+
+    // 漏登记的回报只能靠扫描找到
+    OrderFeedback found;
+    EXPECT_TRUE(buffer->find_feedback_by_order_id(ids.back(), found));
+    EXPECT_STREQ(ids.back().c_str(), found.order_id);
+    EXPECT_TRUE(buffer->find_feedback_by_order_id(ids.front(), found));
+    EXPECT_FALSE(buffer->find_feedback_by_order_id("missing", found));
+    uint64_t scans = buffer->get_statistics().fallback_scans;
+    EXPECT_EQ(2u, scans);
+
+    // 写满一整圈，漏登记的回报被覆盖
+    for (size_t i = 0; i < OrderFeedbackBuffer::BUFFER_SIZE; ++i) {
+        ASSERT_TRUE(write_and_consume(*buffer, "age_" + std::to_string(i)));
+    }
+    ASSERT_EQ(1u, buffer->get_statistics().index_overflows);
+
+    EXPECT_FALSE(buffer->find_feedback_by_order_id("missing", found));
+    EXPECT_FALSE(buffer->find_feedback_by_order_id(ids.back(), found));
+    EXPECT_EQ(scans, buffer->get_statistics().fallback_scans);
+
+    // 仍在环内的回报照常通过索引命中
+    std::string recent = "age_" + std::to_string(OrderFeedbackBuffer::BUFFER_SIZE - 1);
+    EXPECT_TRUE(buffer->find_feedback_by_order_id(recent, found));
+    EXPECT_STREQ(recent.c_str(), found.order_id);
+}
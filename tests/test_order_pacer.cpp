@@ -0,0 +1,101 @@
+// 下单限频调度器统计测试：快速路径只在发送成功后计入sentImmediately；
+// 发送失败时归还令牌并计入sendFailures，排队订单失败后重排
+
+#include "order_pacer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace trading;
+
+TEST(OrderPacerTest, FailedImmediateSendIsNotCounted)
+{
+    bool accept = false;
+    int64_t nextRequestId = 1;
+    OrderPacer pacer;
+    pacer.start(OrderPacer::Config(), [&](PacedOrder& order) {
+        order.requestId = nextRequestId++;
+        return accept;
+    });
+
+    PacedOrder rejected;
+    EXPECT_FALSE(pacer.submit(rejected));
+    EXPECT_EQ(0u, pacer.getStatistics().sentImmediately);
+    EXPECT_EQ(1u, pacer.getStatistics().sendFailures);
+
+    accept = true;
+    PacedOrder sent;
+    EXPECT_TRUE(pacer.submit(sent));
+    OrderPacerStatistics stats = pacer.getStatistics();
+    EXPECT_EQ(1u, stats.sentImmediately);
+    EXPECT_EQ(0u, stats.sentFromQueue);
+    EXPECT_EQ(0u, stats.queued);
+
+    pacer.stop();
+}
+
+TEST(OrderPacerTest, FailedImmediateSendReturnsTokens)
+{
+    bool accept = false;
+    int64_t nextRequestId = 1;
+    OrderPacer pacer;
+    pacer.start(OrderPacer::Config(), [&](PacedOrder& order) {
+        order.requestId = nextRequestId++;
+        return accept;
+    });
+    // 每秒只允许一单：失败的发送若未归还令牌，下一单只能排队
+    int slot = pacer.registerStrategy("one_per_second", 1, 0);
+    ASSERT_GT(slot, 0);
+
+    PacedOrder rejected;
+    rejected.strategySlot = slot;
+    EXPECT_FALSE(pacer.submit(rejected));
+
+    accept = true;
+    PacedOrder sent;
+    sent.strategySlot = slot;
+    EXPECT_TRUE(pacer.submit(sent));
+    OrderPacerStatistics stats = pacer.getStatistics();
+    EXPECT_EQ(1u, stats.sendFailures);
+    EXPECT_EQ(1u, stats.sentImmediately);
+    EXPECT_EQ(0u, stats.queued);
+
+    pacer.stop();
+}
+
+TEST(OrderPacerTest, FailedQueuedSendIsRequeued)
+{
+    std::atomic<int> failuresLeft(0);
+    std::atomic<int64_t> nextRequestId(1);
+    OrderPacer pacer;
+    pacer.start(OrderPacer::Config(), [&](PacedOrder& order) {
+        order.requestId = nextRequestId++;
+        return failuresLeft.fetch_sub(1) <= 0;
+    });
+    int slot = pacer.registerStrategy("one_per_second", 1, 0);
+    ASSERT_GT(slot, 0);
+
+    // 第一单用掉本秒令牌，第二单排队，调度线程首次发送失败后重排并再次发出
+    PacedOrder first;
+    first.strategySlot = slot;
+    ASSERT_TRUE(pacer.submit(first));
+    failuresLeft.store(1);
+    PacedOrder second;
+    second.strategySlot = slot;
+    ASSERT_TRUE(pacer.submit(second));
+    EXPECT_EQ(1u, pacer.getStatistics().queued);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (pacer.getStatistics().sentFromQueue == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    OrderPacerStatistics stats = pacer.getStatistics();
+    EXPECT_EQ(1u, stats.sentFromQueue);
+    EXPECT_EQ(1u, stats.sendFailures);
+    EXPECT_EQ(0u, stats.droppedAfterFailures);
+    EXPECT_EQ(0u, stats.queued);
+
+    pacer.stop();
+}
@@ -0,0 +1,133 @@
+// 订单回报缓冲区跨进程吞吐测试
+// 父进程创建缓冲区并消费，fork出的子进程打开同名共享内存作为唯一生产者。
+// 校验回报按写入顺序到达、不丢不重、内容完整，并输出每秒消息数。
+
+#include "shared_memory/core/order_report_buffer.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <signal.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::shared_memory;
+
+namespace {
+
+constexpr uint64_t MESSAGE_COUNT = 1000000;
+constexpr size_t BUFFER_CAPACITY = 4096;
+constexpr size_t BATCH_SIZE = 64;
+constexpr auto STALL_TIMEOUT = std::chrono::seconds(10);
+
+const char* SYMBOLS[] = {"BTCUSDT", "ETHUSDT", "SOLUSDT", "BNBUSDT"};
+
+// 每条回报的内容都由序号推出，消费者据此校验（timestamp由push写入，不参与比较）
+void fill_report(OrderReport& report, uint64_t sequence)
+{
+    report.order_id = sequence;
+    report.set_symbol(SYMBOLS[sequence & 3]);
+    report.side = (sequence & 1) ? tes::Side::SELL : tes::Side::BUY;
+    report.status = tes::OrderStatus::FILLED;
+    report.quantity = static_cast<double>(sequence) * 0.5;
+    report.filled_quantity = report.quantity;
+    report.price = 100.0 + static_cast<double>(sequence % 1000);
+}
+
+bool report_matches(const OrderReport& report, uint64_t sequence)
+{
+    OrderReport expected;
+    fill_report(expected, sequence);
+    return report.order_id == expected.order_id &&
+           std::strcmp(report.symbol, expected.symbol) == 0 &&
+           report.side == expected.side &&
+           report.quantity == expected.quantity &&
+           report.price == expected.price &&
+           report.timestamp != 0;
+}
+
+// 子进程：打开缓冲区，按序写入全部回报，满时让出CPU
+[[noreturn]] void run_producer(const std::string& name)
+{
+    int exit_code = 0;
+    try {
+        OrderReportBuffer buffer(name, BUFFER_CAPACITY, false);
+        OrderReport report;
+        for (uint64_t sequence = 0; sequence < MESSAGE_COUNT; ++sequence) {
+            fill_report(report, sequence);
+            while (!buffer.push(report)) {
+                std::this_thread::yield();
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "producer failed: %s\n", e.what());
+        exit_code = 1;
+    }
+    // 不运行父进程继承来的析构和gtest退出逻辑
+    _exit(exit_code);
+}
+
+} // namespace
+
+TEST(OrderReportBufferIpcTest, ForkedProducerDeliversInOrderWithoutLoss)
+{
+    std::string name = "ipc_test_" + std::to_string(getpid());
+    std::unique_ptr<OrderReportBuffer> buffer(new OrderReportBuffer(name, BUFFER_CAPACITY, true));
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t producer = fork();
+    ASSERT_NE(-1, producer);
+    if (producer == 0) {
+        run_producer(name);
+    }
+
+    std::vector<OrderReport> batch(BATCH_SIZE);
+    uint64_t expected = 0;
+    uint64_t out_of_order = 0;
+    uint64_t corrupted = 0;
+    auto last_progress = start;
+    while (expected < MESSAGE_COUNT) {
+        size_t count = buffer->pop_batch(batch.data(), batch.size());
+        if (count == 0) {
+            if (std::chrono::steady_clock::now() - last_progress > STALL_TIMEOUT) {
+                break;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (batch[i].order_id != expected) {
+                ++out_of_order;
+                expected = batch[i].order_id;
+            }
+            if (!report_matches(batch[i], expected)) {
+                ++corrupted;
+            }
+            ++expected;
+        }
+        last_progress = std::chrono::steady_clock::now();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    if (expected < MESSAGE_COUNT) {
+        kill(producer, SIGKILL);
+    }
+    int status = 0;
+    ASSERT_EQ(producer, waitpid(producer, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    EXPECT_EQ(MESSAGE_COUNT, expected) << "consumer stalled for " << STALL_TIMEOUT.count() << "s";
+    EXPECT_EQ(0u, out_of_order);
+    EXPECT_EQ(0u, corrupted);
+    EXPECT_TRUE(buffer->empty());
+
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double messages_per_second = seconds > 0.0 ? static_cast<double>(expected) / seconds : 0.0;
+    RecordProperty("messages_per_second", std::to_string(static_cast<uint64_t>(messages_per_second)));
+    std::cout << "[ OrderReportBuffer IPC ] " << expected << " reports in " << seconds * 1000.0 << " ms, "
+              << static_cast<uint64_t>(messages_per_second) << " msg/s" << std::endl;
+}
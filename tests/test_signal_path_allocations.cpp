@@ -0,0 +1,162 @@
+// 信号到订单路径的无分配回归测试
+// 本测试链接tes_execution_alloc_tracking（打开TES_ENABLE_ALLOCATION_TRACKING），全局operator new已被替换。
+// 在测试线程上直接调用process_trading_signal，断言"signal_to_order"区域内没有发生分配；
+// 热路径上新增的分配（std::string临时量、容器扩容等）会让测试失败。
+
+#include "execution/allocation_tracker.h"
+#include "execution/execution_controller.h"
+#include "execution/trading_rule_registry.h"
+#include "execution/trading_rule_table.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::execution;
+
+namespace {
+
+const char* REGION_NAME = "signal_to_order";
+
+AllocationRegionReport region_report(const char* name)
+{
+    for (const auto& report : AllocationTracker::get_region_reports()) {
+        if (report.name == name) {
+            return report;
+        }
+    }
+    return {name, 0, 0, 0, 0};
+}
+
+void publish_test_rules()
+{
+    SymbolRule rule;
+    rule.symbol = "BTCUSDT";
+    rule.status = SymbolTradingStatus::TRADING;
+    rule.quantity_precision = 3;
+    rule.price_precision = 1;
+    rule.min_qty = 0.001;
+    rule.max_qty = 1000.0;
+    rule.step_size = 0.001;
+    rule.tick_size = 0.1;
+    rule.min_notional = 5.0;
+    TradingRuleRegistry::getInstance().publish(TradingRuleTable::build({rule}));
+}
+
+tes::shared_memory::TradingSignal make_signal(uint64_t signal_id)
+{
+    tes::shared_memory::TradingSignal signal;
+    signal.signal_id = signal_id;
+    signal.set_instrument_id("BTCUSDT");
+    signal.set_symbol("BTCUSDT");
+    signal.set_strategy_id("alloc_test");
+    signal.type = tes::shared_memory::SignalType::BUY;
+    signal.side = tes::shared_memory::OrderSide::BUY;
+    signal.order_type = tes::shared_memory::OrderType::LIMIT;
+    signal.time_in_force = tes::shared_memory::TimeInForce::GTC;
+    signal.quantity = 0.01;
+    signal.price = 50000.0;
+    return signal;
+}
+
+} // namespace
+
+class SignalPathAllocationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 违规只计数，不输出也不中止，由断言报告
+        AllocationTracker::set_policy(AllocationPolicy::COUNT);
+
+        work_dir_ = "/tmp/tes_alloc_test_" + std::to_string(getpid());
+        ASSERT_EQ(0, system(("mkdir -p " + work_dir_).c_str()));
+
+        // 文件模式且不监听文件：不连接共享内存，不启用交易所，下单走OrderManager
+        std::string signal_file = work_dir_ + "/signals.json";
+        std::ofstream(signal_file) << "[]";
+        std::string system_config = work_dir_ + "/system_config.json";
+        std::ofstream(system_config) << "{\"signal_transmission_config\": {\"mode\": \"file\", "
+                                     << "\"json_file_path\": \"" << signal_file << "\", "
+                                     << "\"enable_auto_sync\": false}}";
+
+        ExecutionController::Config config;
+        config.worker_thread_count = 1;
+        config.trading_exchanges = {};
+        config.system_config_file = system_config;
+        config.enable_risk_checking = true;
+        config.enable_position_tracking = false;
+        config.enable_latency_tracing = true;
+        config.latency_tracer_config.sample_every = 0;
+        config.enable_flight_recorder = true;
+        config.flight_recorder_path = work_dir_ + "/flight_recorder";
+        config.flight_recorder_capacity = 1024;
+        config.json_feedback_config.output_directory = work_dir_;
+
+        publish_test_rules();
+
+        controller_ = std::unique_ptr<ExecutionController>(new ExecutionController());
+        controller_->set_config(config);
+        ASSERT_TRUE(controller_->initialize());
+        ASSERT_TRUE(controller_->start());
+    }
+
+    void TearDown() override {
+        if (controller_) {
+            controller_->stop();
+            controller_->cleanup();
+            controller_.reset();
+        }
+        system(("rm -rf " + work_dir_).c_str());
+    }
+
+    std::string work_dir_;
+    std::unique_ptr<ExecutionController> controller_;
+};
+
+// 钩子确实生效：区域内的分配必须被记到该区域，否则下面的零分配断言没有意义
+TEST_F(SignalPathAllocationTest, TrackerCountsAllocationsInsideRegion)
+{
+    ASSERT_TRUE(AllocationTracker::enabled());
+
+    AllocationCounters before = AllocationTracker::thread_counters();
+    uint64_t region_allocations = 0;
+    {
+        ScopedNoAllocRegion region("alloc_test_sanity");
+        std::unique_ptr<std::vector<int>> values(new std::vector<int>(64));
+        region_allocations = region.allocations();
+    }
+    AllocationCounters after = AllocationTracker::thread_counters();
+
+    EXPECT_GE(region_allocations, 2u);
+    EXPECT_GE(after.allocations - before.allocations, 2u);
+    EXPECT_EQ(1u, region_report("alloc_test_sanity").violating_entries);
+}
+
+TEST_F(SignalPathAllocationTest, SignalToOrderPathDoesNotAllocate)
+{
+    // 预热：首次调用登记区域、建立线程本地状态和各处的一次性缓存
+    for (uint64_t i = 1; i <= 8; ++i) {
+        controller_->process_trading_signal(make_signal(i));
+    }
+
+    const uint64_t signal_count = 1000;
+    AllocationRegionReport before = region_report(REGION_NAME);
+    uint64_t processed_before = controller_->get_statistics().signals_processed;
+
+    for (uint64_t i = 0; i < signal_count; ++i) {
+        controller_->process_trading_signal(make_signal(100 + i));
+    }
+
+    AllocationRegionReport after = region_report(REGION_NAME);
+    EXPECT_EQ(signal_count, controller_->get_statistics().signals_processed - processed_before);
+    EXPECT_EQ(0u, controller_->get_statistics().risk_violations);
+
+    // 区域必须每次都进入，且没有任何一次分配
+    EXPECT_EQ(signal_count, after.entries - before.entries);
+    EXPECT_EQ(0u, after.violating_entries - before.violating_entries);
+    EXPECT_EQ(0u, after.allocations - before.allocations)
+        << (after.bytes - before.bytes) << " bytes allocated on the signal-to-order path";
+}
@@ -0,0 +1,116 @@
+// 交易规则引擎测试：未知交易对不论检查项掩码都必须拒绝，
+// 不能拿第0行的限制去校验（单笔与批量/AVX2路径结果一致）；
+// 单独检查价格时不做数量步长检查
+
+#include "execution/trading_rule_checker.h"
+#include "execution/trading_rule_registry.h"
+#include "execution/trading_rule_table.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using namespace tes::execution;
+
+namespace {
+
+std::unique_ptr<TradingRuleTable> make_table()
+{
+    // 第0行是一个宽松的可交易交易对，未知交易对若误用它会被放行
+    SymbolRule loose;
+    loose.symbol = "AAAUSDT";
+    loose.status = SymbolTradingStatus::TRADING;
+    loose.min_qty = 0.0;
+    loose.max_qty = 0.0;
+    loose.step_size = 0.0;
+    loose.tick_size = 0.0;
+    loose.min_notional = 0.0;
+
+    SymbolRule btc;
+    btc.symbol = "BTCUSDT";
+    btc.status = SymbolTradingStatus::TRADING;
+    btc.min_qty = 0.001;
+    btc.max_qty = 1000.0;
+    btc.step_size = 0.001;
+    btc.tick_size = 0.1;
+    btc.min_notional = 5.0;
+    return TradingRuleTable::build({loose, btc});
+}
+
+} // namespace
+
+TEST(TradingRuleCheckerTest, UnknownSymbolRejectedWhateverMask)
+{
+    std::unique_ptr<TradingRuleTable> table = make_table();
+    ASSERT_TRUE(table);
+    int32_t unknown = table->find("NOSUCHUSDT");
+    ASSERT_EQ(TradingRuleTable::NOT_FOUND, unknown);
+
+    const uint32_t masks[] = {CHECK_ALL, CHECK_QUANTITY, CHECK_PRICE | CHECK_PRECISION, CHECK_MIN_NOTIONAL, 0u};
+    for (uint32_t mask : masks) {
+        EXPECT_EQ(TradingRuleCheckResult::REJECT_SYMBOL_NOT_FOUND,
+                  TradingRuleChecker::evaluate(table.get(), unknown, 0.01, 50000.0, mask)) << "mask " << mask;
+    }
+
+    // 已知交易对不受影响
+    int32_t btc = table->find("BTCUSDT");
+    EXPECT_EQ(TradingRuleCheckResult::PASS,
+              TradingRuleChecker::evaluate(table.get(), btc, 0.01, 50000.0, CHECK_QUANTITY));
+
+    // 未加载规则表时仍跳过交易对检查
+    EXPECT_EQ(TradingRuleCheckResult::PASS,
+              TradingRuleChecker::evaluate(nullptr, TradingRuleTable::NOT_FOUND, 0.01, 50000.0, CHECK_ALL));
+}
+
+TEST(TradingRuleCheckerTest, BatchRejectsUnknownSymbolWithMaskedStatusCheck)
+{
+    std::unique_ptr<TradingRuleTable> table = make_table();
+    ASSERT_TRUE(table);
+    int32_t btc = table->find("BTCUSDT");
+
+    // 9笔：两个完整的4笔块加一笔标量尾部，未知交易对分布在块内和尾部
+    std::vector<int32_t> indices = {btc, TradingRuleTable::NOT_FOUND, btc, btc,
+                                    TradingRuleTable::NOT_FOUND, btc, btc, btc,
+                                    TradingRuleTable::NOT_FOUND};
+    std::vector<double> quantities(indices.size(), 0.01);
+    std::vector<double> prices(indices.size(), 50000.0);
+    std::vector<TradingRuleCheckResult> results(indices.size());
+
+    size_t passed = TradingRuleChecker::evaluate_batch(table.get(), indices.data(), quantities.data(), prices.data(),
+                                                       indices.size(), CHECK_QUANTITY | CHECK_MIN_NOTIONAL,
+                                                       results.data());
+    EXPECT_EQ(6u, passed);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(indices[i] == TradingRuleTable::NOT_FOUND ? TradingRuleCheckResult::REJECT_SYMBOL_NOT_FOUND
+                                                            : TradingRuleCheckResult::PASS,
+                  results[i]) << "order " << i;
+    }
+}
+
+TEST(TradingRuleCheckerTest, PriceCheckIgnoresQuantityStep)
+{
+    // 步长10不能整除占位数量1.0，价格检查不应因此拒绝
+    SymbolRule coarse;
+    coarse.symbol = "LOTUSDT";
+    coarse.status = SymbolTradingStatus::TRADING;
+    coarse.min_qty = 10.0;
+    coarse.max_qty = 100000.0;
+    coarse.step_size = 10.0;
+    coarse.tick_size = 0.0001;
+    coarse.min_notional = 5.0;
+    TradingRuleRegistry::getInstance().publish(TradingRuleTable::build({coarse}));
+
+    TradingRuleChecker checker;
+    TradingRuleChecker::Config config;
+    config.log_violations = false;
+    checker.set_config(config);
+    ASSERT_TRUE(checker.initialize());
+
+    EXPECT_EQ(TradingRuleCheckResult::PASS, checker.check_price_rules("LOTUSDT", 0.1234));
+    EXPECT_EQ(TradingRuleCheckResult::REJECT_PRICE_PRECISION, checker.check_price_rules("LOTUSDT", 0.12345));
+    EXPECT_EQ(TradingRuleCheckResult::REJECT_QUANTITY_PRECISION, checker.check_quantity_rules("LOTUSDT", 15.0));
+
+    // 关闭精度检查后价格精度也不再检查
+    config.enable_precision_check = false;
+    checker.set_config(config);
+    EXPECT_EQ(TradingRuleCheckResult::PASS, checker.check_price_rules("LOTUSDT", 0.12345));
+}
@@ -0,0 +1,141 @@
+// 交易规则注册表发布/回收测试
+// 读者拿到的表在其后RETAINED_TABLES-1次发布内保持可用；
+// 刷新器按解析出的规则判断内容是否变化，serverTime等无关字段变化不触发重建。
+
+#include "execution/trading_rule_registry.h"
+#include "execution/trading_rule_table.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace tes::execution;
+
+namespace {
+
+std::unique_ptr<TradingRuleTable> make_table(double min_qty)
+{
+    SymbolRule rule;
+    rule.symbol = "BTCUSDT";
+    rule.status = SymbolTradingStatus::TRADING;
+    rule.quantity_precision = 3;
+    rule.price_precision = 1;
+    rule.min_qty = min_qty;
+    rule.max_qty = 1000.0;
+    rule.step_size = 0.001;
+    rule.tick_size = 0.1;
+    rule.min_notional = 5.0;
+    return TradingRuleTable::build({rule});
+}
+
+} // namespace
+
+TEST(TradingRuleRegistryTest, RetiredTableStaysValidWhileRetained)
+{
+    TradingRuleRegistry& registry = TradingRuleRegistry::getInstance();
+    registry.publish(make_table(0.001));
+    uint64_t version = registry.version();
+
+    TradingRuleTablePtr held = registry.current();
+    ASSERT_TRUE(held);
+
+    // 保留窗口内连续发布，读者手中的旧表不受影响
+    const size_t publishes = TradingRuleRegistry::RETAINED_TABLES - 1;
+    for (size_t i = 0; i < publishes; ++i) {
+        registry.publish(make_table(0.002 + i * 0.001));
+    }
+    EXPECT_EQ(version + publishes, registry.version());
+    EXPECT_NE(held, registry.current());
+    int32_t index = held->find("BTCUSDT");
+    ASSERT_NE(TradingRuleTable::NOT_FOUND, index);
+    EXPECT_DOUBLE_EQ(0.001, held->min_qty(index));
+
+    // 当前表总是最新发布的版本
+    TradingRuleTablePtr latest = registry.current();
+    index = latest->find("BTCUSDT");
+    ASSERT_NE(TradingRuleTable::NOT_FOUND, index);
+    EXPECT_DOUBLE_EQ(0.002 + (publishes - 1) * 0.001, latest->min_qty(index));
+}
+
+TEST(TradingRuleRegistryTest, ConcurrentReadersDuringPublish)
+{
+    TradingRuleRegistry& registry = TradingRuleRegistry::getInstance();
+    registry.publish(make_table(0.001));
+
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> reads(0);
+    std::atomic<uint64_t> misses(0);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (running.load(std::memory_order_relaxed)) {
+                TradingRuleTablePtr table = registry.current();
+                int32_t index = table ? table->find("BTCUSDT") : TradingRuleTable::NOT_FOUND;
+                if (index == TradingRuleTable::NOT_FOUND || !(table->min_qty(index) > 0)) {
+                    misses.fetch_add(1, std::memory_order_relaxed);
+                }
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // 至少发布200次，且直到读者真正与发布交错执行过（单核机器上读者可能晚于发布开始）；
+    // 发布间隔1ms，保证单次查找远短于保留窗口内的RETAINED_TABLES-1次发布
+    for (int i = 0; i < 200 || reads.load(std::memory_order_relaxed) < 10000; ++i) {
+        registry.publish(make_table(0.001 * (1 + i % 10)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running.store(false);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(0u, misses.load());
+}
+
+TEST(ExchangeRulesRefresherTest, ServerTimeChangeDoesNotRebuild)
+{
+    std::string path = "/tmp/tes_exchange_info_test_" + std::to_string(getpid()) + ".json";
+    auto write_exchange_info = [&path](uint64_t server_time, const char* step_size) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "{\"timezone\":\"UTC\",\"serverTime\":" << server_time << ",\"symbols\":[{"
+             << "\"symbol\":\"BTCUSDT\",\"status\":\"TRADING\",\"pricePrecision\":1,\"quantityPrecision\":3,"
+             << "\"filters\":[{\"filterType\":\"PRICE_FILTER\",\"tickSize\":\"0.1\",\"minPrice\":\"0.1\",\"maxPrice\":\"1000000\"},"
+             << "{\"filterType\":\"LOT_SIZE\",\"minQty\":\"0.001\",\"maxQty\":\"1000\",\"stepSize\":\"" << step_size << "\"},"
+             << "{\"filterType\":\"MIN_NOTIONAL\",\"notional\":\"5\"}]}]}";
+    };
+
+    ExchangeRulesRefresher::Config config;
+    config.source = path;
+    ExchangeRulesRefresher refresher;
+    refresher.start(config);
+
+    write_exchange_info(1700000000000ULL, "0.001");
+    ASSERT_TRUE(refresher.refresh_now());
+    uint64_t version = TradingRuleRegistry::getInstance().version();
+
+    // 只有serverTime变化：不重建、不发布
+    write_exchange_info(1700000005000ULL, "0.001");
+    ASSERT_TRUE(refresher.refresh_now());
+    ExchangeRulesRefreshStatistics stats = refresher.get_statistics();
+    EXPECT_EQ(1u, stats.refresh_count);
+    EXPECT_EQ(1u, stats.unchanged_count);
+    EXPECT_EQ(version, TradingRuleRegistry::getInstance().version());
+
+    // 规则变化：重新发布
+    write_exchange_info(1700000010000ULL, "0.01");
+    ASSERT_TRUE(refresher.refresh_now());
+    stats = refresher.get_statistics();
+    EXPECT_EQ(2u, stats.refresh_count);
+    EXPECT_EQ(version + 1, TradingRuleRegistry::getInstance().version());
+
+    refresher.stop();
+    std::remove(path.c_str());
+}
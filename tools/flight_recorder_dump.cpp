@@ -0,0 +1,146 @@
+// 飞行记录器解码工具：把记录文件按时间线输出
+// 用法: flight_recorder_dump [--seconds N] [--type TYPE] [--id ID] [记录文件]
+//   --seconds N  只输出最后一个事件之前N秒内的事件
+//   --type TYPE  只输出指定类型（如ORDER_ACK）
+//   --id ID      只输出指定ID（轨迹ID等）
+// 每行给出与上一行的间隔，以及与同一ID上一个事件的间隔（信号到下单、下单到应答等）
+
+#include "shared_memory/core/flight_recorder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using tes::shared_memory::FlightEventRecord;
+using tes::shared_memory::FlightEventType;
+using tes::shared_memory::FlightRecorder;
+using tes::shared_memory::FlightRecorderHeader;
+using tes::shared_memory::flight_event_type_name;
+
+namespace {
+
+const char* DEFAULT_PATH = "/dev/shm/tes_flight_recorder";
+
+void print_usage(const char* program)
+{
+    std::fprintf(stderr, "usage: %s [--seconds N] [--type TYPE] [--id ID] [file]\n", program);
+    std::fprintf(stderr, "default file: %s\n", DEFAULT_PATH);
+}
+
+std::string format_realtime(int64_t ns)
+{
+    time_t seconds = static_cast<time_t>(ns / 1000000000LL);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    char buffer[64];
+    size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    std::snprintf(buffer + length, sizeof(buffer) - length, ".%09lld",
+                  static_cast<long long>(ns % 1000000000LL));
+    return buffer;
+}
+
+// 间隔按量级选择单位
+std::string format_delta(int64_t ns)
+{
+    char buffer[32];
+    if (ns < 10000) {
+        std::snprintf(buffer, sizeof(buffer), "+%lldns", static_cast<long long>(ns));
+    } else if (ns < 10000000) {
+        std::snprintf(buffer, sizeof(buffer), "+%.1fus", ns / 1e3);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "+%.3fms", ns / 1e6);
+    }
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string path = DEFAULT_PATH;
+    double seconds = 0.0;
+    const char* type_filter = nullptr;
+    bool has_id_filter = false;
+    uint64_t id_filter = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--type") == 0 && i + 1 < argc) {
+            type_filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--id") == 0 && i + 1 < argc) {
+            has_id_filter = true;
+            id_filter = std::strtoull(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-') {
+            print_usage(argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    FlightRecorderHeader header;
+    std::vector<FlightEventRecord> events;
+    std::string error;
+    if (!FlightRecorder::load(path, header, events, error)) {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+        return 1;
+    }
+
+    uint64_t written = header.write_index.load();
+    std::printf("flight recorder %s\n", path.c_str());
+    std::printf("  pid %d, created %s, capacity %llu events\n", header.pid,
+                format_realtime(header.created_realtime_ns).c_str(),
+                static_cast<unsigned long long>(header.capacity));
+    std::printf("  written %llu, retained %zu, overwritten %llu\n",
+                static_cast<unsigned long long>(written), events.size(),
+                static_cast<unsigned long long>(written > events.size() ? written - events.size() : 0));
+    std::printf("  shutdown: %s\n\n", header.clean_shutdown.load() ? "clean" : "NOT CLEAN (crashed or still running)");
+
+    if (events.empty()) {
+        return 0;
+    }
+
+    int64_t cutoff_ns = 0;
+    if (seconds > 0.0) {
+        cutoff_ns = events.back().timestamp_ns - static_cast<int64_t>(seconds * 1e9);
+    }
+
+    std::printf("%-29s %12s %8s  %-16s %20s %16s %12s\n",
+                "time", "delta", "tid", "type", "id", "value", "since_id");
+
+    std::unordered_map<uint64_t, int64_t> last_by_id;
+    int64_t previous_ns = 0;
+    for (const auto& event : events) {
+        if (event.timestamp_ns < cutoff_ns) {
+            continue;
+        }
+        const char* type_name = flight_event_type_name(event.type);
+        if (type_filter && std::strcmp(type_filter, type_name) != 0) {
+            continue;
+        }
+        if (has_id_filter && event.id != id_filter) {
+            continue;
+        }
+
+        std::string delta = previous_ns ? format_delta(event.timestamp_ns - previous_ns) : "";
+        std::string since_id;
+        if (event.id != 0) {
+            auto it = last_by_id.find(event.id);
+            if (it != last_by_id.end()) {
+                since_id = format_delta(event.timestamp_ns - it->second);
+            }
+            last_by_id[event.id] = event.timestamp_ns;
+        }
+
+        std::printf("%-29s %12s %8u  %-16s %20llu %16lld %12s\n",
+                    format_realtime(event.timestamp_ns).c_str(), delta.c_str(), event.thread_id, type_name,
+                    static_cast<unsigned long long>(event.id), static_cast<long long>(event.value),
+                    since_id.c_str());
+        previous_ns = event.timestamp_ns;
+    }
+    return 0;
+}